@@ -0,0 +1,37 @@
+import time
+
+import dgl
+
+import numpy as np
+import torch
+
+from .. import utils
+
+
+@utils.benchmark("time", timeout=600)
+@utils.parametrize("num_nodes", [100000, 1000000])
+@utils.parametrize("avg_degree", [5, 20])
+@utils.parametrize("op", ["product", "sum"])
+def track_time(num_nodes, avg_degree, op):
+    device = utils.get_bench_device()
+    graphs = []
+    for _ in range(2):
+        g = dgl.rand_graph(num_nodes, num_nodes * avg_degree).to(device)
+        g.edata["w"] = torch.rand(g.num_edges(), device=device)
+        graphs.append(g)
+
+    def run():
+        if op == "product":
+            return dgl.adj_product_graph(graphs[0], graphs[1], "w")
+        else:
+            return dgl.adj_sum_graph(graphs, "w")
+
+    # dry run
+    run()
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(3):
+            run()
+
+    return t.elapsed_secs / 3
@@ -10,7 +10,7 @@ from .. import utils
 
 
 @utils.benchmark("time", timeout=600)
-@utils.parametrize("graph_name", ["ogbn-arxiv"])
+@utils.parametrize("graph_name", ["ogbn-arxiv", "reddit"])
 @utils.parametrize("format", ["coo"])
 @utils.parametrize("feat_size", [4, 32, 256])
 @utils.parametrize("msg_type", ["copy_u", "u_mul_e"])
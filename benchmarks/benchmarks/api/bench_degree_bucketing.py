@@ -0,0 +1,34 @@
+import time
+
+import dgl
+
+import numpy as np
+import torch
+
+from .. import utils
+
+
+@utils.benchmark("time")
+@utils.parametrize("num_nodes", [100000, 1000000])
+@utils.parametrize("num_msgs", [1000000, 10000000])
+@utils.parametrize("alpha", [1.5, 2.5])
+def track_time(num_nodes, num_msgs, alpha):
+    degree_bucketing = dgl._ffi.function.get_global_func(
+        "_deprecate.runtime.degree_bucketing._CAPI_DGLDegreeBucketing"
+    )
+    # Power-law distributed in-degrees.
+    rng = np.random.default_rng(0)
+    vids = (rng.zipf(alpha, num_msgs) - 1) % num_nodes
+    vids = dgl.backend.to_dgl_nd(torch.from_numpy(vids))
+    msg_ids = dgl.backend.to_dgl_nd(torch.arange(num_msgs))
+    recv_ids = dgl.backend.to_dgl_nd(torch.arange(num_nodes))
+
+    # dry run
+    degree_bucketing(msg_ids, vids, recv_ids)
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(3):
+            degree_bucketing(msg_ids, vids, recv_ids)
+
+    return t.elapsed_secs / 3
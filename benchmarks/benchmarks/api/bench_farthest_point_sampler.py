@@ -0,0 +1,28 @@
+import time
+
+import dgl
+
+import numpy as np
+import torch
+
+from .. import utils
+
+
+@utils.benchmark("time", timeout=600)
+@utils.parametrize("batch_size", [1, 8, 32])
+@utils.parametrize("num_points", [4096, 16384])
+@utils.parametrize("dim", [3, 6])
+def track_time(batch_size, num_points, dim):
+    device = utils.get_bench_device()
+    pos = torch.rand((batch_size, num_points, dim), device=device)
+    npoints = 512
+
+    # dry run
+    dgl.geometry.farthest_point_sampler(pos, npoints)
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(5):
+            dgl.geometry.farthest_point_sampler(pos, npoints)
+
+    return t.elapsed_secs / 5
@@ -43,3 +43,24 @@ def track_time(graph_name, format):
             gg = graph.formats([to_format])
 
     return t.elapsed_secs / 10
+
+
+# The coalescing of parallel edges when converting to a simple graph, which
+# sorts the COO and compacts its runs of duplicates.
+@utils.skip_if_gpu()
+@utils.benchmark("time", timeout=600)
+@utils.parametrize(
+    "graph_name", ["cora", "pubmed", "ogbn-arxiv", "livejournal"]
+)
+def track_time_to_simple(graph_name):
+    graph = utils.get_graph(graph_name, "coo")
+    graph = graph.formats(["coo"])
+    # dry run
+    dgl.to_simple(graph)
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(10):
+            gg = dgl.to_simple(graph)
+
+    return t.elapsed_secs / 10
@@ -0,0 +1,49 @@
+import dgl.graphbolt as gb
+
+import torch
+
+from .. import utils
+
+
+# The benchmark for querying graphbolt's CPU cache policies from many
+# concurrent requests on a Zipfian key stream, as issued by multiple dataloader
+# workers. The returned time is per key.
+@utils.skip_if_gpu()
+@utils.benchmark("time", timeout=600)
+@utils.parametrize("policy", ["sieve", "clock", "concurrent-clock"])
+@utils.parametrize("num_concurrent", [1, 8, 32])
+def track_time(policy, num_concurrent):
+    num_keys = 10_000_000
+    cache_size = 1_000_000
+    batch_size = 16384
+    num_batches = 64
+    cache = gb.impl.CPUFeatureCache((cache_size, 1), torch.float32, policy)
+    policy = cache._policy
+    # Zipf-like popularity of the keys with a heavy head.
+    ranks = torch.randperm(num_keys)
+
+    def make_keys():
+        u = torch.rand(batch_size, dtype=torch.float64)
+        return ranks[(num_keys * u**4).long().clamp_(max=num_keys - 1)]
+
+    def run(batches):
+        for begin in range(0, len(batches), num_concurrent):
+            futures = [
+                policy.query_and_replace_async(keys, 0)
+                for keys in batches[begin : begin + num_concurrent]
+            ]
+            for keys, future in zip(batches[begin:], futures):
+                _, _, pointers, missing_keys, found, missing = future.wait()
+                found_cnt = keys.size(0) - missing_keys.size(0)
+                policy.reading_completed(pointers[:found_cnt], found)
+                policy.writing_completed(pointers[found_cnt:], missing)
+
+    # dry run
+    run([make_keys() for i in range(num_batches)])
+
+    # timing
+    batches = [make_keys() for i in range(num_batches)]
+    with utils.Timer() as t:
+        run(batches)
+
+    return t.elapsed_secs / (num_batches * batch_size)
@@ -0,0 +1,60 @@
+import dgl.graphbolt as gb
+
+import torch
+
+from .. import utils
+
+
+def _get_graph(graph_name, compressed):
+    g = utils.get_graph(graph_name, "csc")
+    graph = gb.from_dglgraph(g, is_homogeneous=True)
+    if compressed:
+        graph.compress_indices()
+    return graph
+
+
+# The memory taken by the indices of graphbolt's FusedCSCSamplingGraph, with
+# and without compression.
+@utils.benchmark("memory", timeout=600)
+@utils.parametrize("graph_name", ["reddit", "ogbn-products"])
+@utils.parametrize("compressed", [False, True])
+def track_memory(graph_name, compressed):
+    graph = _get_graph(graph_name, compressed)
+    if compressed:
+        offsets = graph.compressed_indices_offsets
+        return (
+            graph.compressed_indices.numel()
+            + offsets.numel() * offsets.element_size()
+        )
+    return graph.indices.numel() * graph.indices.element_size()
+
+
+# The time to sample the neighbors of, or to slice the in-edges of, a batch of
+# seeds on CPU, with and without compressed indices. The returned time is per
+# seed.
+@utils.benchmark("time", timeout=600)
+@utils.parametrize("graph_name", ["reddit", "ogbn-products"])
+@utils.parametrize("compressed", [False, True])
+@utils.parametrize("op", ["sample_neighbors", "in_subgraph"])
+def track_time(graph_name, compressed, op):
+    graph = _get_graph(graph_name, compressed)
+    batch_size = 1024
+    seeds = torch.randint(0, graph.total_num_nodes, (batch_size,))
+    fanouts = torch.LongTensor([10])
+
+    def run():
+        if op == "sample_neighbors":
+            graph.sample_neighbors(seeds, fanouts)
+        else:
+            graph.in_subgraph(seeds)
+
+    # dry run
+    for i in range(3):
+        run()
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(20):
+            run()
+
+    return t.elapsed_secs / 20 / batch_size
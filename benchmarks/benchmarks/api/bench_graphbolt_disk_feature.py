@@ -0,0 +1,74 @@
+import os
+import tempfile
+
+import dgl.graphbolt as gb
+import numpy as np
+
+import torch
+
+from .. import utils
+
+
+# The benchmark for gathering rows of a DiskBasedFeature from a locally
+# generated .npy file, optionally behind a CPU cache holding 10% of the rows.
+# The returned time is per read of a batch of rows.
+@utils.skip_if_gpu()
+@utils.benchmark("time", timeout=1200)
+@utils.parametrize("feat_size", [16, 128])
+@utils.parametrize("locality", ["random", "clustered", "skewed"])
+@utils.parametrize("cached", [False, True])
+def track_time(feat_size, locality, cached):
+    if not torch.ops.graphbolt.detect_io_uring():
+        return 0
+    num_rows = 2_000_000
+    batch_size = 100_000
+    with tempfile.TemporaryDirectory() as test_dir:
+        path = os.path.join(test_dir, "feat.npy")
+        data = np.lib.format.open_memmap(
+            path, mode="w+", dtype=np.float32, shape=(num_rows, feat_size)
+        )
+        chunk = 1 << 18
+        for begin in range(0, num_rows, chunk):
+            end = min(begin + chunk, num_rows)
+            data[begin:end] = np.random.rand(end - begin, feat_size)
+        data.flush()
+        data = None
+        feature = gb.DiskBasedFeature(path)
+        disk_feature = feature
+        if cached:
+            feature = gb.cpu_cached_feature(
+                feature, num_rows // 10 * feat_size * 4
+            )
+
+        def make_ids():
+            if locality == "random":
+                return torch.randint(0, num_rows, (batch_size,))
+            if locality == "skewed":
+                # Power law popularity as seen when sampling neighbors.
+                u = torch.rand(batch_size)
+                return (num_rows * u**4).long().clamp_(max=num_rows - 1)
+            # Runs of consecutive rows, e.g. the neighbors of nodes in a
+            # graph with a locality preserving node order.
+            starts = torch.randint(0, num_rows - 16, (batch_size // 16,))
+            return (starts[:, None] + torch.arange(16)).flatten()
+
+        # dry run
+        for i in range(3):
+            feature.read(make_ids())
+
+        # timing
+        ids = [make_ids() for i in range(10)]
+        disk_feature.read_statistics(reset=True)
+        with utils.Timer() as t:
+            for i in range(10):
+                feature.read(ids[i])
+        statistics = disk_feature.read_statistics()
+        print(
+            f"reads per row: {statistics['num_reads'] / 10 / batch_size:.3f}, "
+            f"read amplification: {statistics['read_amplification']:.2f}"
+        )
+        if cached:
+            print(f"miss rate: {feature.miss_rate:.3f}")
+        feature = disk_feature = None
+
+    return t.elapsed_secs / 10
@@ -0,0 +1,44 @@
+import dgl.graphbolt as gb
+
+import torch
+
+from .. import utils
+
+
+# The benchmark for sampling the 3-hop neighborhood of a minibatch with
+# graphbolt's FusedCSCSamplingGraph on CPU, either in a single native call or
+# hop by hop with a unique_and_compact call after each hop. The returned time
+# is per minibatch.
+@utils.skip_if_gpu()
+@utils.benchmark("time", timeout=600)
+@utils.parametrize("graph_name", ["reddit", "ogbn-products"])
+@utils.parametrize("batch_size", [64, 1024])
+@utils.parametrize("mode", ["native", "per_hop"])
+def track_time(graph_name, batch_size, mode):
+    g = utils.get_graph(graph_name, "csc")
+    graph = gb.from_dglgraph(g, is_homogeneous=True)
+    num_nodes = graph.total_num_nodes
+    fanouts = [10, 10, 10]
+    seeds = torch.randperm(num_nodes)[:batch_size].to(graph.indices.dtype)
+
+    def sample():
+        if mode == "native":
+            return graph.sample_neighbors_multi_hop(seeds, fanouts)
+        nodes = seeds
+        for fanout in fanouts:
+            subgraph = graph.sample_neighbors(nodes, torch.LongTensor([fanout]))
+            nodes, _, _ = gb.unique_and_compact_csc_formats(
+                subgraph.sampled_csc, nodes
+            )
+        return nodes
+
+    # dry run
+    for i in range(3):
+        sample()
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(20):
+            sample()
+
+    return t.elapsed_secs / 20
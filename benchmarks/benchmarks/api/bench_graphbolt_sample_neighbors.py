@@ -0,0 +1,67 @@
+import time
+
+import dgl
+import dgl.graphbolt as gb
+
+import torch
+
+from .. import utils
+
+
+# The benchmarks for the per-seed pick kernels of graphbolt's
+# FusedCSCSamplingGraph on CPU. The returned time is per seed.
+@utils.benchmark("time", timeout=600)
+@utils.parametrize("graph_name", ["reddit", "ogbn-products"])
+@utils.parametrize(
+    "mode",
+    [
+        "uniform_replace",
+        "weighted",
+        "weighted_replace",
+        "weighted_prefix_sum",
+        "weighted_replace_prefix_sum",
+        "temporal",
+    ],
+)
+@utils.parametrize("fanout", [5, 20])
+def track_time(graph_name, mode, fanout):
+    g = utils.get_graph(graph_name, "csc")
+    graph = gb.from_dglgraph(g, is_homogeneous=True)
+    num_nodes = graph.total_num_nodes
+    num_edges = graph.total_num_edges
+    graph.edge_attributes = {"prob": torch.rand(num_edges)}
+    if mode.endswith("prefix_sum"):
+        graph.build_probs_prefix_sum("prob")
+    graph.node_attributes = {
+        "timestamp": torch.randint(0, 1000, (num_nodes,), dtype=torch.int64)
+    }
+    batch_size = 1024
+    seeds = torch.randint(0, num_nodes, (batch_size,))
+    fanouts = torch.LongTensor([fanout])
+
+    def sample():
+        if mode == "temporal":
+            graph.temporal_sample_neighbors(
+                seeds,
+                torch.full((batch_size,), 1000, dtype=torch.int64),
+                fanouts,
+                node_timestamp_attr_name="timestamp",
+            )
+        else:
+            graph.sample_neighbors(
+                seeds,
+                fanouts,
+                replace="replace" in mode,
+                probs_name="prob" if mode.startswith("weighted") else None,
+            )
+
+    # dry run
+    for i in range(3):
+        sample()
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(20):
+            sample()
+
+    return t.elapsed_secs / 20 / batch_size
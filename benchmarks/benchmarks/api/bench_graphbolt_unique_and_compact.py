@@ -0,0 +1,36 @@
+import dgl.graphbolt as gb
+
+import torch
+
+from .. import utils
+
+
+# The benchmark for graphbolt's unique_and_compact on CPU with sampled ids that
+# are highly duplicated, as produced by neighbor sampling on a power law graph.
+# The returned time is per call.
+@utils.skip_if_gpu()
+@utils.benchmark("time", timeout=600)
+@utils.parametrize("num_sampled", [100_000, 1_000_000])
+@utils.parametrize("dtype", ["int32", "int64"])
+def track_time(num_sampled, dtype):
+    dtype = getattr(torch, dtype)
+    num_nodes = 10_000_000
+    num_seeds = 1024
+    fanout = num_sampled // num_seeds
+    seeds = torch.randint(0, num_nodes, (num_seeds,), dtype=dtype).unique()
+    # Power law popularity of the sampled neighbors.
+    u = torch.rand(seeds.size(0) * fanout)
+    indices = (num_nodes * u**4).to(dtype).clamp_(max=num_nodes - 1)
+    indptr = torch.arange(0, indices.size(0) + 1, fanout)
+    csc_formats = gb.CSCFormatBase(indptr=indptr, indices=indices)
+
+    # dry run
+    for i in range(3):
+        gb.unique_and_compact_csc_formats(csc_formats, seeds)
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(10):
+            gb.unique_and_compact_csc_formats(csc_formats, seeds)
+
+    return t.elapsed_secs / 10
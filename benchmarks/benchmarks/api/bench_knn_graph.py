@@ -13,7 +13,14 @@ from .. import utils
 @utils.parametrize("size", [1000, 10000])
 @utils.parametrize("dim", [4, 32, 256])
 @utils.parametrize_cpu(
-    "algorithm", ["bruteforce-blas", "bruteforce", "kd-tree", "nn-descent"]
+    "algorithm",
+    [
+        "bruteforce-blas",
+        "bruteforce",
+        "bruteforce-blocked",
+        "kd-tree",
+        "nn-descent",
+    ],
 )
 @utils.parametrize_gpu(
     "algorithm",
@@ -32,3 +39,46 @@ def track_time(size, dim, k, algorithm):
             dgl.knn_graph(feat, k, algorithm=algorithm)
 
     return t.elapsed_secs / 5
+
+
+# The recall of the k nearest neighbors found by an algorithm, against the ones
+# of the exact 'bruteforce-blas' algorithm.
+@utils.skip_if_gpu()
+@utils.benchmark("acc", timeout=120)
+@utils.parametrize("k", [8, 64])
+@utils.parametrize("dim", [32, 128])
+@utils.parametrize("algorithm", ["bruteforce-blocked", "nn-descent"])
+def track_acc(dim, k, algorithm):
+    size = 10000
+    features = np.random.RandomState(42).randn(size, dim)
+    feat = torch.tensor(features, dtype=torch.float)
+    expected = dgl.knn_graph(feat, k, algorithm="bruteforce-blas")
+    actual = dgl.knn_graph(feat, k, algorithm=algorithm)
+
+    def neighbors(g):
+        src, dst = g.edges()
+        return src[torch.sort(dst, stable=True)[1]].view(size, k)
+
+    expected_src = neighbors(expected)
+    actual_src = neighbors(actual)
+    hits = (actual_src.unsqueeze(-1) == expected_src.unsqueeze(1)).any(-1)
+    return hits.float().mean().item()
+
+
+# The throughput of NN-descent on point sets large enough for the neighbor
+# updates of its local join to dominate.
+@utils.skip_if_gpu()
+@utils.benchmark("time", timeout=600)
+@utils.parametrize("size", [50000, 200000])
+@utils.parametrize("dim", [16, 64])
+def track_time_nn_descent(size, dim):
+    features = np.random.RandomState(42).randn(size, dim)
+    feat = torch.tensor(features, dtype=torch.float)
+    # dry run
+    dgl.knn_graph(feat, 16, algorithm="nn-descent")
+    # timing
+    with utils.Timer() as t:
+        for i in range(3):
+            dgl.knn_graph(feat, 16, algorithm="nn-descent")
+
+    return t.elapsed_secs / 3
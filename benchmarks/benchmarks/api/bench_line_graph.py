@@ -0,0 +1,27 @@
+import dgl
+
+from .. import utils
+
+
+# The line graph has an edge for every pair of consecutive edges, so the
+# benchmark uses graphs with low degrees like road networks and molecules.
+@utils.skip_if_gpu()
+@utils.benchmark("time", timeout=1200)
+@utils.parametrize("graph_name", ["cora", "pubmed", "random"])
+@utils.parametrize("format", ["coo", "csr"])
+@utils.parametrize("backtracking", [True, False])
+def track_time(graph_name, format, backtracking):
+    if graph_name == "random":
+        graph = dgl.rand_graph(1_000_000, 4_000_000)
+    else:
+        graph = utils.get_graph(graph_name, format)
+    graph = graph.formats([format])
+    # dry run
+    dgl.line_graph(graph, backtracking=backtracking)
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(3):
+            dgl.line_graph(graph, backtracking=backtracking)
+
+    return t.elapsed_secs / 3
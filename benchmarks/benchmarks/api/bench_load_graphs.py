@@ -0,0 +1,98 @@
+import os
+import tempfile
+
+import dgl
+
+import numpy as np
+import torch
+
+from .. import utils
+
+
+def _save(graphs, layout):
+    path = os.path.join(
+        tempfile.gettempdir(), "bench_load_graphs_{}.bin".format(layout)
+    )
+    dgl.save_graphs(
+        path,
+        graphs,
+        mmap=layout == "mmap",
+        compress=layout == "compress",
+    )
+    return path
+
+
+def _small_graphs(num_graphs):
+    graphs = []
+    for i in range(num_graphs):
+        g = dgl.rand_graph(50, 200)
+        g.ndata["h"] = torch.randn(g.num_nodes(), 64)
+        graphs.append(g)
+    return graphs
+
+
+# Files saved with mmap=True are memory mapped instead of read, so the time
+# excludes reading the pages, which happens when the tensors are accessed.
+@utils.skip_if_gpu()
+@utils.benchmark("time", timeout=1200)
+@utils.parametrize("graph_name", ["reddit", "ogbn-arxiv"])
+@utils.parametrize("layout", ["default", "mmap", "compress"])
+def track_time(graph_name, layout):
+    graph = utils.get_graph(graph_name, "csc")
+    path = _save([graph], layout)
+    # dry run
+    dgl.load_graphs(path)
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(3):
+            dgl.load_graphs(path)
+
+    os.remove(path)
+    return t.elapsed_secs / 3
+
+
+# Loading a few graphs of a file holding a dataset of many small graphs, and
+# reading their features.
+@utils.skip_if_gpu()
+@utils.benchmark("time", timeout=1200)
+@utils.parametrize("num_loaded", [16, 1024])
+@utils.parametrize("layout", ["default", "mmap", "compress"])
+def track_time_idx_list(num_loaded, layout):
+    num_graphs = 10000
+    path = _save(_small_graphs(num_graphs), layout)
+    idx_list = np.random.choice(num_graphs, num_loaded, replace=False).tolist()
+    # dry run
+    dgl.load_graphs(path, idx_list)
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(3):
+            g_list, _ = dgl.load_graphs(path, idx_list)
+            for g in g_list:
+                g.ndata["h"].sum()
+
+    os.remove(path)
+    return t.elapsed_secs / 3
+
+
+# Saving a large graph, and a dataset of many small graphs.
+@utils.skip_if_gpu()
+@utils.benchmark("time", timeout=1200)
+@utils.parametrize("graph_name", ["reddit", "small"])
+@utils.parametrize("layout", ["default", "mmap", "compress"])
+def track_time_save(graph_name, layout):
+    if graph_name == "small":
+        graphs = _small_graphs(10000)
+    else:
+        graphs = [utils.get_graph(graph_name, "csc")]
+    # dry run
+    os.remove(_save(graphs, layout))
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(3):
+            path = _save(graphs, layout)
+
+    os.remove(path)
+    return t.elapsed_secs / 3
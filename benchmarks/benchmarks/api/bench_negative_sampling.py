@@ -0,0 +1,37 @@
+import dgl
+
+import torch
+
+from .. import utils
+
+
+# The benchmark for the negative samplers, either drawing pairs uniformly over
+# the graph or corrupting the destinations of given positive edges.
+@utils.skip_if_gpu()
+@utils.benchmark("time", timeout=600)
+@utils.parametrize("graph_name", ["reddit", "ogbn-products"])
+@utils.parametrize("num_samples", [100_000, 1_000_000])
+@utils.parametrize("mode", ["global", "global_replace", "per_source"])
+def track_time(graph_name, num_samples, mode):
+    graph = utils.get_graph(graph_name, "csr")
+    src, _ = graph.find_edges(torch.randint(0, graph.num_edges(), (1024,)))
+    k = num_samples // src.shape[0]
+
+    def sample():
+        if mode == "per_source":
+            dgl.sampling.per_source_uniform_negative_sampling(graph, src, k)
+        else:
+            dgl.sampling.global_uniform_negative_sampling(
+                graph, num_samples, replace=mode == "global_replace"
+            )
+
+    # dry run
+    for i in range(3):
+        sample()
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(10):
+            sample()
+
+    return t.elapsed_secs / 10
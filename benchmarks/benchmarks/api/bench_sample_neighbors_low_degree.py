@@ -0,0 +1,41 @@
+import time
+
+import dgl
+
+import numpy as np
+import torch
+
+from .. import utils
+
+
+# Per-seed cost of neighbor sampling on graphs whose average degree is close to
+# the fanout, where the per-row overhead of the pick loop rather than the
+# random number generation dominates.
+@utils.benchmark("time")
+@utils.parametrize("num_nodes", [100000, 1000000])
+@utils.parametrize("avg_degree", [2, 5, 10])
+@utils.parametrize("fanout", [5, 10])
+@utils.parametrize("weighted", [False, True])
+def track_time(num_nodes, avg_degree, fanout, weighted):
+    device = utils.get_bench_device()
+    graph = dgl.rand_graph(num_nodes, num_nodes * avg_degree).to(device)
+    graph = graph.formats(["csc"])
+    prob = None
+    if weighted:
+        graph.edata["p"] = torch.rand(graph.num_edges(), device=device)
+        prob = "p"
+
+    seed_nodes_num = 10000
+    seed_nodes = np.random.randint(0, graph.num_nodes(), seed_nodes_num)
+    seed_nodes = torch.from_numpy(seed_nodes).to(device)
+
+    # dry run
+    for i in range(3):
+        dgl.sampling.sample_neighbors(graph, seed_nodes, fanout, prob=prob)
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(50):
+            dgl.sampling.sample_neighbors(graph, seed_nodes, fanout, prob=prob)
+
+    return t.elapsed_secs / 50 / seed_nodes_num
@@ -0,0 +1,46 @@
+import time
+
+import dgl
+
+import numpy as np
+import torch
+
+from .. import utils
+
+
+def _random_dag(num_nodes, avg_degree):
+    # Random edges oriented from the smaller to the larger node ID.
+    src = torch.randint(0, num_nodes, (num_nodes * avg_degree,))
+    dst = torch.randint(0, num_nodes, (num_nodes * avg_degree,))
+    mask = src != dst
+    src, dst = src[mask], dst[mask]
+    return dgl.graph(
+        (torch.minimum(src, dst), torch.maximum(src, dst)), num_nodes=num_nodes
+    )
+
+
+@utils.benchmark("time", timeout=600)
+@utils.parametrize("num_nodes", [100000, 1000000, 10000000])
+@utils.parametrize("avg_degree", [2, 10])
+@utils.parametrize("traversal", ["bfs_nodes", "bfs_edges", "topological_nodes"])
+def track_time(num_nodes, avg_degree, traversal):
+    graph = _random_dag(num_nodes, avg_degree)
+    source = torch.randint(0, num_nodes, (16,))
+
+    def run():
+        if traversal == "bfs_nodes":
+            return dgl.bfs_nodes_generator(graph, source)
+        elif traversal == "bfs_edges":
+            return dgl.bfs_edges_generator(graph, source)
+        else:
+            return dgl.topological_nodes_generator(graph)
+
+    # dry run
+    run()
+
+    # timing
+    with utils.Timer() as t:
+        for i in range(3):
+            run()
+
+    return t.elapsed_secs / 3
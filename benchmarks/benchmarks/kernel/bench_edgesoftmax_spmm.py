@@ -0,0 +1,47 @@
+import time
+
+import dgl
+
+import torch
+
+from .. import utils
+
+
+# The benchmarks for the attention aggregation of GAT, i.e. edge_softmax
+# followed by u_mul_e_sum, either fused or as two separate ops. The forward
+# and backward passes are both timed.
+@utils.benchmark("time", timeout=600)
+@utils.parametrize("graph", ["ogbn-arxiv", "reddit"])
+@utils.parametrize("num_heads", [1, 4, 8])
+@utils.parametrize("fused", [True, False])
+def track_time(graph, num_heads, fused):
+    device = utils.get_bench_device()
+    graph = utils.get_graph(graph).to(device)
+    feat_size = 64
+    score = torch.randn(
+        (graph.num_edges(), num_heads, 1), device=device, requires_grad=True
+    )
+    feat = torch.randn(
+        (graph.num_nodes(), num_heads, feat_size // num_heads),
+        device=device,
+        requires_grad=True,
+    )
+
+    def run():
+        if fused:
+            y = dgl.ops.edge_softmax_spmm(graph, score, feat)
+        else:
+            a = dgl.ops.edge_softmax(graph, score)
+            y = dgl.ops.u_mul_e_sum(graph, feat, a)
+        y.sum().backward()
+
+    # dry run
+    for i in range(3):
+        run()
+
+    # timing
+    with utils.Timer(device) as t:
+        for i in range(10):
+            run()
+
+    return t.elapsed_secs / 10
@@ -0,0 +1,58 @@
+import time
+
+import dgl
+
+import torch
+
+from .. import utils
+
+
+def calc_gflops(graph, feat_size, num_heads, time):
+    return round(
+        2 * graph.num_edges() * feat_size / 1000000000 / time, 2
+    )  # count both mul and comparison
+
+
+# The benchmarks include broadcasting cases as in bench_gspmm_u_mul_e_sum.py,
+# with Max/Min reducers (which also compute the arg-max/min) and both single
+# and double precision.
+@utils.benchmark("flops", timeout=600)
+@utils.parametrize("graph", ["ogbn-arxiv", "reddit"])
+@utils.parametrize("feat_size", [32, 256])
+@utils.parametrize("num_heads", [0, 4])
+@utils.parametrize("reducer", ["max", "min"])
+@utils.parametrize("dtype", ["float32", "float64"])
+def track_flops(graph, feat_size, num_heads, reducer, dtype):
+    device = utils.get_bench_device()
+    dtype = getattr(torch, dtype)
+    graph = utils.get_graph(graph, format="csc").to(device)
+    if num_heads == 0:
+        x = torch.randn(
+            graph.num_nodes(), feat_size, dtype=dtype, device=device
+        )
+        w = torch.randn(
+            graph.num_edges(), feat_size, dtype=dtype, device=device
+        )
+    else:
+        x = torch.randn(
+            graph.num_nodes(),
+            num_heads,
+            feat_size // num_heads,
+            dtype=dtype,
+            device=device,
+        )
+        w = torch.randn(
+            graph.num_edges(), num_heads, 1, dtype=dtype, device=device
+        )
+    op = getattr(dgl.ops, "u_mul_e_" + reducer)
+
+    # dry run
+    for i in range(3):
+        y = op(graph, x, w)
+
+    # timing
+    with utils.Timer(device) as t:
+        for i in range(10):
+            y = op(graph, x, w)
+
+    return calc_gflops(graph, feat_size, num_heads, t.elapsed_secs / 10)
@@ -359,16 +359,24 @@ def setup_track_flops(*args, **kwargs):
     torch.random.manual_seed(42)
 
 
+def setup_track_memory(*args, **kwargs):
+    # fix random seed
+    np.random.seed(42)
+    torch.random.manual_seed(42)
+
+
 TRACK_UNITS = {
     "time": "s",
     "acc": "%",
     "flops": "GFLOPS",
+    "memory": "bytes",
 }
 
 TRACK_SETUP = {
     "time": setup_track_time,
     "acc": setup_track_acc,
     "flops": setup_track_flops,
+    "memory": setup_track_memory,
 }
 
 
@@ -554,6 +562,7 @@ def benchmark(track_type, timeout=60):
             - 'time' : For timing. Unit: second.
             - 'acc' : For accuracy. Unit: percentage, value between 0 and 100.
             - 'flops' : Unit: GFlops, number of floating point operations per second.
+            - 'memory' : For memory footprint. Unit: byte.
     timeout : int
         Timeout threshold in second.
 
@@ -565,7 +574,7 @@ def benchmark(track_type, timeout=60):
         def foo():
             pass
     """
-    assert track_type in ["time", "acc", "flops"]
+    assert track_type in ["time", "acc", "flops", "memory"]
 
     def _wrapper(func):
         func.unit = TRACK_UNITS[track_type]
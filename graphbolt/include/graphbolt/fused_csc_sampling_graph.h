@@ -29,7 +29,13 @@ template <SamplerType S>
 struct SamplerArgs;
 
 template <>
-struct SamplerArgs<SamplerType::NEIGHBOR> {};
+struct SamplerArgs<SamplerType::NEIGHBOR> {
+  /**
+   * Optional cumulative sum of the probabilities over the edges of every
+   * node, see FusedCSCSamplingGraph::BuildProbsPrefixSum.
+   */
+  const double* probs_prefix_sum = nullptr;
+};
 
 template <>
 struct SamplerArgs<SamplerType::LABOR> {
@@ -124,13 +130,38 @@ class FusedCSCSamplingGraph : public torch::CustomClassHolder {
   int64_t NumNodes() const { return indptr_.size(0) - 1; }
 
   /** @brief Get the number of edges. */
-  int64_t NumEdges() const { return indices_.size(0); }
+  int64_t NumEdges() const {
+    return IsIndicesCompressed() ? indptr_[-1].item<int64_t>()
+                                 : indices_.size(0);
+  }
 
   /** @brief Get the csc index pointer tensor. */
   const torch::Tensor CSCIndptr() const { return indptr_; }
 
-  /** @brief Get the index tensor. */
-  const torch::Tensor Indices() const { return indices_; }
+  /**
+   * @brief Get the index tensor. If the indices are compressed, they are
+   * decompressed into a new tensor.
+   */
+  const torch::Tensor Indices() const;
+
+  /** @brief Whether the indices are compressed, see CompressIndices. */
+  inline bool IsIndicesCompressed() const {
+    return compressed_indices_.has_value();
+  }
+
+  /** @brief Get the compressed indices if the indices are compressed. */
+  inline const torch::optional<torch::Tensor> CompressedIndices() const {
+    return compressed_indices_;
+  }
+
+  /**
+   * @brief Get the byte offsets of the blocks of nodes in the compressed
+   * indices if the indices are compressed.
+   */
+  inline const torch::optional<torch::Tensor> CompressedIndicesOffsets()
+      const {
+    return compressed_indices_offsets_;
+  }
 
   /** @brief Get the node type offset tensor for a heterogeneous graph. */
   inline const torch::optional<torch::Tensor> NodeTypeOffset() const {
@@ -209,8 +240,23 @@ class FusedCSCSamplingGraph : public torch::CustomClassHolder {
   /** @brief Set the csc index pointer tensor. */
   inline void SetCSCIndptr(const torch::Tensor& indptr) { indptr_ = indptr; }
 
-  /** @brief Set the index tensor. */
-  inline void SetIndices(const torch::Tensor& indices) { indices_ = indices; }
+  /** @brief Set the index tensor, replacing the compressed indices if any. */
+  inline void SetIndices(const torch::Tensor& indices) {
+    indices_ = indices;
+    compressed_indices_ = torch::nullopt;
+    compressed_indices_offsets_ = torch::nullopt;
+  }
+
+  /**
+   * @brief Set the indices compressed by CompressIndices.
+   * @param dtype The dtype of the indices.
+   * @param compressed_indices The uint8 compressed indices.
+   * @param offsets The int64 byte offsets of the blocks of nodes in the
+   * compressed indices.
+   */
+  void SetCompressedIndices(
+      torch::ScalarType dtype, const torch::Tensor& compressed_indices,
+      const torch::Tensor& offsets);
 
   /** @brief Set the node type offset tensor for a heterogeneous graph. */
   inline void SetNodeTypeOffset(
@@ -248,11 +294,12 @@ class FusedCSCSamplingGraph : public torch::CustomClassHolder {
     node_attributes_ = node_attributes;
   }
 
-  /** @brief Set the edge attributes dictionary. */
-  inline void SetEdgeAttributes(
-      const torch::optional<EdgeAttrMap>& edge_attributes) {
-    edge_attributes_ = edge_attributes;
-  }
+  /**
+   * @brief Set the edge attributes dictionary. The prefix sum of an attribute
+   * built by BuildProbsPrefixSum is dropped if the attribute is replaced while
+   * the prefix sum is kept as it is.
+   */
+  void SetEdgeAttributes(const torch::optional<EdgeAttrMap>& edge_attributes);
 
   /** @brief Add node attribute by name. */
   inline void AddNodeAttribute(
@@ -269,9 +316,49 @@ class FusedCSCSamplingGraph : public torch::CustomClassHolder {
     if (!edge_attributes_.has_value()) {
       edge_attributes_ = EdgeAttrMap();
     }
+    // A prefix sum built from the previous value would be stale.
+    edge_attributes_.value().erase(ProbsPrefixSumName(name));
     edge_attributes_.value().insert_or_assign(name, edge_attribute);
   }
 
+  /** @brief Name of the edge attribute built by BuildProbsPrefixSum. */
+  static inline std::string ProbsPrefixSumName(const std::string& probs_name) {
+    return probs_name + ".prefix_sum";
+  }
+
+  /**
+   * @brief Precompute the exclusive cumulative sum of the probabilities in the
+   * edge attribute \p probs_name over the in-edges of every node, and store it
+   * in float64 as the edge attribute ProbsPrefixSumName(probs_name). The sum
+   * restarts at 0 at the first in-edge of every node.
+   *
+   * Since the attribute is stored with the other edge attributes, it is
+   * persisted by Save and CopyToSharedMemory. Once it exists, the CPU neighbor
+   * sampler draws the neighbors of a seed with binary searches over it when
+   * sampling with \p probs_name, instead of scanning the probabilities of all
+   * the neighbors of the seed. It has to be rebuilt if the probabilities are
+   * modified in place.
+   *
+   * @param probs_name The name of a 1D edge attribute holding non-negative
+   * (unnormalized) probabilities or a mask.
+   */
+  void BuildProbsPrefixSum(const std::string& probs_name);
+
+  /**
+   * @brief Replace the indices with a compressed copy of them.
+   *
+   * The neighbors of every node are stored in chunks of delta encoded and
+   * bit-packed node IDs, with an index over blocks of nodes for random access,
+   * which takes a fraction of the memory of the indices when the neighbors of
+   * the nodes are sorted or close to each other. The compressed indices are
+   * persisted by Save, pickling and CopyToSharedMemory.
+   *
+   * Only InSubgraph and neighbor sampling on the CPU, which decode the
+   * neighbors they pick on the fly, are supported on a compressed graph.
+   * Indices() decompresses the whole indices, and SetIndices replaces them.
+   */
+  void CompressIndices();
+
   /**
    * @brief Magic number to indicate graph version in serialize/deserialize
    * stage.
@@ -373,6 +460,40 @@ class FusedCSCSamplingGraph : public torch::CustomClassHolder {
       torch::optional<torch::Tensor> random_seed,
       double seed2_contribution) const;
 
+  /**
+   * @brief Sample the neighborhood of the given nodes over multiple hops and
+   * compact the node ids of all hops in a single call. The nodes of each hop
+   * are the seeds of the hop followed by the newly sampled nodes, and are the
+   * seeds of the next hop.
+   *
+   * @param seeds The unique nodes from which to sample neighbors.
+   * @param fanouts The number of edges to be sampled for each node at each
+   * hop, starting from the hop of `seeds`, following the same rules as in
+   * SampleNeighbors.
+   * @param replace Boolean indicating whether the sample is preformed with or
+   * without replacement.
+   * @param layer Boolean indicating whether neighbors should be sampled in a
+   * layer sampling fashion, see SampleNeighbors.
+   * @param probs_or_mask An optional edge attribute tensor for probablities
+   * or masks, following the same rules as in SampleNeighbors.
+   *
+   * @return The sampled subgraph of each hop, in the sampling order. The
+   * indices are compacted, and `original_column_node_ids` and
+   * `original_row_node_ids` hold the seeds and the nodes of the hop.
+   */
+  std::vector<c10::intrusive_ptr<FusedSampledSubgraph>>
+  SampleNeighborsMultiHop(
+      const torch::Tensor& seeds, const std::vector<int64_t>& fanouts,
+      bool replace, bool layer,
+      torch::optional<torch::Tensor> probs_or_mask) const;
+
+  c10::intrusive_ptr<
+      Future<std::vector<c10::intrusive_ptr<FusedSampledSubgraph>>>>
+  SampleNeighborsMultiHopAsync(
+      const torch::Tensor& seeds, const std::vector<int64_t>& fanouts,
+      bool replace, bool layer,
+      torch::optional<torch::Tensor> probs_or_mask) const;
+
   /**
    * @brief Sample neighboring edges of the given nodes with a temporal
    * constraint. If `node_timestamp_attr_name` or `edge_timestamp_attr_name` is
@@ -462,12 +583,30 @@ class FusedCSCSamplingGraph : public torch::CustomClassHolder {
       const std::vector<int64_t>& fanouts, NumPickFn num_pick_fn,
       PickFn pick_fn) const;
 
+  /**
+   * @brief Return the data of the prefix sum built by BuildProbsPrefixSum for
+   * the edge attribute \p probs_or_mask, or nullptr if there is none.
+   */
+  const double* ProbsPrefixSum(const torch::Tensor& probs_or_mask) const;
+
   /** @brief CSC format index pointer array. */
   torch::Tensor indptr_;
 
-  /** @brief CSC format index array. */
+  /**
+   * @brief CSC format index array. It is empty, but keeps the dtype of the
+   * indices, if the indices are compressed.
+   */
   torch::Tensor indices_;
 
+  /** @brief The indices compressed by CompressIndices, if any. */
+  torch::optional<torch::Tensor> compressed_indices_;
+
+  /**
+   * @brief The byte offsets of every block of nodes in compressed_indices_,
+   * if any.
+   */
+  torch::optional<torch::Tensor> compressed_indices_offsets_;
+
   /**
    * @brief Offset array of node type. The length of it is equal to the number
    * of node types + 1. The tensor is in ascending order as nodes of the same
@@ -19,11 +19,19 @@
  */
 #include "./cache_policy.h"
 
+#include <graphbolt/async.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 #include "./utils.h"
 
 namespace graphbolt {
 namespace storage {
 
+constexpr int64_t kKeysGrainSize = 4096;
+
 template <typename CachePolicy>
 std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
 BaseCachePolicy::QueryImpl(CachePolicy& policy, torch::Tensor keys) {
@@ -195,6 +203,18 @@ void BaseCachePolicy::WritingCompleted(torch::Tensor pointers) {
   ReadingWritingCompletedImpl<true>(pointers);
 }
 
+template <typename CachePolicy>
+void BaseCachePolicy::WritingAbortedImpl(
+    CachePolicy& policy, torch::Tensor pointers) {
+  auto pointers_ptr =
+      reinterpret_cast<CacheKey**>(pointers.data_ptr<int64_t>());
+  for (int64_t i = 0; i < pointers.size(0); i++) {
+    if (const auto pointer = pointers_ptr[i]) {
+      policy.Erase(pointer);
+    }
+  }
+}
+
 S3FifoCachePolicy::S3FifoCachePolicy(int64_t capacity)
     : BaseCachePolicy(capacity),
       ghost_queue_(capacity - capacity / 10),
@@ -220,6 +240,10 @@ std::tuple<torch::Tensor, torch::Tensor> S3FifoCachePolicy::Replace(
   return ReplaceImpl(*this, keys);
 }
 
+void S3FifoCachePolicy::WritingAborted(torch::Tensor pointers) {
+  WritingAbortedImpl(*this, pointers);
+}
+
 SieveCachePolicy::SieveCachePolicy(int64_t capacity)
     // Ensure that queue_ is constructed first before accessing its `.end()`.
     : BaseCachePolicy(capacity), queue_(), hand_(queue_.end()) {
@@ -242,6 +266,10 @@ std::tuple<torch::Tensor, torch::Tensor> SieveCachePolicy::Replace(
   return ReplaceImpl(*this, keys);
 }
 
+void SieveCachePolicy::WritingAborted(torch::Tensor pointers) {
+  WritingAbortedImpl(*this, pointers);
+}
+
 LruCachePolicy::LruCachePolicy(int64_t capacity) : BaseCachePolicy(capacity) {
   TORCH_CHECK(capacity > 0, "Capacity needs to be positive.");
   key_to_cache_key_.reserve(kCapacityFactor * (capacity + 1));
@@ -262,6 +290,10 @@ std::tuple<torch::Tensor, torch::Tensor> LruCachePolicy::Replace(
   return ReplaceImpl(*this, keys);
 }
 
+void LruCachePolicy::WritingAborted(torch::Tensor pointers) {
+  WritingAbortedImpl(*this, pointers);
+}
+
 ClockCachePolicy::ClockCachePolicy(int64_t capacity)
     : BaseCachePolicy(capacity) {
   TORCH_CHECK(capacity > 0, "Capacity needs to be positive.");
@@ -283,5 +315,263 @@ std::tuple<torch::Tensor, torch::Tensor> ClockCachePolicy::Replace(
   return ReplaceImpl(*this, keys);
 }
 
+void ClockCachePolicy::WritingAborted(torch::Tensor pointers) {
+  WritingAbortedImpl(*this, pointers);
+}
+
+ConcurrentClockCachePolicy::ConcurrentClockCachePolicy(int64_t capacity)
+    : BaseCachePolicy(capacity),
+      num_sets_((capacity + kWays - 1) / kWays),
+      states_(std::make_unique<state_t[]>(capacity)),
+      reference_bits_(std::make_unique<std::atomic<uint8_t>[]>(capacity)),
+      hands_(std::make_unique<std::atomic<uint32_t>[]>(num_sets_)) {
+  TORCH_CHECK(capacity > 0, "Capacity needs to be positive.");
+  for (int64_t i = 0; i < capacity; i++) {
+    states_[i].store(0, std::memory_order_relaxed);
+    reference_bits_[i].store(0, std::memory_order_relaxed);
+  }
+  for (int64_t i = 0; i < num_sets_; i++) {
+    hands_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+ConcurrentClockCachePolicy::state_t* ConcurrentClockCachePolicy::Read(
+    int64_t key) {
+  const auto tag = Tag(key);
+  const auto begin = SetBegin(key);
+  const auto end = begin + SetSize(begin);
+  for (auto i = begin; i < end; i++) {
+    auto& state = states_[i];
+    auto s = state.load(std::memory_order_acquire);
+    while ((s >> kKeyShift) == tag) {
+      const auto ref = s & kRefMask;
+      if (ref == kWriting) return nullptr;
+      TORCH_CHECK(
+          ref + 1 < kWriting,
+          "There are too many in-flight read requests to the same cache "
+          "entry!");
+      // On failure, s is reloaded and the key is checked again since the slot
+      // might have been evicted in the meantime.
+      if (state.compare_exchange_weak(s, s + 1, std::memory_order_acquire)) {
+        if (!reference_bits_[i].load(std::memory_order_relaxed)) {
+          reference_bits_[i].store(1, std::memory_order_relaxed);
+        }
+        return &state;
+      }
+    }
+  }
+  return nullptr;
+}
+
+bool ConcurrentClockCachePolicy::Contains(int64_t key) const {
+  const auto tag = Tag(key);
+  const auto begin = SetBegin(key);
+  const auto end = begin + SetSize(begin);
+  for (auto i = begin; i < end; i++) {
+    if ((states_[i].load() >> kKeyShift) == tag) return true;
+  }
+  return false;
+}
+
+int64_t ConcurrentClockCachePolicy::Insert(int64_t key) {
+  const auto tag = Tag(key);
+  const auto begin = SetBegin(key);
+  const auto size = SetSize(begin);
+  auto& hand = hands_[begin / kWays];
+  // The first sweep clears the reference bits so that the second one finds a
+  // victim unless the slots are in use. The third sweep tolerates the slots
+  // the concurrent inserters claim in between.
+  for (int64_t iter = 0; iter < 3 * size; iter++) {
+    const auto i = begin + hand.fetch_add(1, std::memory_order_relaxed) % size;
+    auto& state = states_[i];
+    auto s = state.load(std::memory_order_relaxed);
+    if (s & kRefMask) continue;
+    if ((s >> kKeyShift) &&
+        reference_bits_[i].load(std::memory_order_relaxed)) {
+      reference_bits_[i].store(0, std::memory_order_relaxed);
+      continue;
+    }
+    if (!state.compare_exchange_strong(s, (tag << kKeyShift) | kWriting)) {
+      continue;
+    }
+    // Another thread might be inserting the same key into another slot of the
+    // set. The claims and the loads below are sequentially consistent, so at
+    // least one of the two threads sees the other and backs off.
+    for (auto j = begin; j < begin + size; j++) {
+      if (j != i && (states_[j].load() >> kKeyShift) == tag) {
+        state.store(0, std::memory_order_release);
+        return -1;
+      }
+    }
+    return i;
+  }
+  return -1;
+}
+
+template <bool replace>
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
+ConcurrentClockCachePolicy::ParallelQuery(
+    torch::Tensor keys, int64_t& found_cnt) {
+  const auto num_keys = keys.size(0);
+  auto positions = torch::empty_like(
+      keys, keys.options()
+                .dtype(torch::kInt64)
+                .pinned_memory(utils::is_pinned(keys)));
+  auto indices = torch::empty_like(
+      keys, keys.options()
+                .dtype(torch::kInt64)
+                .pinned_memory(utils::is_pinned(keys)));
+  auto pointers = torch::empty_like(
+      keys, keys.options()
+                .dtype(torch::kInt64)
+                .pinned_memory(utils::is_pinned(keys)));
+  auto missing_keys = torch::empty_like(
+      keys, keys.options().pinned_memory(utils::is_pinned(keys)));
+  const auto num_chunks = (num_keys + kKeysGrainSize - 1) / kKeysGrainSize;
+  // The slots found or claimed by the first pass, compacted by the second.
+  std::vector<int64_t> slots(num_keys);
+  std::vector<uint8_t> found(num_keys);
+  std::vector<int64_t> found_offsets(num_chunks + 1, 0);
+  AT_DISPATCH_INDEX_TYPES(
+      keys.scalar_type(), "ConcurrentClockCachePolicy::Query", ([&] {
+        auto keys_ptr = keys.data_ptr<index_t>();
+        graphbolt::parallel_for_each(0, num_chunks, 1, [&](int64_t chunk) {
+          const auto begin = chunk * kKeysGrainSize;
+          const auto end = std::min(num_keys, begin + kKeysGrainSize);
+          int64_t cnt = 0;
+          for (auto i = begin; i < end; i++) {
+            const auto key = keys_ptr[i];
+            if (auto state = Read(key)) {
+              found[i] = 1;
+              slots[i] = state - states_.get();
+              cnt++;
+            } else {
+              found[i] = 0;
+              if constexpr (replace) {
+                // A key in the cache that can't be read is being written.
+                slots[i] = Contains(key) ? -1 : Insert(key);
+              }
+            }
+          }
+          found_offsets[chunk + 1] = cnt;
+        });
+        std::inclusive_scan(
+            found_offsets.begin(), found_offsets.end(), found_offsets.begin());
+        found_cnt = found_offsets.back();
+        auto positions_ptr = positions.data_ptr<int64_t>();
+        auto indices_ptr = indices.data_ptr<int64_t>();
+        static_assert(
+            sizeof(state_t*) == sizeof(int64_t), "You need 64 bit pointers.");
+        auto pointers_ptr =
+            reinterpret_cast<state_t**>(pointers.data_ptr<int64_t>());
+        auto missing_keys_ptr = missing_keys.data_ptr<index_t>();
+        graphbolt::parallel_for_each(0, num_chunks, 1, [&](int64_t chunk) {
+          const auto begin = chunk * kKeysGrainSize;
+          const auto end = std::min(num_keys, begin + kKeysGrainSize);
+          auto found_pos = found_offsets[chunk];
+          // The missing keys are placed at the end in reverse order, matching
+          // BaseCachePolicy::QueryImpl.
+          auto missing_pos = num_keys - (begin - found_offsets[chunk]);
+          for (auto i = begin; i < end; i++) {
+            const auto slot = slots[i];
+            if (found[i]) {
+              positions_ptr[found_pos] = slot;
+              pointers_ptr[found_pos] = &states_[slot];
+              indices_ptr[found_pos++] = i;
+            } else {
+              indices_ptr[--missing_pos] = i;
+              missing_keys_ptr[missing_pos] = keys_ptr[i];
+              if constexpr (replace) {
+                // Ensure that even if an offset is added, it stays negative.
+                positions_ptr[missing_pos] =
+                    slot >= 0 ? slot : std::numeric_limits<int64_t>::min();
+                pointers_ptr[missing_pos] =
+                    slot >= 0 ? &states_[slot] : nullptr;
+              }
+            }
+          }
+        });
+      }));
+  return {positions, indices, pointers, missing_keys.slice(0, found_cnt)};
+}
+
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
+ConcurrentClockCachePolicy::Query(torch::Tensor keys) {
+  int64_t found_cnt;
+  auto [positions, indices, pointers, missing_keys] =
+      ParallelQuery<false>(keys, found_cnt);
+  return {
+      positions.slice(0, 0, found_cnt), indices, missing_keys,
+      pointers.slice(0, 0, found_cnt)};
+}
+
+std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
+ConcurrentClockCachePolicy::QueryAndReplace(torch::Tensor keys) {
+  int64_t found_cnt;
+  return ParallelQuery<true>(keys, found_cnt);
+}
+
+std::tuple<torch::Tensor, torch::Tensor> ConcurrentClockCachePolicy::Replace(
+    torch::Tensor keys) {
+  auto positions = torch::empty_like(
+      keys, keys.options()
+                .dtype(torch::kInt64)
+                .pinned_memory(utils::is_pinned(keys)));
+  auto pointers = torch::empty_like(
+      keys, keys.options()
+                .dtype(torch::kInt64)
+                .pinned_memory(utils::is_pinned(keys)));
+  AT_DISPATCH_INDEX_TYPES(
+      keys.scalar_type(), "ConcurrentClockCachePolicy::Replace", ([&] {
+        auto keys_ptr = keys.data_ptr<index_t>();
+        auto positions_ptr = positions.data_ptr<int64_t>();
+        auto pointers_ptr =
+            reinterpret_cast<state_t**>(pointers.data_ptr<int64_t>());
+        graphbolt::parallel_for_each(
+            0, keys.size(0), kKeysGrainSize, [&](int64_t i) {
+              const auto key = keys_ptr[i];
+              const auto slot = Contains(key) ? -1 : Insert(key);
+              // Ensure that even if an offset is added, it stays negative.
+              positions_ptr[i] =
+                  slot >= 0 ? slot : std::numeric_limits<int64_t>::min();
+              pointers_ptr[i] = slot >= 0 ? &states_[slot] : nullptr;
+            });
+      }));
+  return {positions, pointers};
+}
+
+void ConcurrentClockCachePolicy::ReadingCompleted(torch::Tensor pointers) {
+  auto pointers_ptr = reinterpret_cast<state_t**>(pointers.data_ptr<int64_t>());
+  graphbolt::parallel_for_each(
+      0, pointers.size(0), kKeysGrainSize, [&](int64_t i) {
+        pointers_ptr[i]->fetch_sub(1, std::memory_order_release);
+      });
+}
+
+void ConcurrentClockCachePolicy::WritingCompleted(torch::Tensor pointers) {
+  auto pointers_ptr = reinterpret_cast<state_t**>(pointers.data_ptr<int64_t>());
+  graphbolt::parallel_for_each(
+      0, pointers.size(0), kKeysGrainSize, [&](int64_t i) {
+        if (const auto pointer = pointers_ptr[i]) {
+          // Only the writer can modify a slot that is being written.
+          pointer->fetch_and(~kRefMask, std::memory_order_release);
+        }
+      });
+}
+
+void ConcurrentClockCachePolicy::WritingAborted(torch::Tensor pointers) {
+  auto pointers_ptr = reinterpret_cast<state_t**>(pointers.data_ptr<int64_t>());
+  graphbolt::parallel_for_each(
+      0, pointers.size(0), kKeysGrainSize, [&](int64_t i) {
+        if (const auto pointer = pointers_ptr[i]) {
+          // Empty the slot and clear its reference bit so that it is the
+          // first one evicted from its set.
+          reference_bits_[pointer - states_.get()].store(
+              0, std::memory_order_relaxed);
+          pointer->store(0, std::memory_order_release);
+        }
+      });
+}
+
 }  // namespace storage
 }  // namespace graphbolt
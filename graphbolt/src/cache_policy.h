@@ -25,8 +25,10 @@
 #include <tsl/robin_map.h>
 #include <tsl/robin_set.h>
 
+#include <atomic>
 #include <cuda/std/atomic>
 #include <limits>
+#include <memory>
 
 #include "./circular_queue.h"
 
@@ -152,6 +154,12 @@ class BaseCachePolicy {
    */
   virtual ~BaseCachePolicy() = default;
 
+  /**
+   * @brief Whether the policy can be used by multiple threads concurrently
+   * without external synchronization.
+   */
+  static constexpr bool kThreadSafe = false;
+
   /**
    * @brief The policy query function.
    * @param keys The keys to query the cache.
@@ -195,13 +203,20 @@ class BaseCachePolicy {
    * @brief A reader has finished reading these keys, so they can be evicted.
    * @param pointers The CacheKey pointers in the cache to unmark.
    */
-  static void ReadingCompleted(torch::Tensor pointers);
+  virtual void ReadingCompleted(torch::Tensor pointers);
 
   /**
    * @brief A writer has finished writing these keys, so they can be evicted.
    * @param pointers The CacheKey pointers in the cache to unmark.
    */
-  static void WritingCompleted(torch::Tensor pointers);
+  virtual void WritingCompleted(torch::Tensor pointers);
+
+  /**
+   * @brief A writer has failed to write these keys, so they are removed from
+   * the cache and their slots are the first to be reused.
+   * @param pointers The CacheKey pointers in the cache to remove.
+   */
+  virtual void WritingAborted(torch::Tensor pointers) = 0;
 
  protected:
   template <typename K, typename V>
@@ -226,6 +241,22 @@ class BaseCachePolicy {
   static std::tuple<torch::Tensor, torch::Tensor> ReplaceImpl(
       CachePolicy& policy, torch::Tensor keys);
 
+  template <typename CachePolicy>
+  static void WritingAbortedImpl(CachePolicy& policy, torch::Tensor pointers);
+
+  /**
+   * @brief Erases the key of an evicted entry from the map.
+   * @return false if the writing of the entry was aborted. Its key was erased
+   * then and may have been inserted again since.
+   */
+  template <typename Map>
+  static bool EraseEvicted(Map& map, const CacheKey& cache_key) {
+    auto it = map.find(cache_key.getKey());
+    if (it == map.end() || &*it->second != &cache_key) return false;
+    map.erase(it);
+    return true;
+  }
+
   template <typename T>
   static void MoveToFront(
       std::list<T>& from, std::list<T>& to,
@@ -286,6 +317,11 @@ class S3FifoCachePolicy : public BaseCachePolicy {
    */
   std::tuple<torch::Tensor, torch::Tensor> Replace(torch::Tensor keys);
 
+  /**
+   * @brief See BaseCachePolicy::WritingAborted.
+   */
+  void WritingAborted(torch::Tensor pointers) override;
+
   CacheKey* Read(int64_t key) {
     auto it = key_to_cache_key_.find(key);
     if (it != key_to_cache_key_.end()) {
@@ -323,6 +359,13 @@ class S3FifoCachePolicy : public BaseCachePolicy {
     return &cache_key_ptr->setPos(Evict());
   }
 
+  void Erase(CacheKey* cache_key) {
+    // The entry stays in the queue until it is evicted, which happens as soon
+    // as it is reached since it is neither used nor referenced.
+    key_to_cache_key_.erase(cache_key->getKey());
+    cache_key->ResetFreq().EndUse<true>();
+  }
+
  private:
   int64_t EvictMainQueue() {
     while (true) {
@@ -333,7 +376,7 @@ class S3FifoCachePolicy : public BaseCachePolicy {
         std::advance(it, -1);
         MoveToFront(main_queue_, main_queue_, it);
       } else {
-        key_to_cache_key_.erase(evicted.getKey());
+        EraseEvicted(key_to_cache_key_, evicted);
         const auto evicted_pos = evicted.getPos();
         main_queue_.pop_back();
         return evicted_pos;
@@ -352,14 +395,17 @@ class S3FifoCachePolicy : public BaseCachePolicy {
         MoveToFront(small_queue_, main_queue_, it);
       } else {
         const auto evicted_key = evicted.getKey();
-        key_to_cache_key_.erase(evicted_key);
+        const auto erased = EraseEvicted(key_to_cache_key_, evicted);
         const auto evicted_pos = evicted.getPos();
         small_queue_.pop_back();
-        if (ghost_queue_.IsFull()) {
-          ghost_set_.erase(ghost_queue_.Pop());
+        // Keys whose writing was aborted were never in the cache.
+        if (erased) {
+          if (ghost_queue_.IsFull()) {
+            ghost_set_.erase(ghost_queue_.Pop());
+          }
+          ghost_set_.insert(evicted_key);
+          ghost_queue_.Push(evicted_key);
         }
-        ghost_set_.insert(evicted_key);
-        ghost_queue_.Push(evicted_key);
         return evicted_pos;
       }
     }
@@ -417,6 +463,11 @@ class SieveCachePolicy : public BaseCachePolicy {
    */
   std::tuple<torch::Tensor, torch::Tensor> Replace(torch::Tensor keys);
 
+  /**
+   * @brief See BaseCachePolicy::WritingAborted.
+   */
+  void WritingAborted(torch::Tensor pointers) override;
+
   CacheKey* Read(int64_t key) {
     auto it = key_to_cache_key_.find(key);
     if (it != key_to_cache_key_.end()) {
@@ -451,6 +502,13 @@ class SieveCachePolicy : public BaseCachePolicy {
     return &cache_key_ptr->setPos(Evict());
   }
 
+  void Erase(CacheKey* cache_key) {
+    // The entry stays in the queue until it is evicted, which happens as soon
+    // as it is reached since it is neither used nor referenced.
+    key_to_cache_key_.erase(cache_key->getKey());
+    cache_key->ResetFreq().EndUse<true>();
+  }
+
  private:
   int64_t Evict() {
     // If the cache has space, get an unused slot otherwise perform eviction.
@@ -461,7 +519,7 @@ class SieveCachePolicy : public BaseCachePolicy {
       if (hand_ == queue_.begin()) hand_ = queue_.end();
       --hand_;
     }
-    key_to_cache_key_.erase(hand_->getKey());
+    EraseEvicted(key_to_cache_key_, *hand_);
     const auto pos = hand_->getPos();
     const auto temp = hand_;
     if (hand_ == queue_.begin()) {
@@ -513,6 +571,11 @@ class LruCachePolicy : public BaseCachePolicy {
    */
   std::tuple<torch::Tensor, torch::Tensor> Replace(torch::Tensor keys);
 
+  /**
+   * @brief See BaseCachePolicy::WritingAborted.
+   */
+  void WritingAborted(torch::Tensor pointers) override;
+
   CacheKey* Read(int64_t key) {
     auto it = key_to_cache_key_.find(key);
     if (it != key_to_cache_key_.end()) {
@@ -549,6 +612,14 @@ class LruCachePolicy : public BaseCachePolicy {
     return &cache_key_ptr->setPos(Evict());
   }
 
+  void Erase(CacheKey* cache_key) {
+    auto it = key_to_cache_key_.find(cache_key->getKey());
+    // Move the entry to the back of the queue so that it is evicted next.
+    queue_.splice(queue_.end(), queue_, it->second);
+    key_to_cache_key_.erase(it);
+    cache_key->EndUse<true>();
+  }
+
  private:
   int64_t Evict() {
     // If the cache has space, get an unused slot otherwise perform eviction.
@@ -561,7 +632,7 @@ class LruCachePolicy : public BaseCachePolicy {
       MoveToFront(queue_, queue_, it);
     }
     const auto& cache_key = queue_.back();
-    key_to_cache_key_.erase(cache_key.getKey());
+    EraseEvicted(key_to_cache_key_, cache_key);
     const auto pos = cache_key.getPos();
     queue_.pop_back();
     return pos;
@@ -609,6 +680,11 @@ class ClockCachePolicy : public BaseCachePolicy {
    */
   std::tuple<torch::Tensor, torch::Tensor> Replace(torch::Tensor keys);
 
+  /**
+   * @brief See BaseCachePolicy::WritingAborted.
+   */
+  void WritingAborted(torch::Tensor pointers) override;
+
   CacheKey* Read(int64_t key) {
     auto it = key_to_cache_key_.find(key);
     if (it != key_to_cache_key_.end()) {
@@ -643,6 +719,13 @@ class ClockCachePolicy : public BaseCachePolicy {
     return &cache_key_ptr->setPos(Evict());
   }
 
+  void Erase(CacheKey* cache_key) {
+    // The entry stays in the queue until it is evicted, which happens as soon
+    // as it is reached since it is neither used nor referenced.
+    key_to_cache_key_.erase(cache_key->getKey());
+    cache_key->ResetFreq().EndUse<true>();
+  }
+
  private:
   int64_t Evict() {
     // If the cache has space, get an unused slot otherwise perform eviction.
@@ -655,7 +738,7 @@ class ClockCachePolicy : public BaseCachePolicy {
         std::advance(it, -1);
         MoveToFront(queue_, queue_, it);
       } else {
-        key_to_cache_key_.erase(cache_key.getKey());
+        EraseEvicted(key_to_cache_key_, cache_key);
         const auto evicted_pos = cache_key.getPos();
         queue_.pop_back();
         return evicted_pos;
@@ -667,6 +750,124 @@ class ClockCachePolicy : public BaseCachePolicy {
   map_t<int64_t, CacheKey*> key_to_cache_key_;
 };
 
+/**
+ * @brief ConcurrentClockCachePolicy is a CLOCK policy that can be used by many
+ * threads at once without any locks, so it does not need to be partitioned.
+ * The slots are grouped into sets of kWays slots and a key can only reside in
+ * the set selected by its hash, so a lookup probes kWays adjacent words. Each
+ * slot stores its key and reference count in a single atomic word so that a
+ * reader can verify the key and pin the slot with one compare-and-swap.
+ * Eviction runs CLOCK over the slots of the set using atomic reference bits.
+ * If all the slots of the set are in use, a missing key is reported without a
+ * position instead of waiting for a slot to be released.
+ **/
+class ConcurrentClockCachePolicy : public BaseCachePolicy {
+ public:
+  static constexpr bool kThreadSafe = true;
+
+  /**
+   * @brief Constructor for the ConcurrentClockCachePolicy class.
+   *
+   * @param capacity The capacity of the cache in terms of # elements.
+   */
+  ConcurrentClockCachePolicy(int64_t capacity);
+
+  ConcurrentClockCachePolicy() = default;
+
+  virtual ~ConcurrentClockCachePolicy() = default;
+
+  /**
+   * @brief See BaseCachePolicy::Query.
+   */
+  std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor> Query(
+      torch::Tensor keys);
+
+  /**
+   * @brief See BaseCachePolicy::QueryAndReplace.
+   */
+  std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
+  QueryAndReplace(torch::Tensor keys);
+
+  /**
+   * @brief See BaseCachePolicy::Replace.
+   */
+  std::tuple<torch::Tensor, torch::Tensor> Replace(torch::Tensor keys);
+
+  /**
+   * @brief See BaseCachePolicy::ReadingCompleted.
+   */
+  void ReadingCompleted(torch::Tensor pointers) override;
+
+  /**
+   * @brief See BaseCachePolicy::WritingCompleted.
+   */
+  void WritingCompleted(torch::Tensor pointers) override;
+
+  /**
+   * @brief See BaseCachePolicy::WritingAborted.
+   */
+  void WritingAborted(torch::Tensor pointers) override;
+
+ private:
+  using state_t = std::atomic<uint64_t>;
+  static constexpr int64_t kWays = 8;
+  // A slot state holds the key + 1 in its higher 48 bits, 0 for an empty slot,
+  // and the reference count in its lower 16 bits.
+  static constexpr int kKeyShift = 16;
+  static constexpr uint64_t kRefMask = (uint64_t{1} << kKeyShift) - 1;
+  // The reference count of a slot that is being written.
+  static constexpr uint64_t kWriting = kRefMask;
+
+  static uint64_t Tag(int64_t key) {
+    TORCH_CHECK(
+        0 <= key && key < (int64_t{1} << (64 - kKeyShift)) - 1,
+        "Keys are restricted to be 48-bit unsigned integers.");
+    return static_cast<uint64_t>(key) + 1;
+  }
+
+  /**
+   * @brief The first slot of the set that the key belongs to.
+   */
+  int64_t SetBegin(int64_t key) const {
+    // Mix the bits so that consecutive keys are spread over the sets.
+    auto h = static_cast<uint64_t>(key);
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return static_cast<int64_t>(h % num_sets_) * kWays;
+  }
+
+  int64_t SetSize(int64_t begin) const {
+    return std::min(kWays, capacity_ - begin);
+  }
+
+  /**
+   * @brief Pins the slot holding the key for reading.
+   * @return The slot, nullptr if the key is missing or being written.
+   */
+  state_t* Read(int64_t key);
+
+  /**
+   * @brief Whether any slot holds the key, regardless of its state.
+   */
+  bool Contains(int64_t key) const;
+
+  /**
+   * @brief Evicts a slot of the key's set and pins it for writing the key.
+   * @return The position of the slot, -1 if no slot could be evicted.
+   */
+  int64_t Insert(int64_t key);
+
+  template <bool replace>
+  std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>
+  ParallelQuery(torch::Tensor keys, int64_t& found_cnt);
+
+  int64_t num_sets_;
+  std::unique_ptr<state_t[]> states_;
+  std::unique_ptr<std::atomic<uint8_t>[]> reference_bits_;
+  std::unique_ptr<std::atomic<uint32_t>[]> hands_;
+};
+
 }  // namespace storage
 }  // namespace graphbolt
 
@@ -0,0 +1,83 @@
+/**
+ *  Copyright (c) 2024 by Contributors
+ * @file cached_ondisk_npy_array.cc
+ * @brief On disk numpy array with an in-memory cache of its hot rows.
+ */
+#include "./cached_ondisk_npy_array.h"
+
+#include <stdexcept>
+
+namespace graphbolt {
+namespace storage {
+
+CachedOnDiskNpyArray::CachedOnDiskNpyArray(
+    c10::intrusive_ptr<OnDiskNpyArray> array,
+    c10::intrusive_ptr<PartitionedCachePolicy> policy,
+    c10::intrusive_ptr<FeatureCache> cache, int64_t offset)
+    : array_(std::move(array)),
+      policy_(std::move(policy)),
+      cache_(std::move(cache)),
+      offset_(offset) {}
+
+torch::Tensor CachedOnDiskNpyArray::IndexSelect(torch::Tensor index) {
+  TORCH_CHECK(index.dim() == 1, "The index tensor needs to be 1d.");
+  const auto num_rows = array_->NumRows();
+  index = torch::where(index < 0, index + num_rows, index);
+  // Reject invalid ids before they are admitted into the cache.
+  if (index.numel() > 0 && (index.min().item<int64_t>() < 0 ||
+                            index.max().item<int64_t>() >= num_rows)) {
+    throw std::out_of_range("IndexError: Index out of range.");
+  }
+  auto [positions, indices, pointers, missing_keys, found_offsets,
+        missing_offsets] = policy_->QueryAndReplace(index, offset_);
+  const auto found_cnt = index.size(0) - missing_keys.size(0);
+  auto values =
+      cache_->Query(positions.slice(0, 0, found_cnt), indices, index.size(0));
+  policy_->ReadingCompleted(pointers.slice(0, 0, found_cnt), found_offsets);
+  // The slots of the missing keys are locked for writing until the rows are
+  // read from the disk and inserted.
+  const auto missing_pointers = pointers.slice(0, found_cnt);
+  torch::Tensor missing_values;
+  try {
+#ifdef HAVE_LIBRARY_LIBURING
+    missing_values = array_->IndexSelectIOUringImpl(missing_keys);
+#else
+    TORCH_CHECK(false, "OnDiskNpyArray is not supported on non-Linux systems.");
+#endif  // HAVE_LIBRARY_LIBURING
+    cache_->Replace(positions.slice(0, found_cnt), missing_values);
+  } catch (...) {
+    // The slots hold no valid rows, so the keys are removed from the cache
+    // instead of being marked as written.
+    policy_->WritingAborted(missing_pointers, missing_offsets);
+    throw;
+  }
+  values.index_copy_(0, indices.slice(0, found_cnt), missing_values);
+  policy_->WritingCompleted(missing_pointers, missing_offsets);
+  num_queries_.fetch_add(index.size(0), std::memory_order_relaxed);
+  num_misses_.fetch_add(missing_keys.size(0), std::memory_order_relaxed);
+  return values;
+}
+
+c10::intrusive_ptr<Future<torch::Tensor>>
+CachedOnDiskNpyArray::IndexSelectAsync(torch::Tensor index) {
+  return async([=, this] { return IndexSelect(index); });
+}
+
+torch::Dict<std::string, int64_t> CachedOnDiskNpyArray::Statistics() const {
+  auto statistics = array_->ReadStatistics();
+  statistics.insert(
+      "num_queries", num_queries_.load(std::memory_order_relaxed));
+  statistics.insert("num_misses", num_misses_.load(std::memory_order_relaxed));
+  return statistics;
+}
+
+c10::intrusive_ptr<CachedOnDiskNpyArray> CachedOnDiskNpyArray::Create(
+    c10::intrusive_ptr<OnDiskNpyArray> array,
+    c10::intrusive_ptr<PartitionedCachePolicy> policy,
+    c10::intrusive_ptr<FeatureCache> cache, int64_t offset) {
+  return c10::make_intrusive<CachedOnDiskNpyArray>(
+      std::move(array), std::move(policy), std::move(cache), offset);
+}
+
+}  // namespace storage
+}  // namespace graphbolt
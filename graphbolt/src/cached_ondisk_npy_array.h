@@ -0,0 +1,85 @@
+/**
+ *  Copyright (c) 2024 by Contributors
+ * @file cached_ondisk_npy_array.h
+ * @brief On disk numpy array with an in-memory cache of its hot rows.
+ */
+#ifndef GRAPHBOLT_CACHED_ONDISK_NPY_ARRAY_H_
+#define GRAPHBOLT_CACHED_ONDISK_NPY_ARRAY_H_
+
+#include <graphbolt/async.h>
+#include <torch/custom_class.h>
+#include <torch/torch.h>
+
+#include <atomic>
+#include <string>
+
+#include "./cnumpy.h"
+#include "./feature_cache.h"
+#include "./partitioned_cache_policy.h"
+
+namespace graphbolt {
+namespace storage {
+
+/**
+ * @brief Since OnDiskNpyArray reads with O_DIRECT, repeated reads of the same
+ * rows are not served by the page cache. This class puts a FeatureCache managed
+ * by a PartitionedCachePolicy in front of an OnDiskNpyArray and performs the
+ * cache lookup, the disk reads of the missing rows and their admission into the
+ * cache in a single asynchronous call.
+ */
+class CachedOnDiskNpyArray : public torch::CustomClassHolder {
+ public:
+  /**
+   * @brief Constructor for the CachedOnDiskNpyArray class.
+   *
+   * @param array The on disk array holding all the rows.
+   * @param policy The caching policy deciding which rows stay in the cache.
+   * @param cache The storage of the cached rows.
+   * @param offset The offset added to the row ids to form the cache keys, so
+   * that a cache can be shared by multiple arrays.
+   */
+  CachedOnDiskNpyArray(
+      c10::intrusive_ptr<OnDiskNpyArray> array,
+      c10::intrusive_ptr<PartitionedCachePolicy> policy,
+      c10::intrusive_ptr<FeatureCache> cache, int64_t offset);
+
+  /**
+   * @brief Read the rows with the given ids, from the cache when present and
+   * from the disk otherwise. The rows read from the disk are inserted into the
+   * cache.
+   *
+   * @param index A 1D tensor containing the ids of the rows to read.
+   *
+   * @return The rows, pinned if the cache storage is pinned.
+   */
+  torch::Tensor IndexSelect(torch::Tensor index);
+
+  c10::intrusive_ptr<Future<torch::Tensor>> IndexSelectAsync(
+      torch::Tensor index);
+
+  /**
+   * @brief Return the number of rows queried ("num_queries") and missing from
+   * the cache ("num_misses") since creation, along with the I/O counters of
+   * the on disk array, see OnDiskNpyArray::ReadStatistics.
+   */
+  torch::Dict<std::string, int64_t> Statistics() const;
+
+  static c10::intrusive_ptr<CachedOnDiskNpyArray> Create(
+      c10::intrusive_ptr<OnDiskNpyArray> array,
+      c10::intrusive_ptr<PartitionedCachePolicy> policy,
+      c10::intrusive_ptr<FeatureCache> cache, int64_t offset);
+
+ private:
+  c10::intrusive_ptr<OnDiskNpyArray> array_;
+  c10::intrusive_ptr<PartitionedCachePolicy> policy_;
+  c10::intrusive_ptr<FeatureCache> cache_;
+  const int64_t offset_;
+
+  std::atomic<int64_t> num_queries_{0};
+  std::atomic<int64_t> num_misses_{0};
+};
+
+}  // namespace storage
+}  // namespace graphbolt
+
+#endif  // GRAPHBOLT_CACHED_ONDISK_NPY_ARRAY_H_
@@ -10,6 +10,7 @@
 #include "./io_uring.h"
 
 #ifdef HAVE_LIBRARY_LIBURING
+#include <errno.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -131,30 +132,44 @@ c10::intrusive_ptr<Future<torch::Tensor>> OnDiskNpyArray::IndexSelect(
 #endif  // HAVE_LIBRARY_LIBURING
 }
 
+/**
+ * @brief A read of the file range [offset_, offset_ + read_len_) containing the
+ * rows at positions [begin_, end_) of the sorted index.
+ */
 class ReadRequest {
  public:
-  char *destination_;
-  int64_t read_len_;
+  int64_t begin_;
+  int64_t end_;
   int64_t offset_;
-  int64_t block_size_;
+  int64_t read_len_;
+  // Number of bytes already read, which is a multiple of the block size.
+  int64_t num_read_;
   char *aligned_read_buffer_;
 
-  auto AlignedOffset() const { return offset_ & ~(block_size_ - 1); }
-
-  auto ReadBuffer() const {
-    return aligned_read_buffer_ + offset_ - AlignedOffset();
-  }
+  auto ReadOffset() const { return offset_ + num_read_; }
 
-  auto AlignedReadSize() const {
-    const int64_t end_offset = offset_ + read_len_;
-    const int64_t aligned_end_offset =
-        (end_offset + block_size_ - 1) & ~(block_size_ - 1);
-    return aligned_end_offset - AlignedOffset();
-  }
+  auto ReadBuffer() const { return aligned_read_buffer_ + num_read_; }
 
-  auto MinimumReadSize() const { return offset_ + read_len_ - AlignedOffset(); }
+  auto ReadSize() const { return read_len_ - num_read_; }
 };
 
+torch::Dict<std::string, int64_t> OnDiskNpyArray::ReadStatistics() const {
+  torch::Dict<std::string, int64_t> statistics;
+  statistics.insert("num_reads", num_reads_.load(std::memory_order_relaxed));
+  statistics.insert(
+      "num_bytes_read", num_bytes_read_.load(std::memory_order_relaxed));
+  statistics.insert(
+      "num_bytes_requested",
+      num_bytes_requested_.load(std::memory_order_relaxed));
+  return statistics;
+}
+
+void OnDiskNpyArray::ResetReadStatistics() {
+  num_reads_.store(0, std::memory_order_relaxed);
+  num_bytes_read_.store(0, std::memory_order_relaxed);
+  num_bytes_requested_.store(0, std::memory_order_relaxed);
+}
+
 #ifdef HAVE_LIBRARY_LIBURING
 torch::Tensor OnDiskNpyArray::IndexSelectIOUringImpl(torch::Tensor index) {
   std::vector<int64_t> shape(index.sizes().begin(), index.sizes().end());
@@ -167,7 +182,44 @@ torch::Tensor OnDiskNpyArray::IndexSelectIOUringImpl(torch::Tensor index) {
                  .requires_grad(false));
   auto result_buffer = reinterpret_cast<char *>(result.data_ptr());
 
-  // Indicator for index error.
+  auto ids = index.reshape(-1).to(torch::kInt64);
+  ids = torch::where(ids < 0, ids + feature_dim_[0], ids);
+  if (ids.numel() > 0 && (ids.min().item<int64_t>() < 0 ||
+                          ids.max().item<int64_t>() >= feature_dim_[0])) {
+    throw std::out_of_range("IndexError: Index out of range.");
+  }
+  // Sort the rows so that the rows in the same or adjacent blocks of the file
+  // are next to each other, then coalesce them into runs that are fetched by a
+  // single read each, as long as the read fits in a slot of the read buffer.
+  auto [sorted_ids_tensor, permutation_tensor] = ids.sort();
+  const int64_t *sorted_ids = sorted_ids_tensor.data_ptr<int64_t>();
+  const int64_t *permutation = permutation_tensor.data_ptr<int64_t>();
+  const int64_t num_ids = ids.numel();
+  auto align_down = [&](int64_t x) { return x & ~(block_size_ - 1); };
+  auto align_up = [&](int64_t x) {
+    return (x + block_size_ - 1) & ~(block_size_ - 1);
+  };
+  auto row_offset = [&](int64_t k) {
+    return sorted_ids[k] * feature_size_ + prefix_len_;
+  };
+  const int64_t max_read_size = aligned_length_ + block_size_;
+  // Run r consists of the sorted positions [run_offsets[r], run_offsets[r+1]).
+  std::vector<int64_t> run_offsets;
+  for (int64_t k = 0, run_begin = 0, run_end = 0; k < num_ids; ++k) {
+    const int64_t begin = align_down(row_offset(k));
+    const int64_t end = align_up(row_offset(k) + feature_size_);
+    if (k == 0 || begin > run_end || end - run_begin > max_read_size) {
+      run_offsets.push_back(k);
+      run_begin = begin;
+    }
+    run_end = end;
+  }
+  const int64_t num_runs = run_offsets.size();
+  run_offsets.push_back(num_ids);
+  num_bytes_requested_.fetch_add(
+      num_ids * feature_size_, std::memory_order_relaxed);
+
+  // Indicator for io_uring errors.
   std::atomic<int> error_flag{};
   std::atomic<int64_t> work_queue{};
   // Construct a QueueAndBufferAcquirer object so that the worker threads can
@@ -179,6 +231,7 @@ torch::Tensor OnDiskNpyArray::IndexSelectIOUringImpl(torch::Tensor index) {
     CircularQueue<ReadRequest> read_queue(8 * kGroupSize);
     int64_t num_submitted = 0;
     int64_t num_completed = 0;
+    int64_t num_bytes_read = 0;
     auto [acquired_queue_handle, read_buffer_source2] = queue_source.get();
     auto &io_uring_queue = acquired_queue_handle.get();
     // Capturing structured binding is available only in C++20, so we rename.
@@ -200,10 +253,20 @@ torch::Tensor OnDiskNpyArray::IndexSelectIOUringImpl(torch::Tensor index) {
     };
     for (int64_t read_buffer_slot = 0; true;) {
       auto request_read_buffer = [&]() {
-        return read_buffer_source + (aligned_length_ + block_size_) *
+        return read_buffer_source + max_read_size *
                                         (read_buffer_slot++ % (8 * kGroupSize));
       };
-      const auto num_requested_items = std::max(
+      auto push_fn = [&](const ReadRequest &req) {
+        // Put requests into io_uring queue.
+        struct io_uring_sqe *sqe = io_uring_get_sqe(&io_uring_queue);
+        TORCH_CHECK(sqe);
+        io_uring_sqe_set_data(sqe, read_queue.Push(req));
+        io_uring_prep_read(
+            sqe, file_description_, req.ReadBuffer(), req.ReadSize(),
+            req.ReadOffset());
+        submit_fn(kGroupSize);
+      };
+      const auto num_requested_runs = std::max(
           std::min(
               // The condition not to overflow the completion queue.
               2 * kGroupSize -
@@ -212,43 +275,23 @@ torch::Tensor OnDiskNpyArray::IndexSelectIOUringImpl(torch::Tensor index) {
               kGroupSize - read_queue.Size()),
           int64_t{});
       const auto begin =
-          work_queue.fetch_add(num_requested_items, std::memory_order_relaxed);
-      if ((begin >= index.numel() && read_queue.IsEmpty() &&
-           num_completed >= num_submitted) ||
-          // Even when we encounter out of bounds index (error_flag == 1), we
-          // continue. We want to ensure the reads in flight successfully
-          // complete to avoid the instability due to incompleted reads.
-          error_flag.load(std::memory_order_relaxed) > 1)
+          work_queue.fetch_add(num_requested_runs, std::memory_order_relaxed);
+      // Even when a read fails, we continue. We want to ensure the reads in
+      // flight successfully complete to avoid the instability due to
+      // incompleted reads.
+      if (begin >= num_runs && read_queue.IsEmpty() &&
+          num_completed >= num_submitted)
         break;
-      const auto end = std::min(begin + num_requested_items, index.numel());
-      AT_DISPATCH_INDEX_TYPES(
-          index.scalar_type(), "IndexSelectIOUring", ([&] {
-            auto index_data = index.data_ptr<index_t>();
-            for (int64_t i = begin; i < end; ++i) {
-              int64_t feature_id = index_data[i];
-              if (feature_id < 0) feature_id += feature_dim_[0];
-              if (feature_id < 0 || feature_id >= feature_dim_[0]) {
-                error_flag.store(1, std::memory_order_relaxed);
-                // Simply skip the out of bounds index.
-                continue;
-              }
-              // calculate offset of the feature.
-              const int64_t offset = feature_id * feature_size_ + prefix_len_;
-
-              ReadRequest req{
-                  result_buffer + feature_size_ * i, feature_size_, offset,
-                  block_size_, request_read_buffer()};
-
-              // Put requests into io_uring queue.
-              struct io_uring_sqe *sqe = io_uring_get_sqe(&io_uring_queue);
-              TORCH_CHECK(sqe);
-              io_uring_sqe_set_data(sqe, read_queue.Push(req));
-              io_uring_prep_read(
-                  sqe, file_description_, req.aligned_read_buffer_,
-                  req.AlignedReadSize(), req.AlignedOffset());
-              submit_fn(kGroupSize);
-            }
-          }));
+      const auto end = std::min(begin + num_requested_runs, num_runs);
+      for (int64_t r = begin; r < end; ++r) {
+        const int64_t offset = align_down(row_offset(run_offsets[r]));
+        const int64_t read_len =
+            align_up(row_offset(run_offsets[r + 1] - 1) + feature_size_) -
+            offset;
+        push_fn(ReadRequest{
+            run_offsets[r], run_offsets[r + 1], offset, read_len, 0,
+            request_read_buffer()});
+      }
 
       submit_fn(1);  // Submit all sqes.
       // Wait for the reads; completion queue entries.
@@ -257,57 +300,61 @@ torch::Tensor OnDiskNpyArray::IndexSelectIOUringImpl(torch::Tensor index) {
       TORCH_CHECK(
           ::io_uring_wait_cqe_nr(
               &io_uring_queue, &cqe, num_submitted - num_completed) == 0);
-      // Check the reads and abort on failure.
+      // Check the reads and scatter the rows of the completed runs.
       int num_cqes_seen = 0;
       unsigned head;
       io_uring_for_each_cqe(&io_uring_queue, head, cqe) {
-        const auto &req =
+        const auto req =
             *reinterpret_cast<ReadRequest *>(io_uring_cqe_get_data(cqe));
-        auto actual_read_len = cqe->res;
+        num_cqes_seen++;
+        const int64_t actual_read_len = cqe->res;
         if (actual_read_len < 0) {
           error_flag.store(actual_read_len, std::memory_order_relaxed);
-          break;
+          continue;
         }
-        const auto remaining_read_len =
-            std::max(req.MinimumReadSize() - actual_read_len, int64_t{});
-        const auto remaining_useful_read_len =
-            std::min(remaining_read_len, req.read_len_);
-        const auto useful_read_len = req.read_len_ - remaining_useful_read_len;
-        if (remaining_read_len) {
-          // Remaining portion will be read as part of the next batch.
-          ReadRequest rest{
-              req.destination_ + useful_read_len, remaining_useful_read_len,
-              req.offset_ + useful_read_len, block_size_,
-              request_read_buffer()};
-          // Put requests into io_uring queue.
-          struct io_uring_sqe *sqe = io_uring_get_sqe(&io_uring_queue);
-          TORCH_CHECK(sqe);
-          io_uring_sqe_set_data(sqe, read_queue.Push(rest));
-          io_uring_prep_read(
-              sqe, file_description_, rest.aligned_read_buffer_,
-              rest.AlignedReadSize(), rest.AlignedOffset());
-          submit_fn(kGroupSize);
+        num_bytes_read += actual_read_len;
+        // The run is complete once its last row has been read, even if the
+        // read stopped short of the aligned end at the end of the file.
+        const int64_t minimum_read_len =
+            row_offset(req.end_ - 1) + feature_size_ - req.ReadOffset();
+        if (actual_read_len < minimum_read_len) {
+          const int64_t useful_read_len = align_down(actual_read_len);
+          if (useful_read_len == 0) {
+            error_flag.store(-EIO, std::memory_order_relaxed);
+            continue;
+          }
+          // The rest of the run is read as part of the next batch, into a
+          // fresh slot so that slots are never held for more than a batch.
+          ReadRequest rest = req;
+          rest.num_read_ += useful_read_len;
+          rest.aligned_read_buffer_ = request_read_buffer();
+          std::memcpy(
+              rest.aligned_read_buffer_, req.aligned_read_buffer_,
+              rest.num_read_);
+          push_fn(rest);
+          continue;
+        }
+        for (int64_t k = req.begin_; k < req.end_; ++k) {
+          std::memcpy(
+              result_buffer + feature_size_ * permutation[k],
+              req.aligned_read_buffer_ + row_offset(k) - req.offset_,
+              feature_size_);
         }
-        // Copy results into result_buffer.
-        std::memcpy(req.destination_, req.ReadBuffer(), useful_read_len);
-        num_cqes_seen++;
       }
 
       // Move the head pointer of completion queue.
       io_uring_cq_advance(&io_uring_queue, num_cqes_seen);
       num_completed += num_cqes_seen;
     }
+    num_reads_.fetch_add(num_submitted, std::memory_order_relaxed);
+    num_bytes_read_.fetch_add(num_bytes_read, std::memory_order_relaxed);
   });
   const auto ret_val = error_flag.load(std::memory_order_relaxed);
-  switch (ret_val) {
-    case 0:  // Successful.
-      return result;
-    case 1:
-      throw std::out_of_range("IndexError: Index out of range.");
-    default:
-      throw std::runtime_error(
-          "io_uring error with errno: " + std::to_string(-ret_val));
+  if (ret_val != 0) {
+    throw std::runtime_error(
+        "io_uring error with errno: " + std::to_string(-ret_val));
   }
+  return result;
 }
 
 c10::intrusive_ptr<Future<torch::Tensor>> OnDiskNpyArray::IndexSelectIOUring(
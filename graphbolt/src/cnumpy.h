@@ -4,6 +4,8 @@
  * @file cnumpy.h
  * @brief Numpy File Fetecher class.
  */
+#ifndef GRAPHBOLT_CNUMPY_H_
+#define GRAPHBOLT_CNUMPY_H_
 
 #ifdef HAVE_LIBRARY_LIBURING
 #include <liburing.h>
@@ -12,6 +14,7 @@
 #include <graphbolt/async.h>
 #include <torch/script.h>
 
+#include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
@@ -75,6 +78,9 @@ class OnDiskNpyArray : public torch::CustomClassHolder {
   /** @brief Deconstructor. */
   ~OnDiskNpyArray();
 
+  /** @brief Number of rows of the array. */
+  int64_t NumRows() const { return feature_dim_[0]; }
+
   /**
    * @brief Parses the header of a numpy file to extract feature information.
    **/
@@ -86,6 +92,17 @@ class OnDiskNpyArray : public torch::CustomClassHolder {
    */
   c10::intrusive_ptr<Future<torch::Tensor>> IndexSelect(torch::Tensor index);
 
+  /**
+   * @brief Return the I/O counters accumulated since the creation of the array
+   * or the last ResetReadStatistics call: the number of read requests issued
+   * ("num_reads"), the number of bytes read from the file ("num_bytes_read")
+   * and the number of bytes of the selected rows ("num_bytes_requested").
+   */
+  torch::Dict<std::string, int64_t> ReadStatistics() const;
+
+  /** @brief Reset the counters returned by ReadStatistics. */
+  void ResetReadStatistics();
+
 #ifdef HAVE_LIBRARY_LIBURING
   /**
    * @brief Index-select operation on an on-disk numpy array using IO Uring for
@@ -95,7 +112,9 @@ class OnDiskNpyArray : public torch::CustomClassHolder {
    * uses IO Uring for asynchronous I/O to efficiently read data from disk. The
    * input tensor 'index' specifies the indices of features to select. The
    * function reads features corresponding to the indices from the disk and
-   * returns a new tensor containing the selected features.
+   * returns a new tensor containing the selected features. The requested rows
+   * are sorted and the rows in the same or adjacent file blocks are fetched by
+   * a single read, then scattered to their positions in the result.
    *
    * @param index A 1D tensor containing the indices of features to select.
    * @return A tensor containing the selected features.
@@ -134,6 +153,10 @@ class OnDiskNpyArray : public torch::CustomClassHolder {
   int num_thread_;                 // Default thread number.
   torch::Tensor read_tensor_;      // Provides temporary read buffer.
 
+  std::atomic<int64_t> num_reads_{0};            // Read requests issued.
+  std::atomic<int64_t> num_bytes_read_{0};       // Bytes read from the file.
+  std::atomic<int64_t> num_bytes_requested_{0};  // Bytes of selected rows.
+
 #ifdef HAVE_LIBRARY_LIBURING
 
   static inline std::once_flag
@@ -226,3 +249,5 @@ class OnDiskNpyArray : public torch::CustomClassHolder {
 
 }  // namespace storage
 }  // namespace graphbolt
+
+#endif  // GRAPHBOLT_CNUMPY_H_
@@ -0,0 +1,231 @@
+/**
+ *  Copyright (c) 2024 by Contributors
+ * @file compressed_indices.cc
+ * @brief Compressed storage of the indices of a CSC graph.
+ */
+#include "./compressed_indices.h"
+
+#include <torch/torch.h>
+
+#include <numeric>
+
+#include "./utils.h"
+
+namespace graphbolt {
+namespace ops {
+
+namespace {
+
+constexpr int64_t kMaxPackedWidth = 56;
+
+inline uint64_t ToZigzag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t VarintSize(uint64_t value) {
+  int64_t size = 1;
+  for (; value >= 0x80; value >>= 7) ++size;
+  return size;
+}
+
+/**
+ * @brief Encode a chunk of \p num_edges edges into \p out, or only compute its
+ * size if \p out is nullptr.
+ *
+ * @return The size of the encoded chunk.
+ */
+template <typename index_t>
+int64_t EncodeChunk(const index_t* values, int64_t num_edges, uint8_t* out) {
+  const int64_t num_deltas = num_edges - 1;
+  uint64_t deltas[kCompressedIndicesChunkSize];
+  uint64_t max_delta = 0;
+  for (int64_t i = 0; i < num_deltas; ++i) {
+    // Wrap around instead of overflowing for the extreme int64 values.
+    deltas[i] = ToZigzag(static_cast<int64_t>(
+        static_cast<uint64_t>(values[i + 1]) -
+        static_cast<uint64_t>(values[i])));
+    max_delta |= deltas[i];
+  }
+  int width = 0;
+  while (width < 64 && (max_delta >> width)) ++width;
+  if (width > kMaxPackedWidth) width = 64;
+  const uint64_t first = ToZigzag(values[0]);
+  const int64_t size = VarintSize(first) + 1 + ((num_deltas * width + 7) >> 3);
+  if (out == nullptr) return size;
+
+  uint64_t value = first;
+  for (; value >= 0x80; value >>= 7) *out++ = (value & 0x7f) | 0x80;
+  *out++ = value;
+  *out++ = width;
+  if (width == 64) {
+    std::memcpy(out, deltas, num_deltas * sizeof(uint64_t));
+    return size;
+  }
+  uint64_t pending = 0;
+  int num_pending_bits = 0;
+  for (int64_t i = 0; i < num_deltas; ++i) {
+    pending |= deltas[i] << num_pending_bits;
+    num_pending_bits += width;
+    for (; num_pending_bits >= 8; num_pending_bits -= 8) {
+      *out++ = pending;
+      pending >>= 8;
+    }
+  }
+  if (num_pending_bits > 0) *out = pending;
+  return size;
+}
+
+/**
+ * @brief Apply \p fn to the edge offset and the size of every chunk of the
+ * nodes of \p block.
+ */
+template <typename indptr_t, typename Fn>
+void ForEachChunk(
+    const indptr_t* indptr, int64_t num_nodes, int64_t block, Fn fn) {
+  const int64_t begin = block * kCompressedIndicesRowsPerBlock;
+  const int64_t end =
+      std::min(begin + kCompressedIndicesRowsPerBlock, num_nodes);
+  for (int64_t row = begin; row < end; ++row) {
+    for (int64_t offset = indptr[row]; offset < indptr[row + 1];
+         offset += kCompressedIndicesChunkSize) {
+      fn(offset, std::min<int64_t>(
+                     kCompressedIndicesChunkSize, indptr[row + 1] - offset));
+    }
+  }
+}
+
+}  // namespace
+
+std::tuple<torch::Tensor, torch::Tensor> CompressIndices(
+    torch::Tensor indptr, torch::Tensor indices) {
+  TORCH_CHECK(
+      !utils::is_on_gpu(indptr) && !utils::is_on_gpu(indices),
+      "Indices can only be compressed on the CPU.");
+  indptr = indptr.contiguous();
+  indices = indices.contiguous();
+  const int64_t num_nodes = indptr.size(0) - 1;
+  const int64_t num_blocks =
+      (num_nodes + kCompressedIndicesRowsPerBlock - 1) /
+      kCompressedIndicesRowsPerBlock;
+  auto offsets = torch::empty({num_blocks + 1}, torch::kInt64);
+  auto offsets_data = offsets.data_ptr<int64_t>();
+  torch::Tensor compressed_indices;
+  AT_DISPATCH_INDEX_TYPES(
+      indptr.scalar_type(), "CompressIndices::indptr", ([&] {
+        using indptr_t = index_t;
+        const auto indptr_data = indptr.data_ptr<indptr_t>();
+        AT_DISPATCH_INDEX_TYPES(
+            indices.scalar_type(), "CompressIndices::indices", ([&] {
+              const auto indices_data = indices.data_ptr<index_t>();
+              // Compute the size of every block, then encode the blocks at
+              // their offsets.
+              offsets_data[0] = 0;
+              torch::parallel_for(
+                  0, num_blocks, 64, [&](int64_t begin, int64_t end) {
+                    for (int64_t block = begin; block < end; ++block) {
+                      int64_t size = 0;
+                      ForEachChunk(
+                          indptr_data, num_nodes, block,
+                          [&](int64_t offset, int64_t num_edges) {
+                            size += EncodeChunk(
+                                indices_data + offset, num_edges, nullptr);
+                          });
+                      offsets_data[block + 1] = size;
+                    }
+                  });
+              std::partial_sum(
+                  offsets_data, offsets_data + num_blocks + 1, offsets_data);
+              compressed_indices = torch::zeros(
+                  {offsets_data[num_blocks] + kCompressedIndicesPadding},
+                  torch::kUInt8);
+              auto compressed_data = compressed_indices.data_ptr<uint8_t>();
+              torch::parallel_for(
+                  0, num_blocks, 64, [&](int64_t begin, int64_t end) {
+                    for (int64_t block = begin; block < end; ++block) {
+                      auto out = compressed_data + offsets_data[block];
+                      ForEachChunk(
+                          indptr_data, num_nodes, block,
+                          [&](int64_t offset, int64_t num_edges) {
+                            out += EncodeChunk(
+                                indices_data + offset, num_edges, out);
+                          });
+                    }
+                  });
+            }));
+      }));
+  return std::make_tuple(compressed_indices, offsets);
+}
+
+torch::Tensor DecompressIndices(
+    torch::Tensor indptr, torch::Tensor compressed_indices,
+    torch::Tensor offsets, torch::ScalarType dtype,
+    torch::optional<torch::Tensor> nodes,
+    torch::optional<torch::Tensor> output_indptr) {
+  TORCH_CHECK(
+      !nodes.has_value() || output_indptr.has_value(),
+      "The output indptr is required to decompress the neighbors of nodes.");
+  const int64_t num_nodes = indptr.size(0) - 1;
+  const auto compressed_data = compressed_indices.data_ptr<uint8_t>();
+  const auto offsets_data = offsets.data_ptr<int64_t>();
+  torch::Tensor indices;
+  AT_DISPATCH_INDEX_TYPES(
+      indptr.scalar_type(), "DecompressIndices::indptr", ([&] {
+        using indptr_t = index_t;
+        const auto indptr_data = indptr.data_ptr<indptr_t>();
+        AT_DISPATCH_INDEX_TYPES(dtype, "DecompressIndices::indices", ([&] {
+          using indices_t = index_t;
+          if (!nodes.has_value()) {
+            indices = torch::empty(
+                {static_cast<int64_t>(indptr_data[num_nodes])}, dtype);
+            auto indices_data = indices.data_ptr<indices_t>();
+            const int64_t num_blocks = offsets.size(0) - 1;
+            torch::parallel_for(
+                0, num_blocks, 64, [&](int64_t begin, int64_t end) {
+                  for (int64_t block = begin; block < end; ++block) {
+                    const uint8_t* data = compressed_data + offsets_data[block];
+                    ForEachChunk(
+                        indptr_data, num_nodes, block,
+                        [&](int64_t offset, int64_t num_edges) {
+                          data = compressed_indices::DecodeChunk(
+                              data, num_edges, indices_data + offset);
+                        });
+                  }
+                });
+            return;
+          }
+          const auto out_indptr_data =
+              output_indptr->data_ptr<indptr_t>();
+          const int64_t num_selected = nodes->size(0);
+          indices = torch::empty(
+              {static_cast<int64_t>(out_indptr_data[num_selected])}, dtype);
+          auto indices_data = indices.data_ptr<indices_t>();
+          AT_DISPATCH_INDEX_TYPES(
+              nodes->scalar_type(), "DecompressIndices::nodes", ([&] {
+                const auto nodes_data = nodes->data_ptr<index_t>();
+                torch::parallel_for(
+                    0, num_selected, 128, [&](int64_t begin, int64_t end) {
+                      for (int64_t i = begin; i < end; ++i) {
+                        const int64_t row = nodes_data[i];
+                        const uint8_t* data = compressed_indices::FindRow(
+                            indptr_data, compressed_data, offsets_data, row);
+                        auto out = indices_data + out_indptr_data[i];
+                        const int64_t degree =
+                            indptr_data[row + 1] - indptr_data[row];
+                        for (int64_t j = 0; j < degree;
+                             j += kCompressedIndicesChunkSize) {
+                          data = compressed_indices::DecodeChunk(
+                              data,
+                              std::min(kCompressedIndicesChunkSize, degree - j),
+                              out + j);
+                        }
+                      }
+                    });
+              }));
+        }));
+      }));
+  return indices;
+}
+
+}  // namespace ops
+}  // namespace graphbolt
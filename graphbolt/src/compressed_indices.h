@@ -0,0 +1,208 @@
+/**
+ *  Copyright (c) 2024 by Contributors
+ * @file compressed_indices.h
+ * @brief Compressed storage of the indices of a CSC graph.
+ *
+ * The neighbors of every node are split into chunks of
+ * kCompressedIndicesChunkSize consecutive edges, stored one after the other in
+ * the order of the edges. A chunk of n edges is stored as
+ * {
+ *   varint first (the zigzag encoded first neighbor)
+ *   uint8_t width
+ *   bits deltas[n - 1] (the zigzag encoded differences between consecutive
+ *                       neighbors, packed in width bits each, little-endian)
+ * }
+ * The width is at most 56 so that any packed value can be read with a single
+ * unaligned 8 byte load, or 64 for chunks of very distant neighbors. The
+ * stream is followed by kCompressedIndicesPadding bytes so that these loads
+ * never read past its end.
+ *
+ * The byte offset of the first chunk of every block of
+ * kCompressedIndicesRowsPerBlock nodes is stored aside, so that the neighbors
+ * of a node are found by skipping the chunks of at most
+ * kCompressedIndicesRowsPerBlock - 1 nodes, which only reads their headers.
+ */
+#ifndef GRAPHBOLT_COMPRESSED_INDICES_H_
+#define GRAPHBOLT_COMPRESSED_INDICES_H_
+
+#include <torch/script.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+namespace graphbolt {
+namespace ops {
+
+/** @brief The number of edges of a chunk of compressed indices. */
+constexpr int64_t kCompressedIndicesChunkSize = 128;
+
+/** @brief The number of nodes of a block of compressed indices. */
+constexpr int64_t kCompressedIndicesRowsPerBlock = 16;
+
+/** @brief The number of bytes following the compressed indices. */
+constexpr int64_t kCompressedIndicesPadding = 8;
+
+/**
+ * @brief Compress the indices of a CSC graph.
+ *
+ * @param indptr The indptr tensor of the graph on the CPU.
+ * @param indices The indices tensor of the graph on the CPU.
+ *
+ * @return (torch::Tensor, torch::Tensor) The uint8 compressed indices and the
+ * int64 byte offsets of its blocks of nodes, of shape
+ * (ceil(N / kCompressedIndicesRowsPerBlock) + 1,) for N nodes.
+ */
+std::tuple<torch::Tensor, torch::Tensor> CompressIndices(
+    torch::Tensor indptr, torch::Tensor indices);
+
+/**
+ * @brief Decompress the neighbors of the given nodes, or of all the nodes if
+ * \p nodes is not given.
+ *
+ * @param indptr The indptr tensor of the graph on the CPU.
+ * @param compressed_indices The compressed indices returned by
+ * CompressIndices.
+ * @param offsets The offsets returned by CompressIndices.
+ * @param dtype The dtype of the indices.
+ * @param nodes Nodes tensor with shape (M,).
+ * @param output_indptr The indptr of the output, as returned by
+ * IndexSelectCSC for \p nodes. Required if \p nodes is given.
+ *
+ * @return The indices of the neighbors.
+ */
+torch::Tensor DecompressIndices(
+    torch::Tensor indptr, torch::Tensor compressed_indices,
+    torch::Tensor offsets, torch::ScalarType dtype,
+    torch::optional<torch::Tensor> nodes = torch::nullopt,
+    torch::optional<torch::Tensor> output_indptr = torch::nullopt);
+
+namespace compressed_indices {
+
+inline uint64_t ReadVarint(const uint8_t*& data) {
+  uint64_t value = 0;
+  for (int shift = 0;; shift += 7) {
+    const uint8_t byte = *data++;
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return value;
+  }
+}
+
+inline uint64_t FromZigzag(uint64_t value) {
+  return (value >> 1) ^ (~(value & 1) + 1);
+}
+
+/** @brief Return the end of a chunk of \p num_edges edges. */
+inline const uint8_t* SkipChunk(const uint8_t* data, int64_t num_edges) {
+  while (*data & 0x80) ++data;
+  const int64_t width = data[1];
+  return data + 2 + (((num_edges - 1) * width + 7) >> 3);
+}
+
+/**
+ * @brief Decode a chunk of \p num_edges edges into \p out and return its end.
+ */
+template <typename index_t>
+const uint8_t* DecodeChunk(
+    const uint8_t* data, int64_t num_edges, index_t* out) {
+  uint64_t value = FromZigzag(ReadVarint(data));
+  const int width = *data++;
+  out[0] = static_cast<index_t>(value);
+  const int64_t num_deltas = num_edges - 1;
+  uint64_t deltas[kCompressedIndicesChunkSize];
+  if (width == 64) {
+    std::memcpy(deltas, data, num_deltas * sizeof(uint64_t));
+  } else {
+    // The iterations are independent so that the compiler vectorizes them.
+    const uint64_t mask = (uint64_t{1} << width) - 1;
+    for (int64_t i = 0; i < num_deltas; ++i) {
+      const int64_t bit = i * width;
+      uint64_t word;
+      std::memcpy(&word, data + (bit >> 3), sizeof(word));
+      deltas[i] = (word >> (bit & 7)) & mask;
+    }
+  }
+  for (int64_t i = 0; i < num_deltas; ++i) {
+    value += FromZigzag(deltas[i]);
+    out[i + 1] = static_cast<index_t>(value);
+  }
+  return data + ((num_deltas * width + 7) >> 3);
+}
+
+/** @brief Return the beginning of the first chunk of the node \p row. */
+template <typename indptr_t>
+const uint8_t* FindRow(
+    const indptr_t* indptr, const uint8_t* compressed_indices,
+    const int64_t* offsets, int64_t row) {
+  const int64_t block = row / kCompressedIndicesRowsPerBlock;
+  const uint8_t* data = compressed_indices + offsets[block];
+  for (int64_t r = block * kCompressedIndicesRowsPerBlock; r < row; ++r) {
+    for (int64_t begin = indptr[r]; begin < indptr[r + 1];
+         begin += kCompressedIndicesChunkSize) {
+      data = SkipChunk(
+          data, std::min<int64_t>(
+                    kCompressedIndicesChunkSize, indptr[r + 1] - begin));
+    }
+  }
+  return data;
+}
+
+/**
+ * @brief Random access to the neighbors of a node, which decodes only the
+ * chunks holding the accessed neighbors. An instance is meant to be reused
+ * for many nodes by a thread, so that its buffers are allocated once.
+ */
+template <typename index_t>
+class RowDecoder {
+ public:
+  /** @brief Access the \p num_neighbors neighbors starting at \p data. */
+  void Reset(const uint8_t* data, int64_t num_neighbors) {
+    next_chunk_ = data;
+    num_neighbors_ = num_neighbors;
+    chunks_.clear();
+    decoded_.assign(
+        (num_neighbors + kCompressedIndicesChunkSize - 1) /
+            kCompressedIndicesChunkSize,
+        false);
+    if (static_cast<int64_t>(values_.size()) < num_neighbors) {
+      values_.resize(num_neighbors);
+    }
+  }
+
+  /** @brief Get the \p i-th neighbor. */
+  index_t operator[](int64_t i) {
+    const int64_t chunk = i / kCompressedIndicesChunkSize;
+    if (!decoded_[chunk]) {
+      while (static_cast<int64_t>(chunks_.size()) <= chunk) {
+        chunks_.push_back(next_chunk_);
+        next_chunk_ = SkipChunk(next_chunk_, ChunkSize(chunks_.size() - 1));
+      }
+      DecodeChunk(
+          chunks_[chunk], ChunkSize(chunk),
+          values_.data() + chunk * kCompressedIndicesChunkSize);
+      decoded_[chunk] = true;
+    }
+    return values_[i];
+  }
+
+ private:
+  int64_t ChunkSize(int64_t chunk) const {
+    return std::min<int64_t>(
+        kCompressedIndicesChunkSize,
+        num_neighbors_ - chunk * kCompressedIndicesChunkSize);
+  }
+
+  const uint8_t* next_chunk_ = nullptr;
+  int64_t num_neighbors_ = 0;
+  std::vector<const uint8_t*> chunks_;
+  std::vector<bool> decoded_;
+  std::vector<index_t> values_;
+};
+
+}  // namespace compressed_indices
+}  // namespace ops
+}  // namespace graphbolt
+
+#endif  // GRAPHBOLT_COMPRESSED_INDICES_H_
@@ -10,13 +10,22 @@
 #include <intrin.h>
 #endif  // _MSC_VER
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GRAPHBOLT_ID_HASH_MAP_SSE2
+#endif
+
+#include <algorithm>
 #include <cmath>
 #include <cuda/std/atomic>
 #include <numeric>
+#include <utility>
 
 namespace {
 static constexpr int64_t kEmptyKey = -1;
 static constexpr int kGrainSize = 256;
+// The number of iterations ahead whose groups are prefetched.
+static constexpr int kPrefetchDistance = 16;
 
 // The formula is established from experience which is used to get the hashmap
 // size from the input array size.
@@ -24,6 +33,66 @@ inline size_t GetMapSize(size_t num) {
   size_t capacity = 1;
   return capacity << static_cast<size_t>(1 + std::log2(num * 3));
 }
+
+inline int FirstSetBit(uint32_t mask) {
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<int>(index);
+#else
+  return __builtin_ctz(mask);
+#endif  // _MSC_VER
+}
+
+/**
+ * @brief Compare all the keys of a group with `id` and with the empty key.
+ *
+ * @return The bitmasks of the slots holding `id` and of the empty slots.
+ */
+template <int kGroupSize, typename IdType>
+inline std::pair<uint32_t, uint32_t> MatchGroup(
+    const IdType* keys, const IdType id) {
+  uint32_t match = 0, empty = 0;
+#ifdef GRAPHBOLT_ID_HASH_MAP_SSE2
+  constexpr int kLanes = 16 / sizeof(IdType);
+  static_assert(kGroupSize % kLanes == 0);
+  __m128i key, empty_key;
+  if constexpr (sizeof(IdType) == 4) {
+    key = _mm_set1_epi32(id);
+    empty_key = _mm_set1_epi32(static_cast<IdType>(kEmptyKey));
+  } else {
+    key = _mm_set1_epi64x(id);
+    empty_key = _mm_set1_epi64x(static_cast<IdType>(kEmptyKey));
+  }
+  for (int i = 0; i < kGroupSize; i += kLanes) {
+    // Groups are 16 byte aligned. The volatile load keeps the compiler from
+    // reloading the keys for the second comparison while other threads are
+    // inserting.
+    const __m128i v = *reinterpret_cast<const volatile __m128i*>(keys + i);
+    auto eq = _mm_cmpeq_epi32(v, key);
+    auto eq_empty = _mm_cmpeq_epi32(v, empty_key);
+    if constexpr (sizeof(IdType) == 4) {
+      match |= _mm_movemask_ps(_mm_castsi128_ps(eq)) << i;
+      empty |= _mm_movemask_ps(_mm_castsi128_ps(eq_empty)) << i;
+    } else {
+      // SSE2 has no 64-bit comparison, both 32-bit halves need to be equal.
+      constexpr int kSwapHalves = _MM_SHUFFLE(2, 3, 0, 1);
+      eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, kSwapHalves));
+      eq_empty =
+          _mm_and_si128(eq_empty, _mm_shuffle_epi32(eq_empty, kSwapHalves));
+      match |= _mm_movemask_pd(_mm_castsi128_pd(eq)) << i;
+      empty |= _mm_movemask_pd(_mm_castsi128_pd(eq_empty)) << i;
+    }
+  }
+#else
+  for (int i = 0; i < kGroupSize; i++) {
+    const IdType key = reinterpret_cast<const volatile IdType*>(keys)[i];
+    match |= static_cast<uint32_t>(key == id) << i;
+    empty |= static_cast<uint32_t>(key == static_cast<IdType>(kEmptyKey)) << i;
+  }
+#endif  // GRAPHBOLT_ID_HASH_MAP_SSE2
+  return {match, empty};
+}
 }  // namespace
 
 namespace graphbolt {
@@ -32,25 +101,72 @@ namespace sampling {
 template <typename IdType>
 ConcurrentIdHashMap<IdType>::ConcurrentIdHashMap(
     const torch::Tensor& ids, size_t num_seeds) {
+  Allocate(static_cast<size_t>(ids.size(0)), ids.options());
+  unique_ids_ = torch::empty({0}, ids.options());
+  InsertIds(ids, num_seeds);
+}
+
+template <typename IdType>
+torch::Tensor ConcurrentIdHashMap<IdType>::InsertAndMapIds(
+    const torch::Tensor& ids) {
+  const auto num_unique = static_cast<size_t>(unique_ids_.size(0));
+  const auto num_ids = num_unique + static_cast<size_t>(ids.size(0));
+  if (GetMapSize(num_ids) > static_cast<size_t>(hash_map_.size(0) / 2)) {
+    // Move the existing keys to a larger table, their values are their
+    // indices in unique_ids_.
+    Allocate(num_ids, hash_map_.options());
+    const IdType* unique_ids_data = unique_ids_.data_ptr<IdType>();
+    IdType* hash_map_data = hash_map_.data_ptr<IdType>();
+    torch::parallel_for(0, num_unique, kGrainSize, [&](int64_t s, int64_t e) {
+      for (int64_t i = s; i < e; i++) {
+        if (i + kPrefetchDistance < e) {
+          Prefetch(unique_ids_data[i + kPrefetchDistance]);
+        }
+        hash_map_data[Insert(unique_ids_data[i]) + kGroupSize] = i;
+      }
+    });
+  }
+  InsertIds(ids, 0);
+  return MapInsertedIds(0);
+}
+
+template <typename IdType>
+void ConcurrentIdHashMap<IdType>::Allocate(
+    size_t num_ids, const torch::TensorOptions& options) {
+  // At least two groups so that the hash shift stays below 64.
+  const size_t capacity = std::max<size_t>(GetMapSize(num_ids), 2 * kGroupSize);
+  const int64_t num_groups = capacity / kGroupSize;
+  mask_ = num_groups - 1;
+  shift_ = 64 - static_cast<int>(std::log2(num_groups));
+
+  hash_map_ = torch::full({static_cast<int64_t>(capacity * 2)}, -1, options);
+}
+
+template <typename IdType>
+void ConcurrentIdHashMap<IdType>::InsertIds(
+    const torch::Tensor& ids, size_t num_seeds) {
   const IdType* ids_data = ids.data_ptr<IdType>();
   const size_t num_ids = static_cast<size_t>(ids.size(0));
-  size_t capacity = GetMapSize(num_ids);
-  mask_ = static_cast<IdType>(capacity - 1);
-
-  hash_map_ =
-      torch::full({static_cast<int64_t>(capacity * 2)}, -1, ids.options());
+  // The ids new to the map are numbered after the existing unique ids.
+  const size_t num_unique = static_cast<size_t>(unique_ids_.size(0));
 
   // This code block is to fill the ids into hash_map_.
-  unique_ids_ = torch::empty_like(ids);
-  IdType* unique_ids_data = unique_ids_.data_ptr<IdType>();
+  auto unique_ids = torch::empty(num_unique + num_ids, ids.options());
+  IdType* unique_ids_data = unique_ids.data_ptr<IdType>();
+  key_indices_ = torch::empty_like(ids, ids.options().dtype(torch::kInt64));
+  auto key_indices = key_indices_.data_ptr<int64_t>();
   // Insert all ids into the hash map.
   torch::parallel_for(0, num_ids, kGrainSize, [&](int64_t s, int64_t e) {
     for (int64_t i = s; i < e; i++) {
-      InsertAndSetMin(ids_data[i], static_cast<IdType>(i));
+      if (i + kPrefetchDistance < e) Prefetch(ids_data[i + kPrefetchDistance]);
+      key_indices[i] = InsertAndSetMin(
+          ids_data[i], static_cast<IdType>(num_unique + i));
     }
   });
-  // Place the first `num_seeds` ids.
-  unique_ids_.slice(0, 0, num_seeds) = ids.slice(0, 0, num_seeds);
+  // Keep the existing unique ids and place the first `num_seeds` ids.
+  unique_ids.slice(0, 0, num_unique) = unique_ids_;
+  unique_ids.slice(0, num_unique, num_unique + num_seeds) =
+      ids.slice(0, 0, num_seeds);
 
   auto valid_tensor = torch::empty(num_ids, ids.options().dtype(torch::kInt8));
   auto valid = valid_tensor.data_ptr<int8_t>();
@@ -58,12 +174,14 @@ ConcurrentIdHashMap<IdType>::ConcurrentIdHashMap(
   const int64_t num_threads = torch::get_num_threads();
   std::vector<size_t> block_offset(num_threads + 1, 0);
 
+  IdType* hash_map_data = hash_map_.data_ptr<IdType>();
   // Count the valid numbers in each thread.
   torch::parallel_for(
       num_seeds, num_ids, kGrainSize, [&](int64_t s, int64_t e) {
         size_t count = 0;
         for (int64_t i = s; i < e; i++) {
-          if (MapId(ids_data[i]) == i) {
+          const auto value = static_cast<IdType>(num_unique + i);
+          if (hash_map_data[key_indices[i] + kGroupSize] == value) {
             count++;
             valid[i] = 1;
           } else {
@@ -77,17 +195,18 @@ ConcurrentIdHashMap<IdType>::ConcurrentIdHashMap(
   // Get ExclusiveSum of each block.
   std::partial_sum(
       block_offset.begin() + 1, block_offset.end(), block_offset.begin() + 1);
-  unique_ids_ = unique_ids_.slice(0, 0, num_seeds + block_offset.back());
+  unique_ids_ =
+      unique_ids.slice(0, 0, num_unique + num_seeds + block_offset.back());
 
   // Get unique array from ids and set value for hash map.
   torch::parallel_for(
       num_seeds, num_ids, kGrainSize, [&](int64_t s, int64_t e) {
         auto thread_id = torch::get_thread_num();
-        auto pos = block_offset[thread_id] + num_seeds;
+        auto pos = block_offset[thread_id] + num_unique + num_seeds;
         for (int64_t i = s; i < e; i++) {
           if (valid[i]) {
             unique_ids_data[pos] = ids_data[i];
-            Set(ids_data[i], pos);
+            hash_map_data[key_indices[i] + kGroupSize] = pos;
             pos = pos + 1;
           }
         }
@@ -105,6 +224,7 @@ torch::Tensor ConcurrentIdHashMap<IdType>::MapIds(
 
   torch::parallel_for(0, num_ids, kGrainSize, [&](int64_t s, int64_t e) {
     for (int64_t i = s; i < e; i++) {
+      if (i + kPrefetchDistance < e) Prefetch(ids_data[i + kPrefetchDistance]);
       values_data[i] = MapId(ids_data[i]);
     }
   });
@@ -112,89 +232,96 @@ torch::Tensor ConcurrentIdHashMap<IdType>::MapIds(
 }
 
 template <typename IdType>
-constexpr IdType getKeyIndex(IdType pos) {
-  return 2 * pos;
-}
+torch::Tensor ConcurrentIdHashMap<IdType>::MapInsertedIds(
+    int64_t offset) const {
+  auto key_indices = key_indices_.slice(0, offset);
+  const auto key_indices_data = key_indices.data_ptr<int64_t>();
+  const IdType* hash_map_data = hash_map_.data_ptr<IdType>();
 
-template <typename IdType>
-constexpr IdType getValueIndex(IdType pos) {
-  return 2 * pos + 1;
+  torch::Tensor new_ids = torch::empty_like(key_indices, hash_map_.options());
+  IdType* values_data = new_ids.data_ptr<IdType>();
+
+  torch::parallel_for(
+      0, key_indices.size(0), kGrainSize, [&](int64_t s, int64_t e) {
+        for (int64_t i = s; i < e; i++) {
+          values_data[i] = hash_map_data[key_indices_data[i] + kGroupSize];
+        }
+      });
+  return new_ids;
 }
 
 template <typename IdType>
-inline void ConcurrentIdHashMap<IdType>::Next(
-    IdType* pos, IdType* delta) const {
-  // Use Quadric probing.
-  *pos = (*pos + (*delta) * (*delta)) & mask_;
-  *delta = *delta + 1;
+inline int64_t ConcurrentIdHashMap<IdType>::GroupBegin(IdType id) const {
+  // Fibonacci hashing spreads the ids even if they share a stride.
+  const auto hash =
+      static_cast<uint64_t>(id) * uint64_t{0x9E3779B97F4A7C15} >> shift_;
+  return static_cast<int64_t>(hash) * 2 * kGroupSize;
 }
 
 template <typename IdType>
-inline IdType ConcurrentIdHashMap<IdType>::MapId(IdType id) const {
-  IdType pos = (id & mask_), delta = 1;
-  IdType empty_key = static_cast<IdType>(kEmptyKey);
-  IdType* hash_map_data = hash_map_.data_ptr<IdType>();
-  IdType key = hash_map_data[getKeyIndex(pos)];
-  while (key != empty_key && key != id) {
-    Next(&pos, &delta);
-    key = hash_map_data[getKeyIndex(pos)];
-  }
-  if (key == empty_key) {
-    throw std::out_of_range("Id not found: " + std::to_string(id));
-  }
-  return hash_map_data[getValueIndex(pos)];
+inline int64_t ConcurrentIdHashMap<IdType>::NextGroup(int64_t begin) const {
+  // Use linear probing over the groups.
+  return ((begin / (2 * kGroupSize) + 1) & mask_) * 2 * kGroupSize;
 }
 
 template <typename IdType>
-bool ConcurrentIdHashMap<IdType>::Insert(IdType id) {
-  IdType pos = (id & mask_), delta = 1;
-  InsertState state = AttemptInsertAt(pos, id);
-  while (state == InsertState::OCCUPIED) {
-    Next(&pos, &delta);
-    state = AttemptInsertAt(pos, id);
-  }
-
-  return state == InsertState::INSERTED;
+inline void ConcurrentIdHashMap<IdType>::Prefetch(IdType id) const {
+#if defined(__GNUC__) || defined(__clang__)
+  const IdType* keys = hash_map_.data_ptr<IdType>() + GroupBegin(id);
+  __builtin_prefetch(keys);
+  __builtin_prefetch(keys + kGroupSize);
+#endif
 }
 
 template <typename IdType>
-inline void ConcurrentIdHashMap<IdType>::Set(IdType key, IdType value) {
-  IdType pos = (key & mask_), delta = 1;
-  IdType* hash_map_data = hash_map_.data_ptr<IdType>();
-  while (hash_map_data[getKeyIndex(pos)] != key) {
-    Next(&pos, &delta);
+inline IdType ConcurrentIdHashMap<IdType>::MapId(IdType id) const {
+  const IdType* hash_map_data = hash_map_.data_ptr<IdType>();
+  for (auto begin = GroupBegin(id);; begin = NextGroup(begin)) {
+    const auto [match, empty] =
+        MatchGroup<kGroupSize>(hash_map_data + begin, id);
+    if (match) {
+      return hash_map_data[begin + kGroupSize + FirstSetBit(match)];
+    }
+    if (empty) {
+      throw std::out_of_range("Id not found: " + std::to_string(id));
+    }
   }
-
-  hash_map_data[getValueIndex(pos)] = value;
 }
 
 template <typename IdType>
-inline void ConcurrentIdHashMap<IdType>::InsertAndSet(IdType id, IdType value) {
-  IdType pos = (id & mask_), delta = 1;
-  while (AttemptInsertAt(pos, id) == InsertState::OCCUPIED) {
-    Next(&pos, &delta);
+inline int64_t ConcurrentIdHashMap<IdType>::Insert(IdType id) {
+  const IdType* hash_map_data = hash_map_.data_ptr<IdType>();
+  for (auto begin = GroupBegin(id);; begin = NextGroup(begin)) {
+    auto [match, empty] = MatchGroup<kGroupSize>(hash_map_data + begin, id);
+    // The slots of a group are filled in order and never emptied, so the key
+    // can only be before the first empty slot. The key might have been
+    // inserted by another thread after the group was loaded, in which case
+    // the insertion attempts below find it.
+    while (true) {
+      const int first_empty = empty ? FirstSetBit(empty) : kGroupSize;
+      if (match && FirstSetBit(match) < first_empty) {
+        return begin + FirstSetBit(match);
+      }
+      if (first_empty == kGroupSize) break;
+      const auto pos = begin + first_empty;
+      if (AttemptInsertAt(pos, id) != InsertState::OCCUPIED) return pos;
+      empty &= empty - 1;
+    }
   }
-
-  hash_map_.data_ptr<IdType>()[getValueIndex(pos)] = value;
 }
 
 template <typename IdType>
-void ConcurrentIdHashMap<IdType>::InsertAndSetMin(IdType id, IdType value) {
-  IdType pos = (id & mask_), delta = 1;
-  InsertState state = AttemptInsertAt(pos, id);
-  while (state == InsertState::OCCUPIED) {
-    Next(&pos, &delta);
-    state = AttemptInsertAt(pos, id);
-  }
+int64_t ConcurrentIdHashMap<IdType>::InsertAndSetMin(IdType id, IdType value) {
+  const auto pos = Insert(id);
 
   IdType empty_key = static_cast<IdType>(kEmptyKey);
-  IdType val_pos = getValueIndex(pos);
   ::cuda::std::atomic_ref value_ref(
-      reinterpret_cast<IdType*>(hash_map_.data_ptr())[val_pos]);
+      reinterpret_cast<IdType*>(hash_map_.data_ptr())[pos + kGroupSize]);
   for (auto old_val = empty_key; old_val == empty_key || old_val > value;) {
     // It is more efficient to use weak variant in a loop.
     if (value_ref.compare_exchange_weak(old_val, value)) break;
   }
+  return pos;
 }
 
 template <typename IdType>
@@ -202,7 +329,7 @@ inline typename ConcurrentIdHashMap<IdType>::InsertState
 ConcurrentIdHashMap<IdType>::AttemptInsertAt(int64_t pos, IdType key) {
   auto expected = static_cast<IdType>(kEmptyKey);
   ::cuda::std::atomic_ref key_ref(
-      reinterpret_cast<IdType*>(hash_map_.data_ptr())[getKeyIndex(pos)]);
+      reinterpret_cast<IdType*>(hash_map_.data_ptr())[pos]);
   if (key_ref.compare_exchange_strong(expected, key)) {
     return InsertState::INSERTED;
   } else if (expected == key) {
@@ -55,6 +55,12 @@ namespace sampling {
  * R = H.Map(I) (3)
  * R should be:
  * [1, 0, 4]
+ *
+ * The table is made of groups of kGroupSize keys followed by their values, and
+ * a key is stored in the first free slot of the group its hash selects or of
+ * the groups following it. A probe compares the key against a whole group with
+ * SIMD instructions, and batched inserts and lookups prefetch the groups of the
+ * keys a few iterations ahead to hide the cache misses.
  **/
 template <typename IdType>
 class ConcurrentIdHashMap {
@@ -87,7 +93,8 @@ class ConcurrentIdHashMap {
   ConcurrentIdHashMap& operator=(const ConcurrentIdHashMap& other) = delete;
 
   /**
-   * @brief Get the unique ids for the keys given in the constructor.
+   * @brief Get the unique ids for the keys inserted so far, in the order of
+   * their mappings.
    */
   const torch::Tensor& GetUniqueIds() const { return unique_ids_; }
 
@@ -100,51 +107,81 @@ class ConcurrentIdHashMap {
    */
   torch::Tensor MapIds(const torch::Tensor& ids) const;
 
- private:
   /**
-   * @brief Get the next position and delta for probing.
+   * @brief Find mappings of the ids given in the constructor, or in the last
+   * call to `InsertAndMapIds`, starting from `offset`. It is faster than
+   * `MapIds` as the positions of these ids in the hash map are recorded during
+   * the insertion.
+   *
+   * @param offset The index of the first id to map for.
    *
-   * @param[in,out] pos Calculate the next position with quadric probing.
-   * @param[in,out] delta Calculate the next delta by adding 1.
+   * @return Mapping results corresponding to `ids[offset:]`.
    */
-  inline void Next(IdType* pos, IdType* delta) const;
+  torch::Tensor MapInsertedIds(int64_t offset) const;
 
   /**
-   * @brief Find the mapping of a given key.
+   * @brief Insert more ids and find their mappings. The ids not in the hash
+   * map yet are mapped after the existing unique ids, and appended to them.
+   * Existing mappings are not changed, so the results of previous calls to
+   * `GetUniqueIds` stay a prefix of the unique ids.
    *
-   * @param id The key to map for.
+   * @param ids The ids to be inserted, which can be duplicated.
    *
-   * @return Mapping result corresponding to `id`.
+   * @return Mapping results corresponding to `ids`.
    */
-  inline IdType MapId(const IdType id) const;
+  torch::Tensor InsertAndMapIds(const torch::Tensor& ids);
 
+ private:
   /**
-   * @brief Insert an id into the hash map.
-   *
-   * @param id The id to be inserted.
-   *
-   * @return Whether the `id` is inserted or not.
+   * @brief Allocate an empty hash map large enough for `num_ids` keys.
+   */
+  void Allocate(size_t num_ids, const torch::TensorOptions& options);
+
+  /**
+   * @brief Insert ids into the hash map, which must be large enough, and
+   * append the new ones to the unique ids. The first `num_seeds` ids must be
+   * unique and not in the hash map yet.
+   */
+  void InsertIds(const torch::Tensor& ids, size_t num_seeds);
+
+  /**
+   * @brief The number of slots in a group, which are compared at once.
+   */
+  static constexpr int kGroupSize = 8;
+
+  /**
+   * @brief Get the index of the first key of the group a key hashes to.
+   */
+  inline int64_t GroupBegin(IdType id) const;
+
+  /**
+   * @brief Get the index of the first key of the group following the one
+   * starting at `begin`.
+   */
+  inline int64_t NextGroup(int64_t begin) const;
+
+  /**
+   * @brief Prefetch the group a key hashes to.
    */
-  inline bool Insert(IdType id);
+  inline void Prefetch(IdType id) const;
 
   /**
-   * @brief Set the value for the key in the hash map.
+   * @brief Find the mapping of a given key.
    *
-   * @param key The key to set for.
-   * @param value The value to be set for the `key`.
+   * @param id The key to map for.
    *
-   * @warning Key must exist.
+   * @return Mapping result corresponding to `id`.
    */
-  inline void Set(IdType key, IdType value);
+  inline IdType MapId(const IdType id) const;
 
   /**
-   * @brief Insert a key into the hash map.
+   * @brief Insert a key into the hash map if it does not exist.
    *
    * @param id The key to be inserted.
-   * @param value The value to be set for the `key`.
    *
+   * @return The index of the key in `hash_map_`.
    */
-  inline void InsertAndSet(IdType key, IdType value);
+  inline int64_t Insert(IdType id);
 
   /**
    * @brief Insert a key into the hash map. If the key exists, set the value
@@ -153,8 +190,9 @@ class ConcurrentIdHashMap {
    * @param id The key to be inserted.
    * @param value The value to be set for the `key`.
    *
+   * @return The index of the key in `hash_map_`.
    */
-  inline void InsertAndSetMin(IdType id, IdType value);
+  inline int64_t InsertAndSetMin(IdType id, IdType value);
 
   /**
    * @brief Attempt to insert the key into the hash map at the given position.
@@ -178,10 +216,20 @@ class ConcurrentIdHashMap {
   torch::Tensor unique_ids_;
 
   /**
-   * @brief Mask which is assisted to get the position in the table
-   * for a key by performing `&` operation with it.
+   * @brief Holds the index in `hash_map_` of each id of the last insertion.
+   */
+  torch::Tensor key_indices_;
+
+  /**
+   * @brief Mask to wrap around the indices of the groups in `hash_map_`.
+   */
+  int64_t mask_;
+
+  /**
+   * @brief Shift which turns the multiplicative hash of a key into the index
+   * of its group.
    */
-  IdType mask_;
+  int shift_;
 };
 
 }  // namespace sampling
@@ -13,11 +13,14 @@
 #include <array>
 #include <cmath>
 #include <limits>
+#include <memory>
 #include <numeric>
 #include <tuple>
 #include <type_traits>
 #include <vector>
 
+#include "./compressed_indices.h"
+#include "./concurrent_id_hash_map.h"
 #include "./expand_indptr.h"
 #include "./index_select.h"
 #include "./macro.h"
@@ -132,6 +135,19 @@ void FusedCSCSamplingGraph::Load(torch::serialize::InputArchive& archive) {
       read_from_archive<torch::Tensor>(archive, "FusedCSCSamplingGraph/indptr");
   indices_ = read_from_archive<torch::Tensor>(
       archive, "FusedCSCSamplingGraph/indices");
+  // Graphs saved before the indices could be compressed lack the key.
+  c10::IValue has_compressed_indices;
+  if (archive.try_read(
+          "FusedCSCSamplingGraph/has_compressed_indices",
+          has_compressed_indices) &&
+      has_compressed_indices.toBool()) {
+    SetCompressedIndices(
+        indices_.scalar_type(),
+        read_from_archive<torch::Tensor>(
+            archive, "FusedCSCSamplingGraph/compressed_indices"),
+        read_from_archive<torch::Tensor>(
+            archive, "FusedCSCSamplingGraph/compressed_indices_offsets"));
+  }
   if (read_from_archive<bool>(
           archive, "FusedCSCSamplingGraph/has_node_type_offset")) {
     node_type_offset_ = read_from_archive<torch::Tensor>(
@@ -173,6 +189,16 @@ void FusedCSCSamplingGraph::Save(
       "FusedCSCSamplingGraph/magic_num", kCSCSamplingGraphSerializeMagic);
   archive.write("FusedCSCSamplingGraph/indptr", indptr_);
   archive.write("FusedCSCSamplingGraph/indices", indices_);
+  archive.write(
+      "FusedCSCSamplingGraph/has_compressed_indices", IsIndicesCompressed());
+  if (compressed_indices_) {
+    archive.write(
+        "FusedCSCSamplingGraph/compressed_indices",
+        compressed_indices_.value());
+    archive.write(
+        "FusedCSCSamplingGraph/compressed_indices_offsets",
+        compressed_indices_offsets_.value());
+  }
   archive.write(
       "FusedCSCSamplingGraph/has_node_type_offset",
       node_type_offset_.has_value());
@@ -229,6 +255,12 @@ void FusedCSCSamplingGraph::SetState(
       "Version number mismatches when loading pickled FusedCSCSamplingGraph.")
   indptr_ = independent_tensors.at("indptr");
   indices_ = independent_tensors.at("indices");
+  if (independent_tensors.find("compressed_indices") !=
+      independent_tensors.end()) {
+    SetCompressedIndices(
+        indices_.scalar_type(), independent_tensors.at("compressed_indices"),
+        independent_tensors.at("compressed_indices_offsets"));
+  }
   if (independent_tensors.find("node_type_offset") !=
       independent_tensors.end()) {
     node_type_offset_ = independent_tensors.at("node_type_offset");
@@ -262,6 +294,12 @@ FusedCSCSamplingGraph::GetState() const {
   independent_tensors.insert("version_number", torch::tensor({kPickleVersion}));
   independent_tensors.insert("indptr", indptr_);
   independent_tensors.insert("indices", indices_);
+  if (compressed_indices_.has_value()) {
+    independent_tensors.insert(
+        "compressed_indices", compressed_indices_.value());
+    independent_tensors.insert(
+        "compressed_indices_offsets", compressed_indices_offsets_.value());
+  }
   if (node_type_offset_.has_value()) {
     independent_tensors.insert("node_type_offset", node_type_offset_.value());
   }
@@ -284,8 +322,63 @@ FusedCSCSamplingGraph::GetState() const {
   return state;
 }
 
+const torch::Tensor FusedCSCSamplingGraph::Indices() const {
+  if (!compressed_indices_.has_value()) return indices_;
+  return ops::DecompressIndices(
+      indptr_, compressed_indices_.value(), compressed_indices_offsets_.value(),
+      indices_.scalar_type());
+}
+
+void FusedCSCSamplingGraph::SetCompressedIndices(
+    torch::ScalarType dtype, const torch::Tensor& compressed_indices,
+    const torch::Tensor& offsets) {
+  TORCH_CHECK(
+      compressed_indices.dim() == 1 &&
+          compressed_indices.scalar_type() == torch::kUInt8,
+      "Expected the compressed indices to be a 1D uint8 tensor.");
+  const int64_t num_blocks =
+      (NumNodes() + ops::kCompressedIndicesRowsPerBlock - 1) /
+      ops::kCompressedIndicesRowsPerBlock;
+  TORCH_CHECK(
+      offsets.dim() == 1 && offsets.scalar_type() == torch::kInt64 &&
+          offsets.size(0) == num_blocks + 1,
+      "Expected one int64 offset per block of nodes of the compressed "
+      "indices.");
+  indices_ = torch::empty({0}, indptr_.options().dtype(dtype));
+  compressed_indices_ = compressed_indices;
+  compressed_indices_offsets_ = offsets;
+}
+
+void FusedCSCSamplingGraph::CompressIndices() {
+  if (IsIndicesCompressed()) return;
+  auto [compressed_indices, offsets] = ops::CompressIndices(indptr_, indices_);
+  SetCompressedIndices(indices_.scalar_type(), compressed_indices, offsets);
+}
+
 c10::intrusive_ptr<FusedSampledSubgraph> FusedCSCSamplingGraph::InSubgraph(
     const torch::Tensor& nodes) const {
+  if (IsIndicesCompressed()) {
+    TORCH_CHECK(
+        !utils::is_on_gpu(nodes),
+        "InSubgraph on the GPU is not supported with compressed indices.");
+    std::vector<torch::Tensor> tensors;
+    if (type_per_edge_.has_value()) {
+      tensors.push_back(*type_per_edge_);
+    }
+    auto [output_indptr, results] = ops::IndexSelectCSCBatched(
+        indptr_, tensors, nodes, true, torch::nullopt);
+    auto indices = ops::DecompressIndices(
+        indptr_, compressed_indices_.value(),
+        compressed_indices_offsets_.value(), indices_.scalar_type(), nodes,
+        output_indptr);
+    torch::optional<torch::Tensor> type_per_edge;
+    if (type_per_edge_.has_value()) {
+      type_per_edge = results.at(0);
+    }
+    return c10::make_intrusive<FusedSampledSubgraph>(
+        output_indptr, indices, results.back(), nodes, torch::nullopt,
+        type_per_edge);
+  }
   if (utils::is_on_gpu(nodes) && utils::is_accessible_from_gpu(indptr_) &&
       utils::is_accessible_from_gpu(indices_) &&
       (!type_per_edge_.has_value() ||
@@ -312,6 +405,88 @@ c10::intrusive_ptr<FusedSampledSubgraph> FusedCSCSamplingGraph::InSubgraph(
       type_per_edge);
 }
 
+void FusedCSCSamplingGraph::SetEdgeAttributes(
+    const torch::optional<EdgeAttrMap>& edge_attributes) {
+  const auto previous = edge_attributes_;
+  edge_attributes_ = edge_attributes;
+  if (!previous.has_value() || !edge_attributes.has_value()) return;
+  // A prefix sum is stale if its probabilities were replaced but not itself.
+  std::vector<std::string> stale_names;
+  for (const auto& pair : edge_attributes.value()) {
+    const auto name = ProbsPrefixSumName(pair.key());
+    if (!edge_attributes->contains(name) || !previous->contains(name)) {
+      continue;
+    }
+    const bool probs_replaced =
+        !previous->contains(pair.key()) ||
+        !previous->at(pair.key()).is_same(pair.value());
+    if (probs_replaced &&
+        previous->at(name).is_same(edge_attributes->at(name))) {
+      stale_names.push_back(name);
+    }
+  }
+  if (stale_names.empty()) return;
+  // Do not modify the dictionary of the caller.
+  edge_attributes_ = edge_attributes->copy();
+  for (const auto& name : stale_names) edge_attributes_->erase(name);
+}
+
+void FusedCSCSamplingGraph::BuildProbsPrefixSum(const std::string& probs_name) {
+  auto probs = EdgeAttribute(probs_name).value();
+  TORCH_CHECK(
+      probs.dim() == 1 && probs.size(0) == NumEdges(),
+      "Expected edge attribute ", probs_name,
+      " to be a 1D tensor with one value per edge.");
+  TORCH_CHECK(
+      !utils::is_on_gpu(probs) && !utils::is_on_gpu(indptr_),
+      "The prefix sum of probabilities can only be built on the CPU.");
+  probs = probs.to(torch::kFloat64).contiguous();
+  const int64_t num_edges = probs.size(0);
+  TORCH_CHECK(
+      num_edges == 0 || probs.min().item<double>() >= 0,
+      "Expected edge attribute ", probs_name, " to be non-negative.");
+  auto prefix_sum = torch::empty_like(probs);
+  const double* probs_data = probs.data_ptr<double>();
+  double* prefix_sum_data = prefix_sum.data_ptr<double>();
+  // The sums restart at every node, so that the probabilities of its
+  // neighbors are not lost in the rounding errors of a sum over the edges of
+  // all the preceding nodes.
+  AT_DISPATCH_INDEX_TYPES(
+      indptr_.scalar_type(), "BuildProbsPrefixSum", ([&] {
+        const auto indptr_data = indptr_.data_ptr<index_t>();
+        torch::parallel_for(
+            0, NumNodes(), 64, [&](int64_t begin, int64_t end) {
+              for (int64_t row = begin; row < end; ++row) {
+                double sum = 0;
+                for (int64_t i = indptr_data[row]; i < indptr_data[row + 1];
+                     ++i) {
+                  prefix_sum_data[i] = sum;
+                  sum += probs_data[i];
+                }
+              }
+            });
+      }));
+  AddEdgeAttribute(ProbsPrefixSumName(probs_name), prefix_sum);
+}
+
+const double* FusedCSCSamplingGraph::ProbsPrefixSum(
+    const torch::Tensor& probs_or_mask) const {
+  if (!edge_attributes_.has_value()) return nullptr;
+  const auto& edge_attributes = edge_attributes_.value();
+  for (const auto& pair : edge_attributes) {
+    if (!pair.value().is_same(probs_or_mask)) continue;
+    const auto name = ProbsPrefixSumName(pair.key());
+    if (!edge_attributes.contains(name)) continue;
+    const auto prefix_sum = edge_attributes.at(name);
+    if (!utils::is_on_gpu(prefix_sum) && prefix_sum.is_contiguous() &&
+        prefix_sum.scalar_type() == torch::kFloat64 &&
+        prefix_sum.numel() == NumEdges()) {
+      return prefix_sum.data_ptr<double>();
+    }
+  }
+  return nullptr;
+}
+
 /**
  * @brief Get a lambda function which counts the number of the neighbors to be
  * sampled.
@@ -559,6 +734,14 @@ FusedCSCSamplingGraph::SampleNeighborsImpl(
                   num_picked_neighbors_per_node.data_ptr<indptr_t>();
               num_picked_neighbors_data_ptr[0] = 0;
               const auto seeds_data_ptr = seeds.data_ptr<seeds_t>();
+              const uint8_t* compressed_indices_data =
+                  IsIndicesCompressed()
+                      ? compressed_indices_->data_ptr<uint8_t>()
+                      : nullptr;
+              const int64_t* compressed_indices_offsets_data =
+                  IsIndicesCompressed()
+                      ? compressed_indices_offsets_->data_ptr<int64_t>()
+                      : nullptr;
 
               // Step 1. Calculate pick number of each node.
               torch::parallel_for(
@@ -657,6 +840,7 @@ FusedCSCSamplingGraph::SampleNeighborsImpl(
               auto picked_eids_data_ptr = picked_eids.data_ptr<indptr_t>();
               torch::parallel_for(
                   0, num_seeds, grain_size, [&](int64_t begin, int64_t end) {
+                    ops::compressed_indices::RowDecoder<seeds_t> row_decoder;
                     for (int64_t i = begin; i < end; ++i) {
                       const auto nid = seeds_data_ptr[i];
                       const auto offset = indptr_data[nid];
@@ -709,6 +893,15 @@ FusedCSCSamplingGraph::SampleNeighborsImpl(
                         auto subgraph_indices_data_ptr =
                             subgraph_indices.data_ptr<index_t>();
                         auto indices_data_ptr = indices_.data_ptr<index_t>();
+                        if (compressed_indices_data != nullptr) {
+                          // Only the chunks holding picked neighbors are
+                          // decoded.
+                          row_decoder.Reset(
+                              ops::compressed_indices::FindRow(
+                                  indptr_data, compressed_indices_data,
+                                  compressed_indices_offsets_data, nid),
+                              num_neighbors);
+                        }
                         for (auto i = 0; i < num_etypes; ++i) {
                           if (etype_id_to_dst_ntype_id[i] != seed_type_id)
                             continue;
@@ -723,7 +916,10 @@ FusedCSCSamplingGraph::SampleNeighborsImpl(
                               subgraph_indptr_data_ptr[indptr_offset + 1];
                           for (auto j = picked_begin; j < picked_end; ++j) {
                             subgraph_indices_data_ptr[j] =
-                                indices_data_ptr[picked_eids_data_ptr[j]];
+                                compressed_indices_data != nullptr
+                                    ? row_decoder
+                                          [picked_eids_data_ptr[j] - offset]
+                                    : indices_data_ptr[picked_eids_data_ptr[j]];
                             if (hetero_with_seed_offsets &&
                                 node_type_offset_.has_value()) {
                               // Substract the node type offset from
@@ -811,7 +1007,20 @@ c10::intrusive_ptr<FusedSampledSubgraph> FusedCSCSamplingGraph::SampleNeighbors(
         });
   }
   TORCH_CHECK(seeds.has_value(), "Nodes can not be None on the CPU.");
+  if (IsIndicesCompressed()) {
+    TORCH_CHECK(
+        !layer && !utils::is_on_gpu(seeds.value()),
+        "Only neighbor sampling on the CPU is supported with compressed "
+        "indices.");
+    TORCH_CHECK(
+        seeds->scalar_type() == indices_.scalar_type(),
+        "The data type of the seeds must be the same as the indices.");
+  }
 
+  // Look the prefix sum up before 'probs_or_mask' is possibly converted below.
+  const double* probs_prefix_sum =
+      probs_or_mask.has_value() ? ProbsPrefixSum(probs_or_mask.value())
+                                : nullptr;
   if (probs_or_mask.has_value()) {
     // Note probs will be passed as input for 'torch.multinomial' in deeper
     // stack, which doesn't support 'torch.half' and 'torch.bool' data types. To
@@ -861,7 +1070,7 @@ c10::intrusive_ptr<FusedSampledSubgraph> FusedCSCSamplingGraph::SampleNeighbors(
               probs_or_mask, with_seed_offsets, args));
     }
   } else {
-    SamplerArgs<SamplerType::NEIGHBOR> args;
+    SamplerArgs<SamplerType::NEIGHBOR> args{probs_prefix_sum};
     return SampleNeighborsImpl<TemporalOption::NOT_TEMPORAL>(
         seeds.value(), seed_offsets, fanouts,
         GetNumPickFn(
@@ -892,6 +1101,55 @@ FusedCSCSamplingGraph::SampleNeighborsAsync(
           utils::is_on_gpu(indptr_));
 }
 
+std::vector<c10::intrusive_ptr<FusedSampledSubgraph>>
+FusedCSCSamplingGraph::SampleNeighborsMultiHop(
+    const torch::Tensor& seeds, const std::vector<int64_t>& fanouts,
+    bool replace, bool layer,
+    torch::optional<torch::Tensor> probs_or_mask) const {
+  TORCH_CHECK(
+      !node_type_offset_.has_value(),
+      "Multi-hop sampling is only supported on homogeneous graphs.");
+  TORCH_CHECK(
+      !utils::is_on_gpu(seeds) && !utils::is_on_gpu(indptr_),
+      "Multi-hop sampling is only supported on the CPU.");
+  TORCH_CHECK(
+      seeds.scalar_type() == indices_.scalar_type(),
+      "The data type of the seeds must be the same as the indices.");
+  std::vector<c10::intrusive_ptr<FusedSampledSubgraph>> subgraphs;
+  subgraphs.reserve(fanouts.size());
+  AT_DISPATCH_INDEX_TYPES(
+      indices_.scalar_type(), "SampleNeighborsMultiHop", ([&] {
+        // The nodes of each hop are a prefix of the nodes of the next hop, so
+        // a single map gives consistent compacted ids to all the hops.
+        ConcurrentIdHashMap<index_t> id_map(seeds, seeds.size(0));
+        auto hop_seeds = id_map.GetUniqueIds();
+        for (const auto fanout : fanouts) {
+          auto subgraph = SampleNeighbors(
+              hop_seeds, torch::nullopt, {fanout}, replace, layer, false,
+              probs_or_mask, torch::nullopt, 0);
+          auto compacted_indices = id_map.InsertAndMapIds(*subgraph->indices);
+          auto hop_nodes = id_map.GetUniqueIds();
+          subgraphs.push_back(c10::make_intrusive<FusedSampledSubgraph>(
+              subgraph->indptr, compacted_indices, subgraph->original_edge_ids,
+              hop_seeds, hop_nodes));
+          hop_seeds = hop_nodes;
+        }
+      }));
+  return subgraphs;
+}
+
+c10::intrusive_ptr<
+    Future<std::vector<c10::intrusive_ptr<FusedSampledSubgraph>>>>
+FusedCSCSamplingGraph::SampleNeighborsMultiHopAsync(
+    const torch::Tensor& seeds, const std::vector<int64_t>& fanouts,
+    bool replace, bool layer,
+    torch::optional<torch::Tensor> probs_or_mask) const {
+  return async([=] {
+    return this->SampleNeighborsMultiHop(
+        seeds, fanouts, replace, layer, probs_or_mask);
+  });
+}
+
 c10::intrusive_ptr<FusedSampledSubgraph>
 FusedCSCSamplingGraph::TemporalSampleNeighbors(
     const torch::optional<torch::Tensor>& seeds,
@@ -904,6 +1162,9 @@ FusedCSCSamplingGraph::TemporalSampleNeighbors(
     torch::optional<std::string> edge_timestamp_attr_name,
     torch::optional<torch::Tensor> random_seed,
     double seed2_contribution) const {
+  TORCH_CHECK(
+      !IsIndicesCompressed(),
+      "Temporal sampling is not supported with compressed indices.");
   // 1. Get the timestamp attribute for nodes of the graph
   const auto node_timestamp = this->NodeAttribute(node_timestamp_attr_name);
   // 2. Get the timestamp attribute for edges of the graph
@@ -1020,9 +1281,16 @@ BuildGraphFromSharedMemoryHelper(SharedMemoryHelper&& helper) {
   auto edge_type_to_id = DetensorizeDict(helper.ReadTorchTensorDict());
   auto node_attributes = helper.ReadTorchTensorDict();
   auto edge_attributes = helper.ReadTorchTensorDict();
+  auto compressed_indices = helper.ReadTorchTensor();
+  auto compressed_indices_offsets = helper.ReadTorchTensor();
   auto graph = c10::make_intrusive<FusedCSCSamplingGraph>(
       indptr.value(), indices.value(), node_type_offset, type_per_edge,
       node_type_to_id, edge_type_to_id, node_attributes, edge_attributes);
+  if (compressed_indices.has_value()) {
+    graph->SetCompressedIndices(
+        indices->scalar_type(), compressed_indices.value(),
+        compressed_indices_offsets.value());
+  }
   auto shared_memory = helper.ReleaseSharedMemory();
   graph->HoldSharedMemoryObject(
       std::move(shared_memory.first), std::move(shared_memory.second));
@@ -1041,6 +1309,8 @@ FusedCSCSamplingGraph::CopyToSharedMemory(
   helper.WriteTorchTensorDict(TensorizeDict(edge_type_to_id_));
   helper.WriteTorchTensorDict(node_attributes_);
   helper.WriteTorchTensorDict(edge_attributes_);
+  helper.WriteTorchTensor(compressed_indices_);
+  helper.WriteTorchTensor(compressed_indices_offsets_);
   helper.Flush();
   return BuildGraphFromSharedMemoryHelper(std::move(helper));
 }
@@ -1065,13 +1335,18 @@ void NumPick(
     int64_t num_neighbors, PickedNumType* picked_num_ptr) {
   int64_t num_valid_neighbors = num_neighbors;
   if (probs_or_mask.has_value() && num_neighbors > 0) {
-    // Subtract the count of zeros in probs_or_mask.
+    // Count the non-zeros in probs_or_mask, stopping as soon as the pick
+    // number is known so that hub nodes are not scanned entirely.
+    const int64_t limit = fanout == -1 ? num_neighbors : (replace ? 1 : fanout);
     AT_DISPATCH_ALL_TYPES(
-        probs_or_mask.value().scalar_type(), "CountZero", ([&] {
-          scalar_t* probs_data_ptr = probs_or_mask.value().data_ptr<scalar_t>();
-          num_valid_neighbors -= std::count(
-              probs_data_ptr + offset, probs_data_ptr + offset + num_neighbors,
-              0);
+        probs_or_mask.value().scalar_type(), "CountNonZero", ([&] {
+          const scalar_t* probs_data_ptr =
+              probs_or_mask.value().data_ptr<scalar_t>() + offset;
+          num_valid_neighbors = 0;
+          for (int64_t i = 0;
+               i < num_neighbors && num_valid_neighbors < limit; ++i) {
+            num_valid_neighbors += probs_data_ptr[i] != 0;
+          }
         }));
   }
   if (num_valid_neighbors == 0 || fanout == -1) {
@@ -1081,33 +1356,70 @@ void NumPick(
   }
 }
 
-torch::Tensor TemporalMask(
-    int64_t seed_timestamp, torch::Tensor csc_indices,
+/**
+ * @brief Get a thread-local scratch buffer with room for at least \p size
+ * elements. The buffer is reused by all the seeds sampled by a thread so that
+ * the per-seed pick kernels do not allocate. Buffers used at the same time
+ * need distinct tags.
+ */
+template <typename T, int Tag = 0>
+T* ThreadLocalBuffer(int64_t size) {
+  static thread_local std::unique_ptr<T[]> buffer;
+  static thread_local int64_t capacity = 0;
+  if (capacity < size) {
+    capacity = std::max(size, capacity * 2);
+    buffer.reset(new T[capacity]);
+  }
+  return buffer.get();
+}
+
+/**
+ * @brief Write the probabilities of the neighbors of a seed to
+ * \p masked_probs, with zeros for the neighbors violating the temporal
+ * constraints. The probabilities are 1 when \p probs_or_mask is not given.
+ *
+ * @return The number of neighbors with non-zero probability.
+ */
+template <typename ProbsType>
+int64_t TemporalMask(
+    int64_t seed_timestamp, const torch::Tensor& csc_indices,
     const torch::optional<int64_t>& seed_pre_time_window,
     const torch::optional<torch::Tensor>& probs_or_mask,
     const torch::optional<torch::Tensor>& node_timestamp,
-    const torch::optional<torch::Tensor>& edge_timestamp,
-    std::pair<int64_t, int64_t> edge_range) {
-  auto [l, r] = edge_range;
-  torch::Tensor mask = torch::ones({r - l}, torch::kBool);
-  if (node_timestamp.has_value()) {
-    auto neighbor_timestamp =
-        node_timestamp.value().index_select(0, csc_indices.slice(0, l, r));
-    mask &= neighbor_timestamp < seed_timestamp;
-    if (seed_pre_time_window.has_value())
-      mask &=
-          neighbor_timestamp > seed_timestamp - seed_pre_time_window.value();
-  }
-  if (edge_timestamp.has_value()) {
-    auto edge_ts = edge_timestamp.value().slice(0, l, r);
-    mask &= edge_ts < seed_timestamp;
-    if (seed_pre_time_window.has_value())
-      mask &= edge_ts > seed_timestamp - seed_pre_time_window.value();
-  }
-  if (probs_or_mask.has_value()) {
-    mask &= probs_or_mask.value().slice(0, l, r) != 0;
-  }
-  return mask;
+    const torch::optional<torch::Tensor>& edge_timestamp, int64_t offset,
+    int64_t num_neighbors, ProbsType* masked_probs) {
+  const int64_t* node_ts = node_timestamp.has_value()
+                               ? node_timestamp.value().data_ptr<int64_t>()
+                               : nullptr;
+  const int64_t* edge_ts =
+      edge_timestamp.has_value()
+          ? edge_timestamp.value().data_ptr<int64_t>() + offset
+          : nullptr;
+  const ProbsType* probs =
+      probs_or_mask.has_value()
+          ? probs_or_mask.value().data_ptr<ProbsType>() + offset
+          : nullptr;
+  // Timestamps in (lower, seed_timestamp) are valid.
+  const int64_t lower = seed_pre_time_window.has_value()
+                            ? seed_timestamp - seed_pre_time_window.value()
+                            : std::numeric_limits<int64_t>::min();
+  auto valid = [seed_timestamp, lower](int64_t ts) {
+    return ts < seed_timestamp && ts > lower;
+  };
+  int64_t num_valid = 0;
+  AT_DISPATCH_INDEX_TYPES(
+      csc_indices.scalar_type(), "TemporalMask", ([&] {
+        const index_t* indices = csc_indices.data_ptr<index_t>() + offset;
+        for (int64_t i = 0; i < num_neighbors; ++i) {
+          bool keep = true;
+          if (node_ts) keep = valid(node_ts[indices[i]]);
+          if (edge_ts) keep = keep && valid(edge_ts[i]);
+          const ProbsType prob = probs ? probs[i] : ProbsType(1);
+          masked_probs[i] = keep ? prob : ProbsType(0);
+          num_valid += masked_probs[i] != ProbsType(0);
+        }
+      }));
+  return num_valid;
 }
 
 /**
@@ -1199,11 +1511,17 @@ int64_t TemporalNumPick(
     time_window = utils::GetValueByIndex<int64_t>(
         seed_pre_time_window.value(), seed_offset);
   }
-  auto mask = TemporalMask(
-      utils::GetValueByIndex<int64_t>(seed_timestamp, seed_offset), csc_indics,
-      time_window, probs_or_mask, node_timestamp, edge_timestamp,
-      {offset, offset + num_neighbors});
-  int64_t num_valid_neighbors = utils::GetValueByIndex<int64_t>(mask.sum(), 0);
+  int64_t num_valid_neighbors;
+  AT_DISPATCH_FLOATING_TYPES(
+      probs_or_mask.has_value() ? probs_or_mask.value().scalar_type()
+                                : torch::kFloat32,
+      "TemporalNumPick", ([&] {
+        num_valid_neighbors = TemporalMask(
+            utils::GetValueByIndex<int64_t>(seed_timestamp, seed_offset),
+            csc_indics, time_window, probs_or_mask, node_timestamp,
+            edge_timestamp, offset, num_neighbors,
+            ThreadLocalBuffer<scalar_t>(num_neighbors));
+      }));
   if (num_valid_neighbors == 0 || fanout == -1) return num_valid_neighbors;
   return replace ? fanout : std::min(fanout, num_valid_neighbors);
 }
@@ -1318,11 +1636,11 @@ inline int64_t UniformPick(
     std::iota(picked_data_ptr, picked_data_ptr + num_neighbors, offset);
     return num_neighbors;
   } else if (replace) {
-    std::memcpy(
-        picked_data_ptr,
-        torch::randint(offset, offset + num_neighbors, {fanout}, options)
-            .data_ptr<PickedType>(),
-        fanout * sizeof(PickedType));
+    auto rng = RandomEngine::ThreadLocal();
+    for (int64_t i = 0; i < fanout; ++i) {
+      picked_data_ptr[i] =
+          rng->RandInt<int64_t>(offset, offset + num_neighbors);
+    }
     return fanout;
   } else {
     // We use different sampling strategies for different sampling case.
@@ -1347,18 +1665,18 @@ inline int64_t UniformPick(
       // Use this algorithm when `fanout >= num_neighbors / 10` to
       // reduce computation.
       // In this scenarios above, memory complexity is not a concern due
-      // to the small size of both `fanout` and `num_neighbors`. And it
-      // is efficient to allocate a small amount of memory. So the
+      // to the small size of both `fanout` and `num_neighbors`, and the
+      // memory is a thread-local buffer reused across seeds. So the
       // algorithm performence is great in this case.
-      std::vector<PickedType> seq(num_neighbors);
+      PickedType* seq = ThreadLocalBuffer<PickedType>(num_neighbors);
       // Assign the seq with [offset, offset + num_neighbors].
-      std::iota(seq.begin(), seq.end(), offset);
+      std::iota(seq, seq + num_neighbors, offset);
       for (int64_t i = 0; i < fanout; ++i) {
         auto j = RandomEngine::ThreadLocal()->RandInt(i, num_neighbors);
         std::swap(seq[i], seq[j]);
       }
       // Save the randomly sampled fanout elements to the output tensor.
-      std::copy(seq.begin(), seq.begin() + fanout, picked_data_ptr);
+      std::copy(seq, seq + fanout, picked_data_ptr);
       return fanout;
     } else if (fanout < 64) {
       // [Algorithm]
@@ -1398,7 +1716,8 @@ inline int64_t UniformPick(
       // would otherwise increase the sampling cost. By doing so, we
       // achieve a balance between theoretical efficiency and practical
       // performance.
-      std::unordered_set<PickedType> picked_set;
+      static thread_local std::unordered_set<PickedType> picked_set;
+      picked_set.clear();
       while (static_cast<int64_t>(picked_set.size()) < fanout) {
         picked_set.insert(RandomEngine::ThreadLocal()->RandInt(
             offset, offset + num_neighbors));
@@ -1409,101 +1728,198 @@ inline int64_t UniformPick(
   }
 }
 
-/** @brief An operator to perform non-uniform sampling. */
-static torch::Tensor NonUniformPickOp(
-    torch::Tensor probs, int64_t fanout, bool replace) {
-  auto positive_probs_indices = probs.nonzero().squeeze(1);
-  auto num_positive_probs = positive_probs_indices.size(0);
-  if (num_positive_probs == 0) return torch::empty({0}, torch::kLong);
+/**
+ * @brief Perform non-uniform sampling of the positions [0, num_neighbors)
+ * according to \p probs and write offset + position for every pick to
+ * \p picked_data_ptr. It works on raw pointers with thread-local scratch
+ * buffers, so that no memory is allocated per seed.
+ *
+ * @return The number of picked neighbors.
+ */
+template <typename ProbsType, typename PickedType>
+int64_t NonUniformPickOp(
+    const ProbsType* probs_data_ptr, int64_t num_neighbors, int64_t fanout,
+    bool replace, int64_t offset, PickedType* picked_data_ptr) {
+  int64_t* positive_probs_indices_ptr =
+      ThreadLocalBuffer<int64_t>(num_neighbors);
+  int64_t num_positive_probs = 0;
+  for (int64_t i = 0; i < num_neighbors; ++i) {
+    positive_probs_indices_ptr[num_positive_probs] = i;
+    num_positive_probs += probs_data_ptr[i] != 0;
+  }
+  if (num_positive_probs == 0) return 0;
   if ((fanout == -1) || (num_positive_probs <= fanout && !replace)) {
-    return positive_probs_indices;
+    for (int64_t i = 0; i < num_positive_probs; ++i) {
+      picked_data_ptr[i] = positive_probs_indices_ptr[i] + offset;
+    }
+    return num_positive_probs;
   }
   if (!replace) fanout = std::min(fanout, num_positive_probs);
-  if (fanout == 0) return torch::empty({0}, torch::kLong);
-  auto ret_tensor = torch::empty({fanout}, torch::kLong);
-  auto ret_ptr = ret_tensor.data_ptr<int64_t>();
-  AT_DISPATCH_FLOATING_TYPES(
-      probs.scalar_type(), "MultinomialSampling", ([&] {
-        auto probs_data_ptr = probs.data_ptr<scalar_t>();
-        auto positive_probs_indices_ptr =
-            positive_probs_indices.data_ptr<int64_t>();
-
-        if (!replace) {
-          // The algorithm is from gumbel softmax.
-          // s = argmax( logp - log(-log(eps)) ) where eps ~ U(0, 1).
-          // Here we can apply exp to the formula which will not affect result
-          // of argmax or topk. Then we have
-          // s = argmax( p / (-log(eps)) ) where eps ~ U(0, 1).
-          // We can also simplify the formula above by
-          // s = argmax( p / q ) where q ~ Exp(1).
-          if (fanout == 1) {
-            // Return argmax(p / q).
-            scalar_t max_prob = 0;
-            int64_t max_prob_index = -1;
-            // We only care about the neighbors with non-zero probability.
-            for (auto i = 0; i < num_positive_probs; ++i) {
-              // Calculate (p / q) for the current neighbor.
-              scalar_t current_prob =
-                  probs_data_ptr[positive_probs_indices_ptr[i]] /
-                  RandomEngine::ThreadLocal()->Exponential(1.);
-              if (current_prob > max_prob) {
-                max_prob = current_prob;
-                max_prob_index = positive_probs_indices_ptr[i];
-              }
-            }
-            ret_ptr[0] = max_prob_index;
-          } else {
-            // Return topk(p / q).
-            std::vector<std::pair<scalar_t, int64_t>> q(num_positive_probs);
-            for (auto i = 0; i < num_positive_probs; ++i) {
-              q[i].first = probs_data_ptr[positive_probs_indices_ptr[i]] /
-                           RandomEngine::ThreadLocal()->Exponential(1.);
-              q[i].second = positive_probs_indices_ptr[i];
-            }
-            if (fanout < num_positive_probs / 64) {
-              // Use partial_sort.
-              std::partial_sort(
-                  q.begin(), q.begin() + fanout, q.end(), std::greater{});
-              for (auto i = 0; i < fanout; ++i) {
-                ret_ptr[i] = q[i].second;
-              }
-            } else {
-              // Use nth_element.
-              std::nth_element(
-                  q.begin(), q.begin() + fanout - 1, q.end(), std::greater{});
-              for (auto i = 0; i < fanout; ++i) {
-                ret_ptr[i] = q[i].second;
-              }
-            }
-          }
-        } else {
-          // Calculate cumulative sum of probabilities.
-          std::vector<scalar_t> prefix_sum_probs(num_positive_probs);
-          scalar_t sum_probs = 0;
-          for (auto i = 0; i < num_positive_probs; ++i) {
-            sum_probs += probs_data_ptr[positive_probs_indices_ptr[i]];
-            prefix_sum_probs[i] = sum_probs;
-          }
-          // Normalize.
-          if ((sum_probs > 1.00001) || (sum_probs < 0.99999)) {
-            for (auto i = 0; i < num_positive_probs; ++i) {
-              prefix_sum_probs[i] /= sum_probs;
-            }
-          }
-          for (auto i = 0; i < fanout; ++i) {
-            // Sample a probability mass from a uniform distribution.
-            double uniform_sample =
-                RandomEngine::ThreadLocal()->Uniform(0., 1.);
-            // Use a binary search to find the index.
-            int sampled_index = std::lower_bound(
-                                    prefix_sum_probs.begin(),
-                                    prefix_sum_probs.end(), uniform_sample) -
-                                prefix_sum_probs.begin();
-            ret_ptr[i] = positive_probs_indices_ptr[sampled_index];
-          }
+  if (fanout == 0) return 0;
+  if (!replace) {
+    // The algorithm is from gumbel softmax.
+    // s = argmax( logp - log(-log(eps)) ) where eps ~ U(0, 1).
+    // Here we can apply exp to the formula which will not affect result
+    // of argmax or topk. Then we have
+    // s = argmax( p / (-log(eps)) ) where eps ~ U(0, 1).
+    // We can also simplify the formula above by
+    // s = argmax( p / q ) where q ~ Exp(1).
+    if (fanout == 1) {
+      // Return argmax(p / q).
+      ProbsType max_prob = 0;
+      int64_t max_prob_index = -1;
+      // We only care about the neighbors with non-zero probability.
+      for (int64_t i = 0; i < num_positive_probs; ++i) {
+        // Calculate (p / q) for the current neighbor.
+        ProbsType current_prob =
+            probs_data_ptr[positive_probs_indices_ptr[i]] /
+            RandomEngine::ThreadLocal()->Exponential(1.);
+        if (current_prob > max_prob) {
+          max_prob = current_prob;
+          max_prob_index = positive_probs_indices_ptr[i];
         }
-      }));
-  return ret_tensor;
+      }
+      picked_data_ptr[0] = max_prob_index + offset;
+    } else {
+      // Return topk(p / q).
+      auto q = ThreadLocalBuffer<std::pair<ProbsType, int64_t>>(
+          num_positive_probs);
+      for (int64_t i = 0; i < num_positive_probs; ++i) {
+        q[i].first = probs_data_ptr[positive_probs_indices_ptr[i]] /
+                     RandomEngine::ThreadLocal()->Exponential(1.);
+        q[i].second = positive_probs_indices_ptr[i];
+      }
+      if (fanout < num_positive_probs / 64) {
+        // Use partial_sort.
+        std::partial_sort(
+            q, q + fanout, q + num_positive_probs, std::greater{});
+      } else {
+        // Use nth_element.
+        std::nth_element(
+            q, q + fanout - 1, q + num_positive_probs, std::greater{});
+      }
+      for (int64_t i = 0; i < fanout; ++i) {
+        picked_data_ptr[i] = q[i].second + offset;
+      }
+    }
+  } else {
+    // Calculate cumulative sum of probabilities.
+    ProbsType* prefix_sum_probs =
+        ThreadLocalBuffer<ProbsType>(num_positive_probs);
+    ProbsType sum_probs = 0;
+    for (int64_t i = 0; i < num_positive_probs; ++i) {
+      sum_probs += probs_data_ptr[positive_probs_indices_ptr[i]];
+      prefix_sum_probs[i] = sum_probs;
+    }
+    // Normalize.
+    if ((sum_probs > 1.00001) || (sum_probs < 0.99999)) {
+      for (int64_t i = 0; i < num_positive_probs; ++i) {
+        prefix_sum_probs[i] /= sum_probs;
+      }
+    }
+    for (int64_t i = 0; i < fanout; ++i) {
+      // Sample a probability mass from a uniform distribution.
+      double uniform_sample = RandomEngine::ThreadLocal()->Uniform(0., 1.);
+      // Use a binary search to find the index.
+      int64_t sampled_index =
+          std::lower_bound(
+              prefix_sum_probs, prefix_sum_probs + num_positive_probs,
+              uniform_sample) -
+          prefix_sum_probs;
+      // Guard against rounding errors in the last prefix sum.
+      sampled_index = std::min(sampled_index, num_positive_probs - 1);
+      picked_data_ptr[i] = positive_probs_indices_ptr[sampled_index] + offset;
+    }
+  }
+  return fanout;
+}
+
+/**
+ * @brief Perform the same sampling as NonUniformPickOp with binary searches
+ * over \p prefix_sum, the exclusive cumulative sum of the probabilities of the
+ * neighbors of the seed node starting at the first neighbor to pick from, such
+ * that the probabilities of the neighbors are not scanned.
+ *
+ * Sampling without replacement draws with replacement and rejects the
+ * neighbors picked already, which is equivalent to the Gumbel top-k of
+ * NonUniformPickOp. If too many draws get rejected because the picked
+ * neighbors hold most of the probability mass, the remaining picks are made by
+ * NonUniformPickOp over the neighbors not picked yet. NonUniformPickOp is used
+ * directly whenever it would have to scan all the neighbors anyway.
+ *
+ * @return The number of picked neighbors.
+ */
+template <typename ProbsType, typename PickedType>
+int64_t PrefixSumPickOp(
+    const ProbsType* probs_data_ptr, const double* prefix_sum,
+    int64_t num_neighbors, int64_t fanout, bool replace, int64_t offset,
+    PickedType* picked_data_ptr) {
+  // Rejection sampling checks the picks for duplicates linearly, hence it is
+  // only used for small fanouts that are far from the number of neighbors.
+  constexpr int64_t kMaxRejectionFanout = 128;
+  constexpr int64_t kMinRejectionRatio = 8;
+  // The prefix sum of an edge type of a node starts after the sum of the
+  // preceding edge types.
+  const double base = prefix_sum[0];
+  const double end_sum = prefix_sum[num_neighbors - 1] +
+                         static_cast<double>(probs_data_ptr[num_neighbors - 1]);
+  const double total = end_sum - base;
+  if (fanout == -1 || !(total > 0) ||
+      (!replace && (fanout > kMaxRejectionFanout ||
+                    fanout * kMinRejectionRatio > num_neighbors))) {
+    return NonUniformPickOp(
+        probs_data_ptr, num_neighbors, fanout, replace, offset,
+        picked_data_ptr);
+  }
+  // The last neighbor with non-zero probability, which also absorbs draws
+  // past the end due to rounding errors.
+  const int64_t last =
+      std::lower_bound(prefix_sum, prefix_sum + num_neighbors, end_sum) -
+      prefix_sum - 1;
+  auto rng = RandomEngine::ThreadLocal();
+  auto draw = [&] {
+    const double mass = base + rng->Uniform(0., total);
+    return std::upper_bound(prefix_sum, prefix_sum + last + 1, mass) -
+           prefix_sum - 1;
+  };
+  if (replace) {
+    for (int64_t i = 0; i < fanout; ++i) {
+      picked_data_ptr[i] = draw() + offset;
+    }
+    return fanout;
+  }
+  int64_t num_positive_probs = 0;
+  for (int64_t i = 0; i < num_neighbors && num_positive_probs <= fanout; ++i) {
+    num_positive_probs += probs_data_ptr[i] != 0;
+  }
+  if (num_positive_probs <= fanout) {
+    return NonUniformPickOp(
+        probs_data_ptr, num_neighbors, fanout, replace, offset,
+        picked_data_ptr);
+  }
+  const int64_t max_rejections = fanout + 16;
+  int64_t num_picked = 0;
+  for (int64_t num_rejections = 0;
+       num_picked < fanout && num_rejections < max_rejections;) {
+    const PickedType picked = draw() + offset;
+    if (std::find(picked_data_ptr, picked_data_ptr + num_picked, picked) ==
+        picked_data_ptr + num_picked) {
+      picked_data_ptr[num_picked++] = picked;
+    } else {
+      ++num_rejections;
+    }
+  }
+  if (num_picked < fanout) {
+    ProbsType* remaining_probs = ThreadLocalBuffer<ProbsType, 1>(num_neighbors);
+    std::copy(probs_data_ptr, probs_data_ptr + num_neighbors, remaining_probs);
+    for (int64_t i = 0; i < num_picked; ++i) {
+      remaining_probs[picked_data_ptr[i] - offset] = 0;
+    }
+    num_picked += NonUniformPickOp(
+        remaining_probs, num_neighbors, fanout - num_picked, replace, offset,
+        picked_data_ptr + num_picked);
+  }
+  return num_picked;
 }
 
 /**
@@ -1538,6 +1954,9 @@ static torch::Tensor NonUniformPickOp(
  * probabilities associated with each neighboring edge of a node in the original
  * graph. It must be a 1D floating-point tensor with the number of elements
  * equal to the number of edges in the graph.
+ * @param probs_prefix_sum Optional exclusive cumulative sum of the
+ * probabilities of the edges of every node. If given, the probabilities are
+ * not scanned when possible.
  * @param picked_data_ptr The destination address where the picked neighbors
  * should be put. Enough memory space should be allocated in advance.
  */
@@ -1545,18 +1964,23 @@ template <typename PickedType>
 inline int64_t NonUniformPick(
     int64_t offset, int64_t num_neighbors, int64_t fanout, bool replace,
     const torch::TensorOptions& options, const torch::Tensor& probs_or_mask,
-    PickedType* picked_data_ptr) {
-  auto local_probs =
-      probs_or_mask.size(0) > num_neighbors
-          ? probs_or_mask.slice(0, offset, offset + num_neighbors)
-          : probs_or_mask;
-  auto picked_indices = NonUniformPickOp(local_probs, fanout, replace);
-  auto picked_indices_ptr = picked_indices.data_ptr<int64_t>();
-  for (int i = 0; i < picked_indices.numel(); ++i) {
-    picked_data_ptr[i] =
-        static_cast<PickedType>(picked_indices_ptr[i]) + offset;
-  }
-  return picked_indices.numel();
+    const double* probs_prefix_sum, PickedType* picked_data_ptr) {
+  int64_t picked_count;
+  AT_DISPATCH_FLOATING_TYPES(
+      probs_or_mask.scalar_type(), "MultinomialSampling", ([&] {
+        const scalar_t* local_probs = probs_or_mask.data_ptr<scalar_t>();
+        if (probs_or_mask.size(0) > num_neighbors) local_probs += offset;
+        if (probs_prefix_sum != nullptr) {
+          picked_count = PrefixSumPickOp(
+              local_probs, probs_prefix_sum + offset, num_neighbors, fanout,
+              replace, offset, picked_data_ptr);
+        } else {
+          picked_count = NonUniformPickOp(
+              local_probs, num_neighbors, fanout, replace, offset,
+              picked_data_ptr);
+        }
+      }));
+  return picked_count;
 }
 
 template <typename PickedType>
@@ -1569,7 +1993,7 @@ int64_t Pick(
   if (probs_or_mask.has_value()) {
     return NonUniformPick(
         offset, num_neighbors, fanout, replace, options, probs_or_mask.value(),
-        picked_data_ptr);
+        args.probs_prefix_sum, picked_data_ptr);
   } else {
     return UniformPick(
         offset, num_neighbors, fanout, replace, options, picked_data_ptr);
@@ -1604,31 +2028,32 @@ int64_t TemporalPick(
     time_window = utils::GetValueByIndex<int64_t>(
         seed_pre_time_window.value(), seed_offset);
   }
-  auto mask = TemporalMask(
-      utils::GetValueByIndex<int64_t>(seed_timestamp, seed_offset), csc_indices,
-      time_window, probs_or_mask, node_timestamp, edge_timestamp,
-      {offset, offset + num_neighbors});
-  torch::Tensor masked_prob;
-  if (probs_or_mask.has_value()) {
-    masked_prob =
-        probs_or_mask.value().slice(0, offset, offset + num_neighbors) * mask;
-  } else {
-    masked_prob = S == SamplerType::NEIGHBOR ? mask.to(torch::kFloat32) : mask;
-  }
-  if constexpr (S == SamplerType::NEIGHBOR) {
-    auto picked_indices = NonUniformPickOp(masked_prob, fanout, replace);
-    auto picked_indices_ptr = picked_indices.data_ptr<int64_t>();
-    for (int i = 0; i < picked_indices.numel(); ++i) {
-      picked_data_ptr[i] =
-          static_cast<PickedType>(picked_indices_ptr[i]) + offset;
-    }
-    return picked_indices.numel();
-  }
-  if constexpr (is_labor(S)) {
-    return Pick(
-        offset, num_neighbors, fanout, replace, options, masked_prob, args,
-        picked_data_ptr);
-  }
+  // The masked probabilities are kept in a thread-local buffer, which is
+  // wrapped into a tensor without copying for the LABOR samplers.
+  const auto probs_type = probs_or_mask.has_value()
+                              ? probs_or_mask.value().scalar_type()
+                              : torch::kFloat32;
+  int64_t picked_count = 0;
+  AT_DISPATCH_FLOATING_TYPES(
+      probs_type, "TemporalPick", ([&] {
+        scalar_t* masked_prob = ThreadLocalBuffer<scalar_t, 1>(num_neighbors);
+        TemporalMask(
+            utils::GetValueByIndex<int64_t>(seed_timestamp, seed_offset),
+            csc_indices, time_window, probs_or_mask, node_timestamp,
+            edge_timestamp, offset, num_neighbors, masked_prob);
+        if constexpr (S == SamplerType::NEIGHBOR) {
+          picked_count = NonUniformPickOp(
+              masked_prob, num_neighbors, fanout, replace, offset,
+              picked_data_ptr);
+        }
+        if constexpr (is_labor(S)) {
+          picked_count = Pick(
+              offset, num_neighbors, fanout, replace, options,
+              torch::from_blob(masked_prob, {num_neighbors}, probs_type), args,
+              picked_data_ptr);
+        }
+      }));
+  return picked_count;
 }
 
 template <SamplerType S, typename PickedType>
@@ -1743,7 +2168,8 @@ std::enable_if_t<is_labor(S), int64_t> Pick(
     if (fanout < 0) {
       return NonUniformPick(
           offset, num_neighbors, fanout, replace, options,
-          probs_or_mask.value(), picked_data_ptr);
+          probs_or_mask.value(), /* probs_prefix_sum= */ nullptr,
+          picked_data_ptr);
     } else {
       int64_t picked_count;
       GRAPHBOLT_DISPATCH_ALL_TYPES(
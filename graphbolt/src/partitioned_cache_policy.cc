@@ -55,7 +55,7 @@ torch::Tensor AddOffset(torch::Tensor keys, int64_t offset) {
 template <typename CachePolicy>
 PartitionedCachePolicy::PartitionedCachePolicy(
     CachePolicy, int64_t capacity, int64_t num_partitions)
-    : capacity_(capacity) {
+    : capacity_(capacity), thread_safe_(CachePolicy::kThreadSafe) {
   TORCH_CHECK(num_partitions >= 1, "# partitions need to be positive.");
   for (int64_t i = 0; i < num_partitions; i++) {
     const auto begin = i * capacity / num_partitions;
@@ -143,7 +143,7 @@ std::tuple<
 PartitionedCachePolicy::Query(torch::Tensor keys, const int64_t offset) {
   keys = AddOffset(keys, offset);
   if (policies_.size() == 1) {
-    std::lock_guard lock(mtx_);
+    auto lock = Lock();
     auto [positions, output_indices, missing_keys, found_pointers] =
         policies_[0]->Query(keys);
     auto found_and_missing_offsets = torch::empty(4, found_pointers.options());
@@ -173,7 +173,7 @@ PartitionedCachePolicy::Query(torch::Tensor keys, const int64_t offset) {
   auto result_offsets = result_offsets_tensor.data_ptr<int64_t>();
   namespace gb = graphbolt;
   {
-    std::lock_guard lock(mtx_);
+    auto lock = Lock();
     gb::parallel_for_each(0, policies_.size(), 1, [&](int64_t tid) {
       const auto begin = offsets_ptr[tid];
       const auto end = offsets_ptr[tid + 1];
@@ -260,7 +260,7 @@ PartitionedCachePolicy::QueryAndReplace(
     torch::Tensor keys, const int64_t offset) {
   keys = AddOffset(keys, offset);
   if (policies_.size() == 1) {
-    std::lock_guard lock(mtx_);
+    auto lock = Lock();
     auto [positions, output_indices, pointers, missing_keys] =
         policies_[0]->QueryAndReplace(keys);
     auto found_and_missing_offsets = torch::empty(4, pointers.options());
@@ -290,7 +290,7 @@ PartitionedCachePolicy::QueryAndReplace(
   auto result_offsets = result_offsets_tensor.data_ptr<int64_t>();
   namespace gb = graphbolt;
   {
-    std::lock_guard lock(mtx_);
+    auto lock = Lock();
     gb::parallel_for_each(0, policies_.size(), 1, [&](int64_t tid) {
       const auto begin = offsets_ptr[tid];
       const auto end = offsets_ptr[tid + 1];
@@ -389,7 +389,7 @@ PartitionedCachePolicy::Replace(
     const int64_t offset) {
   keys = AddOffset(keys, offset);
   if (policies_.size() == 1) {
-    std::lock_guard lock(mtx_);
+    auto lock = Lock();
     auto [positions, pointers] = policies_[0]->Replace(keys);
     if (!offsets.has_value()) {
       offsets = torch::empty(2, pointers.options());
@@ -419,7 +419,7 @@ PartitionedCachePolicy::Replace(
   auto output_positions_ptr = output_positions.data_ptr<int64_t>();
   auto output_pointers_ptr = output_pointers.data_ptr<int64_t>();
   namespace gb = graphbolt;
-  std::unique_lock lock(mtx_);
+  auto lock = Lock();
   std::atomic<size_t> semaphore = policies_.size();
   gb::parallel_for_each(0, policies_.size(), 1, [&](int64_t tid) {
     const auto begin = offsets_ptr[tid];
@@ -427,7 +427,7 @@ PartitionedCachePolicy::Replace(
     auto [positions, pointers] =
         policies_.at(tid)->Replace(permuted_keys.slice(0, begin, end));
     const auto ticket = semaphore.fetch_add(-1, std::memory_order_release) - 1;
-    if (ticket == 0) {
+    if (ticket == 0 && lock.owns_lock()) {
       // This thread was the last thread in the critical region.
       lock.unlock();
     }
@@ -492,6 +492,23 @@ void PartitionedCachePolicy::WritingCompleted(
   ReadingWritingCompletedImpl<true>(pointers, offsets);
 }
 
+void PartitionedCachePolicy::WritingAborted(
+    torch::Tensor pointers, torch::Tensor offsets) {
+  if (policies_.size() == 1) {
+    auto lock = Lock();
+    policies_[0]->WritingAborted(pointers);
+    return;
+  }
+  auto offsets_ptr = offsets.data_ptr<int64_t>();
+  namespace gb = graphbolt;
+  auto lock = Lock();
+  gb::parallel_for_each(0, policies_.size(), 1, [&](int64_t tid) {
+    const auto begin = offsets_ptr[tid];
+    const auto end = offsets_ptr[tid + 1];
+    policies_.at(tid)->WritingAborted(pointers.slice(0, begin, end));
+  });
+}
+
 c10::intrusive_ptr<Future<void>> PartitionedCachePolicy::ReadingCompletedAsync(
     torch::Tensor pointers, torch::Tensor offsets) {
   return async([=] { return ReadingCompleted(pointers, offsets); });
@@ -518,6 +535,9 @@ template c10::intrusive_ptr<PartitionedCachePolicy>
     PartitionedCachePolicy::Create<LruCachePolicy>(int64_t, int64_t);
 template c10::intrusive_ptr<PartitionedCachePolicy>
     PartitionedCachePolicy::Create<ClockCachePolicy>(int64_t, int64_t);
+template c10::intrusive_ptr<PartitionedCachePolicy>
+    PartitionedCachePolicy::Create<ConcurrentClockCachePolicy>(
+        int64_t, int64_t);
 
 }  // namespace storage
 }  // namespace graphbolt
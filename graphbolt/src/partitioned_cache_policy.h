@@ -40,7 +40,8 @@ namespace storage {
  * number of partitions that is provided as the second argument of its
  * constructor. Since the partitioning is random but deterministic, the caching
  * policy performance is not affected as the key distribution stays the same in
- * each partition.
+ * each partition. The calls are serialized with a mutex unless the policy is
+ * thread-safe, see BaseCachePolicy::kThreadSafe.
  **/
 class PartitionedCachePolicy : public torch::CustomClassHolder {
  public:
@@ -136,6 +137,15 @@ class PartitionedCachePolicy : public torch::CustomClassHolder {
    */
   void WritingCompleted(torch::Tensor pointers, torch::Tensor offsets);
 
+  /**
+   * @brief A writer has failed to write these keys, so they are removed from
+   * the cache. Unlike WritingCompleted, it modifies the policies and needs the
+   * lock.
+   * @param pointers The CacheKey pointers in the cache to remove.
+   * @param offsets The partition offsets for the pointers.
+   */
+  void WritingAborted(torch::Tensor pointers, torch::Tensor offsets);
+
   c10::intrusive_ptr<Future<void>> ReadingCompletedAsync(
       torch::Tensor pointers, torch::Tensor offsets);
 
@@ -170,7 +180,16 @@ class PartitionedCachePolicy : public torch::CustomClassHolder {
   std::tuple<torch::Tensor, torch::Tensor, torch::Tensor> Partition(
       torch::Tensor keys);
 
+  /**
+   * @brief Locks mtx_ unless the policies are thread-safe.
+   */
+  std::unique_lock<std::mutex> Lock() {
+    if (thread_safe_) return std::unique_lock(mtx_, std::defer_lock);
+    return std::unique_lock(mtx_);
+  }
+
   int64_t capacity_;
+  bool thread_safe_;
   std::vector<std::unique_ptr<BaseCachePolicy>> policies_;
   std::mutex mtx_;
 };
@@ -13,6 +13,7 @@
 #include "./cuda/cooperative_minibatching_utils.h"
 #include "./cuda/max_uva_threads.h"
 #endif
+#include "./cached_ondisk_npy_array.h"
 #include "./cnumpy.h"
 #include "./feature_cache.h"
 #include "./index_select.h"
@@ -51,6 +52,11 @@ TORCH_LIBRARY(graphbolt, m) {
   m.class_<Future<c10::intrusive_ptr<FusedSampledSubgraph>>>(
        "FusedSampledSubgraphFuture")
       .def("wait", &Future<c10::intrusive_ptr<FusedSampledSubgraph>>::Wait);
+  m.class_<Future<std::vector<c10::intrusive_ptr<FusedSampledSubgraph>>>>(
+       "FusedSampledSubgraphListFuture")
+      .def(
+          "wait",
+          &Future<std::vector<c10::intrusive_ptr<FusedSampledSubgraph>>>::Wait);
   m.class_<Future<std::vector<
       std::tuple<torch::Tensor, torch::Tensor, torch::Tensor, torch::Tensor>>>>(
        "UniqueAndCompactBatchedFuture")
@@ -78,12 +84,20 @@ TORCH_LIBRARY(graphbolt, m) {
           "wait",
           &Future<std::tuple<torch::Tensor, std::vector<torch::Tensor>>>::Wait);
   m.class_<storage::OnDiskNpyArray>("OnDiskNpyArray")
-      .def("index_select", &storage::OnDiskNpyArray::IndexSelect);
+      .def("index_select", &storage::OnDiskNpyArray::IndexSelect)
+      .def("read_statistics", &storage::OnDiskNpyArray::ReadStatistics)
+      .def(
+          "reset_read_statistics",
+          &storage::OnDiskNpyArray::ResetReadStatistics);
   m.class_<FusedCSCSamplingGraph>("FusedCSCSamplingGraph")
       .def("num_nodes", &FusedCSCSamplingGraph::NumNodes)
       .def("num_edges", &FusedCSCSamplingGraph::NumEdges)
       .def("csc_indptr", &FusedCSCSamplingGraph::CSCIndptr)
       .def("indices", &FusedCSCSamplingGraph::Indices)
+      .def("compressed_indices", &FusedCSCSamplingGraph::CompressedIndices)
+      .def(
+          "compressed_indices_offsets",
+          &FusedCSCSamplingGraph::CompressedIndicesOffsets)
       .def("node_type_offset", &FusedCSCSamplingGraph::NodeTypeOffset)
       .def("type_per_edge", &FusedCSCSamplingGraph::TypePerEdge)
       .def("node_type_to_id", &FusedCSCSamplingGraph::NodeTypeToID)
@@ -102,11 +116,21 @@ TORCH_LIBRARY(graphbolt, m) {
       .def("set_edge_attributes", &FusedCSCSamplingGraph::SetEdgeAttributes)
       .def("add_node_attribute", &FusedCSCSamplingGraph::AddNodeAttribute)
       .def("add_edge_attribute", &FusedCSCSamplingGraph::AddEdgeAttribute)
+      .def(
+          "build_probs_prefix_sum",
+          &FusedCSCSamplingGraph::BuildProbsPrefixSum)
+      .def("compress_indices", &FusedCSCSamplingGraph::CompressIndices)
       .def("in_subgraph", &FusedCSCSamplingGraph::InSubgraph)
       .def("sample_neighbors", &FusedCSCSamplingGraph::SampleNeighbors)
       .def(
           "sample_neighbors_async",
           &FusedCSCSamplingGraph::SampleNeighborsAsync)
+      .def(
+          "sample_neighbors_multi_hop",
+          &FusedCSCSamplingGraph::SampleNeighborsMultiHop)
+      .def(
+          "sample_neighbors_multi_hop_async",
+          &FusedCSCSamplingGraph::SampleNeighborsMultiHopAsync)
       .def(
           "temporal_sample_neighbors",
           &FusedCSCSamplingGraph::TemporalSampleNeighbors)
@@ -174,6 +198,10 @@ TORCH_LIBRARY(graphbolt, m) {
   m.def(
       "clock_cache_policy",
       &storage::PartitionedCachePolicy::Create<storage::ClockCachePolicy>);
+  m.def(
+      "concurrent_clock_cache_policy",
+      &storage::PartitionedCachePolicy::Create<
+          storage::ConcurrentClockCachePolicy>);
   m.class_<storage::FeatureCache>("FeatureCache")
       .def("is_pinned", &storage::FeatureCache::IsPinned)
       .def_property("nbytes", &storage::FeatureCache::NumBytes)
@@ -183,6 +211,13 @@ TORCH_LIBRARY(graphbolt, m) {
       .def("replace", &storage::FeatureCache::Replace)
       .def("replace_async", &storage::FeatureCache::ReplaceAsync);
   m.def("feature_cache", &storage::FeatureCache::Create);
+  m.class_<storage::CachedOnDiskNpyArray>("CachedOnDiskNpyArray")
+      .def("index_select", &storage::CachedOnDiskNpyArray::IndexSelect)
+      .def(
+          "index_select_async",
+          &storage::CachedOnDiskNpyArray::IndexSelectAsync)
+      .def("statistics", &storage::CachedOnDiskNpyArray::Statistics);
+  m.def("cached_ondisk_npy_array", &storage::CachedOnDiskNpyArray::Create);
   m.def(
       "load_from_shared_memory", &FusedCSCSamplingGraph::LoadFromSharedMemory);
   m.def("unique_and_compact", &UniqueAndCompact);
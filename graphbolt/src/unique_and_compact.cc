@@ -36,7 +36,7 @@ UniqueAndCompact(
       ids.scalar_type(), "unique_and_compact", ([&] {
         ConcurrentIdHashMap<index_t> id_map(ids, num_dst);
         return std::make_tuple(
-            id_map.GetUniqueIds(), id_map.MapIds(src_ids),
+            id_map.GetUniqueIds(), id_map.MapInsertedIds(num_dst),
             id_map.MapIds(dst_ids));
       }));
   auto offsets = torch::zeros(2, c10::TensorOptions().dtype(torch::kInt64));
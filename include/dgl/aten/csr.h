@@ -802,11 +802,13 @@ COOMatrix CSRRowWiseSamplingBiased(
  * given sparse matrix using rejection sampling.
  *
  * @note The number of samples returned may not necessarily be the number of
- * samples given.
+ * samples given. On CPU, the pairs are drawn in rounds until there are enough
+ * of them, so fewer are returned only when the matrix has few non-entries.
  *
  * @param csr The CSR matrix.
  * @param num_samples The number of samples.
- * @param num_trials The number of trials.
+ * @param num_trials The number of trials of each pair on GPU, and the maximum
+ * number of rounds on CPU.
  * @param exclude_self_loops Do not include the examples where the row equals
  * the column.
  * @param replace Whether to sample with replacement.
@@ -818,6 +820,27 @@ std::pair<IdArray, IdArray> CSRGlobalUniformNegativeSampling(
     const CSRMatrix& csr, int64_t num_samples, int num_trials,
     bool exclude_self_loops, bool replace, double redundancy);
 
+/**
+ * @brief For each given row, uniformly sample \a k columns whose entries do not
+ * exist in the given sparse matrix using rejection sampling. The column of a
+ * sample is redrawn up to \a num_trials times.
+ *
+ * @note The samples that fail all their trials are dropped, so fewer than
+ * `len(rows) * k` samples are returned only for rows with few non-neighbors.
+ *
+ * @param csr The CSR matrix, whose columns should be sorted.
+ * @param rows The rows to sample the columns of.
+ * @param k The number of samples per row.
+ * @param num_trials The number of trials per sample.
+ * @param exclude_self_loops Do not include the examples where the row equals
+ * the column.
+ * @return A pair of row and column tensors, the k samples of each row being
+ * contiguous.
+ */
+std::pair<IdArray, IdArray> CSRPerSourceUniformNegativeSampling(
+    const CSRMatrix& csr, IdArray rows, int64_t k, int num_trials,
+    bool exclude_self_loops);
+
 /**
  * @brief Sort the column index according to the tag of each column.
  *
@@ -38,6 +38,28 @@ std::pair<IdArray, IdArray> GlobalUniformNegativeSampling(
     HeteroGraphPtr hg, dgl_type_t etype, int64_t num_samples, int num_trials,
     bool exclude_self_loops, bool replace, double redundancy);
 
+/**
+ * @brief Given an edge type and source nodes, uniformly sample \a k
+ * destinations for each source node that do not have an edge from it using
+ * rejection sampling. The source nodes are preserved, so that the sampled
+ * pairs follow the source degree distribution of the positive edges when the
+ * sources are the ones of the positive edges.
+ *
+ * @note This function requires sorting the CSR matrix of the graph in-place.
+ *
+ * @param hg The graph.
+ * @param etype The edge type.
+ * @param src The source nodes.
+ * @param k The number of negative examples per source node.
+ * @param num_trials The number of rejection sampling trials per example.
+ * @param exclude_self_loops Do not include the examples where the source equals
+ * the destination.
+ * @return The pair of source and destination tensors.
+ */
+std::pair<IdArray, IdArray> PerSourceUniformNegativeSampling(
+    HeteroGraphPtr hg, dgl_type_t etype, IdArray src, int64_t k,
+    int num_trials, bool exclude_self_loops);
+
 };  // namespace sampling
 };  // namespace dgl
 
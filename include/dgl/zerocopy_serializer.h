@@ -146,6 +146,24 @@ class StreamWithBuffer : public dmlc::SeekStream {
     }
   }
 
+  /**
+   * @brief Construct stream backed up by a buffer, and reconstruct NDArrays as
+   * views of the tensors in tensor_list, which keep their data alive.
+   * @param p_buffer buffer pointer
+   * @param size buffer size
+   * @param tensor_list tensors holding the data of the NDArrays to deconstruct
+   * from
+   */
+  StreamWithBuffer(
+      char* p_buffer, size_t size,
+      const std::vector<runtime::NDArray>& tensor_list)
+      : strm_(new dmlc::MemoryFixedSizeStream(p_buffer, size)),
+        send_to_remote_(true) {
+    for (const auto& tensor : tensor_list) {
+      buffer_list_.emplace_back(tensor, tensor->data, tensor.GetSize());
+    }
+  }
+
   // delegate methods to strm_
   virtual size_t Read(void* ptr, size_t size) { return strm_->Read(ptr, size); }
   virtual void Write(const void* ptr, size_t size) { strm_->Write(ptr, size); }
@@ -164,7 +182,8 @@ class StreamWithBuffer : public dmlc::SeekStream {
 
   /**
    * @brief pop NDArray from stream
-   * If send_to_remote=true, the NDArray will be reconstructed from buffer list
+   * If send_to_remote=true, the NDArray will be reconstructed from buffer list,
+   * as a view of the buffer tensor if there is one
    * If send_to_remote=false, the NDArray will be reconstructed from shared
    * memory
    */
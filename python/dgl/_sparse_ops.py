@@ -153,6 +153,111 @@ def _edge_softmax_forward(gidx, e, op):
     return myout
 
 
+def _edge_softmax_spmm_forward(gidx, u, e):
+    r"""Edge softmax weighted SpMM forward interface.
+
+    Computes ``u_mul_e_sum(u, edge_softmax(e))`` in a single pass over the
+    incoming edges of every destination node without materializing the
+    softmax scores.
+
+    Parameters
+    ----------
+    gidx : HeteroGraphIndex
+        The input graph index.
+    u : tensor
+        The feature on source nodes.
+    e : tensor
+        The logits on edges.
+
+    Returns
+    -------
+    tuple
+        The result feature on destination nodes, followed by the maximum
+        logit and the sum of the exponentials of the shifted logits on the
+        destination nodes, which are needed by the backward.
+
+    Notes
+    -----
+    This function does not support gpu op.
+    """
+    if gidx.number_of_etypes() != 1:
+        raise DGLError(
+            "We only support edge_softmax_spmm on graph with one edge type"
+        )
+    if F.dtype(u) != F.dtype(e):
+        raise DGLError(
+            "The node features' data type {} doesn't match edge"
+            " features' data type {}, please convert them to the"
+            " same type.".format(F.dtype(u), F.dtype(e))
+        )
+    ctx = F.context(u)
+    dtype = F.dtype(u)
+    _, dsttype = gidx.metagraph.find_edge(0)
+    num_dst = gidx.num_nodes(dsttype)
+    v_shp = (num_dst,) + infer_broadcast_shape(
+        "mul", F.shape(u)[1:], F.shape(e)[1:]
+    )
+    v = F.zeros(v_shp, dtype, ctx)
+    emax = F.zeros((num_dst,) + F.shape(e)[1:], dtype, ctx)
+    esum = F.zeros((num_dst,) + F.shape(e)[1:], dtype, ctx)
+    if gidx.num_edges(0) > 0:
+        _CAPI_DGLKernelEdge_softmax_spmm_forward(
+            gidx,
+            to_dgl_nd(u),
+            to_dgl_nd(e),
+            to_dgl_nd_for_write(v),
+            to_dgl_nd_for_write(emax),
+            to_dgl_nd_for_write(esum),
+        )
+    return v, emax, esum
+
+
+def _edge_softmax_spmm_backward(gidx, u, e, v, emax, esum, grad_v):
+    r"""Edge softmax weighted SpMM backward interface.
+
+    Parameters
+    ----------
+    gidx : HeteroGraphIndex
+        The input graph index.
+    u : tensor
+        The feature on source nodes.
+    e : tensor
+        The logits on edges.
+    v : tensor
+        The result of the forward.
+    emax : tensor
+        The maximum logit on destination nodes returned by the forward.
+    esum : tensor
+        The softmax denominator on destination nodes returned by the forward.
+    grad_v : tensor
+        The gradient of the result.
+
+    Returns
+    -------
+    tuple
+        The gradients of ``u`` and ``e``.
+
+    Notes
+    -----
+    This function does not support gpu op.
+    """
+    grad_u = F.zeros_like(u)
+    grad_e = F.zeros_like(e)
+    if gidx.num_edges(0) > 0:
+        _CAPI_DGLKernelEdge_softmax_spmm_backward(
+            gidx,
+            to_dgl_nd(u),
+            to_dgl_nd(e),
+            to_dgl_nd(v),
+            to_dgl_nd(emax),
+            to_dgl_nd(esum),
+            to_dgl_nd(grad_v),
+            to_dgl_nd_for_write(grad_u),
+            to_dgl_nd_for_write(grad_e),
+        )
+    return grad_u, grad_e
+
+
 def _gspmm(gidx, op, reduce_op, u, e):
     r"""Generalized Sparse Matrix Multiplication interface. It takes the result of
     :attr:`op` on source node feature and edge feature, leads to a message on edge.
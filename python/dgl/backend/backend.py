@@ -1796,6 +1796,35 @@ def edge_softmax(gidx, logits, eids, norm_by):
     pass
 
 
+def edge_softmax_spmm(gidx, logits, ufeat):
+    r"""Aggregate source node features weighted by the edge softmax.
+
+    For a node :math:`i`, it computes
+
+    .. math::
+      h_i = \sum_{j\in\mathcal{N}(i)} a_{ij} x_j, \quad
+      a_{ij} = \frac{\exp(z_{ij})}{\sum_{j\in\mathcal{N}(i)}\exp(z_{ij})}
+
+    which is equivalent to ``gspmm(gidx, "mul", "sum", ufeat,
+    edge_softmax(gidx, logits))``, but the softmax scores are not stored.
+
+    Parameters
+    ----------
+    gidx : HeteroGraphIndex
+        The graph to perform the aggregation on.
+    logits : Tensor
+        The input edge feature.
+    ufeat : Tensor
+        The source node feature, broadcastable with the logits.
+
+    Returns
+    -------
+    Tensor
+        The aggregated feature on destination nodes.
+    """
+    pass
+
+
 def edge_softmax_hetero(gidx, eids, norm_by, *logits):
     r"""Compute edge softmax.
 
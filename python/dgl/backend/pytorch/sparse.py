@@ -7,6 +7,8 @@ from ..._sparse_ops import (
     _csrsum,
     _edge_softmax_backward,
     _edge_softmax_forward,
+    _edge_softmax_spmm_backward,
+    _edge_softmax_spmm_forward,
     _gather_mm,
     _gather_mm_scatter,
     _gsddmm,
@@ -30,6 +32,7 @@ __all__ = [
     "gsddmm_hetero",
     "edge_softmax",
     "edge_softmax_hetero",
+    "edge_softmax_spmm",
     "segment_reduce",
     "scatter_add",
     "csrmm",
@@ -825,6 +828,49 @@ class EdgeSoftmax_hetero(th.autograd.Function):
         return (None, None, None) + grad_score
 
 
+class EdgeSoftmaxSpMM(th.autograd.Function):
+    @staticmethod
+    def forward(ctx, gidx, score, X):
+        """Forward function.
+
+        Pseudo-code:
+
+        .. code:: python
+
+            a = edge_softmax(g, score)
+            out = u_mul_e_sum(g, X, a)
+            return out
+
+        The kernel computes the softmax online while aggregating, so ``a`` is
+        never materialized. Only the per-node maximum and denominator of the
+        softmax are kept for the backward.
+        """
+        out, score_max, score_sum = _edge_softmax_spmm_forward(gidx, X, score)
+        ctx.backward_cache = gidx
+        ctx.save_for_backward(score, X, out, score_max, score_sum)
+        return out
+
+    @staticmethod
+    def backward(ctx, grad_out):
+        """Backward function.
+
+        Pseudo-code:
+
+        .. code:: python
+
+            a = edge_softmax(g, score)  # recomputed per edge
+            dX = e_mul_v_sum over the reversed graph of (a, grad_out)
+            da = u_dot_v(X, grad_out)
+            grad_score = a * (da - v_dot_v(out, grad_out))
+        """
+        gidx = ctx.backward_cache
+        score, X, out, score_max, score_sum = ctx.saved_tensors
+        dX, grad_score = _edge_softmax_spmm_backward(
+            gidx, X, score, out, score_max, score_sum, grad_out.contiguous()
+        )
+        return None, grad_score, dX
+
+
 class SegmentReduce(th.autograd.Function):
     @staticmethod
     def forward(ctx, op, x, offsets):
@@ -1116,6 +1162,21 @@ def edge_softmax(gidx, logits, eids=ALL, norm_by="dst"):
         return EdgeSoftmax.apply(*args)
 
 
+def edge_softmax_spmm(gidx, logits, ufeat):
+    # The fused kernel is only available on CPU.
+    if logits.is_cuda:
+        return gspmm(gidx, "mul", "sum", ufeat, edge_softmax(gidx, logits))
+    expand = logits.dim() == 1 and ufeat.dim() == 1
+    if logits.dim() == 1:
+        logits = logits.unsqueeze(-1)
+    if ufeat.dim() == 1:
+        ufeat = ufeat.unsqueeze(-1)
+    args = _cast_if_autocast_enabled(gidx, logits, ufeat)
+    with _disable_autocast_if_enabled():
+        out = EdgeSoftmaxSpMM.apply(*args)
+    return out.squeeze(-1) if expand else out
+
+
 def edge_softmax_hetero(gidx, eids=ALL, norm_by="dst", *logits):
     args = _cast_if_autocast_enabled(gidx, eids, norm_by, *logits)
     with _disable_autocast_if_enabled():
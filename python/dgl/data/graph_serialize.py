@@ -80,7 +80,9 @@ class GraphData(ObjectBase):
         return g
 
 
-def save_graphs(filename, g_list, labels=None, formats=None):
+def save_graphs(
+    filename, g_list, labels=None, formats=None, mmap=False, compress=False
+):
     r"""Save graphs and optionally their labels to file.
 
     Besides saving to local files, DGL supports writing the graphs directly
@@ -91,6 +93,10 @@ def save_graphs(filename, g_list, labels=None, formats=None):
     in DGL's own binary format. For graph-level features, pass them via
     the :attr:`labels` argument.
 
+    With :attr:`mmap` or :attr:`compress`, the tensors are encoded and
+    checksummed on multiple threads, and the checksums are verified when the
+    tensors are read or decoded by :func:`load_graphs`.
+
     Parameters
     ----------
     filename : str
@@ -105,6 +111,22 @@ def save_graphs(filename, g_list, labels=None, formats=None):
         only according to what format is available. If multiple formats
         are available, selection priority from high to low is ``coo``,
         ``csc``, ``csr``.
+    mmap: bool, optional
+        If True, store the data of the node/edge features and graph
+        structures at aligned offsets, so that :func:`load_graphs`
+        memory maps the file and returns tensors viewing it instead of
+        reading them. Loading is then nearly free, only the graphs in
+        ``idx_list`` are parsed, and the pages of the file are read on
+        first access and shared by the processes loading it. Such files
+        can only be loaded by DGL versions supporting them. Not supported
+        on Windows. Default: False.
+    compress: bool, optional
+        If True, save the graphs in the layout of ``mmap=True``, with the
+        integer tensors such as the graph structures compressed by delta
+        and variable-length encoding when it makes them at least a quarter
+        smaller, which is the case of sorted ids. The compressed tensors
+        are decoded into memory when loaded instead of being memory mapped.
+        Default: False.
 
     Examples
     ----------
@@ -139,7 +161,7 @@ def save_graphs(filename, g_list, labels=None, formats=None):
             os.makedirs(f_path)
     g_sample = g_list[0] if isinstance(g_list, list) else g_list
     if type(g_sample) == DGLGraph:  # Doesn't support DGLGraph's derived class
-        save_heterographs(filename, g_list, labels, formats)
+        save_heterographs(filename, g_list, labels, formats, mmap, compress)
     else:
         raise DGLError(
             "Invalid argument g_list. Must be a DGLGraph or a list of DGLGraphs."
@@ -153,6 +175,10 @@ def load_graphs(filename, idx_list=None):
     from S3 (by providing a ``"s3://..."`` path) or from HDFS (by providing
     ``"hdfs://..."`` a path).
 
+    Local files saved with ``mmap=True`` are memory mapped. The features and
+    graph structures of the loaded graphs are views of the mapping, which is
+    copy-on-write: modifying them in place does not change the file.
+
     Parameters
     ----------
     filename: str
@@ -187,12 +213,14 @@ def load_graphs(filename, idx_list=None):
     version = _CAPI_GetFileVersion(filename)
     if version == 1:
         dgl_warning(
-            "You are loading a graph file saved by old version of dgl.  \
+            "You are loading a graph file saved by old version of dgl.  \
             Please consider saving it again with the current format."
         )
         return load_graph_v1(filename, idx_list)
     elif version == 2:
         return load_graph_v2(filename, idx_list)
+    elif version in (3, 4):
+        return load_graph_v4(filename, idx_list)
     else:
         raise DGLError("Invalid DGL Version Number.")
 
@@ -207,6 +235,19 @@ def load_graph_v2(filename, idx_list=None):
     return [gdata.get_graph() for gdata in heterograph_list], label_dict
 
 
+def load_graph_v4(filename, idx_list=None):
+    """Internal functions for loading DGLGraphs saved for memory mapping, which
+    also loads the version 3 files without checksums."""
+    if idx_list is None:
+        idx_list = []
+    assert isinstance(idx_list, list)
+    heterograph_list = _CAPI_LoadGraphFiles_V4(
+        filename, idx_list, is_local_path(filename)
+    )
+    label_dict = load_labels_v2(filename)
+    return [gdata.get_graph() for gdata in heterograph_list], label_dict
+
+
 def load_graph_v1(filename, idx_list=None):
     """ "Internal functions for loading DGLGraphs (V0)."""
     if idx_list is None:
@@ -248,7 +289,8 @@ def load_labels(filename):
     version = _CAPI_GetFileVersion(filename)
     if version == 1:
         return load_labels_v1(filename)
-    elif version == 2:
+    elif version in (2, 3, 4):
+        # Versions 3 and 4 store the labels like version 2.
         return load_labels_v2(filename)
     else:
         raise Exception("Invalid DGL Version Number")
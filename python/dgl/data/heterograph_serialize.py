@@ -19,7 +19,9 @@ def tensor_dict_to_ndarray_dict(tensor_dict):
     return convert_to_strmap(ndarray_dict)
 
 
-def save_heterographs(filename, g_list, labels, formats):
+def save_heterographs(
+    filename, g_list, labels, formats, mmap=False, compress=False
+):
     """Save heterographs into file"""
     if labels is None:
         labels = {}
@@ -34,7 +36,12 @@ def save_heterographs(filename, g_list, labels, formats):
     elif isinstance(formats, str):
         formats = [formats]
     _CAPI_SaveHeteroGraphData(
-        filename, gdata_list, tensor_dict_to_ndarray_dict(labels), formats
+        filename,
+        gdata_list,
+        tensor_dict_to_ndarray_dict(labels),
+        formats,
+        mmap or compress,
+        compress,
     )
 
 
@@ -204,6 +204,28 @@ class DistTensor:
         idx = idx.tousertensor()
         return self.kvstore.pull(name=self._name, id_tensor=idx)
 
+    def fetch_async(self, idx):
+        """Start fetching the rows at the given indices.
+
+        The requests to remote machines are sent before returning, so that the
+        rows of the next mini-batch can be prefetched while the current one is
+        being computed.
+
+        Parameters
+        ----------
+        idx : tensor
+            The row indices.
+
+        Returns
+        -------
+        object
+            A handle whose ``wait()`` returns the same tensor as
+            ``self[idx]``.
+        """
+        idx = utils.toindex(idx)
+        idx = idx.tousertensor()
+        return self.kvstore.pull_async(name=self._name, id_tensor=idx)
+
     def __setitem__(self, idx, val):
         idx = utils.toindex(idx)
         idx = idx.tousertensor()
@@ -9,7 +9,7 @@ from .._ffi.ndarray import empty_shared_mem
 
 from . import rpc
 from .graph_partition_book import EdgePartitionPolicy, NodePartitionPolicy
-from .standalone_kvstore import KVClient as SA_KVClient
+from .standalone_kvstore import KVClient as SA_KVClient, PulledData
 
 ############################ Register KVStore Requsts and Responses ###############################
 
@@ -1525,6 +1525,45 @@ class KVClient(object):
                 back_sorted_id
             ]  # return data with original index order
 
+    def pull_async(self, name, id_tensor):
+        """Start pulling message from KVServer.
+
+        Only data with the default pull handler are pulled asynchronously;
+        other data are pulled before returning.
+
+        Parameters
+        ----------
+        name : str
+            data name
+        id_tensor : tensor
+            a vector storing the ID list
+
+        Returns
+        -------
+        object
+            a handle whose ``wait()`` returns a data tensor with the same row
+            size of id_tensor.
+        """
+        assert len(name) > 0, "name cannot be empty."
+        id_tensor = utils.toindex(id_tensor)
+        id_tensor = id_tensor.tousertensor()
+        assert F.ndim(id_tensor) == 1, "ID must be a vector."
+        if self._pull_handlers[name] is default_pull_handler:  # Use fast-pull
+            part_id = self._part_policy[name].to_partid(id_tensor)
+            return rpc.fast_pull_async(
+                name,
+                id_tensor,
+                part_id,
+                KVSTORE_PULL,
+                self._machine_count,
+                self._group_count,
+                self._machine_id,
+                self._client_id,
+                self._data_store[name],
+                self._part_policy[name],
+            )
+        return PulledData(self.pull(name, id_tensor))
+
     def union(self, operand1_name, operand2_name, output_name):
         """Compute the union of two mask arrays in the KVStore."""
         # Each trainer computes its own result from its local storage.
@@ -39,6 +39,7 @@ __all__ = [
     "send_request_to_machine",
     "remote_call_to_machine",
     "fast_pull",
+    "fast_pull_async",
     "DistConnectError",
     "get_num_client",
     "set_num_client",
@@ -638,6 +639,25 @@ class RPCMessage(ObjectBase):
         return _CAPI_DGLRPCMessageGetGroupId(self)
 
 
+@register_object("rpc.FastPullRequest")
+class FastPullRequest(ObjectBase):
+    """Handle of a pull issued by :func:`fast_pull_async`.
+
+    The local rows have been copied when the handle is returned. The remote
+    rows are received by :meth:`wait`.
+    """
+
+    def wait(self):
+        """Wait for the remote rows and return the pulled data.
+
+        Returns
+        -------
+        tensor
+            a data tensor with the same row size of the pulled IDs.
+        """
+        return F.zerocopy_from_dgl_ndarray(_CAPI_DGLRPCFastPullWait(self))
+
+
 def send_request(target, request):
     """Send one request to the target server.
 
@@ -1111,6 +1131,44 @@ def finalize_server():
     print("Server (%d) shutdown." % get_rank())
 
 
+def _fast_pull_args(
+    name,
+    id_tensor,
+    part_id,
+    service_id,
+    machine_count,
+    group_count,
+    machine_id,
+    client_id,
+    local_data,
+    policy,
+):
+    """Arguments of the fast-pull C APIs."""
+    msg_seq = incr_msg_seq()
+    pickle_data = bytearray(pickle.dumps(([0], [name])))
+    global_id = _CAPI_DGLRPCGetGlobalIDFromLocalPartition(
+        F.zerocopy_to_dgl_ndarray(id_tensor),
+        F.zerocopy_to_dgl_ndarray(part_id),
+        machine_id,
+    )
+    global_id = F.zerocopy_from_dgl_ndarray(global_id)
+    g2l_id = policy.to_local(global_id)
+    return (
+        name,
+        int(machine_id),
+        int(machine_count),
+        int(group_count),
+        int(client_id),
+        int(service_id),
+        int(msg_seq),
+        pickle_data,
+        F.zerocopy_to_dgl_ndarray(id_tensor),
+        F.zerocopy_to_dgl_ndarray(part_id),
+        F.zerocopy_to_dgl_ndarray(g2l_id),
+        F.zerocopy_to_dgl_ndarray(local_data),
+    )
+
+
 def fast_pull(
     name,
     id_tensor,
@@ -1148,32 +1206,64 @@ def fast_pull(
     policy : PartitionPolicy
         store the partition information
     """
-    msg_seq = incr_msg_seq()
-    pickle_data = bytearray(pickle.dumps(([0], [name])))
-    global_id = _CAPI_DGLRPCGetGlobalIDFromLocalPartition(
-        F.zerocopy_to_dgl_ndarray(id_tensor),
-        F.zerocopy_to_dgl_ndarray(part_id),
-        machine_id,
-    )
-    global_id = F.zerocopy_from_dgl_ndarray(global_id)
-    g2l_id = policy.to_local(global_id)
     res_tensor = _CAPI_DGLRPCFastPull(
-        name,
-        int(machine_id),
-        int(machine_count),
-        int(group_count),
-        int(client_id),
-        int(service_id),
-        int(msg_seq),
-        pickle_data,
-        F.zerocopy_to_dgl_ndarray(id_tensor),
-        F.zerocopy_to_dgl_ndarray(part_id),
-        F.zerocopy_to_dgl_ndarray(g2l_id),
-        F.zerocopy_to_dgl_ndarray(local_data),
+        *_fast_pull_args(
+            name,
+            id_tensor,
+            part_id,
+            service_id,
+            machine_count,
+            group_count,
+            machine_id,
+            client_id,
+            local_data,
+            policy,
+        )
     )
     return F.zerocopy_from_dgl_ndarray(res_tensor)
 
 
+def fast_pull_async(
+    name,
+    id_tensor,
+    part_id,
+    service_id,
+    machine_count,
+    group_count,
+    machine_id,
+    client_id,
+    local_data,
+    policy,
+):
+    """Asynchronous version of :func:`fast_pull`.
+
+    The requests are sent and the local rows are copied before returning.
+    Other RPC messages can be sent and received until the result is waited
+    for.
+
+    Parameters are the same as :func:`fast_pull`.
+
+    Returns
+    -------
+    FastPullRequest
+        a handle whose ``wait()`` returns the pulled data.
+    """
+    return _CAPI_DGLRPCFastPullAsync(
+        *_fast_pull_args(
+            name,
+            id_tensor,
+            part_id,
+            service_id,
+            machine_count,
+            group_count,
+            machine_id,
+            client_id,
+            local_data,
+            policy,
+        )
+    )
+
+
 def register_sig_handler():
     """Register for handling signal event."""
     _CAPI_DGLRPCHandleSignal()
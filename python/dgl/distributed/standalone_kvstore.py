@@ -6,6 +6,20 @@ This kvstore is used when running in the standalone mode
 from .. import backend as F
 
 
+class PulledData(object):
+    """Handle of a pull that completed before it was returned.
+
+    It mimics the handle returned by an asynchronous fast pull.
+    """
+
+    def __init__(self, data):
+        self._data = data
+
+    def wait(self):
+        """Return the pulled data."""
+        return self._data
+
+
 class KVClient(object):
     """The fake KVStore client.
 
@@ -91,6 +105,10 @@ class KVClient(object):
         else:
             return F.gather_row(self._data[name], id_tensor)
 
+    def pull_async(self, name, id_tensor):
+        """pull data from kvstore, returning a handle of the result"""
+        return PulledData(self.pull(name, id_tensor))
+
     def map_shared_data(self, partition_book):
         """Mapping shared-memory tensor from server to client."""
 
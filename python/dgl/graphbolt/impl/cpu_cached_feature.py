@@ -12,6 +12,7 @@ from ..feature_store import (
 )
 
 from .cpu_feature_cache import CPUFeatureCache
+from .torch_based_feature_store import DiskBasedFeature
 
 __all__ = ["CPUCachedFeature", "cpu_cached_feature"]
 
@@ -48,6 +49,19 @@ class CPUCachedFeature(Feature):
         self._fallback_feature = fallback_feature
         self._feature = cache
         self._offset = offset
+        self._ondisk_reader = self._create_ondisk_reader()
+
+    def _create_ondisk_reader(self):
+        """Returns a native reader performing the cache lookup and the disk
+        reads in a single call if the fallback feature is read with io_uring.
+        """
+        if isinstance(self._fallback_feature, DiskBasedFeature) and hasattr(
+            self._fallback_feature, "_ondisk_npy_array"
+        ):
+            return self._feature.ondisk_reader(
+                self._fallback_feature._ondisk_npy_array, self._offset
+            )
+        return None
 
     def read(self, ids: torch.Tensor = None):
         """Read the feature by index.
@@ -65,6 +79,15 @@ class CPUCachedFeature(Feature):
         """
         if ids is None:
             return self._fallback_feature.read()
+        if self._ondisk_reader is not None:
+            try:
+                return self._ondisk_reader.index_select(ids.cpu()).to(
+                    ids.device
+                )
+            except RuntimeError as e:
+                if "Index out of range" not in str(e):
+                    raise
+                raise IndexError from e
         return self._feature.query_and_replace(
             ids.cpu(), self._fallback_feature.read, self._offset
         ).to(ids.device)
@@ -305,6 +328,8 @@ class CPUCachedFeature(Feature):
                     return values
 
             yield _Waiter([values_copy_event, writing_completed], values)
+        elif self._ondisk_reader is not None:
+            yield self._ondisk_reader.index_select_async(ids)
         else:
             policy_future = policy.query_and_replace_async(ids, self._offset)
 
@@ -395,6 +420,8 @@ class CPUCachedFeature(Feature):
             return 4 + self._fallback_feature.read_async_num_stages(
                 torch.device("cpu")
             )
+        elif self._ondisk_reader is not None:
+            return 1
         else:
             return 3 + self._fallback_feature.read_async_num_stages(ids_device)
 
@@ -443,6 +470,7 @@ class CPUCachedFeature(Feature):
             self._feature = self._cache_type(
                 (cache_size,) + feat0.shape[1:], feat0.dtype
             )
+            self._ondisk_reader = self._create_ondisk_reader()
         else:
             self._fallback_feature.update(value, ids)
             self._feature.replace(ids, value, None, self._offset)
@@ -481,7 +509,8 @@ def cpu_cached_feature(
         resulting in a deadlock.
     policy : str, optional
         The cache eviction policy algorithm name. The available policies are
-        ["s3-fifo", "sieve", "lru", "clock"]. Default is "sieve".
+        ["s3-fifo", "sieve", "lru", "clock", "concurrent-clock"]. Default is
+        "sieve".
     pin_memory : bool, optional
         Whether the cache storage should be allocated on system pinned memory.
         Default is False.
@@ -8,6 +8,7 @@ caching_policies = {
     "sieve": torch.ops.graphbolt.sieve_cache_policy,
     "lru": torch.ops.graphbolt.lru_cache_policy,
     "clock": torch.ops.graphbolt.clock_cache_policy,
+    "concurrent-clock": torch.ops.graphbolt.concurrent_clock_cache_policy,
 }
 
 
@@ -21,11 +22,14 @@ class CPUFeatureCache(object):
     dtype : torch.dtype
         The data type of the elements stored in the cache.
     policy: str, optional
-        The cache policy. Default is "sieve". "s3-fifo", "lru" and "clock" are
-        also available.
+        The cache policy. Default is "sieve". "s3-fifo", "lru", "clock" and
+        "concurrent-clock" are also available. "concurrent-clock" can be
+        queried by multiple threads at the same time, at the cost of storing
+        each key in one of a few slots selected by its hash.
     num_parts: int, optional
         The number of cache partitions for parallelism. Default is
-        `torch.get_num_threads()`.
+        `torch.get_num_threads()`, or 1 for "concurrent-clock" which does not
+        need partitioning.
     pin_memory: bool, optional
         Whether the cache storage should be pinned.
     """
@@ -44,7 +48,9 @@ class CPUFeatureCache(object):
             policy in caching_policies
         ), f"{list(caching_policies.keys())} are the available caching policies."
         if num_parts is None:
-            num_parts = torch.get_num_threads()
+            num_parts = (
+                1 if policy == "concurrent-clock" else torch.get_num_threads()
+            )
         min_num_cache_items = num_parts * (10 if policy == "s3-fifo" else 1)
         # Since we partition the cache, each partition needs to have a positive
         # number of slots. In addition, each "s3-fifo" partition needs at least
@@ -58,6 +64,7 @@ class CPUFeatureCache(object):
         )
         self.total_miss = 0
         self.total_queries = 0
+        self._native_readers = []
 
     def is_pinned(self):
         """Returns True if the cache storage is pinned."""
@@ -170,7 +177,38 @@ class CPUFeatureCache(object):
         self._cache.replace(positions, values)
         self._policy.writing_completed(pointers, offsets)
 
+    def ondisk_reader(self, ondisk_npy_array, offset=0):
+        """Creates a reader that serves the rows of an on disk array through
+        this cache. The cache lookup, the disk reads of the missing rows and
+        their insertion into the cache happen in a single native call.
+
+        Parameters
+        ----------
+        ondisk_npy_array : torch.ScriptObject
+            The on disk array holding the rows, see
+            `torch.ops.graphbolt.ondisk_npy_array`.
+        offset : int
+            The offset to be added to the keys. Default is 0.
+
+        Returns
+        -------
+        torch.ScriptObject
+            The reader with `index_select`, `index_select_async` and
+            `statistics` methods. Its queries count towards `miss_rate`.
+        """
+        reader = torch.ops.graphbolt.cached_ondisk_npy_array(
+            ondisk_npy_array, self._policy, self._cache, offset
+        )
+        self._native_readers.append(reader)
+        return reader
+
     @property
     def miss_rate(self):
         """Returns the cache miss rate since creation."""
-        return self.total_miss / self.total_queries
+        total_miss = self.total_miss
+        total_queries = self.total_queries
+        for reader in self._native_readers:
+            statistics = reader.statistics()
+            total_miss += statistics["num_misses"]
+            total_queries += statistics["num_queries"]
+        return total_miss / total_queries
@@ -3,7 +3,7 @@
 import textwrap
 
 # pylint: disable= invalid-name
-from typing import Dict, Optional, Union
+from typing import Dict, List, Optional, Tuple, Union
 
 import torch
 
@@ -51,6 +51,20 @@ class _SampleNeighborsWaiter:
         )
 
 
+class _SampleNeighborsMultiHopWaiter:
+    def __init__(self, fn, future):
+        self.fn = fn
+        self.future = future
+
+    def wait(self):
+        """Returns the stored value when invoked."""
+        fn = self.fn
+        C_sampled_subgraphs = self.future.wait()
+        # Ensure there is no memory leak.
+        self.fn = self.future = None
+        return fn(C_sampled_subgraphs)
+
+
 class FusedCSCSamplingGraph(SamplingGraph):
     r"""A sampling graph in CSC format."""
 
@@ -63,7 +77,12 @@ class FusedCSCSamplingGraph(SamplingGraph):
 
         classname_str = self.__class__.__name__
         csc_indptr_str = str(self.csc_indptr)
-        indices_str = str(self.indices)
+        compressed_indices = self.compressed_indices
+        if compressed_indices is None:
+            indices_str = str(self.indices)
+        else:
+            # Printing the indices would decompress all of them.
+            indices_str = f"<compressed, {compressed_indices.numel()} bytes>"
         meta_str = f"total_num_nodes={self.total_num_nodes}, num_edges={self.num_edges},"
         if self.node_type_offset is not None:
             meta_str += f"\nnode_type_offset={self.node_type_offset},"
@@ -255,7 +274,8 @@ class FusedCSCSamplingGraph(SamplingGraph):
         Notes
         -------
         It is assumed that edges of each node are already sorted by edge type
-        ids.
+        ids. If the indices are compressed, see :meth:`compress_indices`, they
+        are decompressed into a new tensor.
         """
         return self._c_csc_graph.indices()
 
@@ -264,6 +284,33 @@ class FusedCSCSamplingGraph(SamplingGraph):
         """Sets the indices in the CSC graph."""
         self._c_csc_graph.set_indices(indices)
 
+    @property
+    def compressed_indices(self) -> Optional[torch.Tensor]:
+        """Returns the compressed indices if :meth:`compress_indices` was
+        called.
+
+        Returns
+        -------
+        torch.Tensor or None
+            A uint8 tensor holding the compressed indices, or None if the
+            indices are not compressed.
+        """
+        return self._c_csc_graph.compressed_indices()
+
+    @property
+    def compressed_indices_offsets(self) -> Optional[torch.Tensor]:
+        """Returns the byte offsets of the blocks of nodes in the compressed
+        indices if :meth:`compress_indices` was called.
+
+        Returns
+        -------
+        torch.Tensor or None
+            An int64 tensor holding the offset of every block of nodes in
+            :attr:`compressed_indices`, or None if the indices are not
+            compressed.
+        """
+        return self._c_csc_graph.compressed_indices_offsets()
+
     @property
     def node_type_offset(self) -> Optional[torch.Tensor]:
         """Returns the node type offset tensor if present. Do not modify the
@@ -504,6 +551,39 @@ class FusedCSCSamplingGraph(SamplingGraph):
         """
         self._c_csc_graph.add_edge_attribute(name, tensor)
 
+    def build_probs_prefix_sum(self, probs_name: str) -> None:
+        """Precomputes the cumulative sum of the probabilities in an edge
+        attribute over the in-edges of every node, so that weighted neighbor
+        sampling on the CPU with `probs_name` does not scan the probabilities
+        of all the neighbors of every seed. The exclusive sums, which restart
+        at 0 at the first in-edge of every node, are stored as the float64
+        edge attribute `probs_name + ".prefix_sum"`, hence they are saved and
+        shared along with the other edge attributes. They have to be rebuilt
+        if the probabilities are modified in place, and are dropped if the
+        probabilities are replaced.
+
+        Parameters
+        ----------
+        probs_name: str
+            The name of the edge attribute holding the (unnormalized)
+            probabilities or the mask.
+        """
+        self._c_csc_graph.build_probs_prefix_sum(probs_name)
+
+    def compress_indices(self) -> None:
+        """Replaces the indices with a compressed copy of them in place.
+
+        The neighbors of every node are delta encoded and bit-packed, which
+        takes a fraction of the memory of the indices when the neighbors of
+        the nodes are sorted or close to each other. The compressed indices are
+        kept by :meth:`copy_to_shared_memory`, pickling and saving the graph.
+
+        Only :meth:`in_subgraph` and :meth:`sample_neighbors` on the CPU are
+        supported on a compressed graph. Accessing :attr:`indices`, e.g. by
+        :meth:`to`, decompresses the whole indices.
+        """
+        self._c_csc_graph.compress_indices()
+
     def in_subgraph(
         self,
         nodes: Union[torch.Tensor, Dict[str, torch.Tensor]],
@@ -793,7 +873,8 @@ class FusedCSCSamplingGraph(SamplingGraph):
             This attribute tensor should contain (unnormalized) probabilities
             corresponding to each neighboring edge of a node. It must be a 1D
             floating-point or boolean tensor, with the number of elements
-            equalling the total number of edges.
+            equalling the total number of edges. See `build_probs_prefix_sum`
+            to speed up repeated sampling with the same probabilities.
         returning_indices_and_original_edge_ids_are_optional: bool
             Boolean indicating whether it is okay for the call to this function
             to leave the indices and the original edge ids tensors
@@ -863,13 +944,111 @@ class FusedCSCSamplingGraph(SamplingGraph):
                 returning_indices_and_original_edge_ids_are_optional,
             )
 
+    def sample_neighbors_multi_hop(
+        self,
+        seeds: torch.Tensor,
+        fanouts: List[int],
+        replace: bool = False,
+        probs_name: Optional[str] = None,
+        async_op: bool = False,
+    ) -> Tuple[torch.Tensor, List[SampledSubgraphImpl]]:
+        """Sample the neighborhood of the given nodes over multiple hops and
+        compact the node IDs of all the hops in a single native call, which
+        is faster than calling `sample_neighbors` and `unique_and_compact`
+        for each hop. Only homogeneous graphs on the CPU are supported.
+
+        Parameters
+        ----------
+        seeds: torch.Tensor
+            Unique IDs of the given seed nodes.
+        fanouts: List[int]
+            The number of edges to be sampled for each node at each hop,
+            starting from the hop of `seeds`. See `sample_neighbors` for the
+            meaning of the values.
+        replace: bool
+            Boolean indicating whether the sample is preformed with or
+            without replacement. If True, a value can be selected multiple
+            times. Otherwise, each value can be selected only once.
+        probs_name: str, optional
+            An optional string specifying the name of an edge attribute used
+            as the probabilities or masks of the edges, see
+            `sample_neighbors`.
+        async_op: bool
+            Boolean indicating whether the call is asynchronous. If so, the
+            result can be obtained by calling wait on the returned future.
+
+        Returns
+        -------
+        Tuple[torch.Tensor, List[SampledSubgraphImpl]]
+            The input nodes and the sampled subgraphs, in the same order as
+            in `MiniBatch`, i.e. the subgraph of the last hop first. The
+            indices of the subgraphs are compacted and their original IDs are
+            given by `original_row_node_ids`.
+
+        Examples
+        --------
+        >>> import dgl.graphbolt as gb
+        >>> import torch
+        >>> indptr = torch.LongTensor([0, 2, 4, 5, 6])
+        >>> indices = torch.LongTensor([1, 2, 0, 3, 0, 1])
+        >>> graph = gb.fused_csc_sampling_graph(indptr, indices)
+        >>> input_nodes, subgraphs = graph.sample_neighbors_multi_hop(
+        ...     torch.LongTensor([3]), [-1, -1])
+        >>> print(input_nodes)
+        tensor([3, 1, 0])
+        >>> print(subgraphs[1].sampled_csc)
+        CSCFormatBase(indptr=tensor([0, 1]),
+                      indices=tensor([1]),
+        )
+        """
+        assert len(fanouts) > 0, "Fanouts should not be empty."
+        probs_or_mask = self.edge_attributes[probs_name] if probs_name else None
+        for fanout in fanouts:
+            self._check_sampler_arguments(
+                seeds, torch.tensor([fanout]), probs_or_mask
+            )
+        sampling_fn = (
+            self._c_csc_graph.sample_neighbors_multi_hop_async
+            if async_op
+            else self._c_csc_graph.sample_neighbors_multi_hop
+        )
+        C_sampled_subgraphs = sampling_fn(
+            seeds,
+            fanouts,
+            replace,
+            False,  # is_labor
+            probs_or_mask,
+        )
+        if async_op:
+            return _SampleNeighborsMultiHopWaiter(
+                self._convert_to_multi_hop_subgraphs, C_sampled_subgraphs
+            )
+        return self._convert_to_multi_hop_subgraphs(C_sampled_subgraphs)
+
+    def _convert_to_multi_hop_subgraphs(self, C_sampled_subgraphs):
+        subgraphs = []
+        for C_sampled_subgraph in C_sampled_subgraphs:
+            subgraph = self._convert_to_sampled_subgraph(C_sampled_subgraph)
+            subgraph.original_column_node_ids = (
+                C_sampled_subgraph.original_column_node_ids
+            )
+            subgraph.original_row_node_ids = (
+                C_sampled_subgraph.original_row_node_ids
+            )
+            subgraphs.insert(0, subgraph)
+        return subgraphs[0].original_row_node_ids, subgraphs
+
     def _check_sampler_arguments(self, nodes, fanouts, probs_or_mask):
         if nodes is not None:
             assert nodes.dim() == 1, "Nodes should be 1-D tensor."
-            assert nodes.dtype == self.indices.dtype, (
-                f"Data type of nodes must be consistent with "
-                f"indices.dtype({self.indices.dtype}), but got {nodes.dtype}."
-            )
+            # The sampler checks the data type of the nodes of a compressed
+            # graph, whose indices are not decompressed to check it here.
+            if self.compressed_indices is None:
+                assert nodes.dtype == self.indices.dtype, (
+                    f"Data type of nodes must be consistent with "
+                    f"indices.dtype({self.indices.dtype}), but got "
+                    f"{nodes.dtype}."
+                )
         assert fanouts.dim() == 1, "Fanouts should be 1-D tensor."
         expected_fanout_len = 1
         if self.edge_type_to_id:
@@ -517,6 +517,34 @@ class DiskBasedFeature(Feature):
         """Disk based feature does not support update for now."""
         raise NotImplementedError
 
+    def read_statistics(self, reset: bool = False) -> Dict:
+        """Get the I/O statistics of the reads with ids since the feature was
+        created or the statistics were last reset. Rows in the same or adjacent
+        file blocks are fetched by a single read, so the number of reads can be
+        much lower than the number of rows read.
+
+        Parameters
+        ----------
+        reset : bool
+            Whether to reset the statistics after returning them.
+
+        Returns
+        -------
+        Dict
+            The number of read requests issued to the disk (``num_reads``), the
+            number of bytes read from the disk (``num_bytes_read``), the number
+            of bytes of the rows read (``num_bytes_requested``) and their ratio
+            (``read_amplification``).
+        """
+        assert torch.ops.graphbolt.detect_io_uring()
+        statistics = dict(self._ondisk_npy_array.read_statistics())
+        statistics["read_amplification"] = statistics["num_bytes_read"] / max(
+            statistics["num_bytes_requested"], 1
+        )
+        if reset:
+            self._ondisk_npy_array.reset_read_statistics()
+        return statistics
+
     def metadata(self):
         """Get the metadata of the feature.
         Returns
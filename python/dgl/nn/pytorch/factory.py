@@ -105,6 +105,12 @@ class KNNGraph(nn.Module):
               faster than 'bruteforce' when the dimension of input points
               is not large. This method is only available on CUDA device.
 
+            * 'bruteforce-blocked' (CPU only) is similar to 'bruteforce'
+              but computes the distances between blocks of points with a
+              tiled matrix multiplication. This method is faster than
+              'bruteforce' when the dimension of input points is not small,
+              and has the same memory overhead as 'bruteforce'.
+
             * 'kd-tree' will use the kd-tree algorithm (CPU only).
               This method is suitable for low-dimensional data (e.g. 3D
               point clouds)
@@ -228,6 +234,12 @@ class SegmentedKNNGraph(nn.Module):
               faster than 'bruteforce' when the dimension of input points
               is not large. This method is only available on CUDA device.
 
+            * 'bruteforce-blocked' (CPU only) is similar to 'bruteforce'
+              but computes the distances between blocks of points with a
+              tiled matrix multiplication. This method is faster than
+              'bruteforce' when the dimension of input points is not small,
+              and has the same memory overhead as 'bruteforce'.
+
             * 'kd-tree' will use the kd-tree algorithm (CPU only).
               This method is suitable for low-dimensional data (e.g. 3D
               point clouds)
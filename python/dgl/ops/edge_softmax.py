@@ -3,10 +3,11 @@ from ..backend import (
     astype,
     edge_softmax as edge_softmax_internal,
     edge_softmax_hetero as edge_softmax_hetero_internal,
+    edge_softmax_spmm as edge_softmax_spmm_internal,
 )
-from ..base import ALL, is_all
+from ..base import ALL, DGLError, is_all
 
-__all__ = ["edge_softmax"]
+__all__ = ["edge_softmax", "edge_softmax_spmm"]
 
 
 def edge_softmax(graph, logits, eids=ALL, norm_by="dst"):
@@ -151,3 +152,56 @@ def edge_softmax(graph, logits, eids=ALL, norm_by="dst"):
             etid = graph.get_etype_id(rel)
             score[rel] = score_tuple[etid]
         return score
+
+
+def edge_softmax_spmm(graph, logits, ufeat):
+    r"""Aggregate source node features weighted by the edge softmax of the
+    incoming edges of every node.
+
+    For a node :math:`i`, it computes
+
+    .. math::
+      h_i = \sum_{j\in\mathcal{N}(i)} a_{ij} x_j, \quad
+      a_{ij} = \frac{\exp(z_{ij})}{\sum_{j\in\mathcal{N}(i)}\exp(z_{ij})}
+
+    which is the attention aggregation of models like GAT and Transformer.
+    The result equals ``u_mul_e_sum(graph, ufeat, edge_softmax(graph,
+    logits))``, but on CPU it is computed by a fused kernel in a single pass
+    over the incoming edges of every node, without storing the softmax
+    scores, which saves memory traffic on large multi-head attention layers.
+
+    Parameters
+    ----------
+    graph : DGLGraph
+        The homogeneous graph (or a graph with a single edge type) to perform
+        the aggregation on.
+    logits : torch.Tensor
+        The attention logits on edges, of shape :math:`(E, *, 1)` or
+        :math:`(E, *)`.
+    ufeat : torch.Tensor
+        The features on source nodes, broadcastable with the logits, e.g. of
+        shape :math:`(N, *, D)`.
+
+    Returns
+    -------
+    torch.Tensor
+        The aggregated features on destination nodes.
+
+    Examples
+    --------
+    The following example uses PyTorch backend.
+
+    >>> import dgl
+    >>> import torch as th
+    >>> g = dgl.graph((th.tensor([0, 1, 2]), th.tensor([2, 2, 2])))
+    >>> logits = th.zeros(3, 2, 1)
+    >>> feat = th.arange(12).float().view(3, 2, 2)
+    >>> dgl.ops.edge_softmax_spmm(g, logits, feat)[2]
+    tensor([[4., 5.],
+            [6., 7.]])
+    """
+    if graph._graph.number_of_etypes() != 1:
+        raise DGLError(
+            "edge_softmax_spmm only supports graphs with one edge type."
+        )
+    return edge_softmax_spmm_internal(graph._graph, logits, ufeat)
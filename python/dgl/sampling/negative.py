@@ -6,7 +6,10 @@ from .. import backend as F, utils
 from .._ffi.function import _init_api
 from ..heterograph import DGLGraph
 
-__all__ = ["global_uniform_negative_sampling"]
+__all__ = [
+    "global_uniform_negative_sampling",
+    "per_source_uniform_negative_sampling",
+]
 
 
 def _calc_redundancy(
@@ -119,8 +122,75 @@ def global_uniform_negative_sampling(
     return F.from_dgl_nd(src), F.from_dgl_nd(dst)
 
 
+def per_source_uniform_negative_sampling(
+    g, src, k, exclude_self_loops=True, etype=None
+):
+    """Performs negative sampling that keeps the given source nodes and
+    corrupts the destinations, i.e. for each source node it uniformly samples
+    ``k`` destination nodes such that edges with the given type do not exist
+    between them.
+
+    When ``src`` holds the source nodes of the positive edges, the negative
+    pairs follow the same source degree distribution as the positive ones.
+
+    .. note::
+
+       Only the CPU is supported. A source node with fewer than ``k``
+       non-neighbors in expectation may get fewer than ``k`` negative
+       samples.
+
+    Parameters
+    ----------
+    g : DGLGraph
+        The graph.
+    src : Tensor
+        The source nodes.
+    k : int
+        The number of negative samples per source node.
+    exclude_self_loops : bool, optional
+        Whether to exclude self-loops from the negative samples.  Only impacts the
+        edge types whose source and destination node types are the same.
+
+        Default: True.
+    etype : str or tuple of str, optional
+        The edge type.  Can be omitted if the graph only has one edge type.
+
+    Returns
+    -------
+    tuple[Tensor, Tensor]
+        The source and destination pairs, the samples of each source node
+        being contiguous.
+
+    Examples
+    --------
+    >>> g = dgl.graph(([0, 1, 2], [1, 2, 3]))
+    >>> dgl.sampling.per_source_uniform_negative_sampling(
+    ...     g, torch.tensor([0, 1]), 2)
+    (tensor([0, 0, 1, 1]), tensor([2, 3, 0, 3]))
+    """
+    if etype is None:
+        etype = g.etypes[0]
+    utype, _, vtype = g.to_canonical_etype(etype)
+    exclude_self_loops = exclude_self_loops and (utype == vtype)
+    src = utils.prepare_tensor(g, src, "src")
+
+    etype_id = g.get_etype_id(etype)
+    src, dst = _CAPI_DGLPerSourceUniformNegativeSampling(
+        g._graph,
+        etype_id,
+        F.to_dgl_nd(src),
+        k,
+        100,
+        exclude_self_loops,
+    )
+    return F.from_dgl_nd(src), F.from_dgl_nd(dst)
+
+
 DGLGraph.global_uniform_negative_sampling = utils.alias_func(
     global_uniform_negative_sampling
 )
+DGLGraph.per_source_uniform_negative_sampling = utils.alias_func(
+    per_source_uniform_negative_sampling
+)
 
 _init_api("dgl.sampling.negative", __name__)
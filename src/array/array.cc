@@ -700,6 +700,21 @@ std::pair<IdArray, IdArray> CSRGlobalUniformNegativeSampling(
   return result;
 }
 
+std::pair<IdArray, IdArray> CSRPerSourceUniformNegativeSampling(
+    const CSRMatrix& csr, IdArray rows, int64_t k, int num_trials,
+    bool exclude_self_loops) {
+  CHECK_GE(k, 0) << "Number of samples per row must be non-negative";
+  CHECK_GT(num_trials, 0) << "Number of sampling trials must be positive";
+  CHECK_SAME_DTYPE(csr.indices, rows);
+  CHECK_SAME_CONTEXT(csr.indices, rows);
+  std::pair<IdArray, IdArray> result;
+  ATEN_CSR_SWITCH(csr, XPU, IdType, "CSRPerSourceUniformNegativeSampling", {
+    result = impl::CSRPerSourceUniformNegativeSampling<XPU, IdType>(
+        csr, rows, k, num_trials, exclude_self_loops);
+  });
+  return result;
+}
+
 CSRMatrix UnionCsr(const std::vector<CSRMatrix>& csrs) {
   CSRMatrix ret;
   CHECK_GT(csrs.size(), 1)
@@ -224,6 +224,11 @@ std::pair<IdArray, IdArray> CSRGlobalUniformNegativeSampling(
     const CSRMatrix& csr, int64_t num_samples, int num_trials,
     bool exclude_self_loops, bool replace, double redundancy);
 
+template <DGLDeviceType XPU, typename IdType>
+std::pair<IdArray, IdArray> CSRPerSourceUniformNegativeSampling(
+    const CSRMatrix& csr, IdArray rows, int64_t k, int num_trials,
+    bool exclude_self_loops);
+
 // Union CSRMatrixes
 template <DGLDeviceType XPU, typename IdType>
 CSRMatrix UnionCsr(const std::vector<CSRMatrix>& csrs);
@@ -5,47 +5,85 @@
  */
 
 #include <dgl/array.h>
+#include <dgl/runtime/parallel_for.h>
 
+#include <algorithm>
+#include <numeric>
 #include <vector>
 
 namespace dgl {
 
+using runtime::parallel_for;
+
 namespace aten {
 
 namespace impl {
 
+// The number of entries whose runs are compacted by a task, so that the runs
+// of a task can be written without synchronization.
+constexpr int64_t kCoalesceBlockSize = 1 << 16;
+
 template <DGLDeviceType XPU, typename IdType>
 std::pair<COOMatrix, IdArray> COOCoalesce(COOMatrix coo) {
   const int64_t nnz = coo.row->shape[0];
+  if (!coo.row_sorted || !coo.col_sorted) coo = COOSort(coo, true);
   const IdType* coo_row_data = static_cast<IdType*>(coo.row->data);
   const IdType* coo_col_data = static_cast<IdType*>(coo.col->data);
 
-  if (!coo.row_sorted || !coo.col_sorted) coo = COOSort(coo, true);
+  // An entry starts a run of duplicates if it differs from the previous one.
+  auto is_run_start = [&](int64_t i) {
+    return i == 0 || coo_row_data[i] != coo_row_data[i - 1] ||
+           coo_col_data[i] != coo_col_data[i - 1];
+  };
 
-  std::vector<IdType> new_row, new_col, count;
-  IdType prev_row = -1, prev_col = -1;
-  for (int64_t i = 0; i < nnz; ++i) {
-    const IdType curr_row = coo_row_data[i];
-    const IdType curr_col = coo_col_data[i];
-    if (curr_row == prev_row && curr_col == prev_col) {
-      ++count[count.size() - 1];
-    } else {
-      new_row.push_back(curr_row);
-      new_col.push_back(curr_col);
-      count.push_back(1);
-      prev_row = curr_row;
-      prev_col = curr_col;
+  // Count the runs starting in each block, then write the first entry of each
+  // run at the offset of its block.
+  const int64_t num_blocks =
+      (nnz + kCoalesceBlockSize - 1) / kCoalesceBlockSize;
+  std::vector<int64_t> offsets(num_blocks + 1, 0);
+  parallel_for(0, num_blocks, 1, [&](int64_t b, int64_t e) {
+    for (int64_t block = b; block < e; ++block) {
+      const int64_t end = std::min((block + 1) * kCoalesceBlockSize, nnz);
+      int64_t num_runs = 0;
+      for (int64_t i = block * kCoalesceBlockSize; i < end; ++i) {
+        num_runs += is_run_start(i);
+      }
+      offsets[block + 1] = num_runs;
+    }
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  const int64_t num_runs = offsets[num_blocks];
+  IdArray new_row = NewIdArray(num_runs, coo.row->ctx, coo.row->dtype.bits);
+  IdArray new_col = NewIdArray(num_runs, coo.row->ctx, coo.row->dtype.bits);
+  IdArray count = NewIdArray(num_runs, coo.row->ctx, coo.row->dtype.bits);
+  IdType* new_row_data = new_row.Ptr<IdType>();
+  IdType* new_col_data = new_col.Ptr<IdType>();
+  IdType* count_data = count.Ptr<IdType>();
+  // The position of the first entry of each run, followed by nnz.
+  std::vector<int64_t> run_starts(num_runs + 1, nnz);
+  parallel_for(0, num_blocks, 1, [&](int64_t b, int64_t e) {
+    for (int64_t block = b; block < e; ++block) {
+      const int64_t end = std::min((block + 1) * kCoalesceBlockSize, nnz);
+      int64_t pos = offsets[block];
+      for (int64_t i = block * kCoalesceBlockSize; i < end; ++i) {
+        if (!is_run_start(i)) continue;
+        new_row_data[pos] = coo_row_data[i];
+        new_col_data[pos] = coo_col_data[i];
+        run_starts[pos] = i;
+        ++pos;
+      }
+    }
+  });
+  parallel_for(0, num_runs, [&](int64_t b, int64_t e) {
+    for (int64_t i = b; i < e; ++i) {
+      count_data[i] = run_starts[i + 1] - run_starts[i];
     }
-  }
+  });
 
   COOMatrix coo_result = COOMatrix{
-      coo.num_rows,
-      coo.num_cols,
-      NDArray::FromVector(new_row),
-      NDArray::FromVector(new_col),
-      NullArray(),
-      true};
-  return std::make_pair(coo_result, NDArray::FromVector(count));
+      coo.num_rows, coo.num_cols, new_row, new_col, NullArray(), true};
+  return std::make_pair(coo_result, count);
 }
 
 template std::pair<COOMatrix, IdArray> COOCoalesce<kDGLCPU, int32_t>(COOMatrix);
@@ -5,6 +5,7 @@
  */
 
 #include <dgl/array.h>
+#include <dgl/runtime/parallel_for.h>
 
 #include <algorithm>
 #include <iterator>
@@ -15,37 +16,89 @@ namespace dgl {
 namespace aten {
 namespace impl {
 
+/**
+ * @brief Compute the line graph from the out-edges of each node. The edges of
+ * the line graph are counted for each edge first, so that they can be written
+ * in parallel to their final position. They are ordered by the position of
+ * their source and then of their destination in the COO, like the edges found
+ * by comparing every pair of edges.
+ */
 template <DGLDeviceType XPU, typename IdType>
 COOMatrix COOLineGraph(const COOMatrix& coo, bool backtracking) {
   const int64_t nnz = coo.row->shape[0];
-  IdType* coo_row = coo.row.Ptr<IdType>();
-  IdType* coo_col = coo.col.Ptr<IdType>();
+  const int64_t num_rows = coo.num_rows;
+  const IdType* coo_row = coo.row.Ptr<IdType>();
+  const IdType* coo_col = coo.col.Ptr<IdType>();
   IdArray data = COOHasData(coo)
                      ? coo.data
                      : Range(0, nnz, coo.row->dtype.bits, coo.row->ctx);
-  IdType* data_data = data.Ptr<IdType>();
-  std::vector<IdType> new_row;
-  std::vector<IdType> new_col;
-
-  for (int64_t i = 0; i < nnz; ++i) {
-    IdType u = coo_row[i];
-    IdType v = coo_col[i];
-    for (int64_t j = 0; j < nnz; ++j) {
-      // no self-loop
-      if (i == j) continue;
-
-      // succ_u == v
-      // if not backtracking succ_u != u
-      if (v == coo_row[j] && (backtracking || u != coo_col[j])) {
-        new_row.push_back(data_data[i]);
-        new_col.push_back(data_data[j]);
+  const IdType* data_data = data.Ptr<IdType>();
+
+  // Group the positions of the edges by their source, keeping their order in
+  // the COO, unless they already are.
+  std::vector<int64_t> indptr(num_rows + 1, 0);
+  for (int64_t i = 0; i < nnz; ++i) ++indptr[coo_row[i] + 1];
+  std::partial_sum(indptr.begin(), indptr.end(), indptr.begin());
+  std::vector<IdType> out_edges;
+  if (!coo.row_sorted) {
+    out_edges.resize(nnz);
+    std::vector<int64_t> pos(indptr.begin(), indptr.end() - 1);
+    for (int64_t i = 0; i < nnz; ++i) out_edges[pos[coo_row[i]]++] = i;
+  }
+  auto out_edge = [&](int64_t k) -> int64_t {
+    return coo.row_sorted ? k : out_edges[k];
+  };
+
+  // Edge j succeeds edge i if it leaves the node edge i enters. Self-loops of
+  // the line graph are excluded, and so are the reverse edges unless
+  // backtracking.
+  auto for_each_succ = [&](int64_t i, auto&& f) {
+    const IdType u = coo_row[i];
+    const IdType v = coo_col[i];
+    if (v >= num_rows) return;
+    for (int64_t k = indptr[v]; k < indptr[v + 1]; ++k) {
+      const int64_t j = out_edge(k);
+      if (i == j || (!backtracking && u == coo_col[j])) continue;
+      f(j);
+    }
+  };
+
+  std::vector<int64_t> offsets(nnz + 1, 0);
+  runtime::parallel_for(0, nnz, [&](int64_t b, int64_t e) {
+    for (int64_t i = b; i < e; ++i) {
+      int64_t count = 0;
+      if (backtracking) {
+        // Every out-edge of v but edge i itself.
+        const IdType v = coo_col[i];
+        if (v < num_rows) {
+          count = indptr[v + 1] - indptr[v] - (coo_row[i] == v);
+        }
+      } else {
+        for_each_succ(i, [&](int64_t) { ++count; });
       }
+      offsets[i + 1] = count;
     }
-  }
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  const int64_t num_edges = offsets[nnz];
+  IdArray new_row = NewIdArray(num_edges, coo.row->ctx, coo.row->dtype.bits);
+  IdArray new_col = NewIdArray(num_edges, coo.row->ctx, coo.row->dtype.bits);
+  IdType* new_row_data = new_row.Ptr<IdType>();
+  IdType* new_col_data = new_col.Ptr<IdType>();
+  runtime::parallel_for(0, nnz, [&](int64_t b, int64_t e) {
+    for (int64_t i = b; i < e; ++i) {
+      int64_t pos = offsets[i];
+      for_each_succ(i, [&](int64_t j) {
+        new_row_data[pos] = data_data[i];
+        new_col_data[pos] = data_data[j];
+        ++pos;
+      });
+    }
+  });
 
-  COOMatrix res = COOMatrix(
-      nnz, nnz, NDArray::FromVector(new_row), NDArray::FromVector(new_col),
-      NullArray(), false, false);
+  COOMatrix res =
+      COOMatrix(nnz, nnz, new_row, new_col, NullArray(), false, false);
   return res;
 }
 
@@ -5,13 +5,11 @@
  */
 
 #include <dgl/array.h>
-#include <dgl/runtime/parallel_for.h>
-#include <tsl/robin_map.h>
-#include <tsl/robin_set.h>
 
+#include <utility>
 #include <vector>
 
-#include "array_utils.h"
+#include "spgemm.h"
 
 namespace dgl {
 
@@ -19,71 +17,6 @@ using dgl::runtime::NDArray;
 
 namespace aten {
 
-namespace {
-
-// TODO(BarclayII): avoid using map for sorted CSRs
-template <typename IdType>
-void CountNNZPerRow(
-    const std::vector<const IdType*>& A_indptr,
-    const std::vector<const IdType*>& A_indices, IdType* C_indptr_data,
-    int64_t M) {
-  int64_t n = A_indptr.size();
-
-  runtime::parallel_for(0, M, [=](size_t b, size_t e) {
-    for (size_t i = b; i < e; ++i) {
-      tsl::robin_set<IdType> set;
-      for (int64_t k = 0; k < n; ++k) {
-        for (IdType u = A_indptr[k][i]; u < A_indptr[k][i + 1]; ++u)
-          set.insert(A_indices[k][u]);
-      }
-      C_indptr_data[i] = set.size();
-    }
-  });
-}
-
-template <typename IdType>
-int64_t ComputeIndptrInPlace(IdType* C_indptr_data, int64_t M) {
-  int64_t nnz = 0;
-  IdType len = 0;
-  for (IdType i = 0; i < M; ++i) {
-    len = C_indptr_data[i];
-    C_indptr_data[i] = nnz;
-    nnz += len;
-  }
-  C_indptr_data[M] = nnz;
-  return nnz;
-}
-
-template <typename IdType, typename DType>
-void ComputeIndicesAndData(
-    const std::vector<const IdType*>& A_indptr,
-    const std::vector<const IdType*>& A_indices,
-    const std::vector<const IdType*>& A_eids,
-    const std::vector<const DType*>& A_data, const IdType* C_indptr_data,
-    IdType* C_indices_data, DType* C_weights_data, int64_t M) {
-  int64_t n = A_indptr.size();
-  runtime::parallel_for(0, M, [=](size_t b, size_t e) {
-    for (auto i = b; i < e; ++i) {
-      tsl::robin_map<IdType, DType> map;
-      for (int64_t k = 0; k < n; ++k) {
-        for (IdType u = A_indptr[k][i]; u < A_indptr[k][i + 1]; ++u) {
-          IdType kA = A_indices[k][u];
-          DType vA = A_data[k][A_eids[k] ? A_eids[k][u] : u];
-          map[kA] += vA;
-        }
-      }
-      IdType j = C_indptr_data[i];
-      for (auto it : map) {
-        C_indices_data[j] = it.first;
-        C_weights_data[j] = it.second;
-        ++j;
-      }
-    }
-  });
-}
-
-};  // namespace
-
 template <int XPU, typename IdType, typename DType>
 std::pair<CSRMatrix, NDArray> CSRSum(
     const std::vector<CSRMatrix>& A, const std::vector<NDArray>& A_weights) {
@@ -110,27 +43,20 @@ std::pair<CSRMatrix, NDArray> CSRSum(
     A_data[i] = data.Ptr<DType>();
   }
 
-  IdArray C_indptr =
-      IdArray::Empty({M + 1}, A[0].indptr->dtype, A[0].indptr->ctx);
-  IdType* C_indptr_data = C_indptr.Ptr<IdType>();
-
-  CountNNZPerRow<IdType>(A_indptr, A_indices, C_indptr_data, M);
-  IdType nnz = ComputeIndptrInPlace<IdType>(C_indptr_data, M);
-  // Allocate indices and weights array
-  IdArray C_indices =
-      IdArray::Empty({nnz}, A[0].indices->dtype, A[0].indices->ctx);
-  NDArray C_weights =
-      NDArray::Empty({nnz}, A_weights[0]->dtype, A_weights[0]->ctx);
-  IdType* C_indices_data = C_indices.Ptr<IdType>();
-  DType* C_weights_data = C_weights.Ptr<DType>();
-  ComputeIndicesAndData<IdType, DType>(
-      A_indptr, A_indices, A_eids, A_data, C_indptr_data, C_indices_data,
-      C_weights_data, M);
-
-  return {
-      CSRMatrix(
-          M, N, C_indptr, C_indices, NullArray(C_indptr->dtype, C_indptr->ctx)),
-      C_weights};
+  return cpu::RowwiseSpGEMM<IdType, DType>(
+      M, N, A[0].indptr, A_weights[0],
+      [&](int64_t i) {
+        int64_t flops = 0;
+        for (int64_t k = 0; k < n; ++k)
+          flops += A_indptr[k][i + 1] - A_indptr[k][i];
+        return flops;
+      },
+      [&](int64_t i, const auto& emit) {
+        for (int64_t k = 0; k < n; ++k) {
+          for (IdType u = A_indptr[k][i]; u < A_indptr[k][i + 1]; ++u)
+            emit(A_indices[k][u], A_data[k][A_eids[k] ? A_eids[k][u] : u]);
+        }
+      });
 }
 
 template std::pair<CSRMatrix, NDArray> CSRSum<kDGLCPU, int32_t, float>(
@@ -5,12 +5,13 @@
  */
 
 #include <dgl/array.h>
-#include <dgl/array_iterator.h>
 #include <dgl/random.h>
 #include <dgl/runtime/parallel_for.h>
 
 #include <algorithm>
+#include <numeric>
 #include <utility>
+#include <vector>
 
 using namespace dgl::runtime;
 
@@ -18,52 +19,181 @@ namespace dgl {
 namespace aten {
 namespace impl {
 
-template <DGLDeviceType XPU, typename IdType>
-std::pair<IdArray, IdArray> CSRGlobalUniformNegativeSampling(
-    const CSRMatrix& csr, int64_t num_samples, int num_trials,
-    bool exclude_self_loops, bool replace, double redundancy) {
-  const int64_t num_row = csr.num_rows;
-  const int64_t num_col = csr.num_cols;
-  const int64_t num_actual_samples =
-      static_cast<int64_t>(num_samples * (1 + redundancy));
-  IdArray row = Full<IdType>(-1, num_actual_samples, csr.indptr->ctx);
-  IdArray col = Full<IdType>(-1, num_actual_samples, csr.indptr->ctx);
-  IdType* row_data = row.Ptr<IdType>();
-  IdType* col_data = col.Ptr<IdType>();
+namespace {
 
-  parallel_for(0, num_actual_samples, 1, [&](int64_t b, int64_t e) {
-    for (int64_t i = b; i < e; ++i) {
-      for (int trial = 0; trial < num_trials; ++trial) {
-        IdType u = RandomEngine::ThreadLocal()->RandInt(num_row);
-        IdType v = RandomEngine::ThreadLocal()->RandInt(num_col);
-        if (!(exclude_self_loops && (u == v)) && !CSRIsNonZero(csr, u, v)) {
-          row_data[i] = u;
-          col_data[i] = v;
-          break;
+// The number of candidate pairs drawn by a task, so that the draws of a task
+// can be compacted without synchronization.
+constexpr int64_t kBlockSize = 4096;
+// The minimum number of pairs sorted by a task.
+constexpr int64_t kSortGrainSize = 1 << 16;
+// The extra draws of the rounds after the first one of global sampling.
+constexpr double kRetryMargin = 1.5;
+// The lowest share of draws turning into samples assumed, which bounds the
+// number of draws of a round.
+constexpr double kMinYield = 0.01;
+
+/**
+ * @brief Whether column \a v is a neighbor of row \a u. The neighbors are
+ * binary searched if the columns of each row are sorted.
+ */
+template <typename IdType>
+inline bool IsNeighbor(
+    const IdType* indptr, const IdType* indices, bool sorted, IdType u,
+    IdType v) {
+  const IdType* begin = indices + indptr[u];
+  const IdType* end = indices + indptr[u + 1];
+  return sorted ? std::binary_search(begin, end, v)
+                : std::find(begin, end, v) != end;
+}
+
+/**
+ * @brief Draw \a num_candidates uniform row-column pairs in parallel and append
+ * the ones that are not an entry of \a csr to \a pairs, in the order of the
+ * draws.
+ */
+template <typename IdType>
+void AppendNegativePairs(
+    const CSRMatrix& csr, int64_t num_candidates, bool exclude_self_loops,
+    std::vector<std::pair<IdType, IdType>>* pairs) {
+  const IdType* indptr = csr.indptr.Ptr<IdType>();
+  const IdType* indices = csr.indices.Ptr<IdType>();
+  const IdType num_row = static_cast<IdType>(csr.num_rows);
+  const IdType num_col = static_cast<IdType>(csr.num_cols);
+  const int64_t num_blocks = (num_candidates + kBlockSize - 1) / kBlockSize;
+  std::vector<std::pair<IdType, IdType>> candidates(num_candidates);
+  std::vector<int64_t> offsets(num_blocks + 1, 0);
+
+  parallel_for(0, num_blocks, 1, [&](int64_t b, int64_t e) {
+    auto* rng = RandomEngine::ThreadLocal();
+    for (int64_t block = b; block < e; ++block) {
+      const int64_t begin = block * kBlockSize;
+      const int64_t end = std::min(begin + kBlockSize, num_candidates);
+      int64_t pos = begin;
+      for (int64_t i = begin; i < end; ++i) {
+        const IdType u = rng->RandInt(num_row);
+        const IdType v = rng->RandInt(num_col);
+        if ((exclude_self_loops && u == v) ||
+            IsNeighbor(indptr, indices, csr.sorted, u, v)) {
+          continue;
         }
+        candidates[pos++] = {u, v};
       }
+      offsets[block + 1] = pos - begin;
     }
   });
 
-  PairIterator<IdType> begin(row_data, col_data);
-  PairIterator<IdType> end = std::remove_if(
-      begin, begin + num_actual_samples,
-      [](const std::pair<IdType, IdType>& val) { return val.first == -1; });
-  if (!replace) {
-    std::sort(
-        begin, end,
-        [](const std::pair<IdType, IdType>& a,
-           const std::pair<IdType, IdType>& b) {
-          return a.first < b.first ||
-                 (a.first == b.first && a.second < b.second);
-        });
-    end = std::unique(begin, end);
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  const int64_t num_pairs = pairs->size();
+  pairs->resize(num_pairs + offsets.back());
+  auto* out = pairs->data() + num_pairs;
+  parallel_for(0, num_blocks, 1, [&](int64_t b, int64_t e) {
+    for (int64_t block = b; block < e; ++block) {
+      const auto* begin = candidates.data() + block * kBlockSize;
+      std::copy(
+          begin, begin + offsets[block + 1] - offsets[block],
+          out + offsets[block]);
+    }
+  });
+}
+
+/**
+ * @brief Sort and remove the duplicates of \a pairs. The chunks of the vector
+ * are sorted in parallel and then merged pairwise.
+ */
+template <typename IdType>
+void ParallelSortUnique(std::vector<std::pair<IdType, IdType>>* pairs) {
+  const int64_t num_pairs = pairs->size();
+  const int64_t num_chunks =
+      std::max<int64_t>(compute_num_threads(0, num_pairs, kSortGrainSize), 1);
+  std::vector<int64_t> bounds(num_chunks + 1);
+  for (int64_t i = 0; i <= num_chunks; ++i) {
+    bounds[i] = num_pairs * i / num_chunks;
+  }
+  auto begin = pairs->begin();
+  parallel_for(0, num_chunks, 1, [&](int64_t b, int64_t e) {
+    for (int64_t i = b; i < e; ++i) {
+      std::sort(begin + bounds[i], begin + bounds[i + 1]);
+    }
+  });
+  for (int64_t width = 1; width < num_chunks; width *= 2) {
+    const int64_t num_merges = (num_chunks + 2 * width - 1) / (2 * width);
+    parallel_for(0, num_merges, 1, [&](int64_t b, int64_t e) {
+      for (int64_t i = b; i < e; ++i) {
+        const int64_t first = 2 * width * i;
+        const int64_t middle = std::min(first + width, num_chunks);
+        const int64_t last = std::min(first + 2 * width, num_chunks);
+        std::inplace_merge(
+            begin + bounds[first], begin + bounds[middle],
+            begin + bounds[last]);
+      }
+    });
   }
-  int64_t num_sampled =
-      std::min(static_cast<int64_t>(end - begin), num_samples);
-  return {
-      row.CreateView({num_sampled}, row->dtype),
-      col.CreateView({num_sampled}, col->dtype)};
+  pairs->erase(std::unique(pairs->begin(), pairs->end()), pairs->end());
+}
+
+template <typename IdType>
+std::pair<IdArray, IdArray> PairsToArrays(
+    const std::vector<std::pair<IdType, IdType>>& pairs, int64_t num_pairs,
+    DGLContext ctx) {
+  IdArray row = NewIdArray(num_pairs, ctx, sizeof(IdType) * 8);
+  IdArray col = NewIdArray(num_pairs, ctx, sizeof(IdType) * 8);
+  IdType* row_data = row.Ptr<IdType>();
+  IdType* col_data = col.Ptr<IdType>();
+  parallel_for(0, num_pairs, [&](int64_t b, int64_t e) {
+    for (int64_t i = b; i < e; ++i) {
+      row_data[i] = pairs[i].first;
+      col_data[i] = pairs[i].second;
+    }
+  });
+  return {row, col};
+}
+
+}  // namespace
+
+template <DGLDeviceType XPU, typename IdType>
+std::pair<IdArray, IdArray> CSRGlobalUniformNegativeSampling(
+    const CSRMatrix& csr, int64_t num_samples, int num_trials,
+    bool exclude_self_loops, bool replace, double redundancy) {
+  std::vector<std::pair<IdType, IdType>> pairs;
+  if (csr.num_rows == 0 || csr.num_cols == 0) {
+    return PairsToArrays(pairs, 0, csr.indptr->ctx);
+  }
+  // Each round draws the missing samples with redundancy, until there are
+  // enough of them. The redundancy is chosen so that a single round is
+  // usually enough. The following rounds scale the number of draws by the
+  // share of the draws that turned into new samples, which drops when the
+  // duplicates become frequent.
+  double yield = 1. / (1. + redundancy);
+  for (int trial = 0;
+       trial < num_trials && static_cast<int64_t>(pairs.size()) < num_samples;
+       ++trial) {
+    const int64_t num_missing = num_samples - pairs.size();
+    const int64_t num_candidates =
+        trial == 0 ? std::max<int64_t>(
+                         static_cast<int64_t>(num_missing * (1 + redundancy)),
+                         num_missing)
+                   : static_cast<int64_t>(kRetryMargin * num_missing / yield);
+    const int64_t num_pairs = pairs.size();
+    AppendNegativePairs(csr, num_candidates, exclude_self_loops, &pairs);
+    if (!replace) ParallelSortUnique(&pairs);
+    yield = std::max(
+        static_cast<double>(static_cast<int64_t>(pairs.size()) - num_pairs) /
+            num_candidates,
+        kMinYield);
+  }
+
+  const int64_t num_sampled =
+      std::min(static_cast<int64_t>(pairs.size()), num_samples);
+  if (!replace && num_sampled < static_cast<int64_t>(pairs.size())) {
+    // The unique pairs are sorted, draw the returned ones uniformly instead of
+    // taking the first rows.
+    auto* rng = RandomEngine::ThreadLocal();
+    const int64_t num_pairs = pairs.size();
+    for (int64_t i = 0; i < num_sampled; ++i) {
+      std::swap(pairs[i], pairs[rng->RandInt(i, num_pairs)]);
+    }
+  }
+  return PairsToArrays(pairs, num_sampled, csr.indptr->ctx);
 }
 
 template std::pair<IdArray, IdArray> CSRGlobalUniformNegativeSampling<
@@ -71,6 +201,60 @@ template std::pair<IdArray, IdArray> CSRGlobalUniformNegativeSampling<
 template std::pair<IdArray, IdArray> CSRGlobalUniformNegativeSampling<
     kDGLCPU, int64_t>(const CSRMatrix&, int64_t, int, bool, bool, double);
 
+template <DGLDeviceType XPU, typename IdType>
+std::pair<IdArray, IdArray> CSRPerSourceUniformNegativeSampling(
+    const CSRMatrix& csr, IdArray rows, int64_t k, int num_trials,
+    bool exclude_self_loops) {
+  const IdType* indptr = csr.indptr.Ptr<IdType>();
+  const IdType* indices = csr.indices.Ptr<IdType>();
+  const IdType* rows_data = rows.Ptr<IdType>();
+  const IdType num_col = static_cast<IdType>(csr.num_cols);
+  const int64_t num_samples = rows->shape[0] * k;
+  const int64_t num_blocks = (num_samples + kBlockSize - 1) / kBlockSize;
+  std::vector<std::pair<IdType, IdType>> pairs(num_samples);
+  std::vector<int64_t> offsets(num_blocks + 1, 0);
+
+  // The columns are redrawn until they are not a neighbor of the row, so that
+  // each row gets exactly k negative columns unless it has too few of them.
+  parallel_for(0, num_blocks, 1, [&](int64_t b, int64_t e) {
+    auto* rng = RandomEngine::ThreadLocal();
+    for (int64_t block = b; block < e; ++block) {
+      const int64_t begin = block * kBlockSize;
+      const int64_t end = std::min(begin + kBlockSize, num_samples);
+      int64_t pos = begin;
+      for (int64_t i = begin; i < end; ++i) {
+        const IdType u = rows_data[i / k];
+        for (int trial = 0; trial < num_trials && num_col > 0; ++trial) {
+          const IdType v = rng->RandInt(num_col);
+          if (!(exclude_self_loops && u == v) &&
+              !IsNeighbor(indptr, indices, csr.sorted, u, v)) {
+            pairs[pos++] = {u, v};
+            break;
+          }
+        }
+      }
+      offsets[block + 1] = pos - begin;
+    }
+  });
+
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  if (offsets.back() < num_samples) {
+    // Compact the pairs of the blocks, in order.
+    for (int64_t block = 1; block < num_blocks; ++block) {
+      const auto* begin = pairs.data() + block * kBlockSize;
+      std::copy(
+          begin, begin + offsets[block + 1] - offsets[block],
+          pairs.data() + offsets[block]);
+    }
+  }
+  return PairsToArrays(pairs, offsets.back(), csr.indptr->ctx);
+}
+
+template std::pair<IdArray, IdArray> CSRPerSourceUniformNegativeSampling<
+    kDGLCPU, int32_t>(const CSRMatrix&, IdArray, int64_t, int, bool);
+template std::pair<IdArray, IdArray> CSRPerSourceUniformNegativeSampling<
+    kDGLCPU, int64_t>(const CSRMatrix&, IdArray, int64_t, int, bool);
+
 };  // namespace impl
 };  // namespace aten
 };  // namespace dgl
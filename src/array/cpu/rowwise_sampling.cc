@@ -30,12 +30,11 @@ inline FloatArray DoubleSlice(
 }
 
 template <typename IdxType, typename DType>
-inline NumPicksFn<IdxType> GetSamplingNumPicksFn(
+inline auto GetSamplingNumPicksFn(
     int64_t num_samples, NDArray prob_or_mask, bool replace) {
-  NumPicksFn<IdxType> num_picks_fn = [prob_or_mask, num_samples, replace](
-                                         IdxType rowid, IdxType off,
-                                         IdxType len, const IdxType* col,
-                                         const IdxType* data) {
+  auto num_picks_fn = [prob_or_mask, num_samples, replace](
+                          IdxType rowid, IdxType off, IdxType len,
+                          const IdxType* col, const IdxType* data) {
     const int64_t max_num_picks = (num_samples == -1) ? len : num_samples;
     const DType* prob_or_mask_data = prob_or_mask.Ptr<DType>();
     IdxType nnz = 0;
@@ -56,12 +55,12 @@ inline NumPicksFn<IdxType> GetSamplingNumPicksFn(
 }
 
 template <typename IdxType, typename DType>
-inline PickFn<IdxType> GetSamplingPickFn(
+inline auto GetSamplingPickFn(
     int64_t num_samples, NDArray prob_or_mask, bool replace) {
-  PickFn<IdxType> pick_fn = [prob_or_mask, num_samples, replace](
-                                IdxType rowid, IdxType off, IdxType len,
-                                IdxType num_picks, const IdxType* col,
-                                const IdxType* data, IdxType* out_idx) {
+  auto pick_fn = [prob_or_mask, num_samples, replace](
+                     IdxType rowid, IdxType off, IdxType len, IdxType num_picks,
+                     const IdxType* col, const IdxType* data,
+                     IdxType* out_idx) {
     NDArray prob_or_mask_selected =
         DoubleSlice<IdxType, DType>(prob_or_mask, data, off, len);
     RandomEngine::ThreadLocal()->Choice<IdxType, DType>(
@@ -74,37 +73,34 @@ inline PickFn<IdxType> GetSamplingPickFn(
 }
 
 template <typename IdxType, typename FloatType>
-inline EtypeRangePickFn<IdxType> GetSamplingRangePickFn(
+inline auto GetSamplingRangePickFn(
     const std::vector<int64_t>& num_samples,
     const std::vector<FloatArray>& prob, bool replace) {
-  EtypeRangePickFn<IdxType> pick_fn =
-      [prob, num_samples, replace](
-          IdxType off, IdxType et_offset, IdxType cur_et, IdxType et_len,
-          const std::vector<IdxType>& et_idx,
-          const std::vector<IdxType>& et_eid, const IdxType* eid,
-          IdxType* out_idx) {
-        const FloatArray& p = prob[cur_et];
-        const FloatType* p_data = IsNullArray(p) ? nullptr : p.Ptr<FloatType>();
-        FloatArray probs = FloatArray::Empty({et_len}, p->dtype, p->ctx);
-        FloatType* probs_data = probs.Ptr<FloatType>();
-        for (int64_t j = 0; j < et_len; ++j) {
-          const IdxType cur_eid = et_eid[et_idx[et_offset + j]];
-          probs_data[j] = p_data ? p_data[cur_eid] : static_cast<FloatType>(1.);
-        }
-
-        RandomEngine::ThreadLocal()->Choice<IdxType, FloatType>(
-            num_samples[cur_et], probs, out_idx, replace);
-      };
+  auto pick_fn = [prob, num_samples, replace](
+                     IdxType off, IdxType et_offset, IdxType cur_et,
+                     IdxType et_len, const std::vector<IdxType>& et_idx,
+                     const std::vector<IdxType>& et_eid, const IdxType* eid,
+                     IdxType* out_idx) {
+    const FloatArray& p = prob[cur_et];
+    const FloatType* p_data = IsNullArray(p) ? nullptr : p.Ptr<FloatType>();
+    FloatArray probs = FloatArray::Empty({et_len}, p->dtype, p->ctx);
+    FloatType* probs_data = probs.Ptr<FloatType>();
+    for (int64_t j = 0; j < et_len; ++j) {
+      const IdxType cur_eid = et_eid[et_idx[et_offset + j]];
+      probs_data[j] = p_data ? p_data[cur_eid] : static_cast<FloatType>(1.);
+    }
+
+    RandomEngine::ThreadLocal()->Choice<IdxType, FloatType>(
+        num_samples[cur_et], probs, out_idx, replace);
+  };
   return pick_fn;
 }
 
 template <typename IdxType>
-inline NumPicksFn<IdxType> GetSamplingUniformNumPicksFn(
-    int64_t num_samples, bool replace) {
-  NumPicksFn<IdxType> num_picks_fn = [num_samples, replace](
-                                         IdxType rowid, IdxType off,
-                                         IdxType len, const IdxType* col,
-                                         const IdxType* data) {
+inline auto GetSamplingUniformNumPicksFn(int64_t num_samples, bool replace) {
+  auto num_picks_fn = [num_samples, replace](
+                          IdxType rowid, IdxType off, IdxType len,
+                          const IdxType* col, const IdxType* data) {
     const int64_t max_num_picks = (num_samples == -1) ? len : num_samples;
     if (replace) {
       return static_cast<IdxType>(len == 0 ? 0 : max_num_picks);
@@ -116,12 +112,11 @@ inline NumPicksFn<IdxType> GetSamplingUniformNumPicksFn(
 }
 
 template <typename IdxType>
-inline PickFn<IdxType> GetSamplingUniformPickFn(
-    int64_t num_samples, bool replace) {
-  PickFn<IdxType> pick_fn = [num_samples, replace](
-                                IdxType rowid, IdxType off, IdxType len,
-                                IdxType num_picks, const IdxType* col,
-                                const IdxType* data, IdxType* out_idx) {
+inline auto GetSamplingUniformPickFn(int64_t num_samples, bool replace) {
+  auto pick_fn = [num_samples, replace](
+                     IdxType rowid, IdxType off, IdxType len, IdxType num_picks,
+                     const IdxType* col, const IdxType* data,
+                     IdxType* out_idx) {
     RandomEngine::ThreadLocal()->UniformChoice<IdxType>(
         num_picks, len, out_idx, replace);
     for (int64_t j = 0; j < num_picks; ++j) {
@@ -132,27 +127,25 @@ inline PickFn<IdxType> GetSamplingUniformPickFn(
 }
 
 template <typename IdxType>
-inline EtypeRangePickFn<IdxType> GetSamplingUniformRangePickFn(
+inline auto GetSamplingUniformRangePickFn(
     const std::vector<int64_t>& num_samples, bool replace) {
-  EtypeRangePickFn<IdxType> pick_fn =
-      [num_samples, replace](
-          IdxType off, IdxType et_offset, IdxType cur_et, IdxType et_len,
-          const std::vector<IdxType>& et_idx,
-          const std::vector<IdxType>& et_eid, const IdxType* data,
-          IdxType* out_idx) {
-        RandomEngine::ThreadLocal()->UniformChoice<IdxType>(
-            num_samples[cur_et], et_len, out_idx, replace);
-      };
+  auto pick_fn = [num_samples, replace](
+                     IdxType off, IdxType et_offset, IdxType cur_et,
+                     IdxType et_len, const std::vector<IdxType>& et_idx,
+                     const std::vector<IdxType>& et_eid, const IdxType* data,
+                     IdxType* out_idx) {
+    RandomEngine::ThreadLocal()->UniformChoice<IdxType>(
+        num_samples[cur_et], et_len, out_idx, replace);
+  };
   return pick_fn;
 }
 
 template <typename IdxType, typename FloatType>
-inline NumPicksFn<IdxType> GetSamplingBiasedNumPicksFn(
+inline auto GetSamplingBiasedNumPicksFn(
     int64_t num_samples, IdArray split, FloatArray bias, bool replace) {
-  NumPicksFn<IdxType> num_picks_fn = [num_samples, split, bias, replace](
-                                         IdxType rowid, IdxType off,
-                                         IdxType len, const IdxType* col,
-                                         const IdxType* data) {
+  auto num_picks_fn = [num_samples, split, bias, replace](
+                          IdxType rowid, IdxType off, IdxType len,
+                          const IdxType* col, const IdxType* data) {
     const int64_t max_num_picks = (num_samples == -1) ? len : num_samples;
     const int64_t num_tags = split->shape[1] - 1;
     const IdxType* tag_offset = split.Ptr<IdxType>() + rowid * split->shape[1];
@@ -174,12 +167,12 @@ inline NumPicksFn<IdxType> GetSamplingBiasedNumPicksFn(
 }
 
 template <typename IdxType, typename FloatType>
-inline PickFn<IdxType> GetSamplingBiasedPickFn(
+inline auto GetSamplingBiasedPickFn(
     int64_t num_samples, IdArray split, FloatArray bias, bool replace) {
-  PickFn<IdxType> pick_fn = [num_samples, split, bias, replace](
-                                IdxType rowid, IdxType off, IdxType len,
-                                IdxType num_picks, const IdxType* col,
-                                const IdxType* data, IdxType* out_idx) {
+  auto pick_fn = [num_samples, split, bias, replace](
+                     IdxType rowid, IdxType off, IdxType len, IdxType num_picks,
+                     const IdxType* col, const IdxType* data,
+                     IdxType* out_idx) {
     const IdxType* tag_offset = split.Ptr<IdxType>() + rowid * split->shape[1];
     RandomEngine::ThreadLocal()->BiasedChoice<IdxType, FloatType>(
         num_picks, tag_offset, bias, out_idx, replace);
@@ -205,7 +198,8 @@ COOMatrix CSRRowWiseSampling(
       GetSamplingNumPicksFn<IdxType, DType>(num_samples, prob_or_mask, replace);
   auto pick_fn =
       GetSamplingPickFn<IdxType, DType>(num_samples, prob_or_mask, replace);
-  return CSRRowWisePick(mat, rows, num_samples, replace, pick_fn, num_picks_fn);
+  return CSRRowWisePick<IdxType>(
+      mat, rows, num_samples, replace, pick_fn, num_picks_fn);
 }
 
 template COOMatrix CSRRowWiseSampling<kDGLCPU, int32_t, float>(
@@ -343,7 +337,8 @@ COOMatrix CSRRowWiseSamplingUniform(
   auto num_picks_fn =
       GetSamplingUniformNumPicksFn<IdxType>(num_samples, replace);
   auto pick_fn = GetSamplingUniformPickFn<IdxType>(num_samples, replace);
-  return CSRRowWisePick(mat, rows, num_samples, replace, pick_fn, num_picks_fn);
+  return CSRRowWisePick<IdxType>(
+      mat, rows, num_samples, replace, pick_fn, num_picks_fn);
 }
 
 template COOMatrix CSRRowWiseSamplingUniform<kDGLCPU, int32_t>(
@@ -406,7 +401,8 @@ COOMatrix CSRRowWiseSamplingBiased(
       num_samples, tag_offset, bias, replace);
   auto pick_fn = GetSamplingBiasedPickFn<IdxType, FloatType>(
       num_samples, tag_offset, bias, replace);
-  return CSRRowWisePick(mat, rows, num_samples, replace, pick_fn, num_picks_fn);
+  return CSRRowWisePick<IdxType>(
+      mat, rows, num_samples, replace, pick_fn, num_picks_fn);
 }
 
 template COOMatrix CSRRowWiseSamplingBiased<kDGLCPU, int32_t, float>(
@@ -434,7 +430,8 @@ COOMatrix COORowWiseSampling(
       GetSamplingNumPicksFn<IdxType, DType>(num_samples, prob_or_mask, replace);
   auto pick_fn =
       GetSamplingPickFn<IdxType, DType>(num_samples, prob_or_mask, replace);
-  return COORowWisePick(mat, rows, num_samples, replace, pick_fn, num_picks_fn);
+  return COORowWisePick<IdxType>(
+      mat, rows, num_samples, replace, pick_fn, num_picks_fn);
 }
 
 template COOMatrix COORowWiseSampling<kDGLCPU, int32_t, float>(
@@ -502,7 +499,8 @@ COOMatrix COORowWiseSamplingUniform(
   auto num_picks_fn =
       GetSamplingUniformNumPicksFn<IdxType>(num_samples, replace);
   auto pick_fn = GetSamplingUniformPickFn<IdxType>(num_samples, replace);
-  return COORowWisePick(mat, rows, num_samples, replace, pick_fn, num_picks_fn);
+  return COORowWisePick<IdxType>(
+      mat, rows, num_samples, replace, pick_fn, num_picks_fn);
 }
 
 template COOMatrix COORowWiseSamplingUniform<kDGLCPU, int32_t>(
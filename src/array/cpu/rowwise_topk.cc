@@ -14,49 +14,35 @@ namespace impl {
 namespace {
 
 template <typename IdxType>
-inline NumPicksFn<IdxType> GetTopkNumPicksFn(int64_t k) {
-  NumPicksFn<IdxType> num_picks_fn = [k](IdxType rowid, IdxType off,
-                                         IdxType len, const IdxType* col,
-                                         const IdxType* data) {
+inline auto GetTopkNumPicksFn(int64_t k) {
+  auto num_picks_fn = [k](IdxType rowid, IdxType off, IdxType len,
+                          const IdxType* col, const IdxType* data) {
     const int64_t max_num_picks = (k == -1) ? len : k;
     return std::min(static_cast<IdxType>(max_num_picks), len);
   };
   return num_picks_fn;
 }
 
-template <typename IdxType, typename DType>
-inline PickFn<IdxType> GetTopkPickFn(NDArray weight, bool ascending) {
+template <typename IdxType, typename DType, bool ascending>
+inline auto GetTopkPickFn(NDArray weight) {
   const DType* wdata = static_cast<DType*>(weight->data);
-  PickFn<IdxType> pick_fn = [ascending, wdata](
-                                IdxType rowid, IdxType off, IdxType len,
-                                IdxType num_picks, const IdxType* col,
-                                const IdxType* data, IdxType* out_idx) {
-    std::function<bool(IdxType, IdxType)> compare_fn;
-    if (ascending) {
-      if (data) {
-        compare_fn = [wdata, data](IdxType i, IdxType j) {
-          return wdata[data[i]] < wdata[data[j]];
-        };
-      } else {
-        compare_fn = [wdata](IdxType i, IdxType j) {
-          return wdata[i] < wdata[j];
-        };
-      }
-    } else {
-      if (data) {
-        compare_fn = [wdata, data](IdxType i, IdxType j) {
-          return wdata[data[i]] > wdata[data[j]];
-        };
-      } else {
-        compare_fn = [wdata](IdxType i, IdxType j) {
-          return wdata[i] > wdata[j];
-        };
-      }
-    }
+  auto pick_fn = [wdata](
+                     IdxType rowid, IdxType off, IdxType len, IdxType num_picks,
+                     const IdxType* col, const IdxType* data,
+                     IdxType* out_idx) {
+    auto weight_of = [wdata, data](IdxType i) {
+      return data ? wdata[data[i]] : wdata[i];
+    };
+    auto compare_fn = [&weight_of](IdxType i, IdxType j) {
+      return ascending ? weight_of(i) < weight_of(j)
+                       : weight_of(i) > weight_of(j);
+    };
 
+    // Only the first num_picks elements need to be ordered.
     std::vector<IdxType> idx(len);
     std::iota(idx.begin(), idx.end(), off);
-    std::sort(idx.begin(), idx.end(), compare_fn);
+    std::partial_sort(
+        idx.begin(), idx.begin() + num_picks, idx.end(), compare_fn);
     for (int64_t j = 0; j < num_picks; ++j) {
       out_idx[j] = idx[j];
     }
@@ -71,8 +57,13 @@ template <DGLDeviceType XPU, typename IdxType, typename DType>
 COOMatrix CSRRowWiseTopk(
     CSRMatrix mat, IdArray rows, int64_t k, NDArray weight, bool ascending) {
   auto num_picks_fn = GetTopkNumPicksFn<IdxType>(k);
-  auto pick_fn = GetTopkPickFn<IdxType, DType>(weight, ascending);
-  return CSRRowWisePick(mat, rows, k, false, pick_fn, num_picks_fn);
+  if (ascending) {
+    auto pick_fn = GetTopkPickFn<IdxType, DType, true>(weight);
+    return CSRRowWisePick<IdxType>(mat, rows, k, false, pick_fn, num_picks_fn);
+  } else {
+    auto pick_fn = GetTopkPickFn<IdxType, DType, false>(weight);
+    return CSRRowWisePick<IdxType>(mat, rows, k, false, pick_fn, num_picks_fn);
+  }
 }
 
 template COOMatrix CSRRowWiseTopk<kDGLCPU, int32_t, int32_t>(
@@ -96,8 +87,13 @@ template <DGLDeviceType XPU, typename IdxType, typename DType>
 COOMatrix COORowWiseTopk(
     COOMatrix mat, IdArray rows, int64_t k, NDArray weight, bool ascending) {
   auto num_picks_fn = GetTopkNumPicksFn<IdxType>(k);
-  auto pick_fn = GetTopkPickFn<IdxType, DType>(weight, ascending);
-  return COORowWisePick(mat, rows, k, false, pick_fn, num_picks_fn);
+  if (ascending) {
+    auto pick_fn = GetTopkPickFn<IdxType, DType, true>(weight);
+    return COORowWisePick<IdxType>(mat, rows, k, false, pick_fn, num_picks_fn);
+  } else {
+    auto pick_fn = GetTopkPickFn<IdxType, DType, false>(weight);
+    return COORowWisePick<IdxType>(mat, rows, k, false, pick_fn, num_picks_fn);
+  }
 }
 
 template COOMatrix COORowWiseTopk<kDGLCPU, int32_t, int32_t>(
@@ -0,0 +1,244 @@
+/**
+ *  Copyright (c) 2024 by Contributors
+ * @file array/cpu/spgemm.h
+ * @brief Row-wise (Gustavson) sparse matrix product/sum on CPU.
+ */
+#ifndef DGL_ARRAY_CPU_SPGEMM_H_
+#define DGL_ARRAY_CPU_SPGEMM_H_
+
+#include <dgl/array.h>
+#include <dgl/runtime/parallel_for.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace dgl {
+namespace aten {
+namespace cpu {
+
+/**
+ * @brief Scratch space for accumulating one output row of a sparse matrix
+ * product or sum.
+ *
+ * Rows whose estimated number of products is large compared to the number of
+ * columns are accumulated into a dense array indexed by column. The other rows
+ * are accumulated as (column, value) pairs that are sorted and merged when the
+ * row is flushed. Either way the row is emitted with sorted column indices.
+ *
+ * An accumulator is meant to be created once per thread and reused for all the
+ * rows the thread processes, so that no allocation happens per row.
+ */
+template <typename IdType, typename DType>
+class RowAccumulator {
+ public:
+  explicit RowAccumulator(int64_t num_cols) : num_cols_(num_cols) {}
+
+  /** @brief Start a new row with \a flops estimated products. */
+  void Reset(int64_t flops) {
+    dense_ = UseDense(flops);
+    if (dense_) {
+      if (marker_.empty()) {
+        marker_.assign(num_cols_, -1);
+        values_.resize(num_cols_);
+      }
+      ++stamp_;
+    }
+    cols_.clear();
+    pairs_.clear();
+  }
+
+  /** @brief Record a column of the current row without its value. */
+  void AddCol(IdType col) {
+    if (dense_) {
+      if (marker_[col] != stamp_) {
+        marker_[col] = stamp_;
+        cols_.push_back(col);
+      }
+    } else {
+      cols_.push_back(col);
+    }
+  }
+
+  /** @brief Add \a val to the entry at column \a col of the current row. */
+  void Add(IdType col, DType val) {
+    if (dense_) {
+      if (marker_[col] != stamp_) {
+        marker_[col] = stamp_;
+        values_[col] = val;
+        cols_.push_back(col);
+      } else {
+        values_[col] += val;
+      }
+    } else {
+      pairs_.emplace_back(col, val);
+    }
+  }
+
+  /** @brief Number of distinct columns recorded by AddCol in this row. */
+  int64_t Count() {
+    if (!dense_) {
+      std::sort(cols_.begin(), cols_.end());
+      cols_.erase(std::unique(cols_.begin(), cols_.end()), cols_.end());
+    }
+    return cols_.size();
+  }
+
+  /**
+   * @brief Write the accumulated row in ascending column order.
+   * @return The number of entries written.
+   */
+  int64_t Flush(IdType* indices, DType* data) {
+    int64_t n = 0;
+    if (dense_) {
+      if (static_cast<int64_t>(cols_.size()) * kScanRatio > num_cols_) {
+        // The row is nearly full; scanning the marker is cheaper than sorting.
+        const auto minmax = std::minmax_element(cols_.begin(), cols_.end());
+        for (IdType c = *minmax.first; c <= *minmax.second; ++c) {
+          if (marker_[c] == stamp_) {
+            indices[n] = c;
+            data[n++] = values_[c];
+          }
+        }
+      } else {
+        std::sort(cols_.begin(), cols_.end());
+        for (IdType c : cols_) {
+          indices[n] = c;
+          data[n++] = values_[c];
+        }
+      }
+    } else if (!pairs_.empty()) {
+      std::sort(
+          pairs_.begin(), pairs_.end(),
+          [](const std::pair<IdType, DType>& a,
+             const std::pair<IdType, DType>& b) { return a.first < b.first; });
+      indices[0] = pairs_[0].first;
+      data[0] = pairs_[0].second;
+      for (size_t j = 1; j < pairs_.size(); ++j) {
+        if (pairs_[j].first == indices[n]) {
+          data[n] += pairs_[j].second;
+        } else {
+          indices[++n] = pairs_[j].first;
+          data[n] = pairs_[j].second;
+        }
+      }
+      ++n;
+    }
+    return n;
+  }
+
+ private:
+  // Rows over at most this many columns always use the dense accumulator since
+  // the whole dense array stays in cache.
+  static constexpr int64_t kCacheCols = 1 << 15;
+  // Never allocate a dense accumulator wider than this per thread.
+  static constexpr int64_t kMaxDenseCols = 1 << 22;
+  // Use the dense accumulator when flops * kDenseRatio >= num_cols.
+  static constexpr int64_t kDenseRatio = 16;
+  // Scan the marker instead of sorting when nnz * kScanRatio > num_cols.
+  static constexpr int64_t kScanRatio = 8;
+
+  bool UseDense(int64_t flops) const {
+    if (num_cols_ <= kCacheCols) return true;
+    return num_cols_ <= kMaxDenseCols && flops * kDenseRatio >= num_cols_;
+  }
+
+  const int64_t num_cols_;
+  bool dense_ = false;
+  int64_t stamp_ = -1;
+  std::vector<int64_t> marker_;
+  std::vector<DType> values_;
+  std::vector<IdType> cols_;
+  std::vector<std::pair<IdType, DType>> pairs_;
+};
+
+/**
+ * @brief Compute a sparse matrix whose rows are sums of scaled sparse rows,
+ * e.g. the product or the sum of CSR matrices.
+ *
+ * Rows are split into one contiguous range per thread such that every range
+ * has about the same number of estimated products, then the output is computed
+ * in a symbolic pass (nnz per row) and a numeric pass. The column indices of
+ * every output row are sorted.
+ *
+ * @param M Number of rows of the output.
+ * @param N Number of columns of the output.
+ * @param idx_type_ref Array whose dtype and context the output indices follow.
+ * @param val_type_ref Array whose dtype and context the output values follow.
+ * @param flops_fn Callable (int64_t row) -> int64_t returning the number of
+ *        products contributing to the row.
+ * @param visit_fn Callable (int64_t row, Emit emit) that invokes
+ *        emit(IdType col, DType val) for every product contributing to the
+ *        row. It is invoked twice per row.
+ * @return The output matrix (with sorted indices) and its values.
+ */
+template <typename IdType, typename DType, typename FlopsFn, typename VisitFn>
+std::pair<CSRMatrix, NDArray> RowwiseSpGEMM(
+    int64_t M, int64_t N, IdArray idx_type_ref, NDArray val_type_ref,
+    const FlopsFn& flops_fn, const VisitFn& visit_fn) {
+  std::vector<int64_t> flops(M + 1, 0);
+  runtime::parallel_for(0, M, [&](size_t b, size_t e) {
+    for (auto i = b; i < e; ++i) flops[i + 1] = flops_fn(i);
+  });
+  for (int64_t i = 0; i < M; ++i) flops[i + 1] += flops[i];
+
+  // Balance the estimated products rather than the rows across threads.
+  const int64_t num_parts = runtime::compute_num_threads(0, M, 1);
+  std::vector<int64_t> bounds(num_parts + 1, M);
+  bounds[0] = 0;
+  for (int64_t p = 1; p < num_parts; ++p) {
+    const int64_t target = flops[M] / num_parts * p;
+    bounds[p] =
+        std::lower_bound(flops.begin(), flops.end(), target) - flops.begin();
+    bounds[p] = std::min(std::max(bounds[p], bounds[p - 1]), M);
+  }
+
+  IdArray C_indptr =
+      IdArray::Empty({M + 1}, idx_type_ref->dtype, idx_type_ref->ctx);
+  IdType* C_indptr_data = C_indptr.Ptr<IdType>();
+  C_indptr_data[0] = 0;
+  runtime::parallel_for(0, num_parts, 1, [&](size_t b, size_t e) {
+    RowAccumulator<IdType, DType> acc(N);
+    for (auto p = b; p < e; ++p) {
+      for (int64_t i = bounds[p]; i < bounds[p + 1]; ++i) {
+        acc.Reset(flops[i + 1] - flops[i]);
+        visit_fn(i, [&acc](IdType col, DType) { acc.AddCol(col); });
+        C_indptr_data[i + 1] = acc.Count();
+      }
+    }
+  });
+  for (int64_t i = 0; i < M; ++i) C_indptr_data[i + 1] += C_indptr_data[i];
+  const int64_t nnz = C_indptr_data[M];
+
+  IdArray C_indices =
+      IdArray::Empty({nnz}, idx_type_ref->dtype, idx_type_ref->ctx);
+  NDArray C_weights =
+      NDArray::Empty({nnz}, val_type_ref->dtype, val_type_ref->ctx);
+  IdType* C_indices_data = C_indices.Ptr<IdType>();
+  DType* C_weights_data = C_weights.Ptr<DType>();
+  runtime::parallel_for(0, num_parts, 1, [&](size_t b, size_t e) {
+    RowAccumulator<IdType, DType> acc(N);
+    for (auto p = b; p < e; ++p) {
+      for (int64_t i = bounds[p]; i < bounds[p + 1]; ++i) {
+        acc.Reset(flops[i + 1] - flops[i]);
+        visit_fn(i, [&acc](IdType col, DType val) { acc.Add(col, val); });
+        const int64_t n = acc.Flush(
+            C_indices_data + C_indptr_data[i],
+            C_weights_data + C_indptr_data[i]);
+        CHECK_EQ(n, C_indptr_data[i + 1] - C_indptr_data[i]);
+      }
+    }
+  });
+
+  return {
+      CSRMatrix(
+          M, N, C_indptr, C_indices, NullArray(C_indptr->dtype, C_indptr->ctx),
+          true),
+      C_weights};
+}
+
+}  // namespace cpu
+}  // namespace aten
+}  // namespace dgl
+
+#endif  // DGL_ARRAY_CPU_SPGEMM_H_
@@ -6,6 +6,7 @@
 #include <dgl/array.h>
 #include <dgl/runtime/parallel_for.h>
 
+#include <algorithm>
 #include <atomic>
 #include <numeric>
 #include <unordered_set>
@@ -242,8 +243,18 @@ template std::vector<NDArray> CSRGetDataAndIndices<kDGLCPU, int64_t>(
 
 ///////////////////////////// CSRTranspose /////////////////////////////
 
+// The minimum number of entries counted by a thread of CSRTranspose.
+constexpr int64_t kTransposeGrainSize = 1 << 16;
+
 // for a matrix of shape (N, M) and NNZ
-// complexity: time O(NNZ + max(N, M)), space O(1)
+// complexity: time O(NNZ + max(N, M) * T), space O(min(NNZ, M * T)) where T
+// is the number of threads
+//
+// The rows are split into chunks with about the same number of entries. Each
+// chunk counts its entries per column, and the counts are turned into the
+// position of the first entry of each chunk in each column, so that the
+// chunks scatter their entries in parallel and in row order. The number of
+// chunks is bounded so that the counts take no more space than the entries.
 template <DGLDeviceType XPU, typename IdType>
 CSRMatrix CSRTranspose(CSRMatrix csr) {
   const int64_t N = csr.num_rows;
@@ -262,11 +273,33 @@ CSRMatrix CSRTranspose(CSRMatrix csr) {
   IdType* Bi = static_cast<IdType*>(ret_indices->data);
   IdType* Bx = static_cast<IdType*>(ret_data->data);
 
-  std::fill(Bp, Bp + M, 0);
-
-  for (int64_t j = 0; j < nnz; ++j) {
-    Bp[Aj[j]]++;
+  const int64_t num_chunks = std::max<int64_t>(
+      1, std::min<int64_t>(
+             runtime::compute_num_threads(0, nnz, kTransposeGrainSize),
+             nnz / std::max<int64_t>(M, 1)));
+  std::vector<int64_t> row_bounds(num_chunks + 1, N);
+  for (int64_t t = 0; t < num_chunks; ++t) {
+    row_bounds[t] = std::lower_bound(Ap, Ap + N, nnz * t / num_chunks) - Ap;
   }
+  row_bounds[0] = 0;
+  std::vector<IdType> offsets(num_chunks * M, 0);
+
+  parallel_for(0, num_chunks, 1, [&](int64_t b, int64_t e) {
+    for (int64_t t = b; t < e; ++t) {
+      IdType* counts = offsets.data() + t * M;
+      for (IdType j = Ap[row_bounds[t]]; j < Ap[row_bounds[t + 1]]; ++j) {
+        counts[Aj[j]]++;
+      }
+    }
+  });
+
+  parallel_for(0, M, [&](int64_t b, int64_t e) {
+    for (int64_t i = b; i < e; ++i) {
+      IdType count = 0;
+      for (int64_t t = 0; t < num_chunks; ++t) count += offsets[t * M + i];
+      Bp[i] = count;
+    }
+  });
 
   // cumsum
   for (int64_t i = 0, cumsum = 0; i < M; ++i) {
@@ -276,21 +309,30 @@ CSRMatrix CSRTranspose(CSRMatrix csr) {
   }
   Bp[M] = nnz;
 
-  for (int64_t i = 0; i < N; ++i) {
-    for (IdType j = Ap[i]; j < Ap[i + 1]; ++j) {
-      const IdType dst = Aj[j];
-      Bi[Bp[dst]] = i;
-      Bx[Bp[dst]] = Ax ? Ax[j] : j;
-      Bp[dst]++;
+  parallel_for(0, M, [&](int64_t b, int64_t e) {
+    for (int64_t i = b; i < e; ++i) {
+      IdType pos = Bp[i];
+      for (int64_t t = 0; t < num_chunks; ++t) {
+        const IdType temp = offsets[t * M + i];
+        offsets[t * M + i] = pos;
+        pos += temp;
+      }
     }
-  }
+  });
 
-  // correct the indptr
-  for (int64_t i = 0, last = 0; i <= M; ++i) {
-    IdType temp = Bp[i];
-    Bp[i] = last;
-    last = temp;
-  }
+  parallel_for(0, num_chunks, 1, [&](int64_t b, int64_t e) {
+    for (int64_t t = b; t < e; ++t) {
+      IdType* pos = offsets.data() + t * M;
+      for (int64_t i = row_bounds[t]; i < row_bounds[t + 1]; ++i) {
+        for (IdType j = Ap[i]; j < Ap[i + 1]; ++j) {
+          const IdType dst = Aj[j];
+          Bi[pos[dst]] = i;
+          Bx[pos[dst]] = Ax ? Ax[j] : j;
+          pos[dst]++;
+        }
+      }
+    }
+  });
 
   return CSRMatrix{
       csr.num_cols, csr.num_rows, ret_indptr, ret_indices, ret_data};
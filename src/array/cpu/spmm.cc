@@ -251,6 +251,69 @@ template void Edge_softmax_csr_backward<kDGLCPU, int64_t, double>(
     const std::string& op, const BcastOff& bcast, const CSRMatrix& csr,
     NDArray ufeat, NDArray efeat, NDArray out);
 
+/** @brief Edge softmax weighted SpMM forward op on Csr format. */
+template <int XPU, typename IdType, typename DType>
+void Edge_softmax_spmm_csr_forward(
+    const BcastOff& bcast, const CSRMatrix& csr, NDArray ufeat, NDArray efeat,
+    NDArray out, NDArray emax, NDArray esum) {
+  cpu::Edge_softmax_spmm_csr_forward<IdType, DType>(
+      bcast, csr, ufeat, efeat, out, emax, esum);
+}
+
+/** @brief Edge softmax weighted SpMM backward op on Csr format. */
+template <int XPU, typename IdType, typename DType>
+void Edge_softmax_spmm_csr_backward(
+    const BcastOff& bcast, const CSRMatrix& csc, const CSRMatrix& csr,
+    NDArray ufeat, NDArray efeat, NDArray out, NDArray emax, NDArray esum,
+    NDArray grad_out, NDArray grad_ufeat, NDArray grad_efeat) {
+  cpu::Edge_softmax_spmm_csr_backward<IdType, DType>(
+      bcast, csc, csr, ufeat, efeat, out, emax, esum, grad_out, grad_ufeat,
+      grad_efeat);
+}
+template void Edge_softmax_spmm_csr_forward<kDGLCPU, int32_t, BFloat16>(
+    const BcastOff& bcast, const CSRMatrix& csr, NDArray ufeat, NDArray efeat,
+    NDArray out, NDArray emax, NDArray esum);
+template void Edge_softmax_spmm_csr_forward<kDGLCPU, int64_t, BFloat16>(
+    const BcastOff& bcast, const CSRMatrix& csr, NDArray ufeat, NDArray efeat,
+    NDArray out, NDArray emax, NDArray esum);
+template void Edge_softmax_spmm_csr_forward<kDGLCPU, int32_t, float>(
+    const BcastOff& bcast, const CSRMatrix& csr, NDArray ufeat, NDArray efeat,
+    NDArray out, NDArray emax, NDArray esum);
+template void Edge_softmax_spmm_csr_forward<kDGLCPU, int64_t, float>(
+    const BcastOff& bcast, const CSRMatrix& csr, NDArray ufeat, NDArray efeat,
+    NDArray out, NDArray emax, NDArray esum);
+template void Edge_softmax_spmm_csr_forward<kDGLCPU, int32_t, double>(
+    const BcastOff& bcast, const CSRMatrix& csr, NDArray ufeat, NDArray efeat,
+    NDArray out, NDArray emax, NDArray esum);
+template void Edge_softmax_spmm_csr_forward<kDGLCPU, int64_t, double>(
+    const BcastOff& bcast, const CSRMatrix& csr, NDArray ufeat, NDArray efeat,
+    NDArray out, NDArray emax, NDArray esum);
+
+template void Edge_softmax_spmm_csr_backward<kDGLCPU, int32_t, BFloat16>(
+    const BcastOff& bcast, const CSRMatrix& csc, const CSRMatrix& csr,
+    NDArray ufeat, NDArray efeat, NDArray out, NDArray emax, NDArray esum,
+    NDArray grad_out, NDArray grad_ufeat, NDArray grad_efeat);
+template void Edge_softmax_spmm_csr_backward<kDGLCPU, int64_t, BFloat16>(
+    const BcastOff& bcast, const CSRMatrix& csc, const CSRMatrix& csr,
+    NDArray ufeat, NDArray efeat, NDArray out, NDArray emax, NDArray esum,
+    NDArray grad_out, NDArray grad_ufeat, NDArray grad_efeat);
+template void Edge_softmax_spmm_csr_backward<kDGLCPU, int32_t, float>(
+    const BcastOff& bcast, const CSRMatrix& csc, const CSRMatrix& csr,
+    NDArray ufeat, NDArray efeat, NDArray out, NDArray emax, NDArray esum,
+    NDArray grad_out, NDArray grad_ufeat, NDArray grad_efeat);
+template void Edge_softmax_spmm_csr_backward<kDGLCPU, int64_t, float>(
+    const BcastOff& bcast, const CSRMatrix& csc, const CSRMatrix& csr,
+    NDArray ufeat, NDArray efeat, NDArray out, NDArray emax, NDArray esum,
+    NDArray grad_out, NDArray grad_ufeat, NDArray grad_efeat);
+template void Edge_softmax_spmm_csr_backward<kDGLCPU, int32_t, double>(
+    const BcastOff& bcast, const CSRMatrix& csc, const CSRMatrix& csr,
+    NDArray ufeat, NDArray efeat, NDArray out, NDArray emax, NDArray esum,
+    NDArray grad_out, NDArray grad_ufeat, NDArray grad_efeat);
+template void Edge_softmax_spmm_csr_backward<kDGLCPU, int64_t, double>(
+    const BcastOff& bcast, const CSRMatrix& csc, const CSRMatrix& csr,
+    NDArray ufeat, NDArray efeat, NDArray out, NDArray emax, NDArray esum,
+    NDArray grad_out, NDArray grad_ufeat, NDArray grad_efeat);
+
 /** @brief Generalized SpMM on Coo format. */
 template <int XPU, typename IdType, typename DType>
 void SpMMCoo(
@@ -31,6 +31,88 @@ template <typename DType>
 using AccType = typename std::conditional<
     std::is_same<DType, BFloat16>::value, float, DType>::type;
 
+/**
+ * @brief A range of output features over which the lhs and rhs offsets of a
+ *        broadcast advance with a constant stride of either 0 or 1.
+ */
+struct BcastRun {
+  int64_t out_begin, len, lhs_begin, rhs_begin;
+  int lhs_stride, rhs_stride;
+};
+
+/**
+ * @brief Split the output features of a broadcast into runs.
+ *
+ * Common broadcasts, e.g. multi-head features of shape (H, D) multiplied by
+ * per-head edge weights of shape (H, 1), decompose into a few long runs, so
+ * that the kernels can loop over contiguous (or constant) operands instead of
+ * looking up the offset table for every element.
+ */
+inline std::vector<BcastRun> ComputeBcastRuns(const BcastOff& bcast) {
+  std::vector<BcastRun> runs;
+  const int64_t dim = bcast.out_len;
+  if (!bcast.use_bcast) {
+    if (dim > 0) runs.push_back({0, dim, 0, 0, 1, 1});
+    return runs;
+  }
+  const auto& lhs = bcast.lhs_offset;
+  const auto& rhs = bcast.rhs_offset;
+  for (int64_t k = 0; k < dim;) {
+    BcastRun run{k, 1, lhs[k], rhs[k], 0, 0};
+    if (k + 1 < dim) {
+      const int64_t ls = lhs[k + 1] - lhs[k], rs = rhs[k + 1] - rhs[k];
+      if ((ls == 0 || ls == 1) && (rs == 0 || rs == 1)) {
+        run.lhs_stride = ls;
+        run.rhs_stride = rs;
+        while (k + run.len < dim &&
+               lhs[k + run.len] == run.lhs_begin + run.len * ls &&
+               rhs[k + run.len] == run.rhs_begin + run.len * rs)
+          ++run.len;
+      }
+    }
+    runs.push_back(run);
+    k += run.len;
+  }
+  return runs;
+}
+
+template <int kLhsStride, int kRhsStride, typename F>
+inline void ForEachInBcastRun(const BcastRun& run, const F& f) {
+  const int64_t out_begin = run.out_begin, lhs_begin = run.lhs_begin,
+                rhs_begin = run.rhs_begin;
+#pragma omp simd
+  for (int64_t j = 0; j < run.len; ++j)
+    f(out_begin + j, lhs_begin + j * kLhsStride, rhs_begin + j * kRhsStride);
+}
+
+/**
+ * @brief Invoke f(k, lhs_add, rhs_add) for every output feature k with the
+ *        broadcast offsets of the lhs and rhs operands.
+ *
+ * The strides of every run are compile-time constants in the inner loop, so
+ * that it is vectorized the same way as the loop without broadcasting. Hence
+ * f must not write to the same location for different k.
+ */
+template <typename F>
+inline void ForEachBcastOffset(const std::vector<BcastRun>& runs, const F& f) {
+  for (const BcastRun& run : runs) {
+    switch (run.lhs_stride * 2 + run.rhs_stride) {
+      case 0:
+        ForEachInBcastRun<0, 0>(run, f);
+        break;
+      case 1:
+        ForEachInBcastRun<0, 1>(run, f);
+        break;
+      case 2:
+        ForEachInBcastRun<1, 0>(run, f);
+        break;
+      default:
+        ForEachInBcastRun<1, 1>(run, f);
+        break;
+    }
+  }
+}
+
 /**
  * @brief Naive CPU kernel of SpMM on Csr format.
  * @param cpu_spec JIT'ed kernel
@@ -52,6 +134,7 @@ SpMMSumCsrNaive(
   const IdType* indices = csr.indices.Ptr<IdType>();
   const IdType* edges = csr.data.Ptr<IdType>();
   int64_t dim = bcast.out_len, lhs_dim = bcast.lhs_len, rhs_dim = bcast.rhs_len;
+  const std::vector<BcastRun> runs = ComputeBcastRuns(bcast);
   runtime::parallel_for(0, csr.num_rows, [&](size_t b, size_t e) {
     for (auto rid = b; rid < e; ++rid) {
       const IdType row_start = indptr[rid], row_end = indptr[rid + 1];
@@ -59,15 +142,14 @@ SpMMSumCsrNaive(
       for (IdType j = row_start; j < row_end; ++j) {
         const IdType cid = indices[j];
         const IdType eid = has_idx ? edges[j] : j;
-        for (int64_t k = 0; k < dim; ++k) {
-          const int64_t lhs_add = bcast.use_bcast ? bcast.lhs_offset[k] : k;
-          const int64_t rhs_add = bcast.use_bcast ? bcast.rhs_offset[k] : k;
-          const DType* lhs_off =
-              Op::use_lhs ? X + cid * lhs_dim + lhs_add : nullptr;
-          const DType* rhs_off =
-              Op::use_rhs ? W + eid * rhs_dim + rhs_add : nullptr;
-          out_off[k] += Op::Call(lhs_off, rhs_off);
-        }
+        const DType* lhs_row = Op::use_lhs ? X + cid * lhs_dim : nullptr;
+        const DType* rhs_row = Op::use_rhs ? W + eid * rhs_dim : nullptr;
+        ForEachBcastOffset(
+            runs, [=](int64_t k, int64_t lhs_add, int64_t rhs_add) {
+              out_off[k] += Op::Call(
+                  Op::use_lhs ? lhs_row + lhs_add : nullptr,
+                  Op::use_rhs ? rhs_row + rhs_add : nullptr);
+            });
       }
     }
   });
@@ -159,6 +241,72 @@ void SpMMSumCsr(
 #endif  // _WIN32
 }
 
+/**
+ * @brief Visit the edges of a Coo matrix in parallel, such that all the edges
+ *        of a destination node are visited by the same thread in their order
+ *        in the matrix.
+ * @param coo The Coo matrix.
+ * @param f Callable (int64_t i) invoked on every edge position i.
+ * @note Destination nodes are split into contiguous chunks, and the edges of
+ *       every chunk are gathered with a parallel counting sort. The chunks
+ *       are then dynamically scheduled over the threads, so that the
+ *       reduction on a destination node never needs synchronization.
+ */
+template <typename IdType, typename F>
+void ParallelForCooByDst(const COOMatrix& coo, F&& f) {
+  // Minimal number of edges per thread.
+  constexpr int64_t kGrainSize = 1 << 12;
+  // Number of destination chunks per thread, for load balance.
+  constexpr int64_t kChunksPerThread = 16;
+  const int64_t nnz = coo.row->shape[0];
+  const IdType* col = coo.col.Ptr<IdType>();
+  const int64_t num_threads = runtime::compute_num_threads(0, nnz, kGrainSize);
+  if (num_threads <= 1) {
+    for (int64_t i = 0; i < nnz; ++i) f(i);
+    return;
+  }
+  const int64_t num_chunks =
+      std::min<int64_t>(num_threads * kChunksPerThread, coo.num_cols);
+  const int64_t chunk_size = (coo.num_cols + num_chunks - 1) / num_chunks;
+  const int64_t part_size = (nnz + num_threads - 1) / num_threads;
+
+  // offset[p * num_chunks + c]: where the edges of part p to chunk c go.
+  std::vector<int64_t> offset(num_threads * num_chunks, 0);
+  runtime::parallel_for(0, num_threads, 1, [&](size_t b, size_t e) {
+    for (auto p = b; p < e; ++p) {
+      int64_t* count = offset.data() + p * num_chunks;
+      const int64_t end = std::min<int64_t>(nnz, (p + 1) * part_size);
+      for (int64_t i = p * part_size; i < end; ++i) {
+        ++count[col[i] / chunk_size];
+      }
+    }
+  });
+  std::vector<int64_t> chunk_offset(num_chunks + 1, 0);
+  for (int64_t c = 0; c < num_chunks; ++c) {
+    chunk_offset[c + 1] = chunk_offset[c];
+    for (int64_t p = 0; p < num_threads; ++p) {
+      const int64_t count = offset[p * num_chunks + c];
+      offset[p * num_chunks + c] = chunk_offset[c + 1];
+      chunk_offset[c + 1] += count;
+    }
+  }
+  std::vector<IdType> pos(nnz);
+  runtime::parallel_for(0, num_threads, 1, [&](size_t b, size_t e) {
+    for (auto p = b; p < e; ++p) {
+      int64_t* off = offset.data() + p * num_chunks;
+      const int64_t end = std::min<int64_t>(nnz, (p + 1) * part_size);
+      for (int64_t i = p * part_size; i < end; ++i) {
+        pos[off[col[i] / chunk_size]++] = i;
+      }
+    }
+  });
+
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+  for (int64_t c = 0; c < num_chunks; ++c) {
+    for (int64_t j = chunk_offset[c]; j < chunk_offset[c + 1]; ++j) f(pos[j]);
+  }
+}
+
 /**
  * @brief CPU kernel of SpMM on Coo format.
  * @param bcast Broadcast information.
@@ -167,8 +315,7 @@ void SpMMSumCsr(
  * @param efeat The feature on edges.
  * @param out The result feature on destination nodes.
  * @note it uses node parallel strategy, different threads are responsible
- *       for the computation of different nodes. To avoid possible data hazard,
- *       we use atomic operators in the reduction phase.
+ *       for the computation of different nodes, see ParallelForCooByDst.
  */
 template <typename IdType, typename DType, typename Op>
 typename std::enable_if<!std::is_same<DType, BFloat16>::value, void>::type
@@ -183,30 +330,33 @@ SpMMSumCoo(
   const DType* W = efeat.Ptr<DType>();
   int64_t dim = bcast.out_len, lhs_dim = bcast.lhs_len, rhs_dim = bcast.rhs_len;
   DType* O = out.Ptr<DType>();
-  const int64_t nnz = coo.row->shape[0];
   // fill zero elements
   memset(O, 0, out.GetSize());
   // spmm
-#pragma omp parallel for
-  for (IdType i = 0; i < nnz; ++i) {
+  ParallelForCooByDst<IdType>(coo, [&](int64_t i) {
     const IdType rid = row[i];
     const IdType cid = col[i];
     const IdType eid = has_idx ? edges[i] : i;
     DType* out_off = O + cid * dim;
-    for (int64_t k = 0; k < dim; ++k) {
-      const int64_t lhs_add = bcast.use_bcast ? bcast.lhs_offset[k] : k;
-      const int64_t rhs_add = bcast.use_bcast ? bcast.rhs_offset[k] : k;
-      const DType* lhs_off =
-          Op::use_lhs ? X + rid * lhs_dim + lhs_add : nullptr;
-      const DType* rhs_off =
-          Op::use_rhs ? W + eid * rhs_dim + rhs_add : nullptr;
-      const DType val = Op::Call(lhs_off, rhs_off);
-      if (val != 0) {
-#pragma omp atomic
-        out_off[k] += val;
+    const DType* lhs_row = Op::use_lhs ? X + rid * lhs_dim : nullptr;
+    const DType* rhs_row = Op::use_rhs ? W + eid * rhs_dim : nullptr;
+    if (bcast.use_bcast) {
+      for (int64_t k = 0; k < dim; ++k) {
+        const DType* lhs_off =
+            Op::use_lhs ? lhs_row + bcast.lhs_offset[k] : nullptr;
+        const DType* rhs_off =
+            Op::use_rhs ? rhs_row + bcast.rhs_offset[k] : nullptr;
+        out_off[k] += Op::Call(lhs_off, rhs_off);
+      }
+    } else {
+#pragma omp simd
+      for (int64_t k = 0; k < dim; ++k) {
+        const DType* lhs_off = Op::use_lhs ? lhs_row + k : nullptr;
+        const DType* rhs_off = Op::use_rhs ? rhs_row + k : nullptr;
+        out_off[k] += Op::Call(lhs_off, rhs_off);
       }
     }
-  }
+  });
 }
 
 template <typename IdType, typename DType, typename Op>
@@ -278,6 +428,7 @@ void SpMMCmpCsr(
 #endif  // USE_LIBXSMM
 #endif  // _WIN32
 
+    const std::vector<BcastRun> runs = ComputeBcastRuns(bcast);
     runtime::parallel_for(0, csr.num_rows, [&](size_t b, size_t e) {
       for (auto rid = b; rid < e; ++rid) {
         const IdType row_start = indptr[rid], row_end = indptr[rid + 1];
@@ -287,20 +438,19 @@ void SpMMCmpCsr(
         for (IdType j = row_start; j < row_end; ++j) {
           const IdType cid = indices[j];
           const IdType eid = has_idx ? edges[j] : j;
-          for (int64_t k = 0; k < dim; ++k) {
-            const int64_t lhs_add = bcast.use_bcast ? bcast.lhs_offset[k] : k;
-            const int64_t rhs_add = bcast.use_bcast ? bcast.rhs_offset[k] : k;
-            const DType* lhs_off =
-                Op::use_lhs ? X + cid * lhs_dim + lhs_add : nullptr;
-            const DType* rhs_off =
-                Op::use_rhs ? W + eid * rhs_dim + rhs_add : nullptr;
-            const DType val = Op::Call(lhs_off, rhs_off);
-            if (Cmp::Call(out_off[k], val)) {
-              out_off[k] = val;
-              if (Op::use_lhs) argx_off[k] = cid;
-              if (Op::use_rhs) argw_off[k] = eid;
-            }
-          }
+          const DType* lhs_row = Op::use_lhs ? X + cid * lhs_dim : nullptr;
+          const DType* rhs_row = Op::use_rhs ? W + eid * rhs_dim : nullptr;
+          // Branch-free selects so that the loop over features vectorizes.
+          ForEachBcastOffset(
+              runs, [=](int64_t k, int64_t lhs_add, int64_t rhs_add) {
+                const DType val = Op::Call(
+                    Op::use_lhs ? lhs_row + lhs_add : nullptr,
+                    Op::use_rhs ? rhs_row + rhs_add : nullptr);
+                const bool take = Cmp::Call(out_off[k], val);
+                out_off[k] = take ? val : out_off[k];
+                if (Op::use_lhs) argx_off[k] = take ? cid : argx_off[k];
+                if (Op::use_rhs) argw_off[k] = take ? eid : argw_off[k];
+              });
         }
       }
     });
@@ -371,6 +521,7 @@ void SpMMCmpCsrHetero(
     CHECK_NOTNULL(argW);
   }
   // TODO(Israt): Use LIBXSMM. Homogeneous graph uses LIBXMM when enabled.
+  const std::vector<BcastRun> runs = ComputeBcastRuns(bcast);
   runtime::parallel_for(0, csr.num_rows, [&](size_t b, size_t e) {
     for (auto rid = b; rid < e; ++rid) {
       const IdType row_start = indptr[rid], row_end = indptr[rid + 1];
@@ -382,26 +533,24 @@ void SpMMCmpCsrHetero(
       for (IdType j = row_start; j < row_end; ++j) {
         const IdType cid = indices[j];
         const IdType eid = has_idx ? edges[j] : j;
-        for (int64_t k = 0; k < dim; ++k) {
-          const int64_t lhs_add = bcast.use_bcast ? bcast.lhs_offset[k] : k;
-          const int64_t rhs_add = bcast.use_bcast ? bcast.rhs_offset[k] : k;
-          const DType* lhs_off =
-              Op::use_lhs ? X + cid * lhs_dim + lhs_add : nullptr;
-          const DType* rhs_off =
-              Op::use_rhs ? W + eid * rhs_dim + rhs_add : nullptr;
-          const DType val = Op::Call(lhs_off, rhs_off);
-          if (Cmp::Call(out_off[k], val)) {
-            out_off[k] = val;
-            if (Op::use_lhs) {
-              argx_off[k] = cid;
-              argx_ntype[k] = ntype;
-            }
-            if (Op::use_rhs) {
-              argw_off[k] = eid;
-              argw_etype[k] = etype;
-            }
-          }
-        }
+        const DType* lhs_row = Op::use_lhs ? X + cid * lhs_dim : nullptr;
+        const DType* rhs_row = Op::use_rhs ? W + eid * rhs_dim : nullptr;
+        ForEachBcastOffset(
+            runs, [=](int64_t k, int64_t lhs_add, int64_t rhs_add) {
+              const DType val = Op::Call(
+                  Op::use_lhs ? lhs_row + lhs_add : nullptr,
+                  Op::use_rhs ? rhs_row + rhs_add : nullptr);
+              const bool take = Cmp::Call(out_off[k], val);
+              out_off[k] = take ? val : out_off[k];
+              if (Op::use_lhs) {
+                argx_off[k] = take ? cid : argx_off[k];
+                argx_ntype[k] = take ? ntype : argx_ntype[k];
+              }
+              if (Op::use_rhs) {
+                argw_off[k] = take ? eid : argw_off[k];
+                argw_etype[k] = take ? etype : argw_etype[k];
+              }
+            });
       }
     }
   });
@@ -423,8 +572,7 @@ void SpMMCmpCsrHetero(
  *        destination nodes. It's useful in computing gradients of Min/Max
  *        reducer.
  * @note it uses node parallel strategy, different threads are responsible for
- *       the computation of different nodes. To avoid possible data hazard, we
- *       use atomic operators in the reduction phase.
+ *       the computation of different nodes, see ParallelForCooByDst.
  * @note The result will contain infinity for zero-degree nodes.
  */
 template <typename IdType, typename DType, typename Op, typename Cmp>
@@ -443,12 +591,10 @@ void SpMMCmpCoo(
   DType* O = static_cast<DType*>(out->data);
   IdType* argX = Op::use_lhs ? static_cast<IdType*>(argu->data) : nullptr;
   IdType* argW = Op::use_rhs ? static_cast<IdType*>(arge->data) : nullptr;
-  const int64_t nnz = coo.row->shape[0];
   // fill zero elements
   std::fill(O, O + out.NumElements(), Cmp::zero);
   // spmm
-#pragma omp parallel for
-  for (IdType i = 0; i < nnz; ++i) {
+  ParallelForCooByDst<IdType>(coo, [&](int64_t i) {
     const IdType rid = row[i];
     const IdType cid = col[i];
     const IdType eid = has_idx ? edges[i] : i;
@@ -463,14 +609,13 @@ void SpMMCmpCoo(
       const DType* rhs_off =
           Op::use_rhs ? W + eid * rhs_dim + rhs_add : nullptr;
       const DType val = Op::Call(lhs_off, rhs_off);
-#pragma omp critical
       if (Cmp::Call(out_off[k], val)) {
         out_off[k] = val;
         if (Op::use_lhs) argx_off[k] = rid;
         if (Op::use_rhs) argw_off[k] = eid;
       }
     }
-  }
+  });
 }
 
 /**
@@ -569,6 +714,212 @@ void Edge_softmax_csr_backward(
   });
 }
 
+/**
+ * @brief CPU kernel of the sum of source node features weighted by the edge
+ *        softmax on Csr format, i.e. u_mul_e_sum with the softmax of the edge
+ *        logits over the incoming edges of every destination node.
+ * @param bcast Broadcast information of the source features and the logits.
+ * @param csr The Csr matrix whose rows are the destination nodes.
+ * @param ufeat The feature on source nodes.
+ * @param efeat The logits on edges.
+ * @param out The result feature on destination nodes.
+ * @param emax The maximum of the logits on destination nodes.
+ * @param esum The sum of exp(logits - emax) on destination nodes.
+ * @note The softmax is computed online in a single pass over the edges of a
+ *       row, rescaling the partial sum whenever the maximum grows, so that the
+ *       edge weights are never written to memory.
+ */
+template <typename IdType, typename DType>
+void Edge_softmax_spmm_csr_forward(
+    const BcastOff& bcast, const CSRMatrix& csr, NDArray ufeat, NDArray efeat,
+    NDArray out, NDArray emax, NDArray esum) {
+  typedef AccType<DType> Acc;
+  const bool has_idx = !IsNullArray(csr.data);
+  const IdType* indptr = csr.indptr.Ptr<IdType>();
+  const IdType* indices = csr.indices.Ptr<IdType>();
+  const IdType* edges = has_idx ? csr.data.Ptr<IdType>() : nullptr;
+  const DType* X = ufeat.Ptr<DType>();
+  const DType* W = efeat.Ptr<DType>();
+  DType* O = out.Ptr<DType>();
+  DType* M = emax.Ptr<DType>();
+  DType* S = esum.Ptr<DType>();
+  const int64_t dim = bcast.out_len, lhs_dim = bcast.lhs_len,
+                rhs_dim = bcast.rhs_len;
+  const std::vector<BcastRun> runs = ComputeBcastRuns(bcast);
+  runtime::parallel_for(0, csr.num_rows, [&](size_t b, size_t e) {
+    std::vector<Acc> acc_buf(dim), max_buf(rhs_dim), sum_buf(rhs_dim),
+        scale_buf(rhs_dim), weight_buf(rhs_dim);
+    Acc* acc = acc_buf.data();
+    Acc* max_v = max_buf.data();
+    Acc* sum_v = sum_buf.data();
+    Acc* scale = scale_buf.data();
+    Acc* weight = weight_buf.data();
+    for (auto rid = b; rid < e; ++rid) {
+      const IdType row_start = indptr[rid], row_end = indptr[rid + 1];
+      std::fill(acc, acc + dim, 0);
+      std::fill(max_v, max_v + rhs_dim, -std::numeric_limits<Acc>::infinity());
+      std::fill(sum_v, sum_v + rhs_dim, 0);
+      for (IdType j = row_start; j < row_end; ++j) {
+        const IdType cid = indices[j];
+        const IdType eid = has_idx ? edges[j] : j;
+        const DType* logits = W + eid * rhs_dim;
+        for (int64_t h = 0; h < rhs_dim; ++h) {
+          const Acc x = logits[h];
+          if (x > max_v[h]) {
+            scale[h] = std::exp(max_v[h] - x);
+            max_v[h] = x;
+          } else {
+            scale[h] = 1;
+          }
+          weight[h] = std::exp(x - max_v[h]);
+          sum_v[h] = sum_v[h] * scale[h] + weight[h];
+        }
+        const DType* lhs_row = X + cid * lhs_dim;
+        ForEachBcastOffset(
+            runs, [=](int64_t k, int64_t lhs_add, int64_t rhs_add) {
+              acc[k] = acc[k] * scale[rhs_add] +
+                       weight[rhs_add] * static_cast<Acc>(lhs_row[lhs_add]);
+            });
+      }
+      DType* out_off = O + rid * dim;
+      if (row_end == row_start) {
+        std::fill(out_off, out_off + dim, 0);
+      } else {
+        ForEachBcastOffset(runs, [=](int64_t k, int64_t, int64_t rhs_add) {
+          out_off[k] = acc[k] / sum_v[rhs_add];
+        });
+      }
+      for (int64_t h = 0; h < rhs_dim; ++h) {
+        M[rid * rhs_dim + h] = max_v[h];
+        S[rid * rhs_dim + h] = sum_v[h];
+      }
+    }
+  });
+}
+
+/**
+ * @brief CPU kernel of the backward of Edge_softmax_spmm_csr_forward.
+ * @param bcast Broadcast information of the source features and the logits.
+ * @param csc The Csr matrix whose rows are the destination nodes.
+ * @param csr The Csr matrix whose rows are the source nodes.
+ * @param ufeat The feature on source nodes.
+ * @param efeat The logits on edges.
+ * @param out The result of the forward.
+ * @param emax The maximum of the logits saved by the forward.
+ * @param esum The sum of exp(logits - emax) saved by the forward.
+ * @param grad_out The gradient of out.
+ * @param grad_ufeat The gradient of ufeat, which must be zero-initialized.
+ * @param grad_efeat The gradient of efeat.
+ * @note The edge weights are recomputed from the logits and the saved
+ *       statistics. The gradient of the logits is reduced over the destination
+ *       nodes and the gradient of the source features over the source nodes,
+ *       so neither needs atomics.
+ */
+template <typename IdType, typename DType>
+void Edge_softmax_spmm_csr_backward(
+    const BcastOff& bcast, const CSRMatrix& csc, const CSRMatrix& csr,
+    NDArray ufeat, NDArray efeat, NDArray out, NDArray emax, NDArray esum,
+    NDArray grad_out, NDArray grad_ufeat, NDArray grad_efeat) {
+  typedef AccType<DType> Acc;
+  const DType* X = ufeat.Ptr<DType>();
+  const DType* W = efeat.Ptr<DType>();
+  const DType* O = out.Ptr<DType>();
+  const DType* M = emax.Ptr<DType>();
+  const DType* S = esum.Ptr<DType>();
+  const DType* dO = grad_out.Ptr<DType>();
+  DType* dX = grad_ufeat.Ptr<DType>();
+  DType* dW = grad_efeat.Ptr<DType>();
+  const int64_t dim = bcast.out_len, lhs_dim = bcast.lhs_len,
+                rhs_dim = bcast.rhs_len;
+  auto lhs_offset = [&bcast](int64_t k) {
+    return bcast.use_bcast ? bcast.lhs_offset[k] : k;
+  };
+  auto rhs_offset = [&bcast](int64_t k) {
+    return bcast.use_bcast ? bcast.rhs_offset[k] : k;
+  };
+
+  // grad_efeat[e] = a[e] * (<grad_out[v], ufeat[u]> - <grad_out[v], out[v]>)
+  // per logit, where a is the edge softmax and e = (u, v).
+  {
+    const bool has_idx = !IsNullArray(csc.data);
+    const IdType* indptr = csc.indptr.Ptr<IdType>();
+    const IdType* indices = csc.indices.Ptr<IdType>();
+    const IdType* edges = has_idx ? csc.data.Ptr<IdType>() : nullptr;
+    runtime::parallel_for(0, csc.num_rows, [&](size_t b, size_t e) {
+      std::vector<Acc> dot_out(rhs_dim), dot_u(rhs_dim);
+      for (auto rid = b; rid < e; ++rid) {
+        const IdType row_start = indptr[rid], row_end = indptr[rid + 1];
+        if (row_start == row_end) continue;
+        const DType* grad_off = dO + rid * dim;
+        const DType* out_off = O + rid * dim;
+        std::fill(dot_out.begin(), dot_out.end(), 0);
+        for (int64_t k = 0; k < dim; ++k)
+          dot_out[rhs_offset(k)] += static_cast<Acc>(grad_off[k]) * out_off[k];
+        for (IdType j = row_start; j < row_end; ++j) {
+          const IdType cid = indices[j];
+          const IdType eid = has_idx ? edges[j] : j;
+          const DType* lhs_row = X + cid * lhs_dim;
+          std::fill(dot_u.begin(), dot_u.end(), 0);
+          for (int64_t k = 0; k < dim; ++k)
+            dot_u[rhs_offset(k)] +=
+                static_cast<Acc>(grad_off[k]) * lhs_row[lhs_offset(k)];
+          for (int64_t h = 0; h < rhs_dim; ++h) {
+            const Acc a = std::exp(
+                              static_cast<Acc>(W[eid * rhs_dim + h]) -
+                              M[rid * rhs_dim + h]) /
+                          S[rid * rhs_dim + h];
+            dW[eid * rhs_dim + h] = a * (dot_u[h] - dot_out[h]);
+          }
+        }
+      }
+    });
+  }
+
+  // grad_ufeat[u] = sum of a[e] * grad_out[v] over the out edges e = (u, v).
+  {
+    const bool has_idx = !IsNullArray(csr.data);
+    const IdType* indptr = csr.indptr.Ptr<IdType>();
+    const IdType* indices = csr.indices.Ptr<IdType>();
+    const IdType* edges = has_idx ? csr.data.Ptr<IdType>() : nullptr;
+    // Without broadcasting on the source features every output feature maps
+    // to a distinct source feature, so the loop over features vectorizes.
+    const bool vectorize = lhs_dim == dim;
+    const std::vector<BcastRun> runs = ComputeBcastRuns(bcast);
+    runtime::parallel_for(0, csr.num_rows, [&](size_t b, size_t e) {
+      std::vector<Acc> acc_buf(lhs_dim), weight_buf(rhs_dim);
+      Acc* acc = acc_buf.data();
+      Acc* weight = weight_buf.data();
+      for (auto rid = b; rid < e; ++rid) {
+        const IdType row_start = indptr[rid], row_end = indptr[rid + 1];
+        if (row_start == row_end) continue;
+        std::fill(acc, acc + lhs_dim, 0);
+        for (IdType j = row_start; j < row_end; ++j) {
+          const IdType dst = indices[j];
+          const IdType eid = has_idx ? edges[j] : j;
+          for (int64_t h = 0; h < rhs_dim; ++h) {
+            weight[h] = std::exp(
+                            static_cast<Acc>(W[eid * rhs_dim + h]) -
+                            M[dst * rhs_dim + h]) /
+                        S[dst * rhs_dim + h];
+          }
+          const DType* grad_off = dO + dst * dim;
+          if (vectorize) {
+            ForEachBcastOffset(
+                runs, [=](int64_t k, int64_t lhs_add, int64_t rhs_add) {
+                  acc[lhs_add] += weight[rhs_add] * grad_off[k];
+                });
+          } else {
+            for (int64_t k = 0; k < dim; ++k)
+              acc[lhs_offset(k)] += weight[rhs_offset(k)] * grad_off[k];
+          }
+        }
+        DType* grad_u = dX + rid * lhs_dim;
+        for (int64_t k = 0; k < lhs_dim; ++k) grad_u[k] += acc[k];
+      }
+    });
+  }
+}
+
 }  // namespace cpu
 }  // namespace aten
 }  // namespace dgl
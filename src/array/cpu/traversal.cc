@@ -34,6 +34,9 @@ struct VectorQueueWrapper {
   size_t size() const { return vec->size() - head; }
 };
 
+// Graphs with fewer nodes per thread than this are traversed serially.
+constexpr int64_t kParallelTraversalGrainSize = 1 << 16;
+
 // Internal function to merge multiple traversal traces into one ndarray.
 // It is similar to zip the vectors together.
 template <typename DType>
@@ -91,6 +94,16 @@ template <DGLDeviceType XPU, typename IdType>
 Frontiers BFSNodesFrontiers(const CSRMatrix& csr, IdArray source) {
   std::vector<IdType> ids;
   std::vector<int64_t> sections;
+  const int num_threads = runtime::compute_num_threads(
+      0, csr.num_rows, kParallelTraversalGrainSize);
+  if (num_threads > 1) {
+    ParallelBFSFrontiers<IdType, false>(
+        csr, source, num_threads, &ids, &sections);
+    Frontiers front;
+    front.ids = VecToIdArray(ids, sizeof(IdType) * 8);
+    front.sections = VecToIdArray(sections, sizeof(int64_t) * 8);
+    return front;
+  }
   VectorQueueWrapper<IdType> queue(&ids);
   auto visit = [&](const int64_t v) {};
   auto make_frontier = [&]() {
@@ -116,6 +129,16 @@ template <DGLDeviceType XPU, typename IdType>
 Frontiers BFSEdgesFrontiers(const CSRMatrix& csr, IdArray source) {
   std::vector<IdType> ids;
   std::vector<int64_t> sections;
+  const int num_threads = runtime::compute_num_threads(
+      0, csr.num_rows, kParallelTraversalGrainSize);
+  if (num_threads > 1) {
+    ParallelBFSFrontiers<IdType, true>(
+        csr, source, num_threads, &ids, &sections);
+    Frontiers front;
+    front.ids = VecToIdArray(ids, sizeof(IdType) * 8);
+    front.sections = VecToIdArray(sections, sizeof(int64_t) * 8);
+    return front;
+  }
   // NOTE: std::queue has no top() method.
   std::vector<IdType> nodes;
   VectorQueueWrapper<IdType> queue(&nodes);
@@ -146,6 +169,15 @@ template <DGLDeviceType XPU, typename IdType>
 Frontiers TopologicalNodesFrontiers(const CSRMatrix& csr) {
   std::vector<IdType> ids;
   std::vector<int64_t> sections;
+  const int num_threads = runtime::compute_num_threads(
+      0, csr.num_rows, kParallelTraversalGrainSize);
+  if (num_threads > 1) {
+    ParallelTopologicalFrontiers<IdType>(csr, num_threads, &ids, &sections);
+    Frontiers front;
+    front.ids = VecToIdArray(ids, sizeof(IdType) * 8);
+    front.sections = VecToIdArray(sections, sizeof(int64_t) * 8);
+    return front;
+  }
   VectorQueueWrapper<IdType> queue(&ids);
   auto visit = [&](const uint64_t v) {};
   auto make_frontier = [&]() {
@@ -12,7 +12,10 @@
 #define DGL_ARRAY_CPU_TRAVERSAL_H_
 
 #include <dgl/graph_interface.h>
+#include <dgl/runtime/parallel_for.h>
 
+#include <algorithm>
+#include <limits>
 #include <stack>
 #include <tuple>
 #include <vector>
@@ -226,6 +229,370 @@ void TopologicalNodes(
   }
 }
 
+/////////////////////// Level-synchronous parallel traversal ///////////////////
+
+// The traversals below process one frontier at a time with all threads and
+// produce exactly the same frontiers, in the same order, as the queue-driven
+// traversals above.
+//
+// Every edge leaving the current frontier gets a key that is its position in
+// the serial expansion order, i.e. the number of frontier edges preceding it.
+// Keys keep increasing across levels. In BFS, a newly reached node is
+// discovered by the edge with the smallest key reaching it, and in topological
+// traversal by the edge with the largest key (the last in-edge to be removed).
+// The next frontier is the set of discovered nodes ordered by key.
+
+namespace detail {
+
+constexpr int64_t kNoKey = std::numeric_limits<int64_t>::max();
+
+inline void AtomicMin(int64_t *addr, int64_t val) {
+  int64_t old = __atomic_load_n(addr, __ATOMIC_RELAXED);
+  while (val < old && !__atomic_compare_exchange_n(
+                          addr, &old, val, true, __ATOMIC_RELAXED,
+                          __ATOMIC_RELAXED)) {
+  }
+}
+
+inline void AtomicMax(int64_t *addr, int64_t val) {
+  int64_t old = __atomic_load_n(addr, __ATOMIC_RELAXED);
+  while (val > old && !__atomic_compare_exchange_n(
+                          addr, &old, val, true, __ATOMIC_RELAXED,
+                          __ATOMIC_RELAXED)) {
+  }
+}
+
+/** @brief A fixed-size bitmap whose bits can be set concurrently. */
+class ConcurrentBitmap {
+ public:
+  explicit ConcurrentBitmap(int64_t size) : words_((size + 63) / 64, 0) {}
+
+  bool Test(int64_t i) const { return (words_[i >> 6] >> (i & 63)) & 1; }
+
+  void Set(int64_t i) {
+    __atomic_fetch_or(
+        &words_[i >> 6], uint64_t{1} << (i & 63), __ATOMIC_RELAXED);
+  }
+
+ private:
+  std::vector<uint64_t> words_;
+};
+
+/**
+ * @brief State of a level-synchronous traversal over the out-edges of a CSR.
+ *
+ * Holds the current frontier, the key of its first edge for every frontier
+ * node and a partition of the frontier into parts with about the same number
+ * of edges, one per thread.
+ */
+template <typename IdType>
+struct FrontierExpansion {
+  const IdType *indptr;
+  const IdType *indices;
+  int num_parts;
+
+  std::vector<IdType> frontier;
+  // offsets[i] is the key of the first out-edge of frontier[i].
+  std::vector<int64_t> offsets;
+  // The frontier nodes in [bounds[p], bounds[p + 1]) belong to part p.
+  std::vector<int64_t> bounds;
+  // Per-part buffers of the discovered nodes, and of the discovering edges.
+  std::vector<std::vector<IdType>> local_nodes, local_edges;
+
+  FrontierExpansion(const CSRMatrix &csr, int num_parts)
+      : indptr(csr.indptr.Ptr<IdType>()),
+        indices(csr.indices.Ptr<IdType>()),
+        num_parts(num_parts),
+        bounds(num_parts + 1),
+        local_nodes(num_parts),
+        local_edges(num_parts) {}
+
+  /** @brief Number of edges leaving the frontier. */
+  int64_t NumEdges() const { return offsets.back() - offsets.front(); }
+
+  /** @brief Compute keys and parts for the frontier, starting at \a base. */
+  void Prepare(int64_t base) {
+    const int64_t n = frontier.size();
+    offsets.resize(n + 1);
+    offsets[0] = base;
+    for (int64_t i = 0; i < n; ++i) {
+      const IdType u = frontier[i];
+      offsets[i + 1] = offsets[i] + indptr[u + 1] - indptr[u];
+    }
+    bounds[0] = 0;
+    for (int p = 1; p < num_parts; ++p) {
+      const int64_t target = base + NumEdges() / num_parts * p;
+      bounds[p] = std::max(
+          bounds[p - 1],
+          static_cast<int64_t>(
+              std::upper_bound(offsets.begin(), offsets.end() - 1, target) -
+              offsets.begin() - 1));
+    }
+    bounds[num_parts] = n;
+  }
+
+  /**
+   * @brief Call \a fn(key, edge position) for every frontier edge, in parallel
+   * over parts. Within a part the edges are visited in increasing key order.
+   */
+  template <typename Fn>
+  void ForEachEdge(Fn fn) const {
+    runtime::parallel_for(0, num_parts, 1, [&](size_t b, size_t e) {
+      for (auto p = b; p < e; ++p) {
+        for (int64_t i = bounds[p]; i < bounds[p + 1]; ++i) {
+          const IdType u = frontier[i];
+          const int64_t key = offsets[i] - indptr[u];
+          for (IdType idx = indptr[u]; idx < indptr[u + 1]; ++idx) {
+            fn(p, key + idx, idx);
+          }
+        }
+      }
+    });
+  }
+
+  /** @brief Concatenate the per-part buffers, in part order, into \a out. */
+  static void Gather(
+      std::vector<std::vector<IdType>> *local, std::vector<IdType> *out) {
+    const int num_parts = local->size();
+    std::vector<int64_t> offsets(num_parts + 1, 0);
+    for (int p = 0; p < num_parts; ++p) {
+      offsets[p + 1] = offsets[p] + (*local)[p].size();
+    }
+    out->resize(offsets[num_parts]);
+    runtime::parallel_for(0, num_parts, 1, [&](size_t b, size_t e) {
+      for (auto p = b; p < e; ++p) {
+        std::copy(
+            (*local)[p].begin(), (*local)[p].end(),
+            out->begin() + offsets[p]);
+        (*local)[p].clear();
+      }
+    });
+  }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Parallel, direction-optimizing breadth-first-search.
+ *
+ * Produces the same frontiers as BFSTraverseNodes (or BFSTraverseEdges if \a
+ * kEdges is true). Frontiers are expanded top-down with per-thread buffers.
+ * When the frontier has many out-edges compared to the rest of the graph,
+ * the expansion switches to bottom-up: each unvisited node scans its in-edges
+ * for frontier nodes. Since the discovering edge must be the one with the
+ * smallest key, the bottom-up scan cannot stop at the first parent found, so
+ * the switch happens later than in classic direction-optimizing BFS.
+ *
+ * @param csr The graph.
+ * @param source Source nodes.
+ * @param num_threads Number of threads to use.
+ * @param ids Output ids. Nodes (including the sources) if \a kEdges is false,
+ *        otherwise the edges of the BFS tree.
+ * @param sections Output sizes of the frontiers.
+ */
+template <typename IdType, bool kEdges>
+void ParallelBFSFrontiers(
+    const CSRMatrix &csr, IdArray source, int num_threads,
+    std::vector<IdType> *ids, std::vector<int64_t> *sections) {
+  // Switch to bottom-up when the frontier edges exceed 1/kAlpha of the edges
+  // of unvisited nodes, and back to top-down when the frontier has less than
+  // 1/kBeta of the nodes.
+  constexpr int64_t kAlpha = 4;
+  constexpr int64_t kBeta = 24;
+
+  const int64_t len = source->shape[0];
+  const IdType *src_data = source.Ptr<IdType>();
+  const int64_t num_nodes = csr.num_rows;
+  const IdType *eid_data = CSRHasData(csr) ? csr.data.Ptr<IdType>() : nullptr;
+
+  detail::FrontierExpansion<IdType> expand(csr, num_threads);
+  detail::ConcurrentBitmap visited(num_nodes);
+  std::vector<int64_t> claim(num_nodes, detail::kNoKey);
+  std::vector<IdType> next_edges;
+  expand.frontier.assign(src_data, src_data + len);
+  for (const IdType u : expand.frontier) visited.Set(u);
+  if (!kEdges) {
+    ids->insert(ids->end(), expand.frontier.begin(), expand.frontier.end());
+    if (len > 0) sections->push_back(len);
+  }
+
+  // Built on the first bottom-up step: the in-edges of every node, as
+  // positions into csr.indices.
+  CSRMatrix in_csr;
+  bool has_in_csr = false;
+  bool bottom_up = false;
+  int64_t unexplored_edges = csr.indices->shape[0];
+  int64_t base = 0;
+
+  while (!expand.frontier.empty()) {
+    expand.Prepare(base);
+    const int64_t frontier_edges = expand.NumEdges();
+    unexplored_edges -= frontier_edges;
+    if (!bottom_up) {
+      bottom_up = frontier_edges > unexplored_edges / kAlpha;
+    } else {
+      bottom_up =
+          static_cast<int64_t>(expand.frontier.size()) >= num_nodes / kBeta;
+    }
+
+    if (!bottom_up) {
+      // Every unvisited node reached by the frontier keeps its smallest key.
+      expand.ForEachEdge([&](int, int64_t key, IdType idx) {
+        const IdType v = expand.indices[idx];
+        if (!visited.Test(v)) detail::AtomicMin(&claim[v], key);
+      });
+      expand.ForEachEdge([&](int p, int64_t key, IdType idx) {
+        const IdType v = expand.indices[idx];
+        if (!visited.Test(v) && claim[v] == key) {
+          expand.local_nodes[p].push_back(v);
+          if (kEdges) {
+            expand.local_edges[p].push_back(eid_data ? eid_data[idx] : idx);
+          }
+        }
+      });
+    } else {
+      if (!has_in_csr) {
+        in_csr = CSRTranspose(CSRMatrix(
+            csr.num_rows, csr.num_cols, csr.indptr, csr.indices));
+        has_in_csr = true;
+      }
+      const IdType *in_indptr = in_csr.indptr.Ptr<IdType>();
+      const IdType *in_indices = in_csr.indices.Ptr<IdType>();
+      const IdType *in_pos = in_csr.data.Ptr<IdType>();
+      // claim[u] of a frontier node u is the key of its first out-edge minus
+      // the position of that edge, so that key = claim[u] + position.
+      runtime::parallel_for(0, expand.frontier.size(), [&](size_t b, size_t e) {
+        for (auto i = b; i < e; ++i) {
+          const IdType u = expand.frontier[i];
+          detail::AtomicMin(&claim[u], expand.offsets[i] - expand.indptr[u]);
+        }
+      });
+      // The discovering edge of every node, indexed by key.
+      std::vector<int64_t> slot(frontier_edges, -1);
+      runtime::parallel_for(0, num_nodes, [&](size_t b, size_t e) {
+        for (auto v = b; v < e; ++v) {
+          if (visited.Test(v)) continue;
+          int64_t best = detail::kNoKey, best_pos = -1;
+          for (IdType j = in_indptr[v]; j < in_indptr[v + 1]; ++j) {
+            const IdType u = in_indices[j];
+            // Frontier nodes are visited, other visited nodes have no claim.
+            if (!visited.Test(u) || claim[u] == detail::kNoKey) continue;
+            const int64_t key = claim[u] + in_pos[j];
+            if (key < best) {
+              best = key;
+              best_pos = in_pos[j];
+            }
+          }
+          if (best_pos >= 0) slot[best - base] = best_pos;
+        }
+      });
+      runtime::parallel_for(0, expand.frontier.size(), [&](size_t b, size_t e) {
+        for (auto i = b; i < e; ++i) claim[expand.frontier[i]] = detail::kNoKey;
+      });
+      // Split the keys evenly among the parts and collect them in order.
+      runtime::parallel_for(0, expand.num_parts, 1, [&](size_t b, size_t e) {
+        for (auto p = b; p < e; ++p) {
+          const int64_t chunk =
+              (frontier_edges + expand.num_parts - 1) / expand.num_parts;
+          const int64_t kb =
+              std::min(frontier_edges, static_cast<int64_t>(p) * chunk);
+          const int64_t ke = std::min(frontier_edges, kb + chunk);
+          for (int64_t k = kb; k < ke; ++k) {
+            if (slot[k] < 0) continue;
+            expand.local_nodes[p].push_back(expand.indices[slot[k]]);
+            if (kEdges) {
+              expand.local_edges[p].push_back(
+                  eid_data ? eid_data[slot[k]] : slot[k]);
+            }
+          }
+        }
+      });
+    }
+
+    base += frontier_edges;
+    detail::FrontierExpansion<IdType>::Gather(
+        &expand.local_nodes, &expand.frontier);
+    runtime::parallel_for(0, expand.frontier.size(), [&](size_t b, size_t e) {
+      for (auto i = b; i < e; ++i) {
+        visited.Set(expand.frontier[i]);
+        claim[expand.frontier[i]] = detail::kNoKey;
+      }
+    });
+    if (expand.frontier.empty()) break;
+    if (kEdges) {
+      detail::FrontierExpansion<IdType>::Gather(
+          &expand.local_edges, &next_edges);
+      ids->insert(ids->end(), next_edges.begin(), next_edges.end());
+    } else {
+      ids->insert(ids->end(), expand.frontier.begin(), expand.frontier.end());
+    }
+    sections->push_back(expand.frontier.size());
+  }
+}
+
+/**
+ * @brief Parallel level-synchronous topological traversal.
+ *
+ * Produces the same frontiers as TopologicalNodes. The in-degrees of the
+ * nodes reached by a frontier are decremented concurrently, and a node whose
+ * in-degree drops to zero is discovered by its in-edge with the largest key.
+ *
+ * @param csr The graph.
+ * @param num_threads Number of threads to use.
+ * @param ids Output node ids.
+ * @param sections Output sizes of the frontiers.
+ */
+template <typename IdType>
+void ParallelTopologicalFrontiers(
+    const CSRMatrix &csr, int num_threads, std::vector<IdType> *ids,
+    std::vector<int64_t> *sections) {
+  const IdType *indices_data = csr.indices.Ptr<IdType>();
+  const int64_t num_nodes = csr.num_rows;
+  const int64_t num_edges = csr.indices->shape[0];
+
+  std::vector<int64_t> degrees(num_nodes, 0);
+  runtime::parallel_for(0, num_edges, [&](size_t b, size_t e) {
+    for (auto eid = b; eid < e; ++eid) {
+      __atomic_fetch_add(&degrees[indices_data[eid]], 1, __ATOMIC_RELAXED);
+    }
+  });
+
+  detail::FrontierExpansion<IdType> expand(csr, num_threads);
+  for (int64_t vid = 0; vid < num_nodes; ++vid) {
+    if (degrees[vid] == 0) expand.frontier.push_back(vid);
+  }
+
+  std::vector<int64_t> last_key(num_nodes, -1);
+  int64_t num_visited_nodes = 0;
+  int64_t base = 0;
+  while (!expand.frontier.empty()) {
+    num_visited_nodes += expand.frontier.size();
+    ids->insert(ids->end(), expand.frontier.begin(), expand.frontier.end());
+    sections->push_back(expand.frontier.size());
+
+    expand.Prepare(base);
+    expand.ForEachEdge([&](int, int64_t key, IdType idx) {
+      const IdType v = indices_data[idx];
+      __atomic_fetch_sub(&degrees[v], 1, __ATOMIC_RELAXED);
+      detail::AtomicMax(&last_key[v], key);
+    });
+    expand.ForEachEdge([&](int p, int64_t key, IdType idx) {
+      const IdType v = indices_data[idx];
+      if (degrees[v] == 0 && last_key[v] == key) {
+        expand.local_nodes[p].push_back(v);
+      }
+    });
+    base += expand.NumEdges();
+    detail::FrontierExpansion<IdType>::Gather(
+        &expand.local_nodes, &expand.frontier);
+  }
+
+  if (num_visited_nodes != num_nodes) {
+    LOG(FATAL)
+        << "Error in topological traversal: loop detected in the given graph.";
+  }
+}
+
 /** @brief Tags for ``DFSEdges``. */
 enum DFSEdgeTag {
   kForward = 0,
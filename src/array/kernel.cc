@@ -342,6 +342,42 @@ void Edge_softmax_backward(
   });
 }
 
+/** @brief Edge softmax weighted SpMM for forward */
+void Edge_softmax_spmm_forward(
+    HeteroGraphPtr graph, NDArray ufeat, NDArray efeat, NDArray out,
+    NDArray emax, NDArray esum) {
+  const auto& bcast = CalcBcastOff("mul", ufeat, efeat);
+
+  ATEN_XPU_SWITCH(graph->Context().device_type, XPU, "edge_softmax_spmm", {
+    ATEN_ID_TYPE_SWITCH(graph->DataType(), IdType, {
+      ATEN_FLOAT_TYPE_SWITCH_16BITS(
+          out->dtype, Dtype, XPU, "edge_softmax_spmm out data", {
+            Edge_softmax_spmm_csr_forward<XPU, IdType, Dtype>(
+                bcast, graph->GetCSCMatrix(0), ufeat, efeat, out, emax, esum);
+          });
+    });
+  });
+}
+
+/** @brief Edge softmax weighted SpMM for backward */
+void Edge_softmax_spmm_backward(
+    HeteroGraphPtr graph, NDArray ufeat, NDArray efeat, NDArray out,
+    NDArray emax, NDArray esum, NDArray grad_out, NDArray grad_ufeat,
+    NDArray grad_efeat) {
+  const auto& bcast = CalcBcastOff("mul", ufeat, efeat);
+
+  ATEN_XPU_SWITCH(graph->Context().device_type, XPU, "edge_softmax_spmm", {
+    ATEN_ID_TYPE_SWITCH(graph->DataType(), IdType, {
+      ATEN_FLOAT_TYPE_SWITCH_16BITS(
+          out->dtype, Dtype, XPU, "edge_softmax_spmm out data_back", {
+            Edge_softmax_spmm_csr_backward<XPU, IdType, Dtype>(
+                bcast, graph->GetCSCMatrix(0), graph->GetCSRMatrix(0), ufeat,
+                efeat, out, emax, esum, grad_out, grad_ufeat, grad_efeat);
+          });
+    });
+  });
+}
+
 NDArray GetEdgeMapping(HeteroGraphRef graph) {
   SparseFormat format = graph->SelectFormat(0, CSC_CODE);
   if (format == SparseFormat::kCSC) {
@@ -560,6 +596,39 @@ DGL_REGISTER_GLOBAL("sparse._CAPI_DGLKernelEdge_softmax_backward")
       Edge_softmax_backward(op, graph.sptr(), out, sds, back_out, ufeat);
     });
 
+DGL_REGISTER_GLOBAL("sparse._CAPI_DGLKernelEdge_softmax_spmm_forward")
+    .set_body([](DGLArgs args, DGLRetValue* rv) {
+      HeteroGraphRef graph = args[0];
+      NDArray U = args[1];
+      NDArray E = args[2];
+      NDArray V = args[3];
+      NDArray emax = args[4];
+      NDArray esum = args[5];
+      CheckCtx(
+          graph->Context(), {U, E, V, emax, esum},
+          {"U_data", "E_data", "out", "emax", "esum"});
+      Edge_softmax_spmm_forward(graph.sptr(), U, E, V, emax, esum);
+    });
+
+DGL_REGISTER_GLOBAL("sparse._CAPI_DGLKernelEdge_softmax_spmm_backward")
+    .set_body([](DGLArgs args, DGLRetValue* rv) {
+      HeteroGraphRef graph = args[0];
+      NDArray U = args[1];
+      NDArray E = args[2];
+      NDArray V = args[3];
+      NDArray emax = args[4];
+      NDArray esum = args[5];
+      NDArray grad_V = args[6];
+      NDArray grad_U = args[7];
+      NDArray grad_E = args[8];
+      CheckCtx(
+          graph->Context(), {U, E, V, emax, esum, grad_V, grad_U, grad_E},
+          {"U_data", "E_data", "out", "emax", "esum", "grad_out", "grad_U",
+           "grad_E"});
+      Edge_softmax_spmm_backward(
+          graph.sptr(), U, E, V, emax, esum, grad_V, grad_U, grad_E);
+    });
+
 DGL_REGISTER_GLOBAL("sparse._CAPI_DGLKernelSpMMHetero")
     .set_body([](DGLArgs args, DGLRetValue* rv) {
       HeteroGraphRef graph = args[0];
@@ -190,6 +190,22 @@ template <int XPU, typename IdType, typename DType>
 void Edge_softmax_csr_backward(
     const std::string& op, const BcastOff& bcast, const aten::CSRMatrix& csr,
     NDArray ufeat, NDArray efeat, NDArray out);
+/**
+ * @brief Edge softmax weighted SpMM forward function on Csr format.
+ */
+template <int XPU, typename IdType, typename DType>
+void Edge_softmax_spmm_csr_forward(
+    const BcastOff& bcast, const aten::CSRMatrix& csr, NDArray ufeat,
+    NDArray efeat, NDArray out, NDArray emax, NDArray esum);
+/**
+ * @brief Edge softmax weighted SpMM backward function on Csr format.
+ */
+template <int XPU, typename IdType, typename DType>
+void Edge_softmax_spmm_csr_backward(
+    const BcastOff& bcast, const aten::CSRMatrix& csc,
+    const aten::CSRMatrix& csr, NDArray ufeat, NDArray efeat, NDArray out,
+    NDArray emax, NDArray esum, NDArray grad_out, NDArray grad_ufeat,
+    NDArray grad_efeat);
 }  // namespace aten
 }  // namespace dgl
 
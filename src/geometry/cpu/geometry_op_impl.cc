@@ -4,7 +4,10 @@
  * @brief Geometry operator CPU implementation
  */
 #include <dgl/random.h>
+#include <dgl/runtime/parallel_for.h>
 
+#include <algorithm>
+#include <limits>
 #include <numeric>
 #include <utility>
 #include <vector>
@@ -76,6 +79,151 @@ IdArray GroupRandomPerm(
   return perm;
 }
 
+namespace {
+
+/**
+ * @brief Squared euclidean distance between two points. When \a kDim is
+ * positive the dimension is a compile-time constant, so that the loop is
+ * unrolled and the caller's loop over points can be vectorized.
+ */
+template <int kDim, typename FloatType>
+inline FloatType SquaredDistance(
+    const FloatType *a, const FloatType *b, int64_t dim) {
+  const int64_t d = (kDim > 0) ? kDim : dim;
+  FloatType ret = 0;
+  for (int64_t k = 0; k < d; ++k) {
+    const FloatType diff = a[k] - b[k];
+    ret += diff * diff;
+  }
+  return ret;
+}
+
+/**
+ * @brief Update the minimum to-the-set distance of points [begin, end) of a
+ * point cloud with a newly sampled point, and return the local farthest point.
+ *
+ * Ties are broken by the smallest index so that the result does not depend on
+ * how the points are split among threads.
+ *
+ * @return A pair of (maximum distance, its index) over [begin, end), or
+ * (-1, begin) if the range is empty.
+ */
+template <int kDim, typename FloatType>
+inline std::pair<FloatType, int64_t> UpdateDistanceAndArgmax(
+    const FloatType *points, const FloatType *sample, FloatType *dist,
+    int64_t begin, int64_t end, int64_t dim) {
+  FloatType dist_max = -1;
+#pragma omp simd reduction(max : dist_max)
+  for (int64_t j = begin; j < end; ++j) {
+    const FloatType one_dist =
+        SquaredDistance<kDim>(points + j * dim, sample, dim);
+    const FloatType new_dist = std::min(dist[j], one_dist);
+    dist[j] = new_dist;
+    dist_max = std::max(dist_max, new_dist);
+  }
+  int64_t dist_argmax = begin;
+  for (int64_t j = begin; j < end; ++j) {
+    if (dist[j] == dist_max) {
+      dist_argmax = j;
+      break;
+    }
+  }
+  return {dist_max, dist_argmax};
+}
+
+/**
+ * @brief Sample one point cloud with a single thread.
+ */
+template <int kDim, typename FloatType, typename IdType>
+void FarthestPointSampleCloud(
+    const FloatType *points, int64_t num_points, int64_t dim,
+    int64_t sample_points, int64_t start_idx, FloatType *dist, IdType *ret) {
+  std::fill(
+      dist, dist + num_points, std::numeric_limits<FloatType>::infinity());
+  int64_t sample_idx = start_idx;
+  ret[0] = static_cast<IdType>(sample_idx);
+  for (int64_t i = 1; i < sample_points; ++i) {
+    sample_idx = UpdateDistanceAndArgmax<kDim>(
+                     points, points + sample_idx * dim, dist, 0, num_points,
+                     dim)
+                     .second;
+    ret[i] = static_cast<IdType>(sample_idx);
+  }
+}
+
+/**
+ * @brief Sample one point cloud with all threads. The points are split into
+ * one contiguous chunk per thread, and every iteration is a parallel distance
+ * update followed by a reduction of the per-thread argmax.
+ */
+template <int kDim, typename FloatType, typename IdType>
+void FarthestPointSampleCloudParallel(
+    const FloatType *points, int64_t num_points, int64_t dim,
+    int64_t sample_points, int64_t start_idx, FloatType *dist, IdType *ret,
+    int num_threads) {
+  std::vector<std::pair<FloatType, int64_t>> local_max(num_threads);
+  int64_t sample_idx = start_idx;
+  ret[0] = static_cast<IdType>(sample_idx);
+#pragma omp parallel num_threads(num_threads)
+  {
+    const int thread_id = omp_get_thread_num();
+    const int64_t chunk = (num_points + num_threads - 1) / num_threads;
+    const int64_t begin = std::min(num_points, thread_id * chunk);
+    const int64_t end = std::min(num_points, begin + chunk);
+    std::fill(
+        dist + begin, dist + end, std::numeric_limits<FloatType>::infinity());
+
+    for (int64_t i = 1; i < sample_points; ++i) {
+      local_max[thread_id] = UpdateDistanceAndArgmax<kDim>(
+          points, points + sample_idx * dim, dist, begin, end, dim);
+#pragma omp barrier
+#pragma omp master
+      {
+        // Chunks are ordered, so a strict comparison keeps the smallest index.
+        auto best = local_max[0];
+        for (int t = 1; t < num_threads; ++t) {
+          if (local_max[t].first > best.first) best = local_max[t];
+        }
+        sample_idx = best.second;
+        ret[i] = static_cast<IdType>(sample_idx);
+      }
+#pragma omp barrier
+    }
+  }
+}
+
+template <int kDim, typename FloatType, typename IdType>
+void FarthestPointSamplerImpl(
+    const FloatType *array_data, int64_t batch_size, int64_t point_in_batch,
+    int64_t dim, int64_t sample_points, FloatType *dist_data,
+    const IdType *start_idx_data, IdType *ret_data) {
+  // Below this many points per cloud, splitting a cloud among threads costs
+  // more in barriers than it saves.
+  constexpr int64_t kMinPointsPerThread = 4096;
+  const int num_threads =
+      runtime::compute_num_threads(0, point_in_batch, kMinPointsPerThread);
+  if (batch_size >= num_threads || num_threads == 1) {
+    // Enough point clouds to keep all threads busy.
+    runtime::parallel_for(0, batch_size, 1, [&](size_t b, size_t e) {
+      for (auto i = b; i < e; ++i) {
+        FarthestPointSampleCloud<kDim>(
+            array_data + i * point_in_batch * dim, point_in_batch, dim,
+            sample_points, start_idx_data[i], dist_data + i * point_in_batch,
+            ret_data + i * sample_points);
+      }
+    });
+  } else {
+    for (int64_t i = 0; i < batch_size; ++i) {
+      FarthestPointSampleCloudParallel<kDim>(
+          array_data + i * point_in_batch * dim, point_in_batch, dim,
+          sample_points, start_idx_data[i], dist_data + i * point_in_batch,
+          ret_data + i * sample_points, num_threads);
+    }
+  }
+}
+
+}  // namespace
+
 /**
  * @brief Farthest Point Sampler without the need to compute all pairs of
  * distance.
@@ -87,6 +235,10 @@ IdArray GroupRandomPerm(
  * ``start_idx``. Then for each point, we maintain the minimum to-sample
  * distance. Finally, we pick the point with the maximum such distance. This
  * process will be repeated for ``sample_points`` - 1 times.
+ *
+ * Point clouds are sampled in parallel when the batch is large enough,
+ * otherwise the points of each cloud are split among threads. The distance
+ * computation is specialized for 2 and 3 dimensional points.
  */
 template <DGLDeviceType XPU, typename FloatType, typename IdType>
 void FarthestPointSampler(
@@ -100,51 +252,26 @@ void FarthestPointSampler(
   FloatType *dist_data = static_cast<FloatType *>(dist->data);
 
   // sample for each cloud in the batch
-  IdType *start_idx_data = static_cast<IdType *>(start_idx->data);
+  const IdType *start_idx_data = static_cast<IdType *>(start_idx->data);
 
   // return value
   IdType *ret_data = static_cast<IdType *>(result->data);
 
-  int64_t array_start = 0, ret_start = 0;
-  // loop for each point cloud sample in this batch
-  for (auto b = 0; b < batch_size; b++) {
-    // random init start sample
-    int64_t sample_idx = (int64_t)start_idx_data[b];
-    ret_data[ret_start] = (IdType)(sample_idx);
-
-    // sample the rest `sample_points - 1` points
-    for (auto i = 0; i < sample_points - 1; i++) {
-      // re-init distance and the argmax
-      int64_t dist_argmax = 0;
-      FloatType dist_max = -1;
-
-      // update the distance
-      for (auto j = 0; j < point_in_batch; j++) {
-        // compute the distance on dimensions
-        FloatType one_dist = 0;
-        for (auto d = 0; d < dim; d++) {
-          FloatType tmp = array_data[(array_start + j) * dim + d] -
-                          array_data[(array_start + sample_idx) * dim + d];
-          one_dist += tmp * tmp;
-        }
-
-        // for each out-of-set point, keep its nearest to-the-set distance
-        if (i == 0 || dist_data[j] > one_dist) {
-          dist_data[j] = one_dist;
-        }
-        // look for the farthest sample
-        if (dist_data[j] > dist_max) {
-          dist_argmax = j;
-          dist_max = dist_data[j];
-        }
-      }
-      // sample the `dist_argmax`-th point
-      sample_idx = dist_argmax;
-      ret_data[ret_start + i + 1] = (IdType)(sample_idx);
-    }
-
-    array_start += point_in_batch;
-    ret_start += sample_points;
+  switch (dim) {
+    case 2:
+      FarthestPointSamplerImpl<2>(
+          array_data, batch_size, point_in_batch, dim, sample_points,
+          dist_data, start_idx_data, ret_data);
+      break;
+    case 3:
+      FarthestPointSamplerImpl<3>(
+          array_data, batch_size, point_in_batch, dim, sample_points,
+          dist_data, start_idx_data, ret_data);
+      break;
+    default:
+      FarthestPointSamplerImpl<-1>(
+          array_data, batch_size, point_in_batch, dim, sample_points,
+          dist_data, start_idx_data, ret_data);
   }
 }
 template void FarthestPointSampler<kDGLCPU, float, int32_t>(
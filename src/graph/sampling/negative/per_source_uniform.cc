@@ -0,0 +1,51 @@
+/**
+ *  Copyright (c) 2024 by Contributors
+ * @file graph/sampling/negative/per_source_uniform.cc
+ * @brief Per source uniform negative sampling.
+ */
+
+#include <dgl/array.h>
+#include <dgl/base_heterograph.h>
+#include <dgl/packed_func_ext.h>
+#include <dgl/runtime/container.h>
+#include <dgl/sampling/negative.h>
+
+#include <utility>
+
+#include "../../../c_api_common.h"
+
+using namespace dgl::runtime;
+using namespace dgl::aten;
+
+namespace dgl {
+namespace sampling {
+
+std::pair<IdArray, IdArray> PerSourceUniformNegativeSampling(
+    HeteroGraphPtr hg, dgl_type_t etype, IdArray src, int64_t k,
+    int num_trials, bool exclude_self_loops) {
+  CSRMatrix csr = hg->GetCSRMatrix(etype);
+  CSRSort_(&csr);
+  return CSRPerSourceUniformNegativeSampling(
+      csr, src, k, num_trials, exclude_self_loops);
+}
+
+DGL_REGISTER_GLOBAL(
+    "sampling.negative._CAPI_DGLPerSourceUniformNegativeSampling")
+    .set_body([](DGLArgs args, DGLRetValue* rv) {
+      HeteroGraphRef hg = args[0];
+      dgl_type_t etype = args[1];
+      CHECK_LE(etype, hg->NumEdgeTypes()) << "invalid edge type " << etype;
+      IdArray src = args[2];
+      int64_t k = args[3];
+      int num_trials = args[4];
+      bool exclude_self_loops = args[5];
+      List<Value> result;
+      std::pair<IdArray, IdArray> ret = PerSourceUniformNegativeSampling(
+          hg.sptr(), etype, src, k, num_trials, exclude_self_loops);
+      result.push_back(Value(MakeValue(ret.first)));
+      result.push_back(Value(MakeValue(ret.second)));
+      *rv = result;
+    });
+
+};  // namespace sampling
+};  // namespace dgl
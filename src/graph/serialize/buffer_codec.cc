@@ -0,0 +1,314 @@
+/**
+ *  Copyright (c) 2024 by Contributors
+ * @file graph/serialize/buffer_codec.cc
+ * @brief Encoding and checksums of the NDArray data stored in graph files.
+ */
+#include "./buffer_codec.h"
+
+#include <dgl/runtime/parallel_for.h>
+#include <dmlc/logging.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace dgl {
+namespace serialize {
+
+using runtime::NDArray;
+using runtime::parallel_for;
+
+namespace {
+
+// An encoded buffer is kept if it is at most this share of the raw one.
+constexpr double kMaxCompressionRatio = 0.75;
+
+using Crc32cTables = std::array<std::array<uint32_t, 256>, 8>;
+
+/** @brief The tables of the slicing-by-8 CRC-32C. */
+Crc32cTables MakeCrc32cTables() {
+  Crc32cTables tables;
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+    for (int k = 0; k < 8; ++k) {
+      crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1)));
+    }
+    tables[0][i] = crc;
+  }
+  for (uint32_t i = 0; i < 256; ++i) {
+    for (int k = 1; k < 8; ++k) {
+      const uint32_t prev = tables[k - 1][i];
+      tables[k][i] = (prev >> 8) ^ tables[0][prev & 0xFF];
+    }
+  }
+  return tables;
+}
+
+int64_t NumChunks(uint64_t size) {
+  return std::max<int64_t>(
+      (size + kChecksumChunkSize - 1) / kChecksumChunkSize, 1);
+}
+
+/**
+ * @brief Compute the checksums of buffers, with their chunks in parallel.
+ */
+std::vector<uint32_t> ComputeChecksums(
+    const std::vector<std::pair<const char *, uint64_t>> &buffers) {
+  std::vector<int64_t> chunk_offsets(buffers.size() + 1, 0);
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    chunk_offsets[i + 1] = chunk_offsets[i] + NumChunks(buffers[i].second);
+  }
+  std::vector<uint32_t> chunk_crcs(chunk_offsets.back());
+  parallel_for(0, chunk_offsets.back(), 1, [&](int64_t b, int64_t e) {
+    auto it = std::upper_bound(chunk_offsets.begin(), chunk_offsets.end(), b);
+    int64_t buf = it - chunk_offsets.begin() - 1;
+    for (int64_t task = b; task < e; ++task) {
+      while (task >= chunk_offsets[buf + 1]) ++buf;
+      const uint64_t begin = (task - chunk_offsets[buf]) * kChecksumChunkSize;
+      const uint64_t end = std::min<uint64_t>(
+          begin + kChecksumChunkSize, buffers[buf].second);
+      chunk_crcs[task] = Crc32c(buffers[buf].first + begin, end - begin);
+    }
+  });
+  std::vector<uint32_t> checksums(buffers.size());
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    checksums[i] = Crc32c(
+        chunk_crcs.data() + chunk_offsets[i],
+        (chunk_offsets[i + 1] - chunk_offsets[i]) * sizeof(uint32_t));
+  }
+  return checksums;
+}
+
+template <typename IdType>
+void EncodeBlock(const IdType *data, int64_t num_elems, std::string *out) {
+  out->clear();
+  out->reserve(num_elems * 2);
+  // The differences wrap around like the values of unsigned integers, so that
+  // any int64 can be decoded back.
+  uint64_t prev = 0;
+  for (int64_t i = 0; i < num_elems; ++i) {
+    const uint64_t value = static_cast<int64_t>(data[i]);
+    const uint64_t delta = value - prev;
+    prev = value;
+    uint64_t zigzag = (delta << 1) ^ (0 - (delta >> 63));
+    while (zigzag >= 0x80) {
+      out->push_back(static_cast<char>(zigzag | 0x80));
+      zigzag >>= 7;
+    }
+    out->push_back(static_cast<char>(zigzag));
+  }
+}
+
+template <typename IdType>
+void DecodeBlock(
+    const char *data, uint64_t size, int64_t num_elems, IdType *out) {
+  const uint8_t *pos = reinterpret_cast<const uint8_t *>(data);
+  const uint8_t *end = pos + size;
+  uint64_t prev = 0;
+  for (int64_t i = 0; i < num_elems; ++i) {
+    uint64_t zigzag = 0;
+    for (int shift = 0;; shift += 7) {
+      CHECK(pos < end && shift < 64) << "Invalid DGL files";
+      const uint8_t byte = *pos++;
+      zigzag |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) break;
+    }
+    prev += (zigzag >> 1) ^ (0 - (zigzag & 1));
+    out[i] = static_cast<IdType>(static_cast<int64_t>(prev));
+  }
+  CHECK(pos == end) << "Invalid DGL files";
+}
+
+/** @brief The header of a buffer encoded with kDeltaVarintCodec. */
+struct DeltaVarintHeader {
+  uint64_t num_elems;
+  uint64_t bits;
+  uint64_t num_blocks;
+  const uint64_t *block_ends;
+  const char *blocks;
+
+  static DeltaVarintHeader Parse(const char *data, uint64_t size) {
+    DeltaVarintHeader header;
+    CHECK_GE(size, 3 * sizeof(uint64_t)) << "Invalid DGL files";
+    std::memcpy(&header.num_elems, data, sizeof(uint64_t));
+    std::memcpy(&header.bits, data + sizeof(uint64_t), sizeof(uint64_t));
+    std::memcpy(&header.num_blocks, data + 2 * sizeof(uint64_t), 8);
+    CHECK(header.bits == 32 || header.bits == 64) << "Invalid DGL files";
+    CHECK_EQ(
+        header.num_blocks,
+        (header.num_elems + kDeltaVarintBlockSize - 1) / kDeltaVarintBlockSize)
+        << "Invalid DGL files";
+    const uint64_t header_size = (3 + header.num_blocks) * sizeof(uint64_t);
+    CHECK_GE(size, header_size) << "Invalid DGL files";
+    // The buffers are stored at aligned offsets.
+    header.block_ends =
+        reinterpret_cast<const uint64_t *>(data + 3 * sizeof(uint64_t));
+    header.blocks = data + header_size;
+    for (uint64_t i = 0; i < header.num_blocks; ++i) {
+      CHECK_LE(header.block_ends[i], size - header_size) << "Invalid DGL files";
+      CHECK(i == 0 || header.block_ends[i - 1] <= header.block_ends[i])
+          << "Invalid DGL files";
+    }
+    return header;
+  }
+};
+
+}  // namespace
+
+uint32_t Crc32c(const void *data, size_t size) {
+  static const Crc32cTables tables = MakeCrc32cTables();
+  const uint8_t *pos = static_cast<const uint8_t *>(data);
+  uint32_t crc = ~0u;
+  for (; size >= 8; size -= 8, pos += 8) {
+    uint64_t word;
+    std::memcpy(&word, pos, sizeof(word));
+    word ^= crc;
+    crc = tables[7][word & 0xFF] ^ tables[6][(word >> 8) & 0xFF] ^
+          tables[5][(word >> 16) & 0xFF] ^ tables[4][(word >> 24) & 0xFF] ^
+          tables[3][(word >> 32) & 0xFF] ^ tables[2][(word >> 40) & 0xFF] ^
+          tables[1][(word >> 48) & 0xFF] ^ tables[0][word >> 56];
+  }
+  for (; size > 0; --size, ++pos) {
+    crc = tables[0][(crc ^ *pos) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+uint32_t BufferChecksum(const void *data, size_t size) {
+  return ComputeChecksums({{static_cast<const char *>(data), size}})[0];
+}
+
+std::vector<EncodedBuffer> EncodeBuffers(
+    const std::vector<NDArray> &tensors, bool compress) {
+  const int64_t num_buffers = tensors.size();
+  std::vector<EncodedBuffer> buffers(num_buffers);
+  // The blocks of the integer arrays, which are encoded in parallel.
+  std::vector<int64_t> block_offsets(num_buffers + 1, 0);
+  for (int64_t i = 0; i < num_buffers; ++i) {
+    const auto &tensor = tensors[i];
+    buffers[i].data = static_cast<const char *>(tensor->data);
+    buffers[i].size = tensor.GetSize();
+    const int64_t num_elems = tensor.NumElements();
+    const bool encode = compress && tensor->dtype.code == kDGLInt &&
+                        (tensor->dtype.bits == 32 || tensor->dtype.bits == 64);
+    block_offsets[i + 1] =
+        block_offsets[i] + (encode ? (num_elems + kDeltaVarintBlockSize - 1) /
+                                         kDeltaVarintBlockSize
+                                   : 0);
+  }
+  std::vector<std::string> blocks(block_offsets.back());
+  parallel_for(0, block_offsets.back(), 1, [&](int64_t b, int64_t e) {
+    auto it = std::upper_bound(block_offsets.begin(), block_offsets.end(), b);
+    int64_t buf = it - block_offsets.begin() - 1;
+    for (int64_t task = b; task < e; ++task) {
+      while (task >= block_offsets[buf + 1]) ++buf;
+      const auto &tensor = tensors[buf];
+      const int64_t begin =
+          (task - block_offsets[buf]) * kDeltaVarintBlockSize;
+      const int64_t num_elems =
+          std::min(kDeltaVarintBlockSize, tensor.NumElements() - begin);
+      if (tensor->dtype.bits == 32) {
+        EncodeBlock(tensor.Ptr<int32_t>() + begin, num_elems, &blocks[task]);
+      } else {
+        EncodeBlock(tensor.Ptr<int64_t>() + begin, num_elems, &blocks[task]);
+      }
+    }
+  });
+
+  for (int64_t i = 0; i < num_buffers; ++i) {
+    const int64_t num_blocks = block_offsets[i + 1] - block_offsets[i];
+    if (num_blocks == 0) continue;
+    std::vector<uint64_t> header = {
+        static_cast<uint64_t>(tensors[i].NumElements()),
+        tensors[i]->dtype.bits, static_cast<uint64_t>(num_blocks)};
+    uint64_t block_end = 0;
+    for (int64_t k = block_offsets[i]; k < block_offsets[i + 1]; ++k) {
+      block_end += blocks[k].size();
+      header.push_back(block_end);
+    }
+    const uint64_t size = header.size() * sizeof(uint64_t) + block_end;
+    if (size > kMaxCompressionRatio * buffers[i].size) continue;
+    auto &encoded = buffers[i].encoded;
+    encoded.reserve(size);
+    encoded.append(
+        reinterpret_cast<const char *>(header.data()),
+        header.size() * sizeof(uint64_t));
+    for (int64_t k = block_offsets[i]; k < block_offsets[i + 1]; ++k) {
+      encoded.append(blocks[k]);
+      std::string().swap(blocks[k]);
+    }
+    buffers[i].codec = kDeltaVarintCodec;
+    buffers[i].data = encoded.data();
+    buffers[i].size = encoded.size();
+  }
+
+  std::vector<std::pair<const char *, uint64_t>> stored;
+  for (const auto &buffer : buffers) {
+    stored.emplace_back(buffer.data, buffer.size);
+  }
+  const auto checksums = ComputeChecksums(stored);
+  for (int64_t i = 0; i < num_buffers; ++i) {
+    buffers[i].checksum = checksums[i];
+  }
+  return buffers;
+}
+
+std::vector<NDArray> DecodeBuffers(
+    const std::vector<NDArray> &stored, const std::vector<uint64_t> &codecs,
+    const std::vector<uint64_t> &checksums) {
+  const int64_t num_buffers = stored.size();
+  std::vector<std::pair<const char *, uint64_t>> stored_bytes;
+  for (const auto &buffer : stored) {
+    stored_bytes.emplace_back(
+        static_cast<const char *>(buffer->data), buffer.GetSize());
+  }
+  const auto actual_checksums = ComputeChecksums(stored_bytes);
+  for (int64_t i = 0; i < num_buffers; ++i) {
+    CHECK_EQ(actual_checksums[i], checksums[i])
+        << "Checksum mismatch, the DGL file is corrupted";
+  }
+
+  std::vector<NDArray> decoded(stored);
+  std::vector<DeltaVarintHeader> headers(num_buffers);
+  std::vector<int64_t> block_offsets(num_buffers + 1, 0);
+  for (int64_t i = 0; i < num_buffers; ++i) {
+    int64_t num_blocks = 0;
+    if (codecs[i] == kDeltaVarintCodec) {
+      headers[i] = DeltaVarintHeader::Parse(
+          stored_bytes[i].first, stored_bytes[i].second);
+      num_blocks = headers[i].num_blocks;
+      decoded[i] = NDArray::Empty(
+          {static_cast<int64_t>(headers[i].num_elems * headers[i].bits / 8)},
+          DGLDataType{kDGLUInt, 8, 1}, DGLContext{kDGLCPU, 0});
+    } else {
+      CHECK_EQ(codecs[i], kRawCodec) << "Invalid DGL files";
+    }
+    block_offsets[i + 1] = block_offsets[i] + num_blocks;
+  }
+  parallel_for(0, block_offsets.back(), 1, [&](int64_t b, int64_t e) {
+    auto it = std::upper_bound(block_offsets.begin(), block_offsets.end(), b);
+    int64_t buf = it - block_offsets.begin() - 1;
+    for (int64_t task = b; task < e; ++task) {
+      while (task >= block_offsets[buf + 1]) ++buf;
+      const auto &header = headers[buf];
+      const int64_t block = task - block_offsets[buf];
+      const int64_t begin = block * kDeltaVarintBlockSize;
+      const int64_t num_elems = std::min<int64_t>(
+          kDeltaVarintBlockSize, header.num_elems - begin);
+      const uint64_t block_begin = block ? header.block_ends[block - 1] : 0;
+      const char *data = header.blocks + block_begin;
+      const uint64_t size = header.block_ends[block] - block_begin;
+      if (header.bits == 32) {
+        DecodeBlock(data, size, num_elems, decoded[buf].Ptr<int32_t>() + begin);
+      } else {
+        DecodeBlock(data, size, num_elems, decoded[buf].Ptr<int64_t>() + begin);
+      }
+    }
+  });
+  return decoded;
+}
+
+}  // namespace serialize
+}  // namespace dgl
@@ -0,0 +1,89 @@
+/**
+ *  Copyright (c) 2024 by Contributors
+ * @file graph/serialize/buffer_codec.h
+ * @brief Encoding and checksums of the NDArray data stored in graph files.
+ */
+#ifndef DGL_GRAPH_SERIALIZE_BUFFER_CODEC_H_
+#define DGL_GRAPH_SERIALIZE_BUFFER_CODEC_H_
+
+#include <dgl/runtime/ndarray.h>
+
+#include <string>
+#include <vector>
+
+namespace dgl {
+namespace serialize {
+
+/** @brief How the data of an NDArray is stored. */
+enum BufferCodec : uint64_t {
+  // The bytes of the NDArray as they are.
+  kRawCodec = 0ull,
+  // The differences between consecutive integers, zigzag and varint encoded
+  // in independent blocks. It shrinks sorted ids such as indptr and the
+  // indices of sorted COO or CSR matrices. The storage is
+  // {
+  //   uint64_t num_elems
+  //   uint64_t bits (32 or 64)
+  //   uint64_t num_blocks
+  //   uint64_t block_ends[num_blocks] (end of each block after the header)
+  //   char[] blocks
+  // }
+  kDeltaVarintCodec = 1ull,
+};
+
+/** @brief The number of integers of a block of kDeltaVarintCodec. */
+constexpr int64_t kDeltaVarintBlockSize = 1 << 16;
+
+/** @brief The size of the chunks the checksum of a buffer is made of. */
+constexpr int64_t kChecksumChunkSize = 1 << 20;
+
+/** @brief An NDArray data buffer prepared to be written. */
+struct EncodedBuffer {
+  BufferCodec codec = kRawCodec;
+  // The stored bytes, which point to the NDArray data for kRawCodec and to
+  // encoded otherwise.
+  const char *data = nullptr;
+  uint64_t size = 0;
+  std::string encoded;
+  uint32_t checksum = 0;
+};
+
+/** @brief Compute the CRC-32C of a buffer. */
+uint32_t Crc32c(const void *data, size_t size);
+
+/**
+ * @brief Compute the checksum of a stored buffer, which is the CRC-32C of the
+ * CRC-32C of each of its chunks of kChecksumChunkSize bytes, so that the
+ * chunks can be checked in parallel.
+ */
+uint32_t BufferChecksum(const void *data, size_t size);
+
+/**
+ * @brief Prepare the data of NDArrays to be written. The integer arrays are
+ * encoded with kDeltaVarintCodec if \a compress and if it makes them at least
+ * a quarter smaller. The blocks and checksum chunks of all the buffers are
+ * processed in parallel, so that both many small buffers and a few large ones
+ * use all the threads.
+ * @param tensors The CPU NDArrays whose data to write.
+ * @param compress Whether to compress the integer arrays.
+ */
+std::vector<EncodedBuffer> EncodeBuffers(
+    const std::vector<runtime::NDArray> &tensors, bool compress);
+
+/**
+ * @brief Check the stored buffers against their checksums and decode them in
+ * parallel. The buffers stored with kRawCodec are returned as they are.
+ * @param stored The uint8 NDArrays holding the stored bytes.
+ * @param codecs The codec of each buffer.
+ * @param checksums The checksum of each buffer.
+ * @return The uint8 NDArrays holding the data of the NDArrays.
+ */
+std::vector<runtime::NDArray> DecodeBuffers(
+    const std::vector<runtime::NDArray> &stored,
+    const std::vector<uint64_t> &codecs,
+    const std::vector<uint64_t> &checksums);
+
+}  // namespace serialize
+}  // namespace dgl
+
+#endif  // DGL_GRAPH_SERIALIZE_BUFFER_CODEC_H_
@@ -7,10 +7,12 @@
 #define DGL_GRAPH_SERIALIZE_DGLSTREAM_H_
 
 #include <dgl/aten/spmat.h>
+#include <dgl/zerocopy_serializer.h>
 #include <dmlc/io.h>
 #include <dmlc/type_traits.h>
 
 #include <memory>
+#include <string>
 
 namespace dgl {
 namespace serialize {
@@ -59,6 +61,37 @@ class DGLStream : public dmlc::Stream {
   // formats to use when saving graph
   const dgl_format_code_t formats_to_save_ = ANY_CODE;
 };
+
+/**
+ * @brief DGLStreamWithBuffer keeps the data of the NDArrays in its buffer list
+ * instead of writing it into the underlying string, so that it can be stored
+ * separately, and tells the formats to save graphs in like DGLStream.
+ */
+class DGLStreamWithBuffer : public StreamWithBuffer {
+ public:
+  DGLStreamWithBuffer(std::string *blob, dgl_format_code_t formats)
+      : StreamWithBuffer(blob, true), formats_to_save_(formats) {}
+
+  uint64_t FormatsToSave() const { return formats_to_save_; }
+
+ private:
+  // formats to use when saving graph
+  const dgl_format_code_t formats_to_save_;
+};
+
+/**
+ * @brief Get the formats to save graphs in requested by the stream, or
+ * ANY_CODE if the stream does not tell.
+ */
+inline dgl_format_code_t FormatsToSave(dmlc::Stream *fs) {
+  if (auto fstream = dynamic_cast<DGLStream *>(fs)) {
+    return fstream->FormatsToSave();
+  }
+  if (auto bstream = dynamic_cast<DGLStreamWithBuffer *>(fs)) {
+    return bstream->FormatsToSave();
+  }
+  return ANY_CODE;
+}
 }  // namespace serialize
 }  // namespace dgl
 
@@ -161,5 +161,15 @@ DGL_REGISTER_GLOBAL("data.graph_serialize._CAPI_LoadGraphFiles_V2")
       *rv = List<HeteroGraphData>(LoadHeteroGraphs(filename, idx_list));
     });
 
+DGL_REGISTER_GLOBAL("data.graph_serialize._CAPI_LoadGraphFiles_V4")
+    .set_body([](DGLArgs args, DGLRetValue *rv) {
+      std::string filename = args[0];
+      List<Value> idxs = args[1];
+      bool use_mmap = args[2];
+      auto idx_list = ListValueToVector<dgl_id_t>(idxs);
+      *rv = List<HeteroGraphData>(
+          LoadHeteroGraphs_V4(filename, idx_list, use_mmap));
+    });
+
 }  // namespace serialize
 }  // namespace dgl
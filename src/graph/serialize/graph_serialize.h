@@ -95,6 +95,10 @@ bool SaveDGLGraphs(
 std::vector<HeteroGraphData> LoadHeteroGraphs(
     const std::string &filename, std::vector<dgl_id_t> idx_list);
 
+std::vector<HeteroGraphData> LoadHeteroGraphs_V4(
+    const std::string &filename, std::vector<dgl_id_t> idx_list,
+    bool use_mmap);
+
 ImmutableGraphPtr ToImmutableGraph(GraphPtr g);
 
 }  // namespace serialize
@@ -32,22 +32,62 @@
  *   vector<string> etype_name;
  * }
  *
+ * Version 4 stores the data of the NDArrays of the graphs apart from the rest
+ * of their HeteroGraphData, at aligned positions, so that the file can be
+ * memory mapped and the NDArrays loaded as views of the mapping. The metadata
+ * and label sections are the same as version 2, and are followed by
+ * {
+ *   for each graph:
+ *     ** Padding till the next 4kB boundary **
+ *     for each NDArray of the graph:
+ *       ** Padding till the next 64B boundary **
+ *       char[] data of the NDArray, stored as told by its BufferCodec
+ *     char[] HeteroGraphData without the data of its NDArrays
+ *
+ *   vector<uint64_t> meta_pos (start position of each HeteroGraphData)
+ *   vector<uint64_t> meta_size (size of each HeteroGraphData)
+ *   vector<uint64_t> buffer_indptr (range of the NDArrays of each graph)
+ *   vector<uint64_t> buffer_pos (start position of each NDArray data)
+ *   vector<uint64_t> buffer_size (stored size of each NDArray data)
+ *   vector<uint64_t> buffer_codec (BufferCodec of each NDArray data)
+ *   vector<uint64_t> buffer_checksum (BufferChecksum of each stored data)
+ *   uint64_t size_of_the_vectors_above (Used to seek to meta_pos vector)
+ * }
+ *
+ * The compressed NDArrays, and the others when the file is not memory mapped,
+ * are decoded into memory and checked against their checksums.
+ *
+ * Version 3 is the same without the buffer_codec and buffer_checksum vectors.
+ * Its NDArrays are stored as they are and are not checked when loaded.
  */
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // _WIN32
 #include <dgl/graph_op.h>
 #include <dgl/immutable_graph.h>
 #include <dgl/runtime/container.h>
+#include <dgl/runtime/dlpack_convert.h>
 #include <dgl/runtime/object.h>
+#include <dgl/zerocopy_serializer.h>
+#include <dlpack/dlpack.h>
 #include <dmlc/io.h>
 #include <dmlc/type_traits.h>
 
 #include <algorithm>
 #include <array>
+#include <cerrno>
+#include <cstring>
 #include <iostream>
+#include <numeric>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "../heterograph.h"
+#include "./buffer_codec.h"
 #include "./dglstream.h"
 #include "./graph_serialize.h"
 #include "dmlc/memory_io.h"
@@ -61,30 +101,29 @@ using dmlc::Stream;
 using dmlc::io::FileSystem;
 using dmlc::io::URI;
 
-bool SaveHeteroGraphs(
-    std::string filename, List<HeteroGraphData> hdata,
-    const std::vector<NamedTensor> &nd_list, dgl_format_code_t formats) {
-  auto fs = std::unique_ptr<DGLStream>(
-      DGLStream::Create(filename.c_str(), "w", false, formats));
-  CHECK(fs->IsValid()) << "File name " << filename << " is not a valid name";
+namespace {
 
-  // Write DGL MetaData
-  const uint64_t kVersion = 2;
-  std::array<char, 4096> meta_buffer;
+// The alignment of the data of every graph in version 4 files.
+constexpr uint64_t kPageSize = 4096;
+// The alignment of the data of every NDArray in version 4 files. The file is
+// mapped at once, so the views only need the alignment of their elements.
+constexpr uint64_t kBufferAlignment = 64;
+// The bytes of NDArray data of the graphs encoded at once when saving version
+// 4 files, which bounds the memory used by the compressed copies.
+constexpr uint64_t kWriteWindowSize = 1ull << 28;
 
-  // Write metadata into char buffer with size 4096
+void WriteMetaData(DGLStream *fs, uint64_t version, uint64_t num_graph) {
+  std::array<char, 4096> meta_buffer{};
   dmlc::MemoryFixedSizeStream meta_fs_(meta_buffer.data(), 4096);
   auto meta_fs = static_cast<Stream *>(&meta_fs_);
   meta_fs->Write(kDGLSerializeMagic);
-  meta_fs->Write(kVersion);
+  meta_fs->Write(version);
   meta_fs->Write(GraphType::kHeteroGraph);
-  uint64_t num_graph = hdata.size();
   meta_fs->Write(num_graph);
-
-  // Write metadata into files
   fs->Write(meta_buffer.data(), 4096);
+}
 
-  // Calculate label dict binary size
+void WriteLabels(DGLStream *fs, const std::vector<NamedTensor> &nd_list) {
   std::string labels_blob;
   dmlc::MemoryStringStream label_fs_(&labels_blob);
   auto label_fs = static_cast<Stream *>(&label_fs_);
@@ -92,11 +131,68 @@ bool SaveHeteroGraphs(
 
   uint64_t gdata_start_pos =
       fs->Count() + sizeof(uint64_t) + labels_blob.size();
-
-  // Write start position of gdata, which can be skipped when only reading gdata
-  // And label dict
   fs->Write(gdata_start_pos);
   fs->Write(labels_blob.c_str(), labels_blob.size());
+}
+
+#ifndef _WIN32
+struct MappedFile {
+  DLManagedTensor tensor;
+  int64_t size;
+};
+
+/**
+ * @brief Map a file copy-on-write, and return an uint8 NDArray viewing the
+ * whole file, which unmaps it once freed. The pages are read from the file
+ * when they are first accessed, and shared with the other processes mapping
+ * it unless they are written.
+ */
+NDArray MapFile(const std::string &filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  CHECK_NE(fd, -1) << "Failed to open " << filename << ": "
+                   << strerror(errno);
+  struct stat st;
+  CHECK_NE(fstat(fd, &st), -1)
+      << "Failed to stat " << filename << ": " << strerror(errno);
+  auto *mapped = new MappedFile();
+  mapped->size = st.st_size;
+  void *data = mmap(
+      nullptr, mapped->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  CHECK_NE(data, MAP_FAILED)
+      << "Failed to map " << filename << ": " << strerror(errno);
+
+  mapped->tensor.dl_tensor.data = data;
+  mapped->tensor.dl_tensor.device = DLDevice{kDLCPU, 0};
+  mapped->tensor.dl_tensor.ndim = 1;
+  mapped->tensor.dl_tensor.dtype = DLDataType{kDLUInt, 8, 1};
+  mapped->tensor.dl_tensor.shape = &mapped->size;
+  mapped->tensor.dl_tensor.strides = nullptr;
+  mapped->tensor.dl_tensor.byte_offset = 0;
+  mapped->tensor.manager_ctx = mapped;
+  mapped->tensor.deleter = [](DLManagedTensor *tensor) {
+    auto *mapped = static_cast<MappedFile *>(tensor->manager_ctx);
+    munmap(tensor->dl_tensor.data, mapped->size);
+    delete mapped;
+  };
+  return DLPackConvert::FromDLPack(&mapped->tensor);
+}
+#endif  // _WIN32
+
+}  // namespace
+
+bool SaveHeteroGraphs(
+    std::string filename, List<HeteroGraphData> hdata,
+    const std::vector<NamedTensor> &nd_list, dgl_format_code_t formats) {
+  auto fs = std::unique_ptr<DGLStream>(
+      DGLStream::Create(filename.c_str(), "w", false, formats));
+  CHECK(fs->IsValid()) << "File name " << filename << " is not a valid name";
+
+  // Write DGL MetaData and label dict
+  const uint64_t kVersion = 2;
+  uint64_t num_graph = hdata.size();
+  WriteMetaData(fs.get(), kVersion, num_graph);
+  WriteLabels(fs.get(), nd_list);
 
   std::vector<uint64_t> graph_indices(num_graph);
 
@@ -185,6 +281,212 @@ std::vector<HeteroGraphData> LoadHeteroGraphs(
   return gdata_refs;
 }
 
+bool SaveHeteroGraphs_V4(
+    std::string filename, List<HeteroGraphData> hdata,
+    const std::vector<NamedTensor> &nd_list, dgl_format_code_t formats,
+    bool compress) {
+#ifndef _WIN32
+  auto fs = std::unique_ptr<DGLStream>(
+      DGLStream::Create(filename.c_str(), "w", false, formats));
+  CHECK(fs->IsValid()) << "File name " << filename << " is not a valid name";
+
+  const uint64_t kVersion = 4;
+  uint64_t num_graph = hdata.size();
+  WriteMetaData(fs.get(), kVersion, num_graph);
+  WriteLabels(fs.get(), nd_list);
+
+  const std::array<char, kPageSize> padding{};
+  std::vector<uint64_t> meta_pos(num_graph), meta_size(num_graph);
+  std::vector<uint64_t> buffer_indptr(num_graph + 1, 0);
+  std::vector<uint64_t> buffer_pos, buffer_size, buffer_codec, buffer_checksum;
+  for (uint64_t start = 0; start < num_graph;) {
+    // The data of the NDArrays is collected in the buffer list of the stream
+    // while the rest of the HeteroGraphData is written into its meta blob.
+    // This is sequential as it creates the sparse formats to save, then the
+    // data of the window of graphs is encoded in parallel.
+    std::vector<std::string> meta_blobs;
+    std::vector<NDArray> tensors;
+    uint64_t window_size = 0;
+    uint64_t end = start;
+    for (; end < num_graph && (end == start || window_size < kWriteWindowSize);
+         ++end) {
+      meta_blobs.emplace_back();
+      DGLStreamWithBuffer meta_fs(&meta_blobs.back(), formats);
+      auto gdata = hdata[end].sptr();
+      static_cast<Stream *>(&meta_fs)->Write(gdata);
+      for (const auto &buffer : meta_fs.buffer_list()) {
+        tensors.push_back(
+            buffer.tensor->ctx.device_type == kDGLCPU
+                ? buffer.tensor
+                : buffer.tensor.CopyTo(DGLContext{kDGLCPU, 0}));
+        window_size += buffer.size;
+      }
+      buffer_indptr[end + 1] =
+          buffer_indptr[end] + meta_fs.buffer_list().size();
+    }
+    const auto encoded = EncodeBuffers(tensors, compress);
+
+    auto buffer = encoded.begin();
+    auto pad_to = [&fs, &padding](uint64_t alignment) {
+      fs->Write(
+          padding.data(), (alignment - fs->Count() % alignment) % alignment);
+    };
+    for (uint64_t i = start; i < end; ++i) {
+      pad_to(kPageSize);
+      for (uint64_t k = buffer_indptr[i]; k < buffer_indptr[i + 1]; ++k) {
+        pad_to(kBufferAlignment);
+        buffer_pos.push_back(fs->Count());
+        buffer_size.push_back(buffer->size);
+        buffer_codec.push_back(buffer->codec);
+        buffer_checksum.push_back(buffer->checksum);
+        fs->Write(buffer->data, buffer->size);
+        ++buffer;
+      }
+      const auto &meta_blob = meta_blobs[i - start];
+      meta_pos[i] = fs->Count();
+      meta_size[i] = meta_blob.size();
+      fs->Write(meta_blob.data(), meta_blob.size());
+    }
+    start = end;
+  }
+
+  std::string table_blob;
+  dmlc::MemoryStringStream table_fs_(&table_blob);
+  auto table_fs = static_cast<Stream *>(&table_fs_);
+  table_fs->Write(meta_pos);
+  table_fs->Write(meta_size);
+  table_fs->Write(buffer_indptr);
+  table_fs->Write(buffer_pos);
+  table_fs->Write(buffer_size);
+  table_fs->Write(buffer_codec);
+  table_fs->Write(buffer_checksum);
+
+  uint64_t table_size = table_blob.size();
+  fs->Write(table_blob.data(), table_blob.size());
+  fs->Write(table_size);
+#else
+  LOG(FATAL) << "Saving graphs for memory mapping is not supported on windows";
+#endif  // _WIN32
+  return true;
+}
+
+std::vector<HeteroGraphData> LoadHeteroGraphs_V4(
+    const std::string &filename, std::vector<dgl_id_t> idx_list,
+    bool use_mmap) {
+  auto fs = std::unique_ptr<SeekStream>(
+      SeekStream::CreateForRead(filename.c_str(), false));
+  CHECK(fs) << "File name " << filename << " is not a valid name";
+  // Read DGL MetaData
+  uint64_t magicNum, graphType, version, num_graph;
+  fs->Read(&magicNum);
+  fs->Read(&version);
+  fs->Read(&graphType);
+  CHECK(fs->Read(&num_graph)) << "Invalid num of graph";
+
+  CHECK_EQ(magicNum, kDGLSerializeMagic) << "Invalid DGL files";
+  CHECK(version == 3 || version == 4) << "Invalid DGL file version";
+  CHECK_EQ(graphType, GraphType::kHeteroGraph) << "Invalid GraphType";
+
+  URI uri(filename.c_str());
+  uint64_t filesize = FileSystem::GetInstance(uri)->GetPathInfo(uri).size;
+  uint64_t table_size;
+  fs->Seek(filesize - sizeof(uint64_t));
+  fs->Read(&table_size);
+  std::vector<uint64_t> meta_pos, meta_size, buffer_indptr, buffer_pos,
+      buffer_size, buffer_codec, buffer_checksum;
+  fs->Seek(filesize - sizeof(uint64_t) - table_size);
+  CHECK(fs->Read(&meta_pos)) << "Invalid DGL files";
+  CHECK(fs->Read(&meta_size)) << "Invalid DGL files";
+  CHECK(fs->Read(&buffer_indptr)) << "Invalid DGL files";
+  CHECK(fs->Read(&buffer_pos)) << "Invalid DGL files";
+  CHECK(fs->Read(&buffer_size)) << "Invalid DGL files";
+  // Version 3 files store every NDArray as it is, without checksums.
+  const bool has_checksums = version >= 4;
+  if (has_checksums) {
+    CHECK(fs->Read(&buffer_codec)) << "Invalid DGL files";
+    CHECK(fs->Read(&buffer_checksum)) << "Invalid DGL files";
+  }
+  CHECK_EQ(meta_pos.size(), num_graph) << "Invalid DGL files";
+
+  NDArray mapped;
+  if (use_mmap) {
+#ifndef _WIN32
+    mapped = MapFile(filename);
+    CHECK_EQ(mapped->shape[0], filesize)
+        << "File " << filename << " changed while being loaded";
+#else
+    LOG(FATAL) << "Memory mapping graph files is not supported on windows";
+#endif  // _WIN32
+  }
+  const DGLDataType uint8_type{kDGLUInt, 8, 1};
+
+  if (idx_list.empty()) {
+    idx_list.resize(num_graph);
+    std::iota(idx_list.begin(), idx_list.end(), 0);
+  }
+  // Only the data of the requested graphs is read. With mmap, the NDArrays
+  // stored as they are view the mapping, whose pages are read when accessed,
+  // and the others are decoded in parallel.
+  std::vector<std::vector<NDArray>> buffers(idx_list.size());
+  std::vector<NDArray> stored;
+  std::vector<uint64_t> codecs, checksums;
+  std::vector<std::pair<size_t, size_t>> decoded_pos;
+  for (size_t i = 0; i < idx_list.size(); ++i) {
+    const auto gid = idx_list[i];
+    CHECK(gid < num_graph)
+        << "ID " << gid
+        << " in idx_list is out of bound. Please check your idx_list.";
+    for (uint64_t k = buffer_indptr[gid]; k < buffer_indptr[gid + 1]; ++k) {
+      CHECK_LE(buffer_pos[k] + buffer_size[k], filesize) << "Invalid DGL files";
+      const int64_t size = buffer_size[k];
+      NDArray buffer;
+      if (use_mmap) {
+        buffer = mapped.CreateView({size}, uint8_type, buffer_pos[k]);
+      } else {
+        buffer = NDArray::Empty({size}, uint8_type, DGLContext{kDGLCPU, 0});
+        fs->Seek(buffer_pos[k]);
+        CHECK_EQ(fs->Read(buffer->data, size), size) << "Invalid DGL files";
+      }
+      if (has_checksums && (!use_mmap || buffer_codec[k] != kRawCodec)) {
+        decoded_pos.emplace_back(i, buffers[i].size());
+        stored.push_back(buffer);
+        codecs.push_back(buffer_codec[k]);
+        checksums.push_back(buffer_checksum[k]);
+      }
+      buffers[i].push_back(buffer);
+    }
+  }
+  const auto decoded = DecodeBuffers(stored, codecs, checksums);
+  for (size_t k = 0; k < decoded.size(); ++k) {
+    buffers[decoded_pos[k].first][decoded_pos[k].second] = decoded[k];
+  }
+
+  std::vector<HeteroGraphData> gdata_refs;
+  gdata_refs.reserve(idx_list.size());
+  for (size_t i = 0; i < idx_list.size(); ++i) {
+    const auto gid = idx_list[i];
+    CHECK_LE(meta_pos[gid] + meta_size[gid], filesize) << "Invalid DGL files";
+    std::string meta_blob;
+    char *meta_data;
+    if (use_mmap) {
+      meta_data = static_cast<char *>(mapped->data) + meta_pos[gid];
+    } else {
+      meta_blob.resize(meta_size[gid]);
+      fs->Seek(meta_pos[gid]);
+      CHECK_EQ(fs->Read(&meta_blob[0], meta_size[gid]), meta_size[gid])
+          << "Invalid DGL files";
+      meta_data = &meta_blob[0];
+    }
+    StreamWithBuffer meta_fs(meta_data, meta_size[gid], buffers[i]);
+    HeteroGraphData gdata = HeteroGraphData::Create();
+    auto hetero_data = gdata.sptr();
+    static_cast<Stream *>(&meta_fs)->Read(&hetero_data);
+    gdata_refs.push_back(gdata);
+  }
+
+  return gdata_refs;
+}
+
 std::vector<NamedTensor> LoadLabels_V2(const std::string &filename) {
   auto fs = std::unique_ptr<SeekStream>(
       SeekStream::CreateForRead(filename.c_str(), false));
@@ -223,6 +525,8 @@ DGL_REGISTER_GLOBAL("data.heterograph_serialize._CAPI_SaveHeteroGraphData")
       List<HeteroGraphData> hgdata = args[1];
       Map<std::string, Value> nd_map = args[2];
       List<Value> formats = args[3];
+      bool page_aligned = args[4];
+      bool compress = args[5];
       std::vector<SparseFormat> formats_vec;
       for (const auto &val : formats) {
         formats_vec.push_back(ParseSparseFormat(val->data));
@@ -233,8 +537,13 @@ DGL_REGISTER_GLOBAL("data.heterograph_serialize._CAPI_SaveHeteroGraphData")
         NDArray ndarray = static_cast<NDArray>(kv.second->data);
         nd_list.emplace_back(kv.first, ndarray);
       }
-      *rv = dgl::serialize::SaveHeteroGraphs(
-          filename, hgdata, nd_list, formats_code);
+      if (page_aligned) {
+        *rv = dgl::serialize::SaveHeteroGraphs_V4(
+            filename, hgdata, nd_list, formats_code, compress);
+      } else {
+        *rv = dgl::serialize::SaveHeteroGraphs(
+            filename, hgdata, nd_list, formats_code);
+      }
     });
 
 DGL_REGISTER_GLOBAL(
@@ -86,10 +86,19 @@ NDArray StreamWithBuffer::PopNDArray() {
   } else {
     CHECK(send_to_remote_) << "Invalid attempt to deserialize from raw data "
                               "pointer with send_to_remote=false";
+    int64_t num_elems = 1;
+    for (int i = 0; i < ndim; ++i) {
+      num_elems *= shape[i];
+    }
     NDArray ret;
-    if (ndim == 0 || shape[0] == 0) {
-      // Mean this is a null ndarray
+    if (num_elems == 0) {
+      // Mean this is a null ndarray, which was not pushed into the buffer list
       ret = CreateNDArrayFromRawData(shape, dtype, cpu_ctx, nullptr);
+    } else if (buffer_list_.front().tensor.defined()) {
+      // The data is owned by the buffer tensor, so view it instead of taking
+      // over the pointer.
+      ret = buffer_list_.front().tensor.CreateView(shape, dtype, 0);
+      buffer_list_.pop_front();
     } else {
       ret = CreateNDArrayFromRawData(
           shape, dtype, cpu_ctx, buffer_list_.front().data);
@@ -27,6 +27,22 @@ namespace impl {
 // This value is directly from pynndescent
 static constexpr int NN_DESCENT_BLOCK_SIZE = 16384;
 
+// The number of tasks per thread generating the neighbor updates of a block
+// in NN-descent, so that the tasks are balanced.
+static constexpr int NN_DESCENT_TASKS_PER_THREAD = 4;
+
+// The number of queries processed by a task of the blocked brute-force KNN,
+// which share the packed data tiles.
+static constexpr int BLOCKED_KNN_QUERY_BLOCK_SIZE = 128;
+
+// The number of data points in a packed tile of the blocked brute-force KNN,
+// chosen so that the tile of 128-dim float points fits in the L2 cache.
+static constexpr int BLOCKED_KNN_DATA_BLOCK_SIZE = 256;
+
+// The number of queries whose distances to a data tile are computed at once,
+// so that each loaded element of the tile is used several times.
+static constexpr int BLOCKED_KNN_QUERY_TILE_SIZE = 4;
+
 /**
  * @brief Compute Euclidean distance between two vectors, return positive
  *  infinite value if the intermediate distance is greater than the worst
@@ -170,44 +186,6 @@ void BuildHeap(IdType* index, FloatType* dist, int k) {
   }
 }
 
-/**
- * @brief Neighbor update process in NN-descent. The distance between
- *  two points are computed. If this new distance is less than any worst
- *  distance of these two points, we update the neighborhood of that point.
- */
-template <typename FloatType, typename IdType>
-int UpdateNeighbors(
-    IdType* neighbors, FloatType* dists, const FloatType* points, bool* flags,
-    IdType c1, IdType c2, IdType point_start, int64_t feature_size, int k) {
-  IdType c1_local = c1 - point_start, c2_local = c2 - point_start;
-  FloatType worst_c1_dist = dists[c1_local * k];
-  FloatType worst_c2_dist = dists[c2_local * k];
-  FloatType new_dist = EuclideanDistWithCheck<FloatType, IdType>(
-      points + c1 * feature_size, points + c2 * feature_size, feature_size,
-      std::max(worst_c1_dist, worst_c2_dist));
-
-  int num_updates = 0;
-  if (new_dist < worst_c1_dist) {
-    ++num_updates;
-#pragma omp critical
-    {
-      FlaggedHeapInsert<FloatType, IdType>(
-          neighbors + c1 * k, dists + c1_local * k, flags + c1_local * k, c2,
-          new_dist, true, k, true);
-    }
-  }
-  if (new_dist < worst_c2_dist) {
-    ++num_updates;
-#pragma omp critical
-    {
-      FlaggedHeapInsert<FloatType, IdType>(
-          neighbors + c2 * k, dists + c2_local * k, flags + c2_local * k, c1,
-          new_dist, true, k, true);
-    }
-  }
-  return num_updates;
-}
-
 /** @brief The kd-tree implementation of K-Nearest Neighbors */
 template <typename FloatType, typename IdType>
 void KdTreeKNN(
@@ -310,6 +288,164 @@ void BruteForceKNN(
     });
   }
 }
+
+/**
+ * @brief Pack a tile of data points transposed, so that the coordinates of
+ *  the points along a dimension are contiguous, and compute their squared
+ *  norms.
+ */
+template <typename FloatType>
+void PackDataTile(
+    const FloatType* points, int64_t num_points, int64_t feature_size,
+    FloatType* packed, FloatType* norms) {
+  for (int64_t i = 0; i < num_points; ++i) {
+    const FloatType* point = points + i * feature_size;
+    FloatType norm = 0;
+    for (int64_t d = 0; d < feature_size; ++d) {
+      packed[d * num_points + i] = point[d];
+      norm += point[d] * point[d];
+    }
+    norms[i] = norm;
+  }
+}
+
+/**
+ * @brief Compute ||y||^2 - 2x.y between \a num_queries (at most
+ *  BLOCKED_KNN_QUERY_TILE_SIZE) queries x and the points y of a packed tile.
+ *  The squared norm of x is left out since it does not change the order of
+ *  the neighbors of a query.
+ */
+template <typename FloatType>
+void ComputeDistanceTile(
+    const FloatType* queries, int num_queries, const FloatType* packed,
+    const FloatType* norms, int64_t num_points, int64_t feature_size,
+    FloatType* dists) {
+  FloatType* rows[BLOCKED_KNN_QUERY_TILE_SIZE];
+  for (int q = 0; q < BLOCKED_KNN_QUERY_TILE_SIZE; ++q) {
+    rows[q] = dists + q * num_points;
+    std::fill(rows[q], rows[q] + num_points, FloatType(0));
+  }
+  for (int64_t d = 0; d < feature_size; ++d) {
+    // Unused rows are computed for zero queries and thrown away, so that the
+    // inner loop does not depend on the number of queries.
+    FloatType x[BLOCKED_KNN_QUERY_TILE_SIZE] = {0};
+    for (int q = 0; q < num_queries; ++q) {
+      x[q] = queries[q * feature_size + d];
+    }
+    const FloatType* y = packed + d * num_points;
+    FloatType *r0 = rows[0], *r1 = rows[1], *r2 = rows[2], *r3 = rows[3];
+#pragma omp simd
+    for (int64_t i = 0; i < num_points; ++i) {
+      r0[i] += x[0] * y[i];
+      r1[i] += x[1] * y[i];
+      r2[i] += x[2] * y[i];
+      r3[i] += x[3] * y[i];
+    }
+  }
+  for (int q = 0; q < num_queries; ++q) {
+    FloatType* row = rows[q];
+#pragma omp simd
+    for (int64_t i = 0; i < num_points; ++i) {
+      row[i] = norms[i] - 2 * row[i];
+    }
+  }
+}
+
+/**
+ * @brief Brute-force KNN which computes the distances between blocks of
+ *  queries and tiles of data points as a tiled matrix multiplication, using
+ *  ||x||^2 + ||y||^2 - 2x.y. The distances of a tile are filtered against the
+ *  worst distance of the heap of the query without branches, so only the few
+ *  candidates which may be among the k nearest ones are inserted.
+ */
+template <typename FloatType, typename IdType>
+void BlockedBruteForceKNN(
+    const NDArray& data_points, const IdArray& data_offsets,
+    const NDArray& query_points, const IdArray& query_offsets, const int k,
+    IdArray result) {
+  static_assert(
+      BLOCKED_KNN_QUERY_TILE_SIZE == 4,
+      "ComputeDistanceTile is unrolled for 4 queries");
+  const int64_t batch_size = data_offsets->shape[0] - 1;
+  const int64_t feature_size = data_points->shape[1];
+  const IdType* data_offsets_data = data_offsets.Ptr<IdType>();
+  const IdType* query_offsets_data = query_offsets.Ptr<IdType>();
+  const FloatType* data_points_data = data_points.Ptr<FloatType>();
+  const FloatType* query_points_data = query_points.Ptr<FloatType>();
+  IdType* query_out = result.Ptr<IdType>();
+  IdType* data_out = query_out + k * query_points->shape[0];
+
+  for (int64_t b = 0; b < batch_size; ++b) {
+    const IdType d_start = data_offsets_data[b];
+    const IdType d_end = data_offsets_data[b + 1];
+    const IdType q_start = query_offsets_data[b];
+    const IdType q_end = query_offsets_data[b + 1];
+    const int64_t num_query_blocks =
+        (q_end - q_start + BLOCKED_KNN_QUERY_BLOCK_SIZE - 1) /
+        BLOCKED_KNN_QUERY_BLOCK_SIZE;
+
+    parallel_for(0, num_query_blocks, 1, [&](int64_t bb, int64_t be) {
+      std::vector<FloatType> packed(BLOCKED_KNN_DATA_BLOCK_SIZE * feature_size);
+      std::vector<FloatType> norms(BLOCKED_KNN_DATA_BLOCK_SIZE);
+      std::vector<FloatType> dists(
+          BLOCKED_KNN_QUERY_TILE_SIZE * BLOCKED_KNN_DATA_BLOCK_SIZE);
+      std::vector<FloatType> heap_dists(BLOCKED_KNN_QUERY_BLOCK_SIZE * k);
+      std::vector<IdType> candidates(BLOCKED_KNN_DATA_BLOCK_SIZE);
+
+      for (int64_t block = bb; block < be; ++block) {
+        const IdType block_start =
+            q_start + block * BLOCKED_KNN_QUERY_BLOCK_SIZE;
+        const IdType block_end = std::min<IdType>(
+            block_start + BLOCKED_KNN_QUERY_BLOCK_SIZE, q_end);
+        for (IdType q_idx = block_start; q_idx < block_end; ++q_idx) {
+          for (IdType k_idx = 0; k_idx < k; ++k_idx) {
+            query_out[q_idx * k + k_idx] = q_idx;
+          }
+        }
+        std::fill(
+            heap_dists.begin(), heap_dists.end(),
+            std::numeric_limits<FloatType>::max());
+
+        for (IdType tile_start = d_start; tile_start < d_end;
+             tile_start += BLOCKED_KNN_DATA_BLOCK_SIZE) {
+          const int64_t tile_size = std::min<int64_t>(
+              BLOCKED_KNN_DATA_BLOCK_SIZE, d_end - tile_start);
+          PackDataTile<FloatType>(
+              data_points_data + tile_start * feature_size, tile_size,
+              feature_size, packed.data(), norms.data());
+
+          for (IdType q_idx = block_start; q_idx < block_end;
+               q_idx += BLOCKED_KNN_QUERY_TILE_SIZE) {
+            const int num_queries = std::min<int>(
+                BLOCKED_KNN_QUERY_TILE_SIZE, block_end - q_idx);
+            ComputeDistanceTile<FloatType>(
+                query_points_data + q_idx * feature_size, num_queries,
+                packed.data(), norms.data(), tile_size, feature_size,
+                dists.data());
+
+            for (int q = 0; q < num_queries; ++q) {
+              const FloatType* row = dists.data() + q * tile_size;
+              FloatType* heap =
+                  heap_dists.data() + (q_idx + q - block_start) * k;
+              IdType* out = data_out + (q_idx + q) * k;
+              FloatType worst_dist = heap[0];
+              IdType num_candidates = 0;
+              for (int64_t i = 0; i < tile_size; ++i) {
+                candidates[num_candidates] = i;
+                num_candidates += row[i] <= worst_dist;
+              }
+              for (IdType c = 0; c < num_candidates; ++c) {
+                const IdType i = candidates[c];
+                HeapInsert<FloatType, IdType>(
+                    out, heap, tile_start + i, row[i], k);
+              }
+            }
+          }
+        }
+      }
+    });
+  }
+}
 }  // namespace impl
 
 template <DGLDeviceType XPU, typename FloatType, typename IdType>
@@ -323,6 +459,9 @@ void KNN(
   } else if (algorithm == std::string("bruteforce")) {
     impl::BruteForceKNN<FloatType, IdType>(
         data_points, data_offsets, query_points, query_offsets, k, result);
+  } else if (algorithm == std::string("bruteforce-blocked")) {
+    impl::BlockedBruteForceKNN<FloatType, IdType>(
+        data_points, data_offsets, query_points, query_offsets, k, result);
   } else {
     LOG(FATAL) << "Algorithm " << algorithm << " is not supported on CPU";
   }
@@ -488,87 +627,114 @@ void NNDescent(
         IdType block_end =
             std::min(point_idx_end, block_start + impl::NN_DESCENT_BLOCK_SIZE);
         IdType block_size = block_end - block_start;
-        nnd_updates_t updates(block_size);
+        // The points are split into stripes, each owned by a single thread
+        // which applies all the updates of the heaps of its points without
+        // locking. The updates are bucketed by the task generating them and
+        // the stripe of the point whose heap they update, so that each owner
+        // only visits its own updates, in the order of generation.
+        const int64_t num_stripes = num_threads;
+        const int64_t num_tasks = std::min<int64_t>(
+            block_size, num_threads * impl::NN_DESCENT_TASKS_PER_THREAD);
+        nnd_updates_t updates(num_tasks * num_stripes);
 
         // generate updates
-        runtime::parallel_for(block_start, block_end, [&](size_t b, size_t e) {
-          for (auto i = b; i < e; ++i) {
-            IdType local_idx = i - point_idx_start;
+        runtime::parallel_for(0, num_tasks, 1, [&](int64_t tb, int64_t te) {
+          for (auto task = tb; task < te; ++task) {
+            auto* task_updates = updates.data() + task * num_stripes;
+            // Each point gets the update if it may enter its heap, which only
+            // shrinks until the updates are applied.
+            auto push_update = [&](IdType p1, IdType p2, FloatType dist,
+                                   FloatType worst_p1_dist,
+                                   FloatType worst_p2_dist) {
+              if (dist <= worst_p1_dist) {
+                task_updates[(p1 - point_idx_start) % num_stripes]
+                    .emplace_back(p1, p2, dist);
+              }
+              if (dist <= worst_p2_dist) {
+                task_updates[(p2 - point_idx_start) % num_stripes]
+                    .emplace_back(p2, p1, dist);
+              }
+            };
+            const IdType task_start =
+                block_start + block_size * task / num_tasks;
+            const IdType task_end =
+                block_start + block_size * (task + 1) / num_tasks;
 
-            for (IdType c1 = 0; c1 < num_candidates; ++c1) {
-              IdType new_c1 = new_candidates[local_idx * num_candidates + c1];
-              if (new_c1 == num_nodes) continue;
-              IdType c1_local = new_c1 - point_idx_start;
-
-              // new-new
-              for (IdType c2 = c1; c2 < num_candidates; ++c2) {
-                IdType new_c2 = new_candidates[local_idx * num_candidates + c2];
-                if (new_c2 == num_nodes) continue;
-                IdType c2_local = new_c2 - point_idx_start;
-
-                FloatType worst_c1_dist = neighbors_dists[c1_local * k];
-                FloatType worst_c2_dist = neighbors_dists[c2_local * k];
-                FloatType new_dist =
-                    impl::EuclideanDistWithCheck<FloatType, IdType>(
-                        points_data + new_c1 * feature_size,
-                        points_data + new_c2 * feature_size, feature_size,
-                        std::max(worst_c1_dist, worst_c2_dist));
-
-                if (new_dist < worst_c1_dist || new_dist < worst_c2_dist) {
-                  updates[i - block_start].push_back(
-                      std::make_tuple(new_c1, new_c2, new_dist));
+            for (IdType i = task_start; i < task_end; ++i) {
+              IdType local_idx = i - point_idx_start;
+
+              for (IdType c1 = 0; c1 < num_candidates; ++c1) {
+                IdType new_c1 = new_candidates[local_idx * num_candidates + c1];
+                if (new_c1 == num_nodes) continue;
+                IdType c1_local = new_c1 - point_idx_start;
+
+                // new-new
+                for (IdType c2 = c1; c2 < num_candidates; ++c2) {
+                  IdType new_c2 =
+                      new_candidates[local_idx * num_candidates + c2];
+                  if (new_c2 == num_nodes) continue;
+                  IdType c2_local = new_c2 - point_idx_start;
+
+                  FloatType worst_c1_dist = neighbors_dists[c1_local * k];
+                  FloatType worst_c2_dist = neighbors_dists[c2_local * k];
+                  FloatType new_dist =
+                      impl::EuclideanDistWithCheck<FloatType, IdType>(
+                          points_data + new_c1 * feature_size,
+                          points_data + new_c2 * feature_size, feature_size,
+                          std::max(worst_c1_dist, worst_c2_dist));
+
+                  if (new_dist < worst_c1_dist || new_dist < worst_c2_dist) {
+                    push_update(
+                        new_c1, new_c2, new_dist, worst_c1_dist,
+                        worst_c2_dist);
+                  }
                 }
-              }
 
-              // new-old
-              for (IdType c2 = 0; c2 < num_candidates; ++c2) {
-                IdType old_c2 = old_candidates[local_idx * num_candidates + c2];
-                if (old_c2 == num_nodes) continue;
-                IdType c2_local = old_c2 - point_idx_start;
-
-                FloatType worst_c1_dist = neighbors_dists[c1_local * k];
-                FloatType worst_c2_dist = neighbors_dists[c2_local * k];
-                FloatType new_dist =
-                    impl::EuclideanDistWithCheck<FloatType, IdType>(
-                        points_data + new_c1 * feature_size,
-                        points_data + old_c2 * feature_size, feature_size,
-                        std::max(worst_c1_dist, worst_c2_dist));
-
-                if (new_dist < worst_c1_dist || new_dist < worst_c2_dist) {
-                  updates[i - block_start].push_back(
-                      std::make_tuple(new_c1, old_c2, new_dist));
+                // new-old
+                for (IdType c2 = 0; c2 < num_candidates; ++c2) {
+                  IdType old_c2 =
+                      old_candidates[local_idx * num_candidates + c2];
+                  if (old_c2 == num_nodes) continue;
+                  IdType c2_local = old_c2 - point_idx_start;
+
+                  FloatType worst_c1_dist = neighbors_dists[c1_local * k];
+                  FloatType worst_c2_dist = neighbors_dists[c2_local * k];
+                  FloatType new_dist =
+                      impl::EuclideanDistWithCheck<FloatType, IdType>(
+                          points_data + new_c1 * feature_size,
+                          points_data + old_c2 * feature_size, feature_size,
+                          std::max(worst_c1_dist, worst_c2_dist));
+
+                  if (new_dist < worst_c1_dist || new_dist < worst_c2_dist) {
+                    push_update(
+                        new_c1, old_c2, new_dist, worst_c1_dist,
+                        worst_c2_dist);
+                  }
                 }
               }
             }
           }
         });
 
-        int tid;
-#pragma omp parallel private(tid, num_threads) reduction(+ : num_updates)
-        {
-          tid = omp_get_thread_num();
-          num_threads = omp_get_num_threads();
-          for (IdType i = 0; i < block_size; ++i) {
-            for (const auto& u : updates[i]) {
-              IdType p1, p2;
-              FloatType d;
-              std::tie(p1, p2, d) = u;
-              IdType p1_local = p1 - point_idx_start;
-              IdType p2_local = p2 - point_idx_start;
-
-              if (p1 % num_threads == tid) {
-                num_updates += impl::FlaggedHeapInsert<FloatType, IdType>(
-                    neighbors + p1 * k, neighbors_dists + p1_local * k,
-                    flags + p1_local * k, p2, d, true, k, true);
-              }
-              if (p2 % num_threads == tid) {
-                num_updates += impl::FlaggedHeapInsert<FloatType, IdType>(
-                    neighbors + p2 * k, neighbors_dists + p2_local * k,
-                    flags + p2_local * k, p1, d, true, k, true);
+        // apply updates
+        std::vector<size_t> stripe_updates(num_stripes, 0);
+        runtime::parallel_for(0, num_stripes, 1, [&](int64_t sb, int64_t se) {
+          for (auto stripe = sb; stripe < se; ++stripe) {
+            for (int64_t task = 0; task < num_tasks; ++task) {
+              for (const auto& u : updates[task * num_stripes + stripe]) {
+                IdType p1, p2;
+                FloatType d;
+                std::tie(p1, p2, d) = u;
+                IdType p1_local = p1 - point_idx_start;
+                stripe_updates[stripe] +=
+                    impl::FlaggedHeapInsert<FloatType, IdType>(
+                        neighbors + p1 * k, neighbors_dists + p1_local * k,
+                        flags + p1_local * k, p2, d, true, k, true);
               }
             }
           }
-        }
+        });
+        for (auto n : stripe_updates) num_updates += n;
       }
 
       // early abort
@@ -1724,14 +1724,10 @@ void UnitGraph::Save(dmlc::Stream* fs) const {
   fs->Write(kDGLSerialize_UnitGraphMagic);
   // Didn't write UnitGraph::meta_graph_, since it's included in the underlying
   // sparse matrix
-  auto save_formats = SparseFormatsToCode({SelectFormat(ALL_CODE)});
-  auto fstream = dynamic_cast<dgl::serialize::DGLStream*>(fs);
-  if (fstream) {
-    auto formats = fstream->FormatsToSave();
-    save_formats = formats == ANY_CODE
-                       ? SparseFormatsToCode({SelectFormat(ALL_CODE)})
-                       : formats;
-  }
+  auto formats = dgl::serialize::FormatsToSave(fs);
+  auto save_formats = formats == ANY_CODE
+                          ? SparseFormatsToCode({SelectFormat(ALL_CODE)})
+                          : formats;
   fs->Write(static_cast<int64_t>(save_formats | 0x100000000));
   fs->Write(static_cast<int64_t>(formats_ | 0x100000000));
   if (save_formats & COO_CODE) {
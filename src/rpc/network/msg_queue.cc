@@ -7,6 +7,7 @@
 
 #include <dmlc/logging.h>
 
+#include <algorithm>
 #include <cstring>
 
 namespace dgl {
@@ -20,6 +21,82 @@ MessageQueue::MessageQueue(int64_t queue_size, int num_producers) {
   queue_size_ = queue_size;
   free_size_ = queue_size;
   num_producers_ = num_producers;
+  exit_flag_ = num_producers == 0;
+  // Every message has at least one byte, so more slots than bytes are useless.
+  size_t num_slots = 1;
+  while (num_slots < static_cast<size_t>(std::min(queue_size, kMaxSlots))) {
+    num_slots <<= 1;
+  }
+  slots_.reset(new Slot[num_slots]);
+  for (size_t i = 0; i < num_slots; ++i) {
+    slots_[i].seq.store(i, std::memory_order_relaxed);
+  }
+  mask_ = num_slots - 1;
+}
+
+bool MessageQueue::TryPush(Message* msg) {
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  Slot* slot;
+  while (true) {
+    slot = &slots_[pos & mask_];
+    const size_t seq = slot->seq.load(std::memory_order_acquire);
+    const intptr_t diff =
+        static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (enqueue_pos_.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+  slot->msg = std::move(*msg);
+  slot->seq.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+bool MessageQueue::TryPop(Message* msg) {
+  size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+  Slot* slot;
+  while (true) {
+    slot = &slots_[pos & mask_];
+    const size_t seq = slot->seq.load(std::memory_order_acquire);
+    const intptr_t diff =
+        static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+    if (diff == 0) {
+      if (dequeue_pos_.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = dequeue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+  *msg = std::move(slot->msg);
+  slot->msg.deallocator = nullptr;
+  slot->seq.store(pos + mask_ + 1, std::memory_order_release);
+  return true;
+}
+
+bool MessageQueue::Full() const {
+  const size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  const size_t seq = slots_[pos & mask_].seq.load(std::memory_order_acquire);
+  return static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos) < 0;
+}
+
+bool MessageQueue::TryReserve(int64_t size) {
+  int64_t free_size = free_size_.load(std::memory_order_relaxed);
+  while (size <= free_size) {
+    if (free_size_.compare_exchange_weak(free_size, free_size - size)) {
+      return true;
+    }
+  }
+  return false;
 }
 
 STATUS MessageQueue::Add(Message msg, bool is_blocking) {
@@ -32,48 +109,44 @@ STATUS MessageQueue::Add(Message msg, bool is_blocking) {
     LOG(WARNING) << "Message size (" << msg.size << ") is negative or zero.";
     return MSG_LE_ZERO;
   }
-  std::unique_lock<std::mutex> lock(mutex_);
-  if (finished_producers_.size() >= num_producers_) {
+  if (exit_flag_.load()) {
     return QUEUE_CLOSE;
   }
-  if (msg.size > free_size_ && !is_blocking) {
-    return QUEUE_FULL;
+  const int64_t size = msg.size;
+  while (!TryReserve(size)) {
+    if (!is_blocking) {
+      return QUEUE_FULL;
+    }
+    not_full_.Wait([&]() { return size <= free_size_.load(); });
   }
-  cond_not_full_.wait(lock, [&]() { return msg.size <= free_size_; });
   // Add data pointer to queue
-  queue_.push(msg);
-  free_size_ -= msg.size;
+  while (!TryPush(&msg)) {
+    if (!is_blocking) {
+      free_size_ += size;
+      not_full_.Notify(true);
+      return QUEUE_FULL;
+    }
+    not_full_.Wait([this]() { return !Full(); });
+  }
   // not empty signal
-  cond_not_empty_.notify_one();
+  not_empty_.Notify();
 
   return ADD_SUCCESS;
 }
 
 STATUS MessageQueue::Remove(Message* msg, bool is_blocking) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  if (queue_.empty()) {
+  while (!TryPop(msg)) {
     if (!is_blocking) {
       return QUEUE_EMPTY;
     }
-    if (finished_producers_.size() >= num_producers_) {
+    if (exit_flag_.load() && Empty()) {
       return QUEUE_CLOSE;
     }
+    not_empty_.Wait([this]() { return !Empty() || exit_flag_.load(); });
   }
-
-  cond_not_empty_.wait(
-      lock, [this] { return !queue_.empty() || exit_flag_.load(); });
-  if (finished_producers_.size() >= num_producers_ && queue_.empty()) {
-    return QUEUE_CLOSE;
-  }
-
-  Message old_msg = queue_.front();
-  queue_.pop();
-  msg->data = old_msg.data;
-  msg->size = old_msg.size;
-  msg->receiver_id = old_msg.receiver_id;
-  msg->deallocator = old_msg.deallocator;
-  free_size_ += old_msg.size;
-  cond_not_full_.notify_one();
+  free_size_ += msg->size;
+  // Waiting producers may need different sizes, so wake them all up.
+  not_full_.Notify(true);
 
   return REMOVE_SUCCESS;
 }
@@ -85,18 +158,18 @@ void MessageQueue::SignalFinished(int producer_id) {
   // waken up to get this signal
   if (finished_producers_.size() >= num_producers_) {
     exit_flag_.store(true);
-    cond_not_empty_.notify_all();
+    not_empty_.Notify(true);
   }
 }
 
 bool MessageQueue::Empty() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return queue_.size() == 0;
+  const size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+  const size_t seq = slots_[pos & mask_].seq.load(std::memory_order_acquire);
+  return static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0;
 }
 
 bool MessageQueue::EmptyAndNoMoreAdd() const {
-  std::lock_guard<std::mutex> lock(mutex_);
-  return queue_.size() == 0 && finished_producers_.size() >= num_producers_;
+  return Empty() && exit_flag_.load();
 }
 
 }  // namespace network
@@ -11,10 +11,11 @@
 #include <atomic>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <set>
 #include <string>
+#include <thread>
 #include <utility>  // for pair
 
 namespace dgl {
@@ -71,18 +72,81 @@ struct Message {
  */
 inline void DefaultMessageDeleter(Message* msg) { delete[] msg->data; }
 
+/**
+ * @brief Parks threads until a condition may have become true.
+ *
+ * Notify() only takes the mutex when some thread is waiting, so that the
+ * threads that never have to wait do not contend on it.
+ */
+class Waiter {
+ public:
+  /**
+   * @brief Block until \a ready returns true.
+   *
+   * The state \a ready reads must be updated before Notify() is invoked.
+   */
+  template <typename Pred>
+  void Wait(Pred ready) {
+    // The condition usually becomes true soon under contention, so yield a
+    // few times before blocking.
+    for (int i = 0; i < kSpinCount; ++i) {
+      if (ready()) {
+        return;
+      }
+      std::this_thread::yield();
+    }
+    num_waiters_.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, ready);
+    }
+    num_waiters_.fetch_sub(1);
+  }
+
+  /**
+   * @brief Wake up one waiting thread, or all of them if \a all is true, to
+   * check their conditions again.
+   */
+  void Notify(bool all = false) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (num_waiters_.load() == 0) {
+      return;
+    }
+    // Taking the mutex makes sure a waiter is either before checking its
+    // condition or already blocked.
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    if (all) {
+      cond_.notify_all();
+    } else {
+      cond_.notify_one();
+    }
+  }
+
+ private:
+  static constexpr int kSpinCount = 16;
+  std::atomic<int> num_waiters_{0};
+  std::mutex mutex_;
+  std::condition_variable cond_;
+};
+
 /**
  * @brief Message Queue for network communication.
  *
  * MessageQueue is FIFO queue that adopts producer/consumer model for data
  * message. It supports one or more producer threads and one or more consumer
  * threads. Producers invokes Add() to push data message into the queue, and
- * consumers invokes Remove() to pop data message from queue. Add() and Remove()
- * use two condition variables to synchronize producer threads and consumer
- * threads. Each producer invokes SignalFinished(producer_id) to claim that it
- * is about to finish, where producer_id is an integer uniquely identify a
- * producer thread. This signaling mechanism prevents consumers from waiting
- * after all producers have finished their jobs.
+ * consumers invokes Remove() to pop data message from queue. Each producer
+ * invokes SignalFinished(producer_id) to claim that it is about to finish,
+ * where producer_id is an integer uniquely identify a producer thread. This
+ * signaling mechanism prevents consumers from waiting after all producers
+ * have finished their jobs.
+ *
+ * Messages are stored in a lock-free bounded ring buffer, and the queue size
+ * in bytes is reserved with atomic operations. Producers and consumers only
+ * block, on a Waiter, when the queue is full or empty respectively. The ring
+ * buffer holds at most kMaxSlots messages, so the queue may also be full when
+ * it holds that many messages.
  *
  * MessageQueue is thread-safe.
  *
@@ -91,6 +155,11 @@ class MessageQueue {
  public:
   /**
    * @brief MessageQueue constructor
+   *
+   * Besides queue_size bytes, the queue holds at most
+   * min(queue_size, kMaxSlots) messages. Add() waits, or returns QUEUE_FULL
+   * if not blocking, when that many messages are in the queue.
+   *
    * @param queue_size size (bytes) of message queue
    * @param num_producers number of producers, use 1 by default
    */
@@ -134,21 +203,75 @@ class MessageQueue {
    */
   bool EmptyAndNoMoreAdd() const;
 
+  /**
+   * @brief Maximal number of messages in the ring buffer
+   */
+  static constexpr int64_t kMaxSlots = 1 << 12;
+
  protected:
   /**
-   * @brief message queue
+   * @brief Slot of the ring buffer
+   *
+   * A slot at position pos is free for the producer of pos when its sequence
+   * is pos, and holds a message for the consumer of pos when its sequence is
+   * pos + 1.
+   */
+  struct Slot {
+    std::atomic<size_t> seq;
+    Message msg;
+  };
+
+  /**
+   * @brief Push a message into the ring buffer
+   * @return false if the ring buffer is full
+   */
+  bool TryPush(Message* msg);
+
+  /**
+   * @brief Pop a message from the ring buffer
+   * @return false if the ring buffer is empty
    */
-  std::queue<Message> queue_;
+  bool TryPop(Message* msg);
+
+  /**
+   * @return true if the ring buffer is full
+   */
+  bool Full() const;
+
+  /**
+   * @brief Try to reserve size bytes of the queue
+   */
+  bool TryReserve(int64_t size);
+
+  /**
+   * @brief Ring buffer of messages
+   */
+  std::unique_ptr<Slot[]> slots_;
+
+  /**
+   * @brief Number of slots minus one, the number of slots is a power of 2
+   */
+  size_t mask_;
+
+  /**
+   * @brief Position of the next message to add
+   */
+  alignas(64) std::atomic<size_t> enqueue_pos_{0};
+
+  /**
+   * @brief Position of the next message to remove
+   */
+  alignas(64) std::atomic<size_t> dequeue_pos_{0};
 
   /**
    * @brief Size of the queue in bytes
    */
-  int64_t queue_size_;
+  alignas(64) int64_t queue_size_;
 
   /**
    * @brief Free size of the queue
    */
-  int64_t free_size_;
+  std::atomic<int64_t> free_size_;
 
   /**
    * @brief Used to check all producers will no longer produce anything
@@ -161,24 +284,24 @@ class MessageQueue {
   std::set<int /* producer_id */> finished_producers_;
 
   /**
-   * @brief Condition when consumer should wait
+   * @brief Protect finished_producers_
    */
-  std::condition_variable cond_not_full_;
+  mutable std::mutex mutex_;
 
   /**
-   * @brief Condition when producer should wait
+   * @brief Where producers wait when the queue is full
    */
-  std::condition_variable cond_not_empty_;
+  Waiter not_full_;
 
   /**
-   * @brief Signal for exit wait
+   * @brief Where consumers wait when the queue is empty
    */
-  std::atomic<bool> exit_flag_{false};
+  Waiter not_empty_;
 
   /**
-   * @brief Protect all above data and conditions
+   * @brief Signal for exit wait, set when all producers have finished
    */
-  mutable std::mutex mutex_;
+  std::atomic<bool> exit_flag_{false};
 };
 
 }  // namespace network
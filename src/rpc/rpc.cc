@@ -36,7 +36,10 @@ RPCStatus SendRPCMessage(const RPCMessage& msg, const int32_t target_id) {
   return kRPCSuccess;
 }
 
-RPCStatus RecvRPCMessage(RPCMessage* msg, int32_t timeout) {
+namespace {
+
+/** @brief Receive the next message from the receiver, ignoring the stash. */
+RPCStatus RecvRPCMessageFromReceiver(RPCMessage* msg, int32_t timeout) {
   static constexpr int32_t retry_timeout = 5 * 1000;  // milliseconds
   RPCStatus status;
   const int32_t real_timeout = timeout == 0 ? retry_timeout : timeout;
@@ -55,6 +58,48 @@ RPCStatus RecvRPCMessage(RPCMessage* msg, int32_t timeout) {
   return status;
 }
 
+/**
+ * @brief Drop the message if it is a response of an abandoned fast pull.
+ *
+ * @return Whether the message was dropped.
+ */
+bool DropAbandonedPullResponse(const RPCMessage& msg) {
+  auto& abandoned = RPCContext::getInstance()->abandoned_pulls;
+  auto it = abandoned.find(msg.msg_seq);
+  if (it == abandoned.end()) return false;
+  if (--it->second == 0) abandoned.erase(it);
+  return true;
+}
+
+}  // namespace
+
+RPCStatus RecvRPCMessage(RPCMessage* msg, int32_t timeout) {
+  auto* ctx = RPCContext::getInstance();
+  auto is_pull_response = [ctx](const RPCMessage& m) {
+    return ctx->pending_pulls.count(m.msg_seq) > 0;
+  };
+  auto& stash = ctx->stashed_msgs;
+  for (auto it = stash.begin(); it != stash.end();) {
+    if (DropAbandonedPullResponse(*it)) {
+      it = stash.erase(it);
+    } else if (!is_pull_response(*it)) {
+      *msg = std::move(*it);
+      stash.erase(it);
+      return kRPCSuccess;
+    } else {
+      ++it;
+    }
+  }
+  while (true) {
+    const RPCStatus status = RecvRPCMessageFromReceiver(msg, timeout);
+    if (status != kRPCSuccess) return status;
+    if (DropAbandonedPullResponse(*msg)) continue;
+    if (!is_pull_response(*msg)) return status;
+    // Leave the response to the fast pull waiting for it.
+    stash.push_back(*msg);
+  }
+}
+
 //////////////////////////// C APIs ////////////////////////////
 DGL_REGISTER_GLOBAL("distributed.rpc._CAPI_DGLRPCReset")
     .set_body([](DGLArgs args, DGLRetValue* rv) { RPCContext::Reset(); });
@@ -347,115 +392,230 @@ DGL_REGISTER_GLOBAL("distributed.rpc._CAPI_DGLRPCGetGlobalIDFromLocalPartition")
       *rv = res_tensor;
     });
 
-DGL_REGISTER_GLOBAL("distributed.rpc._CAPI_DGLRPCFastPull")
-    .set_body([](DGLArgs args, DGLRetValue* rv) {
-      // Input
-      std::string name = args[0];
-      int local_machine_id = args[1];
-      int machine_count = args[2];
-      int group_count = args[3];
-      int client_id = args[4];
-      int service_id = args[5];
-      int64_t msg_seq = args[6];
-      std::string pickle_data = args[7];
-      NDArray ID = args[8];
-      NDArray part_id = args[9];
-      NDArray local_id = args[10];
-      NDArray local_data = args[11];
-      // Data
-      dgl_id_t ID_size = ID.GetSize() / sizeof(dgl_id_t);
-      dgl_id_t* ID_data = static_cast<dgl_id_t*>(ID->data);
-      dgl_id_t* part_id_data = static_cast<dgl_id_t*>(part_id->data);
-      dgl_id_t* local_id_data = static_cast<dgl_id_t*>(local_id->data);
-      char* local_data_char = static_cast<char*>(local_data->data);
-      std::vector<dgl_id_t> local_ids;
-      std::vector<dgl_id_t> local_ids_orginal;
-      std::vector<int64_t> local_data_shape;
-      std::vector<std::vector<dgl_id_t>> remote_ids(machine_count);
-      std::vector<std::vector<dgl_id_t>> remote_ids_original(machine_count);
-      // Get row size (in bytes)
-      int row_size = 1;
-      for (int i = 0; i < local_data->ndim; ++i) {
-        local_data_shape.push_back(local_data->shape[i]);
-        if (i != 0) {
-          row_size *= local_data->shape[i];
-        }
-      }
-      row_size *= (local_data->dtype.bits / 8);
-      size_t data_size = local_data.GetSize();
-      CHECK_GT(local_data_shape.size(), 0);
-      CHECK_EQ(row_size * local_data_shape[0], data_size);
-      // Get local id (used in local machine) and
-      // remote id (send to remote machine)
-      dgl_id_t idx = 0;
-      for (dgl_id_t i = 0; i < ID_size; ++i) {
-        dgl_id_t p_id = part_id_data[i];
-        if (static_cast<int>(p_id) == local_machine_id) {
-          dgl_id_t l_id = local_id_data[idx++];
-          CHECK_LT(l_id, local_data_shape[0]);
-          CHECK_GE(l_id, 0);
-          local_ids.push_back(l_id);
-          local_ids_orginal.push_back(i);
-        } else {
-          CHECK_LT(p_id, machine_count) << "Invalid partition ID.";
-          dgl_id_t id = ID_data[i];
-          remote_ids[p_id].push_back(id);
-          remote_ids_original[p_id].push_back(i);
-        }
+namespace {
+
+/** @brief Begin of the \a p-th of \a num_parts equal chunks of [0, n). */
+inline int64_t ChunkBegin(int64_t n, int64_t num_parts, int64_t p) {
+  return std::min(n, (n + num_parts - 1) / num_parts * p);
+}
+
+/**
+ * @brief Send the requests of a fast pull to the remote machines and copy the
+ * local rows while the requests are outstanding.
+ */
+std::shared_ptr<FastPullRequest> IssueFastPull(DGLArgs args) {
+  // Input
+  std::string name = args[0];
+  int local_machine_id = args[1];
+  int machine_count = args[2];
+  int group_count = args[3];
+  int client_id = args[4];
+  int service_id = args[5];
+  int64_t msg_seq = args[6];
+  std::string pickle_data = args[7];
+  NDArray ID = args[8];
+  NDArray part_id = args[9];
+  NDArray local_id = args[10];
+  NDArray local_data = args[11];
+  // Data
+  const int64_t ID_size = ID.GetSize() / sizeof(dgl_id_t);
+  const dgl_id_t* ID_data = static_cast<dgl_id_t*>(ID->data);
+  const dgl_id_t* part_id_data = static_cast<dgl_id_t*>(part_id->data);
+  const dgl_id_t* local_id_data = static_cast<dgl_id_t*>(local_id->data);
+  const char* local_data_char = static_cast<char*>(local_data->data);
+  std::vector<int64_t> local_data_shape;
+  // Get row size (in bytes)
+  int64_t row_size = 1;
+  for (int i = 0; i < local_data->ndim; ++i) {
+    local_data_shape.push_back(local_data->shape[i]);
+    if (i != 0) {
+      row_size *= local_data->shape[i];
+    }
+  }
+  row_size *= (local_data->dtype.bits / 8);
+  CHECK_GT(local_data_shape.size(), 0);
+  const int64_t num_local_rows = local_data_shape[0];
+  CHECK_EQ(
+      static_cast<size_t>(row_size * num_local_rows), local_data.GetSize());
+
+  auto req = std::make_shared<FastPullRequest>();
+  req->msg_seq = msg_seq;
+  req->group_count = group_count;
+  req->row_size = row_size;
+  req->offset.assign(machine_count + 1, 0);
+  req->pos.resize(ID_size);
+
+  // Group the rows by machine with a parallel counting sort, so that the rows
+  // of every machine keep their input order. The i-th row of the local
+  // machine is then the i-th entry of local_id.
+  const int64_t num_parts = compute_num_threads(0, ID_size, 1);
+  std::vector<int64_t> part_offset(num_parts * machine_count, 0);
+  parallel_for(0, num_parts, 1, [&](size_t b, size_t e) {
+    for (auto p = b; p < e; ++p) {
+      int64_t* count = part_offset.data() + p * machine_count;
+      const int64_t end = ChunkBegin(ID_size, num_parts, p + 1);
+      for (int64_t i = ChunkBegin(ID_size, num_parts, p); i < end; ++i) {
+        CHECK_LT(static_cast<int64_t>(part_id_data[i]), machine_count)
+            << "Invalid partition ID.";
+        ++count[part_id_data[i]];
       }
-      // Send remote id
-      int msg_count = 0;
-      for (size_t i = 0; i < remote_ids.size(); ++i) {
-        if (remote_ids[i].size() != 0) {
-          RPCMessage msg;
-          msg.service_id = service_id;
-          msg.msg_seq = msg_seq;
-          msg.client_id = client_id;
-          int lower = i * group_count;
-          int upper = (i + 1) * group_count;
-          msg.server_id =
-              dgl::RandomEngine::ThreadLocal()->RandInt(lower, upper);
-          msg.data = pickle_data;
-          NDArray tensor = dgl::aten::VecToIdArray<dgl_id_t>(remote_ids[i]);
-          msg.tensors.push_back(tensor);
-          msg.group_id = RPCContext::getInstance()->group_id;
-          SendRPCMessage(msg, msg.server_id);
-          msg_count++;
-        }
+    }
+  });
+  int64_t total = 0;
+  for (int m = 0; m < machine_count; ++m) {
+    req->offset[m] = total;
+    for (int64_t p = 0; p < num_parts; ++p) {
+      const int64_t count = part_offset[p * machine_count + m];
+      part_offset[p * machine_count + m] = total;
+      total += count;
+    }
+  }
+  req->offset[machine_count] = total;
+
+  // The IDs requested from every machine are contiguous in one array, and are
+  // sent as views of it. The slots of the local machine hold local IDs.
+  IdArray ids = aten::NewIdArray(ID_size, DGLContext{kDGLCPU, 0}, 64);
+  dgl_id_t* ids_data = static_cast<dgl_id_t*>(ids->data);
+  const int64_t local_begin = req->offset[local_machine_id];
+  parallel_for(0, num_parts, 1, [&](size_t b, size_t e) {
+    for (auto p = b; p < e; ++p) {
+      int64_t* offset = part_offset.data() + p * machine_count;
+      const int64_t end = ChunkBegin(ID_size, num_parts, p + 1);
+      for (int64_t i = ChunkBegin(ID_size, num_parts, p); i < end; ++i) {
+        const int m = part_id_data[i];
+        const int64_t slot = offset[m]++;
+        req->pos[slot] = i;
+        ids_data[slot] = m == local_machine_id
+                             ? local_id_data[slot - local_begin]
+                             : ID_data[i];
       }
-      local_data_shape[0] = ID_size;
-      NDArray res_tensor = NDArray::Empty(
-          local_data_shape, local_data->dtype, DGLContext{kDGLCPU, 0});
-      char* return_data = static_cast<char*>(res_tensor->data);
-      // Copy local data
-      parallel_for(0, local_ids.size(), [&](size_t b, size_t e) {
+    }
+  });
+
+  // Send remote id
+  for (int m = 0; m < machine_count; ++m) {
+    const int64_t count = req->offset[m + 1] - req->offset[m];
+    if (m == local_machine_id || count == 0) continue;
+    RPCMessage msg;
+    msg.service_id = service_id;
+    msg.msg_seq = msg_seq;
+    msg.client_id = client_id;
+    int lower = m * group_count;
+    int upper = (m + 1) * group_count;
+    msg.server_id = dgl::RandomEngine::ThreadLocal()->RandInt(lower, upper);
+    msg.data = pickle_data;
+    msg.tensors.push_back(ids.CreateView(
+        {count}, ids->dtype, req->offset[m] * sizeof(dgl_id_t)));
+    msg.group_id = RPCContext::getInstance()->group_id;
+    SendRPCMessage(msg, msg.server_id);
+    req->num_pending++;
+  }
+  if (req->num_pending > 0) {
+    RPCContext::getInstance()->pending_pulls.insert(msg_seq);
+  }
+
+  local_data_shape[0] = ID_size;
+  req->result = NDArray::Empty(
+      local_data_shape, local_data->dtype, DGLContext{kDGLCPU, 0});
+  char* return_data = static_cast<char*>(req->result->data);
+  // Copy local data
+  const int64_t* local_pos = req->pos.data() + local_begin;
+  const dgl_id_t* local_rows = ids_data + local_begin;
+  parallel_for(
+      0, req->offset[local_machine_id + 1] - local_begin,
+      [&](size_t b, size_t e) {
         for (auto i = b; i < e; ++i) {
-          CHECK_GE(
-              ID_size * row_size, local_ids_orginal[i] * row_size + row_size);
-          CHECK_GE(data_size, local_ids[i] * row_size + row_size);
-          CHECK_GE(local_ids[i], 0);
+          CHECK_LT(static_cast<int64_t>(local_rows[i]), num_local_rows);
           memcpy(
-              return_data + local_ids_orginal[i] * row_size,
-              local_data_char + local_ids[i] * row_size, row_size);
+              return_data + local_pos[i] * row_size,
+              local_data_char + local_rows[i] * row_size, row_size);
         }
       });
-      // Recv remote message
-      int recv_cnt = 0;
-      while (recv_cnt < msg_count) {
-        RPCMessage msg;
-        auto status = RecvRPCMessage(&msg, 0);
-        CHECK_EQ(status, kRPCSuccess);
-        ++recv_cnt;
-        int part_id = msg.server_id / group_count;
-        char* data_char = static_cast<char*>(msg.tensors[0]->data);
-        dgl_id_t id_size = remote_ids[part_id].size();
-        for (size_t n = 0; n < id_size; ++n) {
-          memcpy(
-              return_data + remote_ids_original[part_id][n] * row_size,
-              data_char + n * row_size, row_size);
-        }
-      }
-      *rv = res_tensor;
+  return req;
+}
+
+/**
+ * @brief Wait for the responses of a fast pull, scattering the rows of every
+ * response as it arrives.
+ */
+NDArray WaitFastPull(FastPullRequest* req) {
+  auto* ctx = RPCContext::getInstance();
+  char* return_data = static_cast<char*>(req->result->data);
+  auto scatter = [req, return_data](const RPCMessage& msg) {
+    const int part_id = msg.server_id / req->group_count;
+    const char* data_char = static_cast<char*>(msg.tensors[0]->data);
+    const int64_t* pos = req->pos.data() + req->offset[part_id];
+    const int64_t row_size = req->row_size;
+    parallel_for(
+        0, req->offset[part_id + 1] - req->offset[part_id],
+        [&](size_t b, size_t e) {
+          for (auto n = b; n < e; ++n) {
+            memcpy(
+                return_data + pos[n] * row_size, data_char + n * row_size,
+                row_size);
+          }
+        });
+    --req->num_pending;
+  };
+  // Responses may have been stashed by other receives.
+  auto& stash = ctx->stashed_msgs;
+  for (auto it = stash.begin(); it != stash.end();) {
+    if (it->msg_seq == req->msg_seq) {
+      scatter(*it);
+      it = stash.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  // Recv remote message
+  while (req->num_pending > 0) {
+    RPCMessage msg;
+    auto status = RecvRPCMessageFromReceiver(&msg, 0);
+    CHECK_EQ(status, kRPCSuccess);
+    if (msg.msg_seq == req->msg_seq) {
+      scatter(msg);
+    } else if (!DropAbandonedPullResponse(msg)) {
+      stash.push_back(std::move(msg));
+    }
+  }
+  ctx->pending_pulls.erase(req->msg_seq);
+  return req->result;
+}
+
+}  // namespace
+
+FastPullRequest::~FastPullRequest() {
+  if (num_pending == 0) return;
+  auto* ctx = RPCContext::getInstance();
+  // Nothing is left to release if the context was reset since the request
+  // was issued.
+  if (ctx->pending_pulls.erase(msg_seq) == 0) return;
+  auto& stash = ctx->stashed_msgs;
+  for (auto it = stash.begin(); it != stash.end();) {
+    if (it->msg_seq == msg_seq) {
+      --num_pending;
+      it = stash.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (num_pending > 0) ctx->abandoned_pulls[msg_seq] = num_pending;
+}
+
+DGL_REGISTER_GLOBAL("distributed.rpc._CAPI_DGLRPCFastPull")
+    .set_body([](DGLArgs args, DGLRetValue* rv) {
+      *rv = WaitFastPull(IssueFastPull(args).get());
+    });
+
+DGL_REGISTER_GLOBAL("distributed.rpc._CAPI_DGLRPCFastPullAsync")
+    .set_body([](DGLArgs args, DGLRetValue* rv) {
+      *rv = IssueFastPull(args);
+    });
+
+DGL_REGISTER_GLOBAL("distributed.rpc._CAPI_DGLRPCFastPullWait")
+    .set_body([](DGLArgs args, DGLRetValue* rv) {
+      FastPullRequestRef req = args[0];
+      *rv = WaitFastPull(req.sptr().get());
     });
 
 DGL_REGISTER_GLOBAL("distributed.rpc._CAPI_DGLRPCGetGroupID")
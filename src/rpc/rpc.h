@@ -17,6 +17,7 @@
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "./network/common.h"
@@ -105,6 +106,26 @@ struct RPCContext {
   int32_t curr_client_id = -1;
   std::unordered_map<int32_t, std::unordered_map<int32_t, int32_t>> clients_;
 
+  /**
+   * @brief Message sequence numbers of the fast pulls whose responses have not
+   * all been received.
+   */
+  std::unordered_set<int64_t> pending_pulls;
+
+  /**
+   * @brief Number of responses not received yet of every fast pull that was
+   * destroyed without waiting for it. These responses are dropped on arrival.
+   */
+  std::unordered_map<int64_t, int> abandoned_pulls;
+
+  /**
+   * @brief Messages received before their consumer asked for them.
+   *
+   * Waiting for a fast pull stashes the messages of other requests here, and
+   * RecvRPCMessage stashes the responses of pending fast pulls here.
+   */
+  std::deque<RPCMessage> stashed_msgs;
+
   /** @brief Get the RPC context singleton */
   static RPCContext* getInstance() {
     static RPCContext ctx;
@@ -128,6 +149,9 @@ struct RPCContext {
     t->group_id = -1;
     t->curr_client_id = -1;
     t->clients_.clear();
+    t->pending_pulls.clear();
+    t->abandoned_pulls.clear();
+    t->stashed_msgs.clear();
   }
 
   int32_t RegisterClient(int32_t client_id, int32_t group_id) {
@@ -151,6 +175,43 @@ struct RPCContext {
   }
 };
 
+/**
+ * @brief A fast pull whose remote responses may not have been received yet.
+ *
+ * The local rows are already copied into the result when it is created. The
+ * remote rows are scattered into the result as their responses arrive.
+ */
+struct FastPullRequest : public runtime::Object {
+  /** @brief Sequence number of the request messages. */
+  int64_t msg_seq;
+
+  /** @brief Number of servers per machine. */
+  int group_count;
+
+  /** @brief Size of a row in bytes. */
+  int64_t row_size;
+
+  /** @brief Number of responses not received yet. */
+  int num_pending = 0;
+
+  /** @brief The pulled rows. */
+  runtime::NDArray result;
+
+  /** @brief Offset of the rows of every machine in pos. */
+  std::vector<int64_t> offset;
+
+  /** @brief Position in result of every row, grouped by machine. */
+  std::vector<int64_t> pos;
+
+  /** @brief Release the responses of the request if it was never waited. */
+  ~FastPullRequest();
+
+  static constexpr const char* _type_key = "rpc.FastPullRequest";
+  DGL_DECLARE_OBJECT_TYPE_INFO(FastPullRequest, runtime::Object);
+};
+
+DGL_DEFINE_OBJECT_REF(FastPullRequestRef, FastPullRequest);
+
 /**
  * @brief Send out one RPC message.
  *
@@ -173,6 +234,7 @@ RPCStatus SendRPCMessage(const RPCMessage& msg);
  * @brief Receive one RPC message.
  *
  * The operation is blocking -- it returns when it receives any message
+ * other than a response of a pending fast pull.
  *
  * @param msg The received message
  * @param timeout The timeout value in milliseconds. If zero, wait indefinitely.
@@ -3,51 +3,144 @@
  * @file scheduler/scheduler.cc
  * @brief DGL Scheduler implementation
  */
+#include <dgl/runtime/parallel_for.h>
 #include <dgl/scheduler.h>
 
+#include <algorithm>
 #include <unordered_map>
 #include <vector>
 
 namespace dgl {
 namespace sched {
 
+namespace {
+
+/** @brief Begin of the \a p-th of \a num_parts equal chunks of [0, n). */
+inline int64_t ChunkBegin(int64_t n, int64_t num_parts, int64_t p) {
+  return std::min(n, (n + num_parts - 1) / num_parts * p);
+}
+
+}  // namespace
+
 template <class IdType>
 std::vector<IdArray> DegreeBucketing(
     const IdArray& msg_ids, const IdArray& vids, const IdArray& recv_ids) {
-  auto n_msgs = msg_ids->shape[0];
+  const int64_t n_msgs = msg_ids->shape[0];
+  const int64_t n_recv = recv_ids->shape[0];
 
   const IdType* vid_data = static_cast<IdType*>(vids->data);
   const IdType* msg_id_data = static_cast<IdType*>(msg_ids->data);
   const IdType* recv_id_data = static_cast<IdType*>(recv_ids->data);
 
-  // in edge: dst->msgs
-  std::unordered_map<IdType, std::vector<IdType>> in_edges;
-  for (IdType i = 0; i < n_msgs; ++i) {
-    in_edges[vid_data[i]].push_back(msg_id_data[i]);
-  }
+  // Node IDs index flat per-node arrays.
+  IdType max_id = -1;
+  for (int64_t i = 0; i < n_msgs; ++i) max_id = std::max(max_id, vid_data[i]);
+  for (int64_t i = 0; i < n_recv; ++i)
+    max_id = std::max(max_id, recv_id_data[i]);
+  const int64_t n_nodes = static_cast<int64_t>(max_id) + 1;
 
-  // bkt: deg->dsts
-  std::unordered_map<IdType, std::vector<IdType>> bkt;
-  for (const auto& it : in_edges) {
-    bkt[it.second.size()].push_back(it.first);
+  // Every chunk of messages counts its messages per node, so that the
+  // messages can later be scattered in input order without synchronization.
+  // There are at most as many chunks as messages per node so that the counts
+  // take no more memory than the messages.
+  const int64_t num_msg_parts = std::max<int64_t>(
+      1, std::min<int64_t>(
+             runtime::compute_num_threads(0, n_msgs, 1),
+             n_msgs / std::max<int64_t>(n_nodes, 1)));
+  std::vector<IdType> msg_count(num_msg_parts * n_nodes, 0);
+  runtime::parallel_for(0, num_msg_parts, 1, [&](size_t b, size_t e) {
+    for (auto p = b; p < e; ++p) {
+      IdType* count = msg_count.data() + p * n_nodes;
+      const int64_t end = ChunkBegin(n_msgs, num_msg_parts, p + 1);
+      for (int64_t i = ChunkBegin(n_msgs, num_msg_parts, p); i < end; ++i)
+        ++count[vid_data[i]];
+    }
+  });
+
+  // in degree of every node
+  std::vector<IdType> in_deg(n_nodes, 0);
+  runtime::parallel_for(0, n_nodes, [&](size_t b, size_t e) {
+    for (auto v = b; v < e; ++v) {
+      for (int64_t p = 0; p < num_msg_parts; ++p)
+        in_deg[v] += msg_count[p * n_nodes + v];
+    }
+  });
+
+  // Zero degree receivers form one more bucket; the flag deduplicates them.
+  std::vector<uint8_t> zero_deg(n_nodes, 0);
+  runtime::parallel_for(0, n_recv, [&](size_t b, size_t e) {
+    for (auto i = b; i < e; ++i) {
+      const IdType v = recv_id_data[i];
+      if (in_deg[v] == 0) __atomic_store_n(&zero_deg[v], 1, __ATOMIC_RELAXED);
+    }
+  });
+
+  // bkt_of_deg: deg -> bucket index, buckets are in ascending degree order
+  IdType max_deg = 0;
+  for (int64_t v = 0; v < n_nodes; ++v) max_deg = std::max(max_deg, in_deg[v]);
+  std::vector<int64_t> bkt_of_deg(max_deg + 1, 0);
+  runtime::parallel_for(0, n_nodes, [&](size_t b, size_t e) {
+    for (auto v = b; v < e; ++v) {
+      if (in_deg[v] > 0)
+        __atomic_store_n(&bkt_of_deg[in_deg[v]], 1, __ATOMIC_RELAXED);
+    }
+  });
+  std::vector<IdType> bkt_deg;
+  for (IdType d = 1; d <= max_deg; ++d) {
+    if (bkt_of_deg[d]) {
+      bkt_of_deg[d] = bkt_deg.size();
+      bkt_deg.push_back(d);
+    }
   }
+  const int64_t n_bkt = bkt_deg.size();
+  // The zero degree bucket, if any, comes last.
+  const int64_t zero_bkt = n_bkt;
+  bkt_deg.push_back(0);
+
+  // Counting sort of the nodes by bucket. Every chunk of node IDs counts its
+  // nodes per bucket, so that nodes are laid out in ascending ID order within
+  // each bucket.
+  const int64_t num_parts = runtime::compute_num_threads(0, n_nodes, 1);
+  const int64_t width = n_bkt + 1;
+  std::vector<int64_t> part_count(num_parts * width, 0);
+  runtime::parallel_for(0, num_parts, 1, [&](size_t b, size_t e) {
+    for (auto p = b; p < e; ++p) {
+      int64_t* count = part_count.data() + p * width;
+      const int64_t end = ChunkBegin(n_nodes, num_parts, p + 1);
+      for (int64_t v = ChunkBegin(n_nodes, num_parts, p); v < end; ++v) {
+        if (in_deg[v] > 0)
+          ++count[bkt_of_deg[in_deg[v]]];
+        else if (zero_deg[v])
+          ++count[zero_bkt];
+      }
+    }
+  });
 
-  std::unordered_set<IdType> zero_deg_nodes;
-  for (IdType i = 0; i < recv_ids->shape[0]; ++i) {
-    if (in_edges.find(recv_id_data[i]) == in_edges.end()) {
-      zero_deg_nodes.insert(recv_id_data[i]);
+  // bucket sizes, degrees and offsets of every chunk in nids and mids
+  std::vector<int64_t> bkt_size(width, 0);
+  for (int64_t p = 0; p < num_parts; ++p) {
+    for (int64_t k = 0; k < width; ++k)
+      bkt_size[k] += part_count[p * width + k];
+  }
+  const int64_t n_zero_deg = bkt_size[zero_bkt];
+  std::vector<int64_t> node_offset(num_parts * width);
+  std::vector<int64_t> bkt_node_start(width), bkt_msg_start(width);
+  int64_t node_pos = 0, msg_pos = 0;
+  for (int64_t k = 0; k < width; ++k) {
+    bkt_node_start[k] = node_pos;
+    bkt_msg_start[k] = msg_pos;
+    msg_pos += bkt_size[k] * bkt_deg[k];
+    for (int64_t p = 0; p < num_parts; ++p) {
+      node_offset[p * width + k] = node_pos;
+      node_pos += part_count[p * width + k];
     }
   }
-  auto n_zero_deg = zero_deg_nodes.size();
+  CHECK_EQ(msg_pos, n_msgs);
 
   // calc output size
-  IdType n_deg = bkt.size();
-  IdType n_dst = in_edges.size();
-  IdType n_mid_sec = bkt.size();  // zero deg won't affect message size
-  if (n_zero_deg > 0) {
-    n_deg += 1;
-    n_dst += n_zero_deg;
-  }
+  const int64_t n_deg = n_bkt + (n_zero_deg > 0);
+  const int64_t n_dst = node_pos;
+  const int64_t n_mid_sec = n_bkt;  // zero deg won't affect message size
 
   // initialize output
   IdArray degs = IdArray::Empty({n_deg}, vids->dtype, vids->ctx);
@@ -61,28 +154,53 @@ std::vector<IdArray> DegreeBucketing(
   IdType* mid_ptr = static_cast<IdType*>(mids->data);
   IdType* msec_ptr = static_cast<IdType*>(mid_section->data);
 
-  // fill in bucketing ordering
-  for (const auto& it : bkt) {  // for each bucket
-    const IdType deg = it.first;
-    const IdType bucket_size = it.second.size();
-    *deg_ptr++ = deg;
-    *nsec_ptr++ = bucket_size;
-    *msec_ptr++ = deg * bucket_size;
-    for (const auto dst : it.second) {  // for each dst in this bucket
-      *nid_ptr++ = dst;
-      for (const auto mid : in_edges[dst]) {  // for each in edge of dst
-        *mid_ptr++ = mid;
+  for (int64_t k = 0; k < n_deg; ++k) {
+    deg_ptr[k] = bkt_deg[k];
+    nsec_ptr[k] = bkt_size[k];
+    if (k < n_mid_sec) msec_ptr[k] = bkt_size[k] * bkt_deg[k];
+  }
+
+  // Place every node in nids. msg_start then holds where the messages of a
+  // node begin in mids.
+  std::vector<IdType> msg_start(n_nodes);
+  runtime::parallel_for(0, num_parts, 1, [&](size_t b, size_t e) {
+    for (auto p = b; p < e; ++p) {
+      int64_t* offset = node_offset.data() + p * width;
+      const int64_t end = ChunkBegin(n_nodes, num_parts, p + 1);
+      for (int64_t v = ChunkBegin(n_nodes, num_parts, p); v < end; ++v) {
+        if (in_deg[v] > 0) {
+          const int64_t k = bkt_of_deg[in_deg[v]];
+          const int64_t pos = offset[k]++;
+          nid_ptr[pos] = v;
+          msg_start[v] =
+              bkt_msg_start[k] + (pos - bkt_node_start[k]) * in_deg[v];
+        } else if (zero_deg[v]) {
+          nid_ptr[offset[zero_bkt]++] = v;
+        }
       }
     }
-  }
+  });
 
-  if (n_zero_deg > 0) {
-    *deg_ptr = 0;
-    *nsec_ptr = n_zero_deg;
-    for (const auto dst : zero_deg_nodes) {
-      *nid_ptr++ = dst;
+  // Turn the counts into the position of the first message of every chunk
+  // for every node, then write the messages of every chunk in input order.
+  runtime::parallel_for(0, n_nodes, [&](size_t b, size_t e) {
+    for (auto v = b; v < e; ++v) {
+      IdType pos = msg_start[v];
+      for (int64_t p = 0; p < num_msg_parts; ++p) {
+        const IdType count = msg_count[p * n_nodes + v];
+        msg_count[p * n_nodes + v] = pos;
+        pos += count;
+      }
     }
-  }
+  });
+  runtime::parallel_for(0, num_msg_parts, 1, [&](size_t b, size_t e) {
+    for (auto p = b; p < e; ++p) {
+      IdType* cursor = msg_count.data() + p * n_nodes;
+      const int64_t end = ChunkBegin(n_msgs, num_msg_parts, p + 1);
+      for (int64_t i = ChunkBegin(n_msgs, num_msg_parts, p); i < end; ++i)
+        mid_ptr[cursor[vid_data[i]]++] = msg_id_data[i];
+    }
+  });
 
   std::vector<IdArray> ret;
   ret.push_back(std::move(degs));
@@ -5,6 +5,9 @@
  */
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+#include <iostream>
 #include <string>
 #include <thread>
 #include <vector>
@@ -103,3 +106,91 @@ TEST(MessageQueueTest, MultiThread) {
   }
   EXPECT_EQ(queue.EmptyAndNoMoreAdd(), true);
 }
+
+TEST(MessageQueueTest, MultiProducerMultiConsumer) {
+  // A small queue so that both producers and consumers have to wait.
+  const int num_producers = 16;
+  const int num_consumers = 4;
+  const int num_messages = 10000;
+  MessageQueue queue(64, num_producers);
+  std::vector<std::string> payloads(num_producers);
+  for (int i = 0; i < num_producers; ++i) {
+    payloads[i] = std::string(1 + i % 4, 'a' + i);
+  }
+  std::atomic<int64_t> num_removed{0};
+  std::vector<std::vector<int>> counts(
+      num_consumers, std::vector<int>(num_producers, 0));
+
+  std::vector<std::thread> producers, consumers;
+  for (int c = 0; c < num_consumers; ++c) {
+    consumers.emplace_back([&, c]() {
+      Message msg;
+      while (queue.Remove(&msg) == REMOVE_SUCCESS) {
+        // Messages of a producer are all its payload.
+        const int i = msg.data[0] - 'a';
+        EXPECT_EQ(string(msg.data, msg.size), payloads[i]);
+        counts[c][i]++;
+        num_removed++;
+      }
+    });
+  }
+  for (int i = 0; i < num_producers; ++i) {
+    producers.emplace_back([&, i]() {
+      for (int n = 0; n < num_messages; ++n) {
+        Message msg = {
+            const_cast<char*>(payloads[i].data()),
+            static_cast<int64_t>(payloads[i].size())};
+        EXPECT_EQ(queue.Add(msg), ADD_SUCCESS);
+      }
+      queue.SignalFinished(i);
+    });
+  }
+  for (auto& t : producers) t.join();
+  for (auto& t : consumers) t.join();
+
+  EXPECT_EQ(num_removed.load(), num_producers * num_messages);
+  for (int i = 0; i < num_producers; ++i) {
+    int total = 0;
+    for (int c = 0; c < num_consumers; ++c) total += counts[c][i];
+    EXPECT_EQ(total, num_messages);
+  }
+  EXPECT_EQ(queue.EmptyAndNoMoreAdd(), true);
+}
+
+TEST(MessageQueueTest, Throughput) {
+  // Many producers and consumers on a queue that rarely fills up, so that the
+  // time goes to contention on the queue. Only reports the throughput.
+  const int num_producers = 16;
+  const int num_messages = 20000;
+  std::string payload("apple");
+  for (const int num_consumers : {1, 4, 16}) {
+    MessageQueue queue(1 << 20, num_producers);
+    std::atomic<int64_t> num_removed{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int c = 0; c < num_consumers; ++c) {
+      threads.emplace_back([&]() {
+        Message msg;
+        while (queue.Remove(&msg) == REMOVE_SUCCESS) num_removed++;
+      });
+    }
+    for (int i = 0; i < num_producers; ++i) {
+      threads.emplace_back([&, i]() {
+        for (int n = 0; n < num_messages; ++n) {
+          Message msg = {const_cast<char*>(payload.data()), 5};
+          queue.Add(msg);
+        }
+        queue.SignalFinished(i);
+      });
+    }
+    for (auto& t : threads) t.join();
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+            .count();
+
+    EXPECT_EQ(num_removed.load(), num_producers * num_messages);
+    std::cout << num_producers << " producers, " << num_consumers
+              << " consumers: " << num_removed.load() / seconds
+              << " messages/s" << std::endl;
+  }
+}
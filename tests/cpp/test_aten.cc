@@ -1379,6 +1379,31 @@ void _TestLineGraphCOO(DGLContext ctx) {
   ASSERT_TRUE(ArrayEQ<IdType>(ld_coo2.col, c_col));
   ASSERT_FALSE(ld_coo2.row_sorted);
   ASSERT_FALSE(ld_coo2.col_sorted);
+
+  // the same edges as A, shuffled
+  IdArray s_row = aten::VecToIdArray(
+      std::vector<IdType>({2, 0, 1, 3, 1, 2}), sizeof(IdType) * 8, ctx);
+  IdArray s_col = aten::VecToIdArray(
+      std::vector<IdType>({0, 2, 2, 3, 0, 1}), sizeof(IdType) * 8, ctx);
+  b_row = aten::VecToIdArray(
+      std::vector<IdType>({1, 2, 4, 5}), sizeof(IdType) * 8, ctx);
+  b_col = aten::VecToIdArray(
+      std::vector<IdType>({5, 0, 1, 4}), sizeof(IdType) * 8, ctx);
+  c_row = aten::VecToIdArray(
+      std::vector<IdType>({0, 1, 1, 2, 2, 4, 5, 5}), sizeof(IdType) * 8, ctx);
+  c_col = aten::VecToIdArray(
+      std::vector<IdType>({1, 0, 5, 0, 5, 1, 2, 4}), sizeof(IdType) * 8, ctx);
+  const aten::COOMatrix &coo_s =
+      aten::COOMatrix(4, 4, s_row, s_col, aten::NullArray(), false, false);
+  const aten::COOMatrix &ls_coo = COOLineGraph(coo_s, false);
+  ASSERT_EQ(ls_coo.num_rows, 6);
+  ASSERT_EQ(ls_coo.num_cols, 6);
+  ASSERT_TRUE(ArrayEQ<IdType>(ls_coo.row, b_row));
+  ASSERT_TRUE(ArrayEQ<IdType>(ls_coo.col, b_col));
+
+  const aten::COOMatrix &ls_coo2 = COOLineGraph(coo_s, true);
+  ASSERT_TRUE(ArrayEQ<IdType>(ls_coo2.row, c_row));
+  ASSERT_TRUE(ArrayEQ<IdType>(ls_coo2.col, c_col));
 }
 
 TEST(LineGraphTest, LineGraphCOO) {
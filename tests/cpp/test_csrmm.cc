@@ -148,6 +148,10 @@ void _TestCsrmm(DGLContext ctx = CTX) {
   bool result = CSRIsClose<IdType, DType>(
       A_mm_B.first, A_mm_B2.first, A_mm_B.second, A_mm_B2.second, 1e-4, 1e-4);
   ASSERT_TRUE(result);
+  if (ctx.device_type == kDGLCPU) {
+    ASSERT_TRUE(A_mm_B.first.sorted);
+    ASSERT_TRUE(aten::CSRIsSorted(A_mm_B.first));
+  }
 }
 
 template <typename IdType, typename DType>
@@ -160,6 +164,10 @@ void _TestCsrsum(DGLContext ctx = CTX) {
       A_plus_C.first, A_plus_C2.first, A_plus_C.second, A_plus_C2.second, 1e-4,
       1e-4);
   ASSERT_TRUE(result);
+  if (ctx.device_type == kDGLCPU) {
+    ASSERT_TRUE(A_plus_C.first.sorted);
+    ASSERT_TRUE(aten::CSRIsSorted(A_plus_C.first));
+  }
 }
 
 template <typename IdType, typename DType>
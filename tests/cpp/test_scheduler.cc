@@ -0,0 +1,91 @@
+#include <dgl/array.h>
+#include <dgl/scheduler.h>
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <vector>
+
+#include "./common.h"
+
+using namespace dgl;
+
+namespace {
+
+template <typename IdType>
+void _TestDegreeBucketing() {
+  // messages: (msg id, dst)
+  //   (10, 3) (11, 1) (12, 3) (13, 4) (14, 1) (15, 3) (16, 0)
+  // recv nodes: 0 1 2 3 4 5 5
+  IdArray msg_ids = aten::VecToIdArray(
+      std::vector<IdType>({10, 11, 12, 13, 14, 15, 16}), sizeof(IdType) * 8);
+  IdArray vids = aten::VecToIdArray(
+      std::vector<IdType>({3, 1, 3, 4, 1, 3, 0}), sizeof(IdType) * 8);
+  IdArray recv_ids = aten::VecToIdArray(
+      std::vector<IdType>({0, 1, 2, 3, 4, 5, 5}), sizeof(IdType) * 8);
+  auto ret = sched::DegreeBucketing<IdType>(msg_ids, vids, recv_ids);
+  ASSERT_EQ(ret.size(), 5);
+
+  // Buckets are in ascending degree order, followed by zero degree nodes.
+  // Nodes are in ascending ID order within a bucket and messages keep their
+  // input order within a node.
+  auto vec = [](std::vector<IdType> v) {
+    return aten::VecToIdArray(v, sizeof(IdType) * 8);
+  };
+  ASSERT_TRUE(ArrayEQ<IdType>(ret[0], vec({1, 2, 3, 0})));
+  ASSERT_TRUE(ArrayEQ<IdType>(ret[1], vec({0, 4, 1, 3, 2, 5})));
+  ASSERT_TRUE(ArrayEQ<IdType>(ret[2], vec({2, 1, 1, 2})));
+  ASSERT_TRUE(ArrayEQ<IdType>(ret[3], vec({16, 13, 11, 14, 10, 12, 15})));
+  ASSERT_TRUE(ArrayEQ<IdType>(ret[4], vec({2, 2, 3})));
+}
+
+template <typename IdType>
+void _TestDegreeBucketingRandom() {
+  const int64_t num_nodes = 5000;
+  const int64_t num_msgs = 100000;
+  std::mt19937 gen(42);
+  // skewed destinations
+  std::geometric_distribution<int64_t> dist(0.002);
+  std::vector<IdType> msg_vec(num_msgs), vid_vec(num_msgs), recv_vec;
+  std::map<IdType, std::vector<IdType>> in_edges;
+  for (int64_t i = 0; i < num_msgs; ++i) {
+    msg_vec[i] = num_msgs - i;
+    vid_vec[i] = std::min(dist(gen), num_nodes - 1);
+    in_edges[vid_vec[i]].push_back(msg_vec[i]);
+  }
+  for (int64_t v = 0; v < num_nodes; ++v) recv_vec.push_back(v);
+  auto ret = sched::DegreeBucketing<IdType>(
+      aten::VecToIdArray(msg_vec, sizeof(IdType) * 8),
+      aten::VecToIdArray(vid_vec, sizeof(IdType) * 8),
+      aten::VecToIdArray(recv_vec, sizeof(IdType) * 8));
+
+  const IdType* degs = Ptr<IdType>(ret[0]);
+  const IdType* nids = Ptr<IdType>(ret[1]);
+  const IdType* nid_section = Ptr<IdType>(ret[2]);
+  const IdType* mids = Ptr<IdType>(ret[3]);
+  const IdType* mid_section = Ptr<IdType>(ret[4]);
+  ASSERT_EQ(Len(ret[1]), num_nodes);
+  ASSERT_EQ(Len(ret[3]), num_msgs);
+  int64_t n = 0, m = 0;
+  for (int64_t k = 0; k < Len(ret[0]); ++k) {
+    if (k > 0 && degs[k] != 0) ASSERT_LT(degs[k - 1], degs[k]);
+    if (degs[k] != 0) ASSERT_EQ(mid_section[k], degs[k] * nid_section[k]);
+    for (int64_t j = 0; j < nid_section[k]; ++j, ++n) {
+      if (j > 0) ASSERT_LT(nids[n - 1], nids[n]);
+      const auto& msgs = in_edges[nids[n]];
+      ASSERT_EQ(static_cast<IdType>(msgs.size()), degs[k]);
+      for (IdType mid : msgs) ASSERT_EQ(mids[m++], mid);
+    }
+  }
+  ASSERT_EQ(n, num_nodes);
+  ASSERT_EQ(m, num_msgs);
+}
+
+}  // namespace
+
+TEST(SchedulerTest, TestDegreeBucketing) {
+  _TestDegreeBucketing<int32_t>();
+  _TestDegreeBucketing<int64_t>();
+  _TestDegreeBucketingRandom<int32_t>();
+  _TestDegreeBucketingRandom<int64_t>();
+}
@@ -3,7 +3,12 @@
 #include <gtest/gtest.h>
 #include <omp.h>
 
+#include <algorithm>
+#include <map>
+#include <numeric>
 #include <random>
+#include <utility>
+#include <vector>
 
 #include "./common.h"
 
@@ -574,3 +579,74 @@ TEST(SpmatTest, COOToCSRAlgs) {
   _TestCOOToCSRAlgs<int32_t>();
   _TestCOOToCSRAlgs<int64_t>();
 }
+
+template <typename IDX>
+void _CheckCOOCoalesce(
+    const std::vector<IDX> &rows, const std::vector<IDX> &cols, IDX n,
+    bool sorted) {
+  std::map<std::pair<IDX, IDX>, IDX> counts;
+  for (size_t i = 0; i < rows.size(); ++i) ++counts[{rows[i], cols[i]}];
+  std::vector<IDX> coalesced_rows, coalesced_cols, coalesced_counts;
+  for (const auto &entry : counts) {
+    coalesced_rows.push_back(entry.first.first);
+    coalesced_cols.push_back(entry.first.second);
+    coalesced_counts.push_back(entry.second);
+  }
+
+  auto coo = aten::COOMatrix(
+      n, n, aten::VecToIdArray(rows, sizeof(IDX) * 8, CTX),
+      aten::VecToIdArray(cols, sizeof(IDX) * 8, CTX), aten::NullArray(),
+      sorted, sorted);
+  auto result = aten::COOCoalesce(coo);
+  ASSERT_EQ(result.first.num_rows, n);
+  ASSERT_EQ(result.first.num_cols, n);
+  ASSERT_TRUE(ArrayEQ<IDX>(
+      result.first.row,
+      aten::VecToIdArray(coalesced_rows, sizeof(IDX) * 8, CTX)));
+  ASSERT_TRUE(ArrayEQ<IDX>(
+      result.first.col,
+      aten::VecToIdArray(coalesced_cols, sizeof(IDX) * 8, CTX)));
+  ASSERT_TRUE(ArrayEQ<IDX>(
+      result.second,
+      aten::VecToIdArray(coalesced_counts, sizeof(IDX) * 8, CTX)));
+}
+
+template <typename IDX>
+void _TestCOOCoalesce() {
+  // Unsorted, with the duplicates apart from each other.
+  _CheckCOOCoalesce<IDX>(
+      {2, 0, 1, 2, 0, 3, 1, 0, 2}, {1, 3, 0, 1, 3, 2, 0, 1, 0}, 4, false);
+
+  // Sorted, with more entries than a block of the parallel compaction and
+  // runs of duplicates straddling the block boundaries, one of them longer
+  // than a block.
+  const int64_t block_size = 1 << 16;
+  std::vector<IDX> rows, cols;
+  auto add_run = [&](IDX row, IDX col, int64_t length) {
+    rows.insert(rows.end(), length, row);
+    cols.insert(cols.end(), length, col);
+  };
+  const IDX last_row = block_size / 100 + 1;
+  for (IDX i = 0; i < block_size - 10; ++i) add_run(i / 100, i % 100, 1);
+  add_run(last_row, 5, 20);
+  add_run(last_row, 6, 1);
+  add_run(last_row, 7, 2 * block_size);
+  add_run(last_row, 8, 3);
+  _CheckCOOCoalesce<IDX>(rows, cols, last_row + 1, true);
+
+  // The same entries shuffled.
+  std::vector<int64_t> perm(rows.size());
+  std::iota(perm.begin(), perm.end(), 0);
+  std::shuffle(perm.begin(), perm.end(), std::mt19937(42));
+  std::vector<IDX> shuffled_rows, shuffled_cols;
+  for (const int64_t i : perm) {
+    shuffled_rows.push_back(rows[i]);
+    shuffled_cols.push_back(cols[i]);
+  }
+  _CheckCOOCoalesce<IDX>(shuffled_rows, shuffled_cols, last_row + 1, false);
+}
+
+TEST(SpmatTest, COOCoalesce) {
+  _TestCOOCoalesce<int32_t>();
+  _TestCOOCoalesce<int64_t>();
+}
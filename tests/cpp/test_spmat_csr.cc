@@ -1,6 +1,13 @@
 #include <dgl/array.h>
+#include <dmlc/omp.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
 #include "./common.h"
 
 using namespace dgl;
@@ -397,6 +404,63 @@ TEST(SpmatTest, CSRTranspose) {
 #endif
 }
 
+template <typename IDX>
+void _TestCSRTransposeLarge(bool with_data) {
+  // Enough entries for the columns to be counted and scattered by several
+  // threads, which has to give the same result as one thread.
+  const int64_t num_rows = 1000, num_cols = 500, nnz = 200000;
+  std::mt19937 gen(42);
+  std::vector<IDX> indptr(num_rows + 1, 0), indices(nnz), data(nnz);
+  for (int64_t i = 0; i < nnz; ++i) indptr[gen() % num_rows + 1]++;
+  std::partial_sum(indptr.begin(), indptr.end(), indptr.begin());
+  for (int64_t i = 0; i < nnz; ++i) indices[i] = gen() % num_cols;
+  std::iota(data.begin(), data.end(), 0);
+  std::shuffle(data.begin(), data.end(), gen);
+  auto csr = aten::CSRMatrix(
+      num_rows, num_cols, aten::VecToIdArray(indptr, sizeof(IDX) * 8, CPU),
+      aten::VecToIdArray(indices, sizeof(IDX) * 8, CPU),
+      with_data ? aten::VecToIdArray(data, sizeof(IDX) * 8, CPU)
+                : aten::NullArray());
+
+  // The entries of every column in row order.
+  std::vector<IDX> tp(num_cols + 1, 0), ti, td;
+  std::vector<std::vector<std::pair<IDX, IDX>>> columns(num_cols);
+  for (int64_t i = 0; i < num_rows; ++i) {
+    for (IDX j = indptr[i]; j < indptr[i + 1]; ++j) {
+      columns[indices[j]].emplace_back(i, with_data ? data[j] : j);
+    }
+  }
+  for (int64_t c = 0; c < num_cols; ++c) {
+    tp[c + 1] = tp[c] + columns[c].size();
+    for (const auto &entry : columns[c]) {
+      ti.push_back(entry.first);
+      td.push_back(entry.second);
+    }
+  }
+
+  const int max_threads = omp_get_max_threads();
+  for (const int num_threads : {1, 4}) {
+    omp_set_num_threads(num_threads);
+    auto csr_t = aten::CSRTranspose(csr);
+    ASSERT_EQ(csr_t.num_rows, num_cols);
+    ASSERT_EQ(csr_t.num_cols, num_rows);
+    ASSERT_TRUE(ArrayEQ<IDX>(
+        csr_t.indptr, aten::VecToIdArray(tp, sizeof(IDX) * 8, CPU)));
+    ASSERT_TRUE(ArrayEQ<IDX>(
+        csr_t.indices, aten::VecToIdArray(ti, sizeof(IDX) * 8, CPU)));
+    ASSERT_TRUE(ArrayEQ<IDX>(
+        csr_t.data, aten::VecToIdArray(td, sizeof(IDX) * 8, CPU)));
+  }
+  omp_set_num_threads(max_threads);
+}
+
+TEST(SpmatTest, CSRTransposeLarge) {
+  _TestCSRTransposeLarge<int32_t>(false);
+  _TestCSRTransposeLarge<int32_t>(true);
+  _TestCSRTransposeLarge<int64_t>(false);
+  _TestCSRTransposeLarge<int64_t>(true);
+}
+
 template <typename IDX>
 void _TestCSRToCOO(DGLContext ctx) {
   auto csr = CSR2<IDX>(ctx);
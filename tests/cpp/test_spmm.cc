@@ -241,4 +241,272 @@ TEST(SpmmTest, TestSpmmDiv) {
   _TestSpmmDiv<double>();
   _TestSpmmDiv<BFloat16>();
 }
+
+template <typename IdType, typename DType>
+void _TestSpmmCoo() {
+  // Enough edges for the destination-partitioned parallel path.
+  const int64_t num_src = 1000, num_dst = 300, nnz = 100000, dim = 5;
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int64_t> src_dist(0, num_src - 1);
+  std::uniform_int_distribution<int64_t> dst_dist(0, num_dst - 1);
+  std::uniform_int_distribution<int> val_dist(-100, 100);
+  IdArray row = aten::NewIdArray(nnz, CPU, sizeof(IdType) * 8);
+  IdArray col = aten::NewIdArray(nnz, CPU, sizeof(IdType) * 8);
+  for (int64_t i = 0; i < nnz; ++i) {
+    row.Ptr<IdType>()[i] = src_dist(rng);
+    // skewed destinations
+    col.Ptr<IdType>()[i] = std::min(dst_dist(rng), dst_dist(rng));
+  }
+  aten::COOMatrix coo(num_src, num_dst, row, col);
+  const DGLDataType dtype = DGLDataTypeTraits<DType>::dtype;
+  NDArray ufeat = NDArray::Empty({num_src, dim}, dtype, CPU);
+  NDArray efeat = NDArray::Empty({nnz, dim}, dtype, CPU);
+  for (int64_t i = 0; i < num_src * dim; ++i)
+    ufeat.Ptr<DType>()[i] = val_dist(rng);
+  for (int64_t i = 0; i < nnz * dim; ++i) efeat.Ptr<DType>()[i] = val_dist(rng);
+  BcastOff bcast;
+  bcast.use_bcast = false;
+  bcast.lhs_len = bcast.rhs_len = bcast.out_len = dim;
+  bcast.reduce_size = 1;
+
+  // Expected results, reducing the edges in order.
+  std::vector<DType> sum(num_dst * dim, 0), max(num_dst * dim);
+  std::vector<IdType> argu(num_dst * dim, 0), arge(num_dst * dim, 0);
+  std::fill(max.begin(), max.end(), ns_op::Max<DType>::zero);
+  for (int64_t i = 0; i < nnz; ++i) {
+    const IdType u = row.Ptr<IdType>()[i], v = col.Ptr<IdType>()[i];
+    for (int64_t k = 0; k < dim; ++k) {
+      const DType val = ufeat.Ptr<DType>()[u * dim + k] *
+                        efeat.Ptr<DType>()[i * dim + k];
+      sum[v * dim + k] += val;
+      if (val > max[v * dim + k]) {
+        max[v * dim + k] = val;
+        argu[v * dim + k] = u;
+        arge[v * dim + k] = i;
+      }
+    }
+  }
+
+  NDArray out = NDArray::Empty({num_dst, dim}, dtype, CPU);
+  aten::cpu::SpMMSumCoo<IdType, DType, ns_op::Mul<DType>>(
+      bcast, coo, ufeat, efeat, out);
+  for (int64_t i = 0; i < num_dst * dim; ++i)
+    ASSERT_EQ(out.Ptr<DType>()[i], sum[i]);
+
+  NDArray out_argu =
+      NDArray::Empty({num_dst, dim}, DGLDataTypeTraits<IdType>::dtype, CPU);
+  NDArray out_arge =
+      NDArray::Empty({num_dst, dim}, DGLDataTypeTraits<IdType>::dtype, CPU);
+  // Arg-Max is not written for zero-degree nodes.
+  std::fill_n(out_argu.Ptr<IdType>(), num_dst * dim, 0);
+  std::fill_n(out_arge.Ptr<IdType>(), num_dst * dim, 0);
+  aten::cpu::SpMMCmpCoo<IdType, DType, ns_op::Mul<DType>, ns_op::Max<DType>>(
+      bcast, coo, ufeat, efeat, out, out_argu, out_arge);
+  for (int64_t i = 0; i < num_dst * dim; ++i) {
+    ASSERT_EQ(out.Ptr<DType>()[i], max[i]);
+    ASSERT_EQ(out_argu.Ptr<IdType>()[i], argu[i]);
+    ASSERT_EQ(out_arge.Ptr<IdType>()[i], arge[i]);
+  }
+}
+
+TEST(SpmmTest, TestSpmmCoo) {
+  _TestSpmmCoo<int32_t, float>();
+  _TestSpmmCoo<int64_t, float>();
+  _TestSpmmCoo<int32_t, double>();
+  _TestSpmmCoo<int64_t, double>();
+}
+
+template <typename IdType, typename DType>
+void _TestSpmmCsrBcast() {
+  // Multi-head features (H, D) scaled by per-head edge weights (H, 1).
+  const int64_t num_src = 50, num_dst = 40, nnz = 600, H = 4, D = 9;
+  const int64_t dim = H * D;
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int64_t> src_dist(0, num_src - 1);
+  std::uniform_int_distribution<int64_t> dst_dist(0, num_dst - 1);
+  std::uniform_int_distribution<int> val_dist(-100, 100);
+  std::vector<IdType> dst(nnz);
+  for (auto& v : dst) v = dst_dist(rng);
+  std::sort(dst.begin(), dst.end());
+  IdArray indptr = aten::NewIdArray(num_dst + 1, CPU, sizeof(IdType) * 8);
+  IdArray indices = aten::NewIdArray(nnz, CPU, sizeof(IdType) * 8);
+  std::fill_n(indptr.Ptr<IdType>(), num_dst + 1, 0);
+  for (int64_t i = 0; i < nnz; ++i) {
+    indptr.Ptr<IdType>()[dst[i] + 1]++;
+    indices.Ptr<IdType>()[i] = src_dist(rng);
+  }
+  for (int64_t v = 0; v < num_dst; ++v)
+    indptr.Ptr<IdType>()[v + 1] += indptr.Ptr<IdType>()[v];
+  aten::CSRMatrix csr(num_dst, num_src, indptr, indices);
+  const DGLDataType dtype = DGLDataTypeTraits<DType>::dtype;
+  NDArray ufeat = NDArray::Empty({num_src, H, D}, dtype, CPU);
+  NDArray efeat = NDArray::Empty({nnz, H, 1}, dtype, CPU);
+  for (int64_t i = 0; i < num_src * dim; ++i)
+    ufeat.Ptr<DType>()[i] = val_dist(rng);
+  for (int64_t i = 0; i < nnz * H; ++i) efeat.Ptr<DType>()[i] = val_dist(rng);
+  BcastOff bcast;
+  bcast.use_bcast = true;
+  bcast.lhs_len = dim;
+  bcast.rhs_len = H;
+  bcast.out_len = dim;
+  bcast.reduce_size = 1;
+  for (int64_t k = 0; k < dim; ++k) {
+    bcast.lhs_offset.push_back(k);
+    bcast.rhs_offset.push_back(k / D);
+  }
+
+  std::vector<DType> sum(num_dst * dim, 0), max(num_dst * dim);
+  std::vector<IdType> argu(num_dst * dim, 0), arge(num_dst * dim, 0);
+  std::fill(max.begin(), max.end(), ns_op::Max<DType>::zero);
+  for (int64_t i = 0; i < nnz; ++i) {
+    const IdType u = indices.Ptr<IdType>()[i], v = dst[i];
+    for (int64_t k = 0; k < dim; ++k) {
+      const DType val = ufeat.Ptr<DType>()[u * dim + k] *
+                        efeat.Ptr<DType>()[i * H + k / D];
+      sum[v * dim + k] += val;
+      if (val > max[v * dim + k]) {
+        max[v * dim + k] = val;
+        argu[v * dim + k] = u;
+        arge[v * dim + k] = i;
+      }
+    }
+  }
+
+  NDArray out = NDArray::Empty({num_dst, dim}, dtype, CPU);
+  std::fill_n(out.Ptr<DType>(), num_dst * dim, 0);
+  aten::cpu::SpMMSumCsr<IdType, DType, ns_op::Mul<DType>>(
+      bcast, csr, ufeat, efeat, out);
+  for (int64_t i = 0; i < num_dst * dim; ++i)
+    ASSERT_EQ(out.Ptr<DType>()[i], sum[i]);
+
+  NDArray out_argu =
+      NDArray::Empty({num_dst, dim}, DGLDataTypeTraits<IdType>::dtype, CPU);
+  NDArray out_arge =
+      NDArray::Empty({num_dst, dim}, DGLDataTypeTraits<IdType>::dtype, CPU);
+  std::fill_n(out.Ptr<DType>(), num_dst * dim, ns_op::Max<DType>::zero);
+  std::fill_n(out_argu.Ptr<IdType>(), num_dst * dim, 0);
+  std::fill_n(out_arge.Ptr<IdType>(), num_dst * dim, 0);
+  aten::cpu::SpMMCmpCsr<IdType, DType, ns_op::Mul<DType>, ns_op::Max<DType>>(
+      bcast, csr, ufeat, efeat, out, out_argu, out_arge);
+  for (int64_t i = 0; i < num_dst * dim; ++i) {
+    ASSERT_EQ(out.Ptr<DType>()[i], max[i]);
+    ASSERT_EQ(out_argu.Ptr<IdType>()[i], argu[i]);
+    ASSERT_EQ(out_arge.Ptr<IdType>()[i], arge[i]);
+  }
+}
+
+TEST(SpmmTest, TestSpmmCsrBcast) {
+  _TestSpmmCsrBcast<int32_t, float>();
+  _TestSpmmCsrBcast<int64_t, float>();
+  _TestSpmmCsrBcast<int32_t, double>();
+  _TestSpmmCsrBcast<int64_t, double>();
+}
+
+template <typename IdType, typename DType>
+void _TestEdgeSoftmaxSpmm() {
+  // Multi-head features (H, D) aggregated with per-head attention (H, 1).
+  const int64_t num_nodes = 30, nnz = 200, H = 3, D = 5, dim = H * D;
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int64_t> node_dist(0, num_nodes - 1);
+  std::uniform_real_distribution<double> val_dist(-2, 2);
+  std::vector<IdType> src(nnz), dst(nnz);
+  for (int64_t i = 0; i < nnz; ++i) {
+    src[i] = node_dist(rng);
+    dst[i] = node_dist(rng);
+  }
+  const DGLDataType idtype = DGLDataTypeTraits<IdType>::dtype;
+  aten::COOMatrix coo(
+      num_nodes, num_nodes, aten::VecToIdArray(src, idtype.bits),
+      aten::VecToIdArray(dst, idtype.bits));
+  const aten::CSRMatrix csr = aten::COOToCSR(coo);
+  const aten::CSRMatrix csc = aten::COOToCSR(aten::COOTranspose(coo));
+  const DGLDataType dtype = DGLDataTypeTraits<DType>::dtype;
+  NDArray ufeat = NDArray::Empty({num_nodes, H, D}, dtype, CPU);
+  NDArray efeat = NDArray::Empty({nnz, H, 1}, dtype, CPU);
+  NDArray grad_out = NDArray::Empty({num_nodes, H, D}, dtype, CPU);
+  for (int64_t i = 0; i < num_nodes * dim; ++i) {
+    ufeat.Ptr<DType>()[i] = val_dist(rng);
+    grad_out.Ptr<DType>()[i] = val_dist(rng);
+  }
+  for (int64_t i = 0; i < nnz * H; ++i) efeat.Ptr<DType>()[i] = val_dist(rng);
+  BcastOff bcast;
+  bcast.use_bcast = true;
+  bcast.lhs_len = dim;
+  bcast.rhs_len = H;
+  bcast.out_len = dim;
+  bcast.reduce_size = 1;
+  for (int64_t k = 0; k < dim; ++k) {
+    bcast.lhs_offset.push_back(k);
+    bcast.rhs_offset.push_back(k / D);
+  }
+
+  // Unfused reference of sum(out * grad_out).
+  auto loss = [&](const DType* U, const DType* W, std::vector<double>* out) {
+    std::vector<double> max(num_nodes * H, -1e30), sum(num_nodes * H, 0);
+    for (int64_t i = 0; i < nnz; ++i)
+      for (int64_t h = 0; h < H; ++h)
+        max[dst[i] * H + h] =
+            std::max<double>(max[dst[i] * H + h], W[i * H + h]);
+    for (int64_t i = 0; i < nnz; ++i)
+      for (int64_t h = 0; h < H; ++h)
+        sum[dst[i] * H + h] += std::exp(W[i * H + h] - max[dst[i] * H + h]);
+    out->assign(num_nodes * dim, 0);
+    for (int64_t i = 0; i < nnz; ++i) {
+      for (int64_t k = 0; k < dim; ++k) {
+        const int64_t h = dst[i] * H + k / D;
+        (*out)[dst[i] * dim + k] += std::exp(W[i * H + k / D] - max[h]) /
+                                     sum[h] * U[src[i] * dim + k];
+      }
+    }
+    double ret = 0;
+    for (int64_t i = 0; i < num_nodes * dim; ++i)
+      ret += (*out)[i] * grad_out.Ptr<DType>()[i];
+    return ret;
+  };
+  const double tol = std::is_same<DType, float>::value ? 1e-4 : 1e-9;
+
+  NDArray out = NDArray::Empty({num_nodes, H, D}, dtype, CPU);
+  NDArray emax = NDArray::Empty({num_nodes, H, 1}, dtype, CPU);
+  NDArray esum = NDArray::Empty({num_nodes, H, 1}, dtype, CPU);
+  aten::cpu::Edge_softmax_spmm_csr_forward<IdType, DType>(
+      bcast, csc, ufeat, efeat, out, emax, esum);
+  std::vector<double> expected;
+  loss(ufeat.Ptr<DType>(), efeat.Ptr<DType>(), &expected);
+  for (int64_t i = 0; i < num_nodes * dim; ++i)
+    ASSERT_LT(std::abs(out.Ptr<DType>()[i] - expected[i]), tol);
+
+  NDArray grad_ufeat = NDArray::Empty({num_nodes, H, D}, dtype, CPU);
+  NDArray grad_efeat = NDArray::Empty({nnz, H, 1}, dtype, CPU);
+  std::fill_n(grad_ufeat.Ptr<DType>(), num_nodes * dim, 0);
+  aten::cpu::Edge_softmax_spmm_csr_backward<IdType, DType>(
+      bcast, csc, csr, ufeat, efeat, out, emax, esum, grad_out, grad_ufeat,
+      grad_efeat);
+  if (!std::is_same<DType, double>::value) return;
+  // Central differences of the reference.
+  const double eps = 1e-6;
+  std::vector<double> unused;
+  const std::vector<std::pair<NDArray, NDArray>> checks = {
+      {ufeat, grad_ufeat}, {efeat, grad_efeat}};
+  for (const auto& check : checks) {
+    DType* data = static_cast<DType*>(check.first->data);
+    const DType* grad = static_cast<DType*>(check.second->data);
+    for (int64_t i = 0; i < check.first.NumElements(); ++i) {
+      const DType saved = data[i];
+      data[i] = saved + eps;
+      const double plus = loss(ufeat.Ptr<DType>(), efeat.Ptr<DType>(), &unused);
+      data[i] = saved - eps;
+      const double minus =
+          loss(ufeat.Ptr<DType>(), efeat.Ptr<DType>(), &unused);
+      data[i] = saved;
+      ASSERT_LT(std::abs(grad[i] - (plus - minus) / (2 * eps)), 1e-6);
+    }
+  }
+}
+
+TEST(SpmmTest, TestEdgeSoftmaxSpmm) {
+  _TestEdgeSoftmaxSpmm<int32_t, float>();
+  _TestEdgeSoftmaxSpmm<int64_t, float>();
+  _TestEdgeSoftmaxSpmm<int32_t, double>();
+  _TestEdgeSoftmaxSpmm<int64_t, double>();
+}
 #endif  // _WIN32
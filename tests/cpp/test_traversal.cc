@@ -0,0 +1,140 @@
+#include <dgl/array.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "../../src/array/cpu/traversal.h"
+#include "./common.h"
+
+using namespace dgl;
+using namespace dgl::runtime;
+using namespace dgl::aten;
+using namespace dgl::aten::impl;
+
+namespace {
+
+// More nodes than the grain size above which the traversals run in parallel.
+constexpr int64_t kNumNodes = 100000;
+
+template <typename IdType>
+struct VectorQueue {
+  std::vector<IdType> *vec;
+  size_t head = 0;
+
+  explicit VectorQueue(std::vector<IdType> *vec) : vec(vec) {}
+  void push(const IdType &elem) { vec->push_back(elem); }
+  IdType top() const { return (*vec)[head]; }
+  void pop() { ++head; }
+  bool empty() const { return head == vec->size(); }
+  size_t size() const { return vec->size() - head; }
+};
+
+/**
+ * @brief A random graph with \a degree out-edges per node on average. If \a
+ * dag, the edges go from smaller to larger node IDs. The edge IDs stored in
+ * data are shuffled.
+ */
+template <typename IdType>
+CSRMatrix RandomGraph(int64_t degree, bool dag, bool with_data) {
+  std::mt19937 rng(42);
+  std::vector<std::vector<IdType>> adj(kNumNodes);
+  for (int64_t e = 0; e < kNumNodes * degree; ++e) {
+    IdType u = rng() % kNumNodes, v = rng() % kNumNodes;
+    if (dag) {
+      if (u == v) continue;
+      if (u > v) std::swap(u, v);
+    }
+    adj[u].push_back(v);
+  }
+  std::vector<IdType> indptr{0}, indices;
+  for (const auto &neighbors : adj) {
+    indices.insert(indices.end(), neighbors.begin(), neighbors.end());
+    indptr.push_back(indices.size());
+  }
+  std::vector<IdType> data(indices.size());
+  for (size_t i = 0; i < data.size(); ++i) data[i] = i;
+  std::shuffle(data.begin(), data.end(), rng);
+  return CSRMatrix(
+      kNumNodes, kNumNodes, NDArray::FromVector(indptr),
+      NDArray::FromVector(indices),
+      with_data ? NDArray::FromVector(data) : NullArray());
+}
+
+template <typename IdType>
+void _TestParallelBFS(bool with_data) {
+  // The frontiers grow past a quarter of the unexplored edges after a few
+  // levels, so the traversal switches to bottom-up and back to top-down.
+  const auto csr = RandomGraph<IdType>(8, false, with_data);
+  const IdArray source = NDArray::FromVector(std::vector<IdType>{0, 7, 0});
+  for (const bool edges : {false, true}) {
+    std::vector<IdType> ids, queued;
+    std::vector<int64_t> sections;
+    VectorQueue<IdType> queue(edges ? &queued : &ids);
+    bool first_frontier = true;
+    auto make_frontier = [&] {
+      if (edges && first_frontier) {
+        first_frontier = false;
+      } else if (!queue.empty()) {
+        sections.push_back(queue.size());
+      }
+    };
+    if (edges) {
+      BFSTraverseEdges<IdType>(
+          csr, source, &queue, [&](IdType e) { ids.push_back(e); },
+          make_frontier);
+    } else {
+      BFSTraverseNodes<IdType>(
+          csr, source, &queue, [](IdType) {}, make_frontier);
+    }
+
+    for (const int num_threads : {2, 4, 7}) {
+      std::vector<IdType> parallel_ids;
+      std::vector<int64_t> parallel_sections;
+      if (edges) {
+        ParallelBFSFrontiers<IdType, true>(
+            csr, source, num_threads, &parallel_ids, &parallel_sections);
+      } else {
+        ParallelBFSFrontiers<IdType, false>(
+            csr, source, num_threads, &parallel_ids, &parallel_sections);
+      }
+      ASSERT_EQ(parallel_ids, ids);
+      ASSERT_EQ(parallel_sections, sections);
+    }
+  }
+}
+
+template <typename IdType>
+void _TestParallelTopological(bool with_data) {
+  const auto csr = RandomGraph<IdType>(4, true, with_data);
+  std::vector<IdType> ids;
+  std::vector<int64_t> sections;
+  VectorQueue<IdType> queue(&ids);
+  TopologicalNodes<IdType>(csr, &queue, [](IdType) {}, [&] {
+    if (!queue.empty()) sections.push_back(queue.size());
+  });
+
+  for (const int num_threads : {2, 4, 7}) {
+    std::vector<IdType> parallel_ids;
+    std::vector<int64_t> parallel_sections;
+    ParallelTopologicalFrontiers<IdType>(
+        csr, num_threads, &parallel_ids, &parallel_sections);
+    ASSERT_EQ(parallel_ids, ids);
+    ASSERT_EQ(parallel_sections, sections);
+  }
+}
+
+}  // namespace
+
+TEST(TraversalTest, TestParallelBFS) {
+  _TestParallelBFS<int32_t>(false);
+  _TestParallelBFS<int32_t>(true);
+  _TestParallelBFS<int64_t>(false);
+  _TestParallelBFS<int64_t>(true);
+}
+
+TEST(TraversalTest, TestParallelTopological) {
+  _TestParallelTopological<int32_t>(false);
+  _TestParallelTopological<int64_t>(true);
+}
@@ -256,6 +256,13 @@ def start_client(num_clients, num_servers):
     assert_array_equal(F.asnumpy(res), F.asnumpy(data_tensor))
     res = kvclient.pull(name="data_2", id_tensor=id_tensor)
     assert_array_equal(F.asnumpy(res), F.asnumpy(data_tensor))
+    # Test asynchronous pull, with other requests in between
+    pull_0 = kvclient.pull_async(name="data_0", id_tensor=id_tensor)
+    pull_1 = kvclient.pull_async(name="data_1", id_tensor=id_tensor)
+    res = kvclient.pull(name="data_2", id_tensor=id_tensor)
+    assert_array_equal(F.asnumpy(res), F.asnumpy(data_tensor))
+    assert_array_equal(F.asnumpy(pull_1.wait()), F.asnumpy(data_tensor))
+    assert_array_equal(F.asnumpy(pull_0.wait()), F.asnumpy(data_tensor))
     # Register new push handler
     kvclient.register_push_handler("data_0", udf_push)
     kvclient.register_push_handler("data_1", udf_push)
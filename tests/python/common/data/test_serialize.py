@@ -1,4 +1,5 @@
 import os
+import struct
 import tempfile
 import time
 import unittest
@@ -428,6 +429,185 @@ def test_graph_serialize_with_restricted_formats():
     os.unlink(path)
 
 
+@unittest.skipIf(F._default_context_str == "gpu", reason="GPU not implemented")
+@unittest.skipIf(os.name == "nt", reason="Do not support windows yet")
+@pytest.mark.parametrize("formats", [None, "csc", ["coo", "csr"]])
+@pytest.mark.parametrize("compress", [False, True])
+def test_graph_serialize_mmap(formats, compress):
+    g_list0 = (
+        construct_graph(5)
+        + create_heterographs2(F.int64)
+        + create_heterographs2(F.int32)
+    )
+    labels0 = {"label": F.arange(0, len(g_list0)), "scalar": F.ones(())}
+
+    # create a temporary file and immediately release it so DGL can open it.
+    f = tempfile.NamedTemporaryFile(delete=False)
+    path = f.name
+    f.close()
+
+    dgl.save_graphs(
+        path, g_list0, labels0, formats=formats, mmap=True, compress=compress
+    )
+
+    idx_list = np.random.permutation(np.arange(len(g_list0))).tolist()
+    for idx_list in [None, idx_list[:4]]:
+        g_list, labels = dgl.load_graphs(path, idx_list)
+        if idx_list is None:
+            idx_list = list(range(len(g_list0)))
+        assert len(g_list) == len(idx_list)
+        for k in labels0:
+            assert F.array_equal(labels[k], labels0[k])
+        for g, idx in zip(g_list, idx_list):
+            g0 = g_list0[idx]
+            assert g.idtype == g0.idtype
+            assert g.canonical_etypes == g0.canonical_etypes
+            if formats is not None:
+                fmts = formats if isinstance(formats, list) else [formats]
+                for fmt in fmts:
+                    assert fmt in g.formats()["created"]
+            for ntype in g0.ntypes:
+                assert g.num_nodes(ntype) == g0.num_nodes(ntype)
+                for k, v in g0.nodes[ntype].data.items():
+                    assert F.array_equal(g.nodes[ntype].data[k], v)
+            for etype in g0.canonical_etypes:
+                u, v = g.edges(form="uv", order="eid", etype=etype)
+                u0, v0 = g0.edges(form="uv", order="eid", etype=etype)
+                assert F.array_equal(u, u0)
+                assert F.array_equal(v, v0)
+                for k, v in g0.edges[etype].data.items():
+                    assert F.array_equal(g.edges[etype].data[k], v)
+
+    # The loaded tensors are copy-on-write views of the file, or decoded
+    # copies.
+    g_list, _ = dgl.load_graphs(path, [0])
+    g_list[0].ndata["n1"][:] = 0
+    g_list, _ = dgl.load_graphs(path, [0])
+    assert F.array_equal(g_list[0].ndata["n1"], g_list0[0].ndata["n1"])
+    assert F.array_equal(load_labels(path)["label"], labels0["label"])
+
+    os.unlink(path)
+
+
+@unittest.skipIf(F._default_context_str == "gpu", reason="GPU not implemented")
+@unittest.skipIf(os.name == "nt", reason="Do not support windows yet")
+def test_graph_serialize_compress():
+    # Sorted ids shrink, random features are stored as they are.
+    g0 = dgl.rand_graph(10000, 200000).formats("csc")
+    g0.ndata["h"] = F.randn((g0.num_nodes(), 4))
+    g0.ndata["id"] = F.arange(0, g0.num_nodes())
+
+    paths = []
+    for compress in [False, True]:
+        f = tempfile.NamedTemporaryFile(delete=False)
+        paths.append(f.name)
+        f.close()
+        dgl.save_graphs(paths[-1], [g0], mmap=True, compress=compress)
+    assert os.path.getsize(paths[1]) < 0.75 * os.path.getsize(paths[0])
+
+    g = dgl.load_graphs(paths[1])[0][0]
+    assert F.array_equal(g.ndata["h"], g0.ndata["h"])
+    assert F.array_equal(g.ndata["id"], g0.ndata["id"])
+    indptr, indices, eids = g.adj_tensors("csc")
+    indptr0, indices0, eids0 = g0.adj_tensors("csc")
+    assert F.array_equal(indptr, indptr0)
+    assert F.array_equal(indices, indices0)
+    assert F.array_equal(eids, eids0)
+
+    for path in paths:
+        os.unlink(path)
+
+
+def _read_table(data):
+    """Return the vectors of the table at the end of a version 4 file."""
+    (table_size,) = struct.unpack("<Q", data[-8:])
+    pos = len(data) - 8 - table_size
+    table = []
+    for _ in range(7):
+        (n,) = struct.unpack_from("<Q", data, pos)
+        table.append(struct.unpack_from("<%dQ" % n, data, pos + 8))
+        pos += 8 * (n + 1)
+    return table
+
+
+def _stored_arrays(path):
+    """Return the position, size and codec of the arrays of a version 4 file,
+    read from the table at its end."""
+    with open(path, "rb") as f:
+        data = f.read()
+    _, _, _, buffer_pos, buffer_size, buffer_codec, _ = _read_table(data)
+    return data, list(zip(buffer_pos, buffer_size, buffer_codec))
+
+
+@unittest.skipIf(F._default_context_str == "gpu", reason="GPU not implemented")
+@unittest.skipIf(os.name == "nt", reason="Do not support windows yet")
+@pytest.mark.parametrize("compress", [False, True])
+def test_graph_serialize_checksum(compress):
+    g0 = dgl.rand_graph(10000, 200000).formats("csc")
+    g0.ndata["h"] = F.randn((g0.num_nodes(), 4))
+    g0.ndata["id"] = F.arange(0, g0.num_nodes())
+    f = tempfile.NamedTemporaryFile(delete=False)
+    path = f.name
+    f.close()
+    dgl.save_graphs(path, [g0], mmap=True, compress=compress)
+    data, arrays = _stored_arrays(path)
+    assert compress == any(codec != 0 for _, _, codec in arrays)
+
+    load = dgl.data.graph_serialize._CAPI_LoadGraphFiles_V4
+    for use_mmap in [False, True]:
+        assert len(load(path, [], use_mmap)) == 1
+        for pos, size, codec in arrays:
+            # The arrays stored as they are in a mapped file are views of the
+            # mapping, which are not read, so not checked, at load time.
+            if use_mmap and codec == 0:
+                continue
+            corrupted = bytearray(data)
+            corrupted[pos + size // 2] ^= 0x01
+            with open(path, "wb") as f:
+                f.write(corrupted)
+            with pytest.raises(dgl.DGLError):
+                load(path, [], use_mmap)
+        with open(path, "wb") as f:
+            f.write(data)
+
+    os.unlink(path)
+
+
+@unittest.skipIf(F._default_context_str == "gpu", reason="GPU not implemented")
+@unittest.skipIf(os.name == "nt", reason="Do not support windows yet")
+def test_graph_serialize_version_3():
+    # Version 3 files are version 4 files without the codec and checksum
+    # vectors of the table, whose arrays are all stored as they are.
+    g0 = dgl.rand_graph(100, 500)
+    g0.ndata["h"] = F.randn((g0.num_nodes(), 4))
+    f = tempfile.NamedTemporaryFile(delete=False)
+    path = f.name
+    f.close()
+    dgl.save_graphs(path, [g0], {"label": F.arange(0, 3)}, mmap=True)
+    with open(path, "rb") as f:
+        data = f.read()
+    table = _read_table(data)
+    (table_size,) = struct.unpack("<Q", data[-8:])
+    table_blob = b"".join(
+        struct.pack("<Q%dQ" % len(vec), len(vec), *vec) for vec in table[:5]
+    )
+    with open(path, "wb") as f:
+        f.write(data[:8] + struct.pack("<Q", 3) + data[16 : -8 - table_size])
+        f.write(table_blob + struct.pack("<Q", len(table_blob)))
+
+    for idx_list in [None, [0]]:
+        g_list, labels = dgl.load_graphs(path, idx_list)
+        g = g_list[0]
+        assert F.array_equal(labels["label"], F.arange(0, 3))
+        assert F.array_equal(g.ndata["h"], g0.ndata["h"])
+        u, v = g.edges(order="eid")
+        u0, v0 = g0.edges(order="eid")
+        assert F.array_equal(u, u0)
+        assert F.array_equal(v, v0)
+
+    os.unlink(path)
+
+
 @unittest.skipIf(F._default_context_str == "gpu", reason="GPU not implemented")
 def test_deserialize_old_graph():
     num_nodes = 100
@@ -188,5 +188,33 @@ def test_edge_softmax(g, norm_by, idtype):
         assert F.allclose(grad_edata_hm, grad_edata_ht)
 
 
+@unittest.skipIf(
+    dgl.backend.backend_name != "pytorch", reason="Only support PyTorch for now"
+)
+@pytest.mark.parametrize("shp", [((1,), (4,)), ((3, 1), (3, 4)), ((2,), (2,))])
+@parametrize_idtype
+def test_edge_softmax_spmm(shp, idtype):
+    g = dgl.rand_graph(30, 200, idtype=idtype, device=F.ctx())
+    e_shp, u_shp = shp
+    logits = F.tensor(np.random.randn(g.num_edges(), *e_shp))
+    feat = F.tensor(np.random.randn(g.num_nodes(), *u_shp))
+
+    e1 = F.attach_grad(F.clone(logits))
+    u1 = F.attach_grad(F.clone(feat))
+    with F.record_grad():
+        out1 = dgl.ops.edge_softmax_spmm(g, e1, u1)
+        F.backward(F.reduce_sum(out1 * out1))
+
+    e2 = F.attach_grad(F.clone(logits))
+    u2 = F.attach_grad(F.clone(feat))
+    with F.record_grad():
+        out2 = dgl.ops.u_mul_e_sum(g, u2, edge_softmax(g, e2))
+        F.backward(F.reduce_sum(out2 * out2))
+
+    assert F.allclose(out1, out2)
+    assert F.allclose(F.grad(e1), F.grad(e2))
+    assert F.allclose(F.grad(u1), F.grad(u2))
+
+
 if __name__ == "__main__":
     test_edge_softmax_unidirectional()
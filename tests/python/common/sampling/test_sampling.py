@@ -1828,6 +1828,76 @@ def test_global_uniform_negative_sampling(dtype):
     assert not F.asnumpy(g.has_edges_between(src, dst, etype="AB")).any()
 
 
+@unittest.skipIf(
+    F._default_context_str == "gpu", reason="GPU sampling draws pairs once"
+)
+@pytest.mark.parametrize("dtype", ["int32", "int64"])
+@pytest.mark.parametrize("replace", [False, True])
+def test_global_uniform_negative_sampling_exact(dtype, replace):
+    warnings.simplefilter("ignore", np.exceptions.ComplexWarning)
+    num_nodes = 300
+    g = dgl.graph(
+        (
+            np.random.randint(0, num_nodes, (20000,)),
+            np.random.randint(0, num_nodes, (20000,)),
+        ),
+        num_nodes=num_nodes,
+        idtype=dtype,
+    )
+    # About half of the non-edges are requested, so that the sampled pairs
+    # collide often.
+    num_samples = (num_nodes * num_nodes - g.to_simple().num_edges()) // 2
+    src, dst = dgl.sampling.global_uniform_negative_sampling(
+        g, num_samples, True, replace
+    )
+    assert len(src) == num_samples
+    assert len(dst) == num_samples
+    assert not F.asnumpy(g.has_edges_between(src, dst)).any()
+    assert not F.asnumpy(src == dst).any()
+    if not replace:
+        s = set(zip(F.asnumpy(src).tolist(), F.asnumpy(dst).tolist()))
+        assert len(s) == num_samples
+
+
+@unittest.skipIf(
+    F._default_context_str == "gpu", reason="Only supported on the CPU"
+)
+@pytest.mark.parametrize("dtype", ["int32", "int64"])
+def test_per_source_uniform_negative_sampling(dtype):
+    g = dgl.heterograph(
+        {
+            ("A", "AB", "B"): (
+                np.random.randint(0, 20, (300,)),
+                np.random.randint(0, 40, (300,)),
+            ),
+        },
+        num_nodes_dict={"A": 20, "B": 40},
+        idtype=dtype,
+    )
+    # Node 0 is connected to all the nodes of B.
+    g.add_edges(F.zeros((40,), g.idtype, F.cpu()), F.arange(0, 40, g.idtype))
+    src = F.tensor(np.random.randint(0, 20, (100,)), g.idtype)
+    k = 5
+    neg_src, neg_dst = dgl.sampling.per_source_uniform_negative_sampling(
+        g, src, k
+    )
+    assert neg_src.dtype == g.idtype
+    assert not F.asnumpy(g.has_edges_between(neg_src, neg_dst)).any()
+    expected_src = F.asnumpy(src).repeat(k)
+    expected_src = expected_src[expected_src != 0]
+    assert np.array_equal(F.asnumpy(neg_src), expected_src)
+    assert F.asnumpy(neg_dst).max() < 40
+
+    # Self loops are excluded on homogeneous graphs.
+    g = dgl.graph(([0, 1], [1, 2]), num_nodes=4, idtype=dtype)
+    neg_src, neg_dst = dgl.sampling.per_source_uniform_negative_sampling(
+        g, F.tensor([0, 0, 3], g.idtype), 10
+    )
+    assert len(neg_src) == 30
+    assert not F.asnumpy(neg_src == neg_dst).any()
+    assert not F.asnumpy(g.has_edges_between(neg_src, neg_dst)).any()
+
+
 if __name__ == "__main__":
     from itertools import product
 
@@ -164,7 +164,8 @@ def _test_knn_common(device, algorithm, dist, exclude_self):
 
 
 @pytest.mark.parametrize(
-    "algorithm", ["bruteforce-blas", "bruteforce", "kd-tree"]
+    "algorithm",
+    ["bruteforce-blas", "bruteforce", "bruteforce-blocked", "kd-tree"],
 )
 @pytest.mark.parametrize("dist", ["euclidean", "cosine"])
 @pytest.mark.parametrize("exclude_self", [False, True])
@@ -172,6 +173,27 @@ def test_knn_cpu(algorithm, dist, exclude_self):
     _test_knn_common(F.cpu(), algorithm, dist, exclude_self)
 
 
+@pytest.mark.parametrize("num_points", [8, 300, 1025])
+@pytest.mark.parametrize("dim", [3, 37])
+def test_knn_blocked_large(num_points, dim):
+    x = th.randn(num_points, dim, dtype=th.float64)
+    y = th.randn(num_points + 5, dim, dtype=th.float64)
+    k = 4
+
+    def ground_truth(x, y, k):
+        dist = th.cdist(y, x)
+        ret = th.topk(dist, k, dim=-1, largest=False)[1]
+        return th.sort(ret, dim=-1)[0]
+
+    gt = ground_truth(x, y, k)
+    out = dgl.functional.knn(
+        k, x, [num_points], y, [num_points + 5], algorithm="bruteforce-blocked"
+    )
+    assert th.all(out[0] == th.arange(num_points + 5).repeat_interleave(k))
+    actual = th.sort(out[1].reshape(-1, k), -1)[0]
+    assert th.all(actual == gt).item()
+
+
 @pytest.mark.parametrize(
     "algorithm", ["bruteforce-blas", "bruteforce", "bruteforce-sharemem"]
 )
@@ -210,6 +232,21 @@ def test_knn_sharedmem_large(num_points):
     assert th.all(actual == gt).item()
 
 
+def test_knn_nn_descent_recall():
+    num_points, k = 2000, 8
+    x = th.randn(num_points, 8)
+    segs = [500, num_points - 500]
+    out = dgl.functional.knn(k, x, segs, algorithm="nn-descent")
+    assert th.all(out[0] == th.arange(num_points).repeat_interleave(k))
+    hits = 0
+    for start, end in [(0, 500), (500, num_points)]:
+        d = th.cdist(x[start:end], x[start:end])
+        gt = th.topk(d, k, dim=-1, largest=False)[1] + start
+        actual = out[1].view(num_points, k)[start:end]
+        hits += (actual.unsqueeze(-1) == gt.unsqueeze(1)).any(-1).sum()
+    assert hits / (num_points * k) > 0.7
+
+
 @parametrize_idtype
 @pytest.mark.parametrize("g", get_cases(["homo"], exclude=["dglgraph"]))
 @pytest.mark.parametrize("weight", [True, False])
@@ -31,7 +31,9 @@ def to_on_disk_numpy(test_dir, name, t):
         torch.float64,
     ],
 )
-@pytest.mark.parametrize("policy", ["s3-fifo", "sieve", "lru", "clock"])
+@pytest.mark.parametrize(
+    "policy", ["s3-fifo", "sieve", "lru", "clock", "concurrent-clock"]
+)
 def test_cpu_cached_feature(dtype, policy):
     cache_size_a = 32
     cache_size_b = 64
@@ -182,3 +184,89 @@ def test_cpu_cached_disk_feature_read_async(dtype):
             assert torch.equal(values.wait(), a[ids])
 
         feat_store = None
+
+
+@unittest.skipIf(
+    not torch.ops.graphbolt.detect_io_uring(),
+    reason="DiskBasedFeature is not available on this system.",
+)
+@pytest.mark.parametrize("policy", ["s3-fifo", "sieve", "lru", "clock"])
+def test_cpu_cached_disk_feature_ondisk_reader(policy):
+    a = torch.randn([1000, 37], dtype=torch.float32)
+
+    cache_size = 256 * a[:1].nbytes
+
+    with tempfile.TemporaryDirectory() as test_dir:
+        path = to_on_disk_numpy(test_dir, "tensor", a)
+
+        feat_store = gb.cpu_cached_feature(
+            gb.DiskBasedFeature(path=path), cache_size, policy
+        )
+        assert feat_store._ondisk_reader is not None
+
+        # Hot rows are served from the cache, the rest from the disk.
+        hot = torch.arange(0, 1000, 10)
+        for _ in range(5):
+            ids = torch.cat([hot, torch.randint(0, 1000, (100,))])
+            ids = ids[torch.randperm(ids.size(0))]
+            assert torch.equal(feat_store.read(ids), a[ids])
+            reader = feat_store.read_async(ids)
+            for _ in range(feat_store.read_async_num_stages(ids.device)):
+                values = next(reader)
+            assert torch.equal(values.wait(), a[ids])
+        statistics = feat_store._ondisk_reader.statistics()
+        assert statistics["num_queries"] == 5 * 2 * 200
+        assert statistics["num_misses"] < statistics["num_queries"] // 2
+        assert statistics["num_bytes_requested"] == (
+            statistics["num_misses"] * a[:1].nbytes
+        )
+        assert feat_store.miss_rate == (
+            statistics["num_misses"] / statistics["num_queries"]
+        )
+
+        # Negative ids count from the end and invalid ids are rejected.
+        ids = torch.tensor([-1, 0, -1000])
+        assert torch.equal(feat_store.read(ids), a[ids])
+        with pytest.raises(IndexError):
+            feat_store.read(torch.tensor([1000]))
+
+        feat_store = None
+
+
+@unittest.skipIf(
+    not torch.ops.graphbolt.detect_io_uring(),
+    reason="DiskBasedFeature is not available on this system.",
+)
+@pytest.mark.parametrize(
+    "policy", ["s3-fifo", "sieve", "lru", "clock", "concurrent-clock"]
+)
+def test_cpu_cached_disk_feature_ondisk_reader_read_failure(policy):
+    a = torch.randn([1000, 37], dtype=torch.float32)
+
+    cache_size = 256 * a[:1].nbytes
+
+    with tempfile.TemporaryDirectory() as test_dir:
+        path = to_on_disk_numpy(test_dir, "tensor", a)
+
+        feat_store = gb.cpu_cached_feature(
+            gb.DiskBasedFeature(path=path), cache_size, policy
+        )
+        assert feat_store._ondisk_reader is not None
+
+        # Reading past the end of the truncated file fails. The failure is
+        # not reported as an invalid id.
+        ids = torch.arange(500, 600)
+        os.truncate(path, os.path.getsize(path) // 10)
+        for _ in range(2):
+            with pytest.raises(RuntimeError):
+                feat_store.read(ids)
+
+        # The rows that failed to be read were not admitted into the cache,
+        # so they are read again once the file is restored.
+        np.save(path, a.numpy())
+        for _ in range(2):
+            assert torch.equal(feat_store.read(ids), a[ids])
+        statistics = feat_store._ondisk_reader.statistics()
+        assert statistics["num_misses"] < 2 * ids.size(0)
+
+        feat_store = None
@@ -152,6 +152,41 @@ def test_more_disk_based_feature(dtype, idtype, shape, index):
         assert_equal(feature.read(idx), test_tensor[idx.long()])
 
 
+@unittest.skipIf(
+    not torch.ops.graphbolt.detect_io_uring(),
+    reason="DiskBasedFeature is not available on this system.",
+)
+@pytest.mark.parametrize("row_size", [3, 100, 1500])
+def test_disk_based_feature_coalesced_reads(row_size):
+    tensor = torch.randn([1000, row_size])
+    with tempfile.TemporaryDirectory() as test_dir:
+        path = to_on_disk_numpy(test_dir, "tensor", tensor)
+        feature = gb.DiskBasedFeature(path=path)
+
+        # Unsorted, duplicated, negative and adjacent ids.
+        ids = torch.cat(
+            [
+                torch.randint(0, 1000, (500,)),
+                torch.arange(200, 300).flip(0),
+                torch.tensor([5, 5, -1, 999, 0]),
+            ]
+        )
+        feature.read_statistics(reset=True)
+        assert_equal(feature.read(ids), tensor[ids])
+        statistics = feature.read_statistics(reset=True)
+        assert statistics["num_bytes_requested"] == ids.numel() * row_size * 4
+        # Rows sharing file blocks are read only once.
+        assert 0 < statistics["num_reads"] < ids.numel()
+        assert statistics["num_bytes_read"] > 0
+        assert feature.read_statistics()["num_reads"] == 0
+
+        # Reading consecutive rows of small features takes few reads.
+        if row_size == 3:
+            feature.read(torch.arange(1000))
+            assert feature.read_statistics()["num_reads"] < 10
+        feature = None
+
+
 @unittest.skipIf(
     not torch.ops.graphbolt.detect_io_uring(),
     reason="DiskBasedFeature is not available on this system.",
@@ -170,3 +170,51 @@ def test_feature_cache(offsets, dtype, feature_size, num_parts, policy, offset):
     if pin_memory:
         val = raw_feature_cache.index_select(idx.to(F.ctx()))
         assert torch.equal(val, a[idx].to(F.ctx()))
+
+
+@pytest.mark.parametrize("num_parts", [1, 2])
+@pytest.mark.parametrize("num_concurrent", [1, 8])
+def test_concurrent_feature_cache(num_parts, num_concurrent):
+    num_keys = 10000
+    cache_size = 4096
+    a = torch.randint(0, 1000, [num_keys, 3])
+    cache = gb.impl.CPUFeatureCache(
+        (cache_size,) + a.shape[1:], a.dtype, "concurrent-clock", num_parts
+    )
+    policy = cache._policy
+    torch.manual_seed(7)
+    for _ in range(10):
+        # Skewed keys with duplicates, queried concurrently.
+        keys = [
+            (num_keys * torch.rand(1000) ** 3).long()
+            for _ in range(num_concurrent)
+        ]
+        futures = [policy.query_and_replace_async(k, 0) for k in keys]
+        results = [future.wait() for future in futures]
+        for k, result in zip(keys, results):
+            (
+                positions,
+                index,
+                pointers,
+                missing_keys,
+                found_offsets,
+                missing_offsets,
+            ) = result
+            found_cnt = k.size(0) - missing_keys.size(0)
+            assert torch.equal(k[index[found_cnt:]], missing_keys)
+            values = cache._cache.query(
+                positions[:found_cnt], index, k.size(0)
+            )
+            policy.reading_completed(pointers[:found_cnt], found_offsets)
+            missing_values = a[missing_keys]
+            values[index[found_cnt:]] = missing_values
+            cache._cache.replace(positions[found_cnt:], missing_values)
+            policy.writing_completed(pointers[found_cnt:], missing_offsets)
+            assert torch.equal(values, a[k])
+    # Once the hot keys are cached, most of the queries hit.
+    keys = (num_keys * torch.rand(1000) ** 3).long()
+    reader_fn = lambda keys: a[keys]
+    cache.query_and_replace(keys, reader_fn)
+    total_miss = cache.total_miss
+    assert torch.equal(cache.query_and_replace(keys, reader_fn), a[keys])
+    assert cache.total_miss - total_miss < keys.size(0) // 10
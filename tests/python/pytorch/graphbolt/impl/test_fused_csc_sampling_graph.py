@@ -2143,6 +2143,252 @@ def test_sample_neighbors_zero_probs(replace, labor, probs_or_mask):
     assert sampled_num == 0
 
 
+@unittest.skipIf(
+    F._default_context_str == "gpu",
+    reason="The prefix sum of probabilities is only used on the CPU.",
+)
+@pytest.mark.parametrize("replace", [True, False])
+@pytest.mark.parametrize("fanout", [1, 4, -1])
+def test_sample_neighbors_probs_prefix_sum(replace, fanout):
+    # A hub node 0 with 1000 neighbors, every other of them with zero weight,
+    # followed by node 1 with 3 neighbors.
+    num_neighbors = 1000
+    indptr = torch.LongTensor([0, num_neighbors, num_neighbors + 3])
+    indices = torch.cat(
+        [torch.arange(num_neighbors) % 2, torch.LongTensor([0, 1, 1])]
+    )
+    weight = torch.rand(num_neighbors + 3) + 0.5
+    weight[:num_neighbors:2] = 0
+    graph = gb.fused_csc_sampling_graph(
+        indptr, indices, edge_attributes={"weight": weight}
+    )
+    graph.build_probs_prefix_sum("weight")
+    prefix_sum = graph.edge_attributes["weight.prefix_sum"]
+    assert prefix_sum.dtype == torch.float64
+    # The exclusive sums restart at every node.
+    expected = torch.cat(
+        [
+            weight[begin:end].double().cumsum(0) - weight[begin:end].double()
+            for begin, end in zip(indptr[:-1], indptr[1:])
+        ]
+    )
+    assert torch.allclose(prefix_sum, expected)
+
+    # The prefix sum is persisted with the other edge attributes.
+    graph = pickle.loads(pickle.dumps(graph))
+    assert "weight.prefix_sum" in graph.edge_attributes
+
+    counts = torch.zeros(num_neighbors + 3)
+    num_rounds = 200
+    for _ in range(num_rounds):
+        subgraph = graph.sample_neighbors(
+            torch.LongTensor([0, 1]),
+            fanouts=torch.LongTensor([fanout]),
+            replace=replace,
+            probs_name="weight",
+        )
+        eids = subgraph.original_edge_ids
+        indptr_out = subgraph.sampled_csc.indptr
+        if fanout == -1:
+            assert torch.equal(indptr_out, torch.LongTensor([0, 500, 503]))
+        else:
+            picked = fanout if replace else min(fanout, 3)
+            assert torch.equal(
+                indptr_out, torch.LongTensor([0, fanout, fanout + picked])
+            )
+        assert torch.all(weight[eids] > 0)
+        if not replace:
+            hub_eids = eids[: indptr_out[1]]
+            assert hub_eids.unique().numel() == hub_eids.numel()
+        counts += torch.bincount(eids, minlength=num_neighbors + 3)
+    if fanout == 1:
+        # The hub neighbors are drawn proportionally to their weights, so the
+        # mean weight of the picks is sum(w^2) / sum(w).
+        hub_weight = weight[:num_neighbors]
+        mean_weight = (counts[:num_neighbors] * hub_weight).sum() / num_rounds
+        expected = (hub_weight**2).sum() / hub_weight.sum()
+        assert abs(mean_weight - expected) < 0.1 * expected
+
+    # Replacing the probabilities drops the stale prefix sum, unless it is
+    # replaced along with them.
+    edge_attributes = graph.edge_attributes
+    graph.edge_attributes = edge_attributes
+    assert "weight.prefix_sum" in graph.edge_attributes
+    graph.edge_attributes = {k: v.clone() for k, v in edge_attributes.items()}
+    assert "weight.prefix_sum" in graph.edge_attributes
+    graph.edge_attributes = {
+        "weight": torch.ones(num_neighbors + 3),
+        "weight.prefix_sum": graph.edge_attributes["weight.prefix_sum"],
+    }
+    assert "weight.prefix_sum" not in graph.edge_attributes
+    graph.build_probs_prefix_sum("weight")
+    graph.add_edge_attribute("weight", torch.ones(num_neighbors + 3))
+    assert "weight.prefix_sum" not in graph.edge_attributes
+
+
+@unittest.skipIf(
+    F._default_context_str == "gpu",
+    reason="The prefix sum of probabilities is only used on the CPU.",
+)
+def test_sample_neighbors_probs_prefix_sum_precision():
+    # The heavy edge of node 0 is followed by the edges of node 1, whose
+    # weights are below the precision of a float64 sum that includes it.
+    indptr = torch.LongTensor([0, 1, 3])
+    indices = torch.LongTensor([0, 0, 1])
+    weight = torch.DoubleTensor([2.0**60, 1024.0, 1.0])
+    graph = gb.fused_csc_sampling_graph(
+        indptr, indices, edge_attributes={"weight": weight}
+    )
+    graph.build_probs_prefix_sum("weight")
+    fanout = 20000
+    subgraph = graph.sample_neighbors(
+        torch.LongTensor([1]),
+        fanouts=torch.LongTensor([fanout]),
+        replace=True,
+        probs_name="weight",
+    )
+    counts = torch.bincount(subgraph.original_edge_ids, minlength=3)
+    assert counts[0] == 0
+    # Edge 2 is expected to be picked fanout / 1025 ~ 19.5 times.
+    assert 0 < counts[2] < 60
+
+
+@unittest.skipIf(
+    F._default_context_str == "gpu",
+    reason="Compressed indices are only supported on the CPU.",
+)
+@pytest.mark.parametrize("dtype", [torch.int32, torch.int64])
+def test_compress_indices(dtype):
+    # Sorted neighbors, a hub node spanning many chunks, isolated nodes and
+    # the extreme values of the dtype.
+    num_nodes = 1000
+    degrees = torch.randint(0, 20, (num_nodes,))
+    degrees[::7] = 0
+    degrees[500] = 5000
+    csc_indptr = torch.cat([torch.zeros(1), degrees.cumsum(0)]).long()
+    indices = torch.randint(0, num_nodes, (csc_indptr[-1],), dtype=dtype)
+    for i in range(0, num_nodes, 2):
+        begin, end = csc_indptr[i], csc_indptr[i + 1]
+        indices[begin:end] = indices[begin:end].sort()[0]
+    info = torch.iinfo(dtype)
+    indices[csc_indptr[3] : csc_indptr[4]] = info.max
+    indices[csc_indptr[5]] = info.min
+    graph = gb.fused_csc_sampling_graph(csc_indptr, indices)
+    compressed = gb.fused_csc_sampling_graph(csc_indptr, indices)
+    assert compressed.compressed_indices is None
+    compressed.compress_indices()
+    assert compressed.compressed_indices.dtype == torch.uint8
+    assert compressed.total_num_edges == graph.total_num_edges
+    assert torch.equal(compressed.indices, indices)
+
+    nodes = torch.randint(0, num_nodes, (100,), dtype=dtype)
+    nodes[0] = 500
+    expected = graph.in_subgraph(nodes)
+    subgraph = compressed.in_subgraph(nodes)
+    assert torch.equal(subgraph.sampled_csc.indptr, expected.sampled_csc.indptr)
+    assert torch.equal(
+        subgraph.sampled_csc.indices, expected.sampled_csc.indices
+    )
+    assert torch.equal(subgraph.original_edge_ids, expected.original_edge_ids)
+
+    for fanout in [3, -1]:
+        subgraph = compressed.sample_neighbors(
+            nodes, fanouts=torch.LongTensor([fanout])
+        )
+        assert torch.equal(
+            subgraph.sampled_csc.indices, indices[subgraph.original_edge_ids]
+        )
+
+    # The compressed indices are shared and pickled in place of the indices.
+    shm_name = f"test_compress_indices_{indices.element_size()}"
+    for graph2 in [
+        compressed.copy_to_shared_memory(shm_name),
+        pickle.loads(pickle.dumps(compressed)),
+    ]:
+        assert torch.equal(
+            graph2.compressed_indices, compressed.compressed_indices
+        )
+        assert torch.equal(graph2.indices, indices)
+
+    with pytest.raises(RuntimeError):
+        compressed.sample_layer_neighbors(nodes, fanouts=torch.LongTensor([3]))
+
+    # Setting the indices replaces the compressed indices.
+    compressed.indices = indices
+    assert compressed.compressed_indices is None
+    assert torch.equal(compressed.indices, indices)
+
+
+@unittest.skipIf(
+    F._default_context_str == "gpu",
+    reason="Compressed indices are only supported on the CPU.",
+)
+def test_compress_indices_size():
+    # Node i has the neighbors [i, i + 10), which are stored in a few bits per
+    # edge.
+    num_nodes = 10000
+    csc_indptr = torch.arange(0, 10 * num_nodes + 1, 10)
+    indices = (
+        torch.arange(num_nodes).repeat_interleave(10)
+        + torch.arange(10).repeat(num_nodes)
+    ).int()
+    graph = gb.fused_csc_sampling_graph(csc_indptr, indices)
+    graph.compress_indices()
+    assert graph.compressed_indices.numel() < indices.numel()
+    assert graph.compressed_indices_offsets.shape == (num_nodes // 16 + 1,)
+    assert torch.equal(graph.indices, indices)
+    # The compressed indices are printed without decompressing them.
+    size = graph.compressed_indices.numel()
+    assert f"indices=<compressed, {size} bytes>" in str(graph)
+
+
+@unittest.skipIf(
+    F._default_context_str == "gpu",
+    reason="Multi-hop sampling is only supported on the CPU.",
+)
+@pytest.mark.parametrize("dtype", [torch.int32, torch.int64])
+@pytest.mark.parametrize("replace", [False, True])
+@pytest.mark.parametrize("async_op", [False, True])
+def test_sample_neighbors_multi_hop(dtype, replace, async_op):
+    num_nodes = 1000
+    csc = torch.randint(0, num_nodes, (10 * num_nodes,))
+    indptr = torch.arange(0, csc.size(0) + 1, 10)
+    indices = csc.to(dtype)
+    graph = gb.fused_csc_sampling_graph(indptr, indices)
+    seeds = torch.randperm(num_nodes, dtype=dtype)[:16]
+    fanouts = [5, 3, -1]
+
+    result = graph.sample_neighbors_multi_hop(
+        seeds, fanouts, replace=replace, async_op=async_op
+    )
+    if async_op:
+        result = result.wait()
+    input_nodes, subgraphs = result
+    assert len(subgraphs) == len(fanouts)
+    assert torch.equal(input_nodes, subgraphs[0].original_row_node_ids)
+    assert torch.equal(subgraphs[-1].original_column_node_ids, seeds)
+    for subgraph, fanout in zip(subgraphs, reversed(fanouts)):
+        dst = subgraph.original_column_node_ids
+        src = subgraph.original_row_node_ids
+        # The nodes of a hop start with its seeds and are unique.
+        assert src.dtype == dtype
+        assert torch.equal(src[: dst.size(0)], dst)
+        assert src.unique().size(0) == src.size(0)
+        csc = subgraph.sampled_csc
+        degrees = csc.indptr.diff()
+        assert torch.all(degrees == (10 if fanout == -1 else fanout))
+        # The compacted indices map to sampled edges of the original graph.
+        eids = subgraph.original_edge_ids
+        assert torch.equal(src[csc.indices], indices[eids])
+        assert torch.equal(dst.long().repeat_interleave(degrees), eids // 10)
+    # The seeds of each hop are the nodes of the previous hop.
+    for i in range(len(subgraphs) - 1):
+        assert torch.equal(
+            subgraphs[i].original_column_node_ids,
+            subgraphs[i + 1].original_row_node_ids,
+        )
+
+
 @pytest.mark.parametrize("replace", [False, True])
 @pytest.mark.parametrize("labor", [False, True])
 @pytest.mark.parametrize(
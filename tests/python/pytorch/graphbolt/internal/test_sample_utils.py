@@ -170,6 +170,28 @@ def test_unique_and_compact_csc_formats_homo():
     assert torch.equal(unique_nodes, expected_unique_nodes)
 
 
+@pytest.mark.parametrize("dtype", [torch.int32, torch.int64])
+def test_unique_and_compact_csc_formats_duplicated(dtype):
+    # Sampled ids are highly duplicated and some of them are seeds, the ids are
+    # strided to collide in a weak hash function.
+    num_seeds = 1000
+    seeds = torch.randperm(20000, dtype=dtype)[:num_seeds] * 64
+    indices = torch.randint(0, 20000, (200000,), dtype=dtype) * 64
+    indptr = torch.arange(0, indices.size(0) + 1, 200)
+    csc_formats = gb.CSCFormatBase(indptr=indptr, indices=indices)
+
+    unique_nodes, compacted_csc_formats, _ = gb.unique_and_compact_csc_formats(
+        csc_formats, seeds
+    )
+
+    expected_unique_nodes = torch.cat([seeds, indices]).unique()
+    assert unique_nodes.dtype == dtype
+    assert torch.equal(unique_nodes[:num_seeds], seeds)
+    assert torch.equal(unique_nodes.sort()[0], expected_unique_nodes)
+    assert torch.equal(compacted_csc_formats.indptr, indptr)
+    assert torch.equal(unique_nodes[compacted_csc_formats.indices], indices)
+
+
 def test_unique_and_compact_incorrect_indptr():
     seeds = torch.tensor([1, 3, 5, 2, 6, 7])
     indptr = torch.tensor([0, 2, 4, 6, 7, 11])